@@ -0,0 +1,313 @@
+/* Microbenchmark for the attributes hash table (iupTable).
+ *
+ * Compares the open addressing Itable with the previous chained implementation
+ * (prime sized bucket array, each bucket with its own items array,
+ * keys compared only by the checksum) on attribute-heavy workloads:
+ * many small tables (one per Ihandle) with repeated Set/Get of attribute names.
+ *
+ * Also measures IupSetAttribute/IupGetAttribute on "user" elements.
+ *
+ * Build with the IUP SDK headers:
+ *   gcc -O2 -I../../../include -I../../../src table_bench.c -liup
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "iup.h"
+#include "iup_export.h"
+#include "iup_table.h"
+
+
+/*********************************************************************/
+/* Previous implementation, simplified, used only for comparison      */
+/*********************************************************************/
+
+typedef struct _OldItem
+{
+  unsigned long keyIndex;
+  char* keyStr;
+  void* value;
+} OldItem;
+
+typedef struct _OldEntry
+{
+  unsigned int nextItemIndex;
+  unsigned int itemsSize;
+  OldItem* items;
+} OldEntry;
+
+typedef struct _OldTable
+{
+  unsigned int entriesSize;
+  unsigned int numberOfEntries;
+  unsigned int tableSizeIndex;
+  OldEntry* entries;
+} OldTable;
+
+static const unsigned int old_hashTableSize[] = { 31, 101, 401, 1601, 4001, 8009, 16001, 32003, 64007 };
+
+static OldTable* oldTableCreate(unsigned int sizeIndex)
+{
+  OldTable* ot = (OldTable*)malloc(sizeof(OldTable));
+  ot->entriesSize = old_hashTableSize[sizeIndex];
+  ot->tableSizeIndex = sizeIndex;
+  ot->numberOfEntries = 0;
+  ot->entries = (OldEntry*)calloc(ot->entriesSize, sizeof(OldEntry));
+  return ot;
+}
+
+static void oldTableDestroy(OldTable* ot)
+{
+  unsigned int i, j;
+  for (i = 0; i < ot->entriesSize; i++)
+  {
+    for (j = 0; j < ot->entries[i].nextItemIndex; j++)
+    {
+      free(ot->entries[i].items[j].keyStr);
+      free(ot->entries[i].items[j].value);
+    }
+    free(ot->entries[i].items);
+  }
+  free(ot->entries);
+  free(ot);
+}
+
+static unsigned long oldTableChecksum(const char* key)
+{
+  unsigned int checksum = 0;
+  while (*key)
+  {
+    checksum *= 31;
+    checksum += *key;
+    key++;
+  }
+  return checksum;
+}
+
+static OldItem* oldTableFind(OldTable* ot, const char* key, OldEntry** entry, unsigned long* keyIndex)
+{
+  unsigned int i;
+  *keyIndex = oldTableChecksum(key);
+  *entry = &(ot->entries[*keyIndex % ot->entriesSize]);
+  for (i = 0; i < (*entry)->nextItemIndex; i++)
+  {
+    if ((*entry)->items[i].keyIndex == *keyIndex)
+      return &((*entry)->items[i]);
+  }
+  return NULL;
+}
+
+static void oldTableSet(OldTable* ot, const char* key, const char* value)
+{
+  OldEntry* entry;
+  unsigned long keyIndex;
+  OldItem* item = oldTableFind(ot, key, &entry, &keyIndex);
+  if (!item)
+  {
+    if (ot->tableSizeIndex < 8 && ot->entriesSize / (ot->numberOfEntries + 1) < 2)
+    {
+      /* resize by re-inserting everything */
+      OldTable* nt = oldTableCreate(ot->tableSizeIndex + 1);
+      unsigned int i, j;
+      for (i = 0; i < ot->entriesSize; i++)
+      {
+        for (j = 0; j < ot->entries[i].nextItemIndex; j++)
+        {
+          OldItem* it = &(ot->entries[i].items[j]);
+          OldEntry* ne = &(nt->entries[it->keyIndex % nt->entriesSize]);
+          if (ne->nextItemIndex >= ne->itemsSize)
+          {
+            ne->itemsSize += 5;
+            ne->items = (OldItem*)realloc(ne->items, ne->itemsSize * sizeof(OldItem));
+          }
+          ne->items[ne->nextItemIndex++] = *it;
+        }
+        free(ot->entries[i].items);
+      }
+      free(ot->entries);
+      ot->entries = nt->entries;
+      ot->entriesSize = nt->entriesSize;
+      ot->tableSizeIndex = nt->tableSizeIndex;
+      free(nt);
+      entry = &(ot->entries[keyIndex % ot->entriesSize]);
+    }
+
+    if (entry->nextItemIndex >= entry->itemsSize)
+    {
+      entry->itemsSize += 5;
+      entry->items = (OldItem*)realloc(entry->items, entry->itemsSize * sizeof(OldItem));
+    }
+
+    item = &(entry->items[entry->nextItemIndex++]);
+    item->keyIndex = keyIndex;
+    item->keyStr = strdup(key);
+    item->value = strdup(value);
+    ot->numberOfEntries++;
+  }
+  else
+  {
+    if (strcmp((char*)item->value, value) == 0)
+      return;
+    free(item->value);
+    item->value = strdup(value);
+  }
+}
+
+static void* oldTableGet(OldTable* ot, const char* key)
+{
+  OldEntry* entry;
+  unsigned long keyIndex;
+  OldItem* item = oldTableFind(ot, key, &entry, &keyIndex);
+  return item ? item->value : NULL;
+}
+
+
+/*********************************************************************/
+/* Workloads                                                          */
+/*********************************************************************/
+
+#define NUM_HANDLES 5000
+#define NUM_ROUNDS 20
+
+static const char* bench_names[] = {
+  "VALUE", "TITLE", "ACTIVE", "VISIBLE", "BGCOLOR", "FGCOLOR", "FONT", "SIZE", "RASTERSIZE", "EXPAND",
+  "ALIGNMENT", "PADDING", "MARGIN", "GAP", "NAME", "TIP", "CURSOR", "MINSIZE", "MAXSIZE", "FLOATING",
+  "HANDLENAME", "CPADDING", "CMARGIN", "NORMALIZERGROUP", "USERSIZE", "_IUP_XY", "IMAGE", "IMINACTIVE",
+  "IMPRESS", "MARKUP"
+};
+#define NUM_NAMES ((int)(sizeof(bench_names)/sizeof(bench_names[0])))
+
+static double benchTime(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static void benchOldTable(void)
+{
+  OldTable** tables = (OldTable**)malloc(NUM_HANDLES * sizeof(OldTable*));
+  clock_t start = clock();
+  int h, n, r;
+  size_t found = 0;
+
+  for (h = 0; h < NUM_HANDLES; h++)
+  {
+    tables[h] = oldTableCreate(1);
+    for (n = 0; n < NUM_NAMES; n++)
+      oldTableSet(tables[h], bench_names[n], "1");
+  }
+
+  for (r = 0; r < NUM_ROUNDS; r++)
+  {
+    for (h = 0; h < NUM_HANDLES; h++)
+    {
+      for (n = 0; n < NUM_NAMES; n++)
+      {
+        if (oldTableGet(tables[h], bench_names[n]))
+          found++;
+        if (oldTableGet(tables[h], "NOTFOUND"))  /* inherited attribute miss */
+          found++;
+      }
+      oldTableSet(tables[h], "VALUE", (r & 1) ? "1" : "0");
+    }
+  }
+
+  for (h = 0; h < NUM_HANDLES; h++)
+    oldTableDestroy(tables[h]);
+  free(tables);
+
+  printf("Chained table:          %.3fs (%lu hits)\n", benchTime(start), (unsigned long)found);
+}
+
+static void benchNewTable(void)
+{
+  Itable** tables = (Itable**)malloc(NUM_HANDLES * sizeof(Itable*));
+  clock_t start = clock();
+  int h, n, r;
+  size_t found = 0;
+
+  for (h = 0; h < NUM_HANDLES; h++)
+  {
+    tables[h] = iupTableCreate(IUPTABLE_STRINGINDEXED);
+    for (n = 0; n < NUM_NAMES; n++)
+      iupTableSet(tables[h], bench_names[n], "1", IUPTABLE_STRING);
+  }
+
+  for (r = 0; r < NUM_ROUNDS; r++)
+  {
+    for (h = 0; h < NUM_HANDLES; h++)
+    {
+      for (n = 0; n < NUM_NAMES; n++)
+      {
+        if (iupTableGet(tables[h], bench_names[n]))
+          found++;
+        if (iupTableGet(tables[h], "NOTFOUND"))  /* inherited attribute miss */
+          found++;
+      }
+      iupTableSet(tables[h], "VALUE", (r & 1) ? "1" : "0", IUPTABLE_STRING);
+    }
+  }
+
+  for (h = 0; h < NUM_HANDLES; h++)
+    iupTableDestroy(tables[h]);
+  free(tables);
+
+  printf("Open addressing table:  %.3fs (%lu hits)\n", benchTime(start), (unsigned long)found);
+}
+
+static void benchAttributes(void)
+{
+  Ihandle** handles = (Ihandle**)malloc(NUM_HANDLES * sizeof(Ihandle*));
+  clock_t start = clock();
+  int h, n, r;
+  size_t found = 0;
+
+  for (h = 0; h < NUM_HANDLES; h++)
+  {
+    handles[h] = IupUser();
+    for (n = 0; n < NUM_NAMES; n++)
+      IupSetAttribute(handles[h], bench_names[n], "1");
+  }
+
+  for (r = 0; r < NUM_ROUNDS; r++)
+  {
+    for (h = 0; h < NUM_HANDLES; h++)
+    {
+      for (n = 0; n < NUM_NAMES; n++)
+      {
+        if (IupGetAttribute(handles[h], bench_names[n]))
+          found++;
+      }
+      IupSetStrAttribute(handles[h], "VALUE", (r & 1) ? "1" : "0");
+    }
+  }
+
+  for (h = 0; h < NUM_HANDLES; h++)
+    IupDestroy(handles[h]);
+  free(handles);
+
+  printf("IupSet/GetAttribute:    %.3fs (%lu hits)\n", benchTime(start), (unsigned long)found);
+}
+
+void TableBenchTest(void)
+{
+  printf("%d handles, %d attributes, %d rounds\n", NUM_HANDLES, NUM_NAMES, NUM_ROUNDS);
+  benchOldTable();
+  benchNewTable();
+  benchAttributes();
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+
+  TableBenchTest();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
@@ -123,6 +123,11 @@ IUP_API double    IupGetDouble(Ihandle* ih, const char* name);
 IUP_API void      IupGetRGB      (Ihandle* ih, const char* name, unsigned char *r, unsigned char *g, unsigned char *b);
 IUP_API void      IupGetRGBA     (Ihandle* ih, const char* name, unsigned char *r, unsigned char *g, unsigned char *b, unsigned char *a);
 
+IUP_API const char* IupAttribAtom(const char* name);
+IUP_API void      IupSetAttributeAtom   (Ihandle* ih, const char* atom, const char* value);
+IUP_API void      IupSetStrAttributeAtom(Ihandle* ih, const char* atom, const char* value);
+IUP_API char*     IupGetAttributeAtom   (Ihandle* ih, const char* atom);
+
 IUP_API void  IupSetAttributeId(Ihandle* ih, const char* name, int id, const char *value);
 IUP_API void  IupSetStrAttributeId(Ihandle* ih, const char* name, int id, const char *value);
 IUP_API void  IupSetStrfId(Ihandle* ih, const char* name, int id, const char* format, ...);
@@ -40,6 +40,15 @@ void IupPlotInsertSamples(Ihandle* ih, int ds_index, int sample_index, double *x
 
 void IupPlotAddSamples(Ihandle* ih, int ds_index, double *x, double *y, int count);
 void IupPlotAddStrSamples(Ihandle* ih, int ds_index, const char** x, double* y, int count);
+void IupPlotAppendRolling(Ihandle* ih, int ds_index, double *x, double *y, int count);
+
+/* element types of external buffers */
+#define IUP_PLOT_DOUBLE 0
+#define IUP_PLOT_FLOAT  1
+#define IUP_PLOT_SHORT  2
+
+void IupPlotAttachBuffers(Ihandle* ih, int ds_index, const void* x, int x_type, int x_stride, const void* y, int y_type, int y_stride, int count);
+void IupPlotBuffersChanged(Ihandle* ih, int ds_index, int start, int end);
 
 void IupPlotGetSample(Ihandle* ih, int ds_index, int sample_index, double *x, double *y);
 void IupPlotGetSampleStr(Ihandle* ih, int ds_index, int sample_index, const char* *x, double *y);
@@ -1030,6 +1030,9 @@ namespace Iup
 
     void AddSamples(int ds_index, double *x, double *y, int count) { IupPlotAddSamples(ih, ds_index, x, y, count); }
     void AddStrSamples(int ds_index, const char** x, double* y, int count) { IupPlotAddStrSamples(ih, ds_index, x, y, count); }
+    void AppendRolling(int ds_index, double *x, double *y, int count) { IupPlotAppendRolling(ih, ds_index, x, y, count); }
+    void AttachBuffers(int ds_index, const void* x, int x_type, int x_stride, const void* y, int y_type, int y_stride, int count) { IupPlotAttachBuffers(ih, ds_index, x, x_type, x_stride, y, y_type, y_stride, count); }
+    void BuffersChanged(int ds_index, int start, int end) { IupPlotBuffersChanged(ih, ds_index, start, end); }
 
     void GetSample(int ds_index, int sample_index, double &x, double &y) { IupPlotGetSample(ih, ds_index, sample_index, &x, &y); }
     void GetSampleStr(int ds_index, int sample_index, const char* &x, double &y) { IupPlotGetSampleStr(ih, ds_index, sample_index, &x, &y); }
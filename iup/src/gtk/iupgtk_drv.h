@@ -52,6 +52,11 @@ void  iupgtkStrSetUTF8Mode(int utf8mode);
 int   iupgtkStrGetUTF8Mode(void);
 
 
+/* loop */
+void iupgtkLoopRelease(void);
+void iupgtkLoopGetPostMessageStats(int *depth, int *drops, int *overflows);
+
+
 /* focus */
 IUP_DRV_API gboolean iupgtkFocusInOutEvent(GtkWidget *widget, GdkEventFocus *evt, Ihandle* ih);
 IUP_DRV_API void iupgtkSetCanFocus(GtkWidget *widget, int can);
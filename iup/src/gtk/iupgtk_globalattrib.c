@@ -234,5 +234,23 @@ IUP_SDK_API char *iupdrvGetGlobal(const char *name)
     g_object_get (gtk_settings_get_default (), "gtk-menu-images", &menu_images, NULL);
     return iupStrReturnBoolean(menu_images);
   }
+  if (iupStrEqual(name, "POSTMESSAGEQUEUEDEPTH"))
+  {
+    int depth;
+    iupgtkLoopGetPostMessageStats(&depth, NULL, NULL);
+    return iupStrReturnInt(depth);
+  }
+  if (iupStrEqual(name, "POSTMESSAGEDROPS"))
+  {
+    int drops;
+    iupgtkLoopGetPostMessageStats(NULL, &drops, NULL);
+    return iupStrReturnInt(drops);
+  }
+  if (iupStrEqual(name, "POSTMESSAGEOVERFLOWS"))
+  {
+    int overflows;
+    iupgtkLoopGetPostMessageStats(NULL, NULL, &overflows);
+    return iupStrReturnInt(overflows);
+  }
   return NULL;
 }
@@ -14,8 +14,11 @@
 #include "iupcbs.h"
 #include "iup_loop.h"
 
+#include "iup_object.h"
 #include "iup_str.h"
 
+#include "iupgtk_drv.h"
+
 /* local variables */
 static IFidle gtk_idle_cb = NULL;
 static guint gtk_idle_id;
@@ -128,33 +131,347 @@ IUP_API void IupFlush(void)
 }
 
 
-typedef struct {
+/* IupPostMessage uses a bounded lock free queue with multiple producers (any thread)
+   and a single consumer (the main loop thread). Each slot has a sequence number
+   that tells if it is free for the producers or ready for the consumer.
+   The main loop is awaken only once for each batch of messages.
+   When the queue is full messages go to an overflow stack, that is delivered
+   only after the queue is empty, so messages from the same thread are never reordered. */
+
+#define GTK_POSTMSG_QUEUE_SIZE 4096  /* must be a power of 2 */
+#define GTK_POSTMSG_STR_SIZE 48
+
+typedef struct _gtkPostMessage {
+  struct _gtkPostMessage* next;  /* used only in the overflow stack */
   Ihandle* ih;
-  char* s;
+  char* s;       /* allocated string, when it does not fit in s_buf */
+  int s_inline;  /* the string is stored in s_buf */
   int i;
   double d;
-  char* p;
-} gtkPostMessageUserData;
+  void* p;
+  char s_buf[GTK_POSTMSG_STR_SIZE];
+} gtkPostMessage;
+
+typedef struct _gtkPostMessageSlot {
+  volatile gint seq;
+  gtkPostMessage msg;
+} gtkPostMessageSlot;
+
+static gtkPostMessageSlot* gtk_postmsg_queue = NULL;
+static volatile gint gtk_postmsg_enqueue_pos = 0;
+static volatile gint gtk_postmsg_dequeue_pos = 0;
+static volatile gint gtk_postmsg_wakeup = 0;
+static gtkPostMessage* volatile gtk_postmsg_overflow = NULL;
+static volatile gint gtk_postmsg_drops = 0;
+static volatile gint gtk_postmsg_overflows = 0;
+
+static void gtkPostMessageInit(void)
+{
+  static gsize init = 0;
+  if (g_once_init_enter(&init))
+  {
+    /* without the queue all the messages use the overflow stack */
+    gtkPostMessageSlot* queue = (gtkPostMessageSlot*)malloc(GTK_POSTMSG_QUEUE_SIZE * sizeof(gtkPostMessageSlot));
+    if (queue)
+    {
+      int i;
+      for (i = 0; i < GTK_POSTMSG_QUEUE_SIZE; i++)
+        queue[i].seq = i;
+    }
+    gtk_postmsg_queue = queue;
+    g_once_init_leave(&init, 1);
+  }
+}
 
-static gint gtkPostMessageCallback(void *cb_data)
+static void gtkPostMessageSet(gtkPostMessage* msg, Ihandle* ih, const char* s, int i, double d, void* p)
 {
-  gtkPostMessageUserData* user_data = (gtkPostMessageUserData*)cb_data;
-  Ihandle* ih = user_data->ih;
+  msg->ih = ih;
+  msg->s = NULL;
+  msg->s_inline = 0;
+  if (s)
+  {
+    size_t len = strlen(s);
+    if (len < GTK_POSTMSG_STR_SIZE)
+    {
+      memcpy(msg->s_buf, s, len + 1);
+      msg->s_inline = 1;
+    }
+    else
+      msg->s = iupStrDup(s);
+  }
+  msg->i = i;
+  msg->d = d;
+  msg->p = p;
+}
+
+static const char* gtkPostMessageGetStr(gtkPostMessage* msg)
+{
+  if (msg->s_inline)
+    return msg->s_buf;
+  return msg->s;
+}
+
+static void gtkPostMessageCall(gtkPostMessage* msg)
+{
+  Ihandle* ih = msg->ih;
   IFnsidv cb = (IFnsidv)IupGetCallback(ih, "POSTMESSAGE_CB");
   if (cb)
-    cb(ih, user_data->s, user_data->i, user_data->d, user_data->p);
-  if (user_data->s) free(user_data->s);
-  free(user_data);
+    cb(ih, (char*)gtkPostMessageGetStr(msg), msg->i, msg->d, msg->p);
+}
+
+static int gtkPostMessageEnqueue(Ihandle* ih, const char* s, int i, double d, void* p)
+{
+  gtkPostMessageSlot* slot;
+  guint pos = (guint)g_atomic_int_get(&gtk_postmsg_enqueue_pos);
+
+  for (;;)
+  {
+    gint diff;
+
+    slot = gtk_postmsg_queue + (pos & (GTK_POSTMSG_QUEUE_SIZE - 1));
+    diff = (gint)((guint)g_atomic_int_get(&slot->seq) - pos);
+
+    if (diff == 0)
+    {
+      /* slot is free, try to reserve it */
+      if (g_atomic_int_compare_and_exchange(&gtk_postmsg_enqueue_pos, (gint)pos, (gint)(pos + 1)))
+        break;
+    }
+    else if (diff < 0)
+      return 0;  /* queue is full */
+
+    pos = (guint)g_atomic_int_get(&gtk_postmsg_enqueue_pos);
+  }
+
+  gtkPostMessageSet(&slot->msg, ih, s, i, d, p);
+
+  /* publish to the consumer */
+  g_atomic_int_set(&slot->seq, (gint)(pos + 1));
+  return 1;
+}
+
+static int gtkPostMessageDequeue(gtkPostMessage* msg)
+{
+  guint pos = (guint)gtk_postmsg_dequeue_pos;  /* only changed by the consumer */
+  gtkPostMessageSlot* slot;
+
+  if (!gtk_postmsg_queue)
+    return 0;
+
+  slot = gtk_postmsg_queue + (pos & (GTK_POSTMSG_QUEUE_SIZE - 1));
+  if ((guint)g_atomic_int_get(&slot->seq) != pos + 1)
+    return 0;  /* empty */
+
+  *msg = slot->msg;
+
+  g_atomic_int_set(&gtk_postmsg_dequeue_pos, (gint)(pos + 1));
+
+  /* release the slot to the producers */
+  g_atomic_int_set(&slot->seq, (gint)(pos + GTK_POSTMSG_QUEUE_SIZE));
+  return 1;
+}
+
+static int gtkPostMessageGetDepth(void)
+{
+  guint enqueue_pos = (guint)g_atomic_int_get(&gtk_postmsg_enqueue_pos);
+  guint dequeue_pos = (guint)g_atomic_int_get(&gtk_postmsg_dequeue_pos);
+  return (int)(enqueue_pos - dequeue_pos);
+}
+
+static guint gtkPostMessageHash(gtkPostMessage* msg)
+{
+  const char* s = gtkPostMessageGetStr(msg);
+  guint hash = (guint)((size_t)msg->ih >> 3) * 0x9e3779b1u;
+  if (s)
+    hash ^= g_str_hash(s);
+  return hash;
+}
+
+static int gtkPostMessageEqual(gtkPostMessage* msg1, gtkPostMessage* msg2)
+{
+  return msg1->ih == msg2->ih && iupStrEqual(gtkPostMessageGetStr(msg1), gtkPostMessageGetStr(msg2));
+}
+
+static int gtkPostMessageCoalesce(int count)
+{
+  /* delivers only the last message of each (ih, s) pair in the batch,
+     returns the number of messages not processed */
+  int i, n = 0, map_size = 16;
+  gtkPostMessage* batch;
+  int* map;
+
+  while (map_size < 2 * count)
+    map_size *= 2;
+
+  batch = (gtkPostMessage*)malloc(count * sizeof(gtkPostMessage));
+  map = (int*)malloc(map_size * sizeof(int));
+  if (!batch || !map)
+  {
+    /* no memory, they will be delivered one by one */
+    if (batch) free(batch);
+    if (map) free(map);
+    return count;
+  }
+
+  memset(map, 0xFF, map_size * sizeof(int));  /* all -1 */
+
+  while (n < count && gtkPostMessageDequeue(batch + n))
+  {
+    int m = (int)(gtkPostMessageHash(batch + n) & (map_size - 1));
+    while (map[m] != -1 && !gtkPostMessageEqual(batch + map[m], batch + n))
+      m = (m + 1) & (map_size - 1);
+    map[m] = n;  /* keep the latest */
+    n++;
+  }
+
+  for (i = 0; i < n; i++)
+  {
+    gtkPostMessage* msg = batch + i;
+    int m = (int)(gtkPostMessageHash(msg) & (map_size - 1));
+    while (map[m] != -1 && !gtkPostMessageEqual(batch + map[m], msg))
+      m = (m + 1) & (map_size - 1);
+
+    if (map[m] == i)
+      gtkPostMessageCall(msg);
+    else
+      g_atomic_int_inc(&gtk_postmsg_drops);
+
+    if (msg->s) free(msg->s);
+  }
+
+  free(map);
+  free(batch);
+  return 0;
+}
+
+static void gtkPostMessageWakeup(void);
+
+static void gtkPostMessageOverflowPush(Ihandle* ih, const char* s, int i, double d, void* p)
+{
+  gtkPostMessage* msg = (gtkPostMessage*)malloc(sizeof(gtkPostMessage));
+  if (!msg)
+  {
+    g_atomic_int_inc(&gtk_postmsg_drops);  /* the message is lost */
+    return;
+  }
+
+  gtkPostMessageSet(msg, ih, s, i, d, p);
+
+  do
+  {
+    msg->next = (gtkPostMessage*)g_atomic_pointer_get(&gtk_postmsg_overflow);
+  } while (!g_atomic_pointer_compare_and_exchange(&gtk_postmsg_overflow, msg->next, msg));
+
+  g_atomic_int_inc(&gtk_postmsg_overflows);
+}
+
+static void gtkPostMessageOverflowFlush(void)
+{
+  gtkPostMessage *msg, *list = NULL;
+
+  /* take the whole stack */
+  do
+  {
+    msg = (gtkPostMessage*)g_atomic_pointer_get(&gtk_postmsg_overflow);
+  } while (!g_atomic_pointer_compare_and_exchange(&gtk_postmsg_overflow, msg, NULL));
+
+  /* reverse it to the posting order */
+  while (msg)
+  {
+    gtkPostMessage* next = msg->next;
+    msg->next = list;
+    list = msg;
+    msg = next;
+  }
+
+  while (list)
+  {
+    msg = list;
+    list = list->next;
+
+    gtkPostMessageCall(msg);
+
+    if (msg->s) free(msg->s);
+    free(msg);
+  }
+}
+
+static gboolean gtkPostMessageQueueCallback(gpointer data)
+{
+  /* process only the messages already posted,
+     newer messages will schedule a new wake up */
+  int count;
+
+  /* must be cleared before dequeuing, so no message is left behind */
+  g_atomic_int_set(&gtk_postmsg_wakeup, 0);
+
+  count = gtkPostMessageGetDepth();
+  if (count > 1 && iupStrBoolean(IupGetGlobal("POSTMESSAGECOALESCE")))
+    count = gtkPostMessageCoalesce(count);
+
+  if (count > 0)
+  {
+    /* dequeue before calling, so the callback can also enter the loop */
+    gtkPostMessage msg;
+    while (count > 0 && gtkPostMessageDequeue(&msg))
+    {
+      gtkPostMessageCall(&msg);
+      if (msg.s) free(msg.s);
+      count--;
+    }
+  }
+
+  if (g_atomic_pointer_get(&gtk_postmsg_overflow) && gtkPostMessageGetDepth() == 0)
+    gtkPostMessageOverflowFlush();
+
+  /* a slot still being written by a producer, or overflow waiting for the queue */
+  if (gtkPostMessageGetDepth() > 0 || g_atomic_pointer_get(&gtk_postmsg_overflow))
+    gtkPostMessageWakeup();
+
+  (void)data;
   return FALSE; /* call only once */
 }
 
+static void gtkPostMessageWakeup(void)
+{
+  if (g_atomic_int_compare_and_exchange(&gtk_postmsg_wakeup, 0, 1))
+    g_idle_add(gtkPostMessageQueueCallback, NULL);
+}
+
+void iupgtkLoopGetPostMessageStats(int *depth, int *drops, int *overflows)
+{
+  if (depth) *depth = gtk_postmsg_queue? gtkPostMessageGetDepth(): 0;
+  if (drops) *drops = g_atomic_int_get(&gtk_postmsg_drops);
+  if (overflows) *overflows = g_atomic_int_get(&gtk_postmsg_overflows);
+}
+
+void iupgtkLoopRelease(void)
+{
+  gtkPostMessage msg;
+
+  /* the remaining messages are discarded,
+     the queue itself is kept because it is initialized only once */
+  while (gtkPostMessageDequeue(&msg))
+  {
+    if (msg.s) free(msg.s);
+  }
+
+  while (gtk_postmsg_overflow)
+  {
+    gtkPostMessage* next = gtk_postmsg_overflow->next;
+    if (gtk_postmsg_overflow->s) free(gtk_postmsg_overflow->s);
+    free(gtk_postmsg_overflow);
+    gtk_postmsg_overflow = next;
+  }
+}
+
 IUP_API void IupPostMessage(Ihandle* ih, const char* s, int i, double d, void* p)
 {
-  gtkPostMessageUserData* user_data = (gtkPostMessageUserData*)malloc(sizeof(gtkPostMessageUserData));
-  user_data->ih = ih;
-  user_data->s = iupStrDup(s);
-  user_data->i = i;
-  user_data->d = d;
-  user_data->p = p;
-  g_idle_add(gtkPostMessageCallback, user_data);
+  gtkPostMessageInit();
+
+  /* while there is overflow, keep using it to preserve the order */
+  if (!gtk_postmsg_queue || g_atomic_pointer_get(&gtk_postmsg_overflow) || !gtkPostMessageEnqueue(ih, s, i, d, p))
+    gtkPostMessageOverflowPush(ih, s, i, d, p);
+
+  gtkPostMessageWakeup();
 }
@@ -437,6 +437,7 @@ int iupdrvOpen(int *argc, char ***argv)
 
 void iupdrvClose(void)
 {
+  iupgtkLoopRelease();
   iupgtkStrRelease();
 }
 
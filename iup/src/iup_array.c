@@ -73,21 +73,69 @@ IUP_SDK_API void* iupArrayReleaseData(Iarray* iarray)
   return data; 
 }
 
-IUP_SDK_API void* iupArrayInc(Iarray* iarray)
+static int iArrayGrow(Iarray* iarray, int new_count)
+{
+  if (new_count > iarray->max_count)
+  {
+    /* grows geometrically, so adding one element at a time is amortized constant time */
+    int new_max_count = iarray->max_count + iarray->max_count / 2;
+    if (new_max_count < iarray->max_count + iarray->start_count)
+      new_max_count = iarray->max_count + iarray->start_count;
+    if (new_max_count < new_count)
+      new_max_count = new_count;
+
+    iarray->data = realloc(iarray->data, (size_t)iarray->elem_size*new_max_count);
+    iupASSERT(iarray->data!=NULL);
+    if (!iarray->data)
+      return 0;
+
+    /* new memory is NOT initialized here */
+    iarray->max_count = new_max_count;
+  }
+  return 1;
+}
+
+IUP_SDK_API void* iupArrayReserve(Iarray* iarray, int max_count)
 {
   iupASSERT(iarray!=NULL);
   if (!iarray)
     return NULL;
-  if (iarray->count >= iarray->max_count)
+  if (max_count > iarray->max_count)
   {
-    int old_count = iarray->max_count;
-    iarray->max_count += iarray->start_count;
-    iarray->data = realloc(iarray->data, iarray->elem_size*iarray->max_count);
+    iarray->data = realloc(iarray->data, (size_t)iarray->elem_size*max_count);
     iupASSERT(iarray->data!=NULL);
     if (!iarray->data)
       return NULL;
-    memset((unsigned char*)iarray->data + iarray->elem_size*old_count, 0, iarray->elem_size*(iarray->max_count-old_count));
+    iarray->max_count = max_count;
   }
+  return iarray->data;
+}
+
+IUP_SDK_API void iupArrayShrink(Iarray* iarray)
+{
+  int max_count;
+  void* data;
+  iupASSERT(iarray!=NULL);
+  if (!iarray || !iarray->data)
+    return;
+  max_count = iarray->count > 0? iarray->count: 1;
+  if (max_count >= iarray->max_count)
+    return;
+  data = realloc(iarray->data, (size_t)iarray->elem_size*max_count);
+  if (!data)  /* the old memory is still valid */
+    return;
+  iarray->data = data;
+  iarray->max_count = max_count;
+}
+
+IUP_SDK_API void* iupArrayInc(Iarray* iarray)
+{
+  iupASSERT(iarray!=NULL);
+  if (!iarray)
+    return NULL;
+  if (!iArrayGrow(iarray, iarray->count + 1))
+    return NULL;
+  memset((unsigned char*)iarray->data + iarray->elem_size*iarray->count, 0, iarray->elem_size);
   iarray->count++;
   return iarray->data;
 }
@@ -97,16 +145,20 @@ IUP_SDK_API void* iupArrayAdd(Iarray* iarray, int add_count)
   iupASSERT(iarray!=NULL);
   if (!iarray)
     return NULL;
-  if (iarray->count+add_count > iarray->max_count)
-  {
-    int old_count = iarray->max_count;
-    iarray->max_count += add_count;
-    iarray->data = realloc(iarray->data, iarray->elem_size*iarray->max_count);
-    iupASSERT(iarray->data!=NULL);
-    if (!iarray->data)
-      return NULL;
-    memset((unsigned char*)iarray->data + iarray->elem_size*old_count, 0, iarray->elem_size*(iarray->max_count-old_count));
-  }
+  if (!iArrayGrow(iarray, iarray->count + add_count))
+    return NULL;
+  memset((unsigned char*)iarray->data + (size_t)iarray->elem_size*iarray->count, 0, (size_t)iarray->elem_size*add_count);
+  iarray->count += add_count;
+  return iarray->data;
+}
+
+IUP_SDK_API void* iupArrayAddUninit(Iarray* iarray, int add_count)
+{
+  iupASSERT(iarray!=NULL);
+  if (!iarray)
+    return NULL;
+  if (!iArrayGrow(iarray, iarray->count + add_count))
+    return NULL;
   iarray->count += add_count;
   return iarray->data;
 }
@@ -118,13 +170,14 @@ IUP_SDK_API void* iupArrayInsert(Iarray* iarray, int index, int insert_count)
     return NULL;
   if (index < 0 || index > iarray->count)
     return NULL;
-  iupArrayAdd(iarray, insert_count);
-  if (index < iarray->count)  /* if equal, insert at the end, no need to move data */
-    memmove((unsigned char*)iarray->data + iarray->elem_size*(index + insert_count), 
-            (unsigned char*)iarray->data + iarray->elem_size*index, 
-            iarray->elem_size*(iarray->count - insert_count - index));
+  if (!iupArrayAddUninit(iarray, insert_count))
+    return NULL;
+  if (index < iarray->count - insert_count)  /* if equal, insert at the end, no need to move data */
+    memmove((unsigned char*)iarray->data + (size_t)iarray->elem_size*(index + insert_count), 
+            (unsigned char*)iarray->data + (size_t)iarray->elem_size*index, 
+            (size_t)iarray->elem_size*(iarray->count - insert_count - index));
   /* clear new data */
-  memset((unsigned char*)iarray->data + iarray->elem_size*index, 0, iarray->elem_size*insert_count);
+  memset((unsigned char*)iarray->data + (size_t)iarray->elem_size*index, 0, (size_t)iarray->elem_size*insert_count);
   return iarray->data;
 }
 
@@ -23,8 +23,9 @@ typedef struct _Iarray Iarray;
 
 /** Creates an array with an initial room for elements, and the element size.
  * The array count starts at 0. And the maximum number of elements starts at the given count.
- * The maximum number of elements is increased by the start_max_count, every time it needs more memory.
- * Data is always initialized with zeros.
+ * Every time it needs more memory the maximum number of elements is increased by half,
+ * or by the start_max_count if larger, so adding elements one at a time is amortized constant time.
+ * Elements are always initialized with zeros, except by \ref iupArrayAddUninit.
  * Must call \ref iupArrayInc, \ref iupArrayAdd or \ref iupArrayInsert to properly increase the number of elements.
  * \ingroup iarray */
 IUP_SDK_API Iarray* iupArrayCreate(int start_max_count, int elem_size);
@@ -43,24 +44,31 @@ IUP_SDK_API void* iupArrayReleaseData(Iarray* iarray);
 
 /** Increments the number of elements in the array.
  * The array count starts at 0. 
- * If the maximum number of elements is reached, the memory allocated is increased by the initial start count.
- * Data is always initialized with zeros.
+ * If the maximum number of elements is reached, the memory allocated is increased (see \ref iupArrayCreate).
+ * The new element is initialized with zeros.
  * Returns the pointer that contains the array.
  * \ingroup iarray */
 IUP_SDK_API void* iupArrayInc(Iarray* iarray);
 
 /** Increments the number of elements in the array by a given count.
  * New space is allocated at the end of the array.
- * If the maximum number of elements is reached, the memory allocated is increased by the given count.
- * Data is always initialized with zeros.
+ * If the maximum number of elements is reached, the memory allocated is increased (see \ref iupArrayCreate).
+ * The new elements are initialized with zeros.
  * Returns the pointer that contains the array.
  * \ingroup iarray */
 IUP_SDK_API void* iupArrayAdd(Iarray* iarray, int add_count);
 
+/** Same as \ref iupArrayAdd but the new elements are NOT initialized.
+ * Use it when all the new elements will be immediately written, 
+ * for instance with memcpy, and the elements do not contain pointers that are later freed.
+ * Returns the pointer that contains the array.
+ * \ingroup iarray */
+IUP_SDK_API void* iupArrayAddUninit(Iarray* iarray, int add_count);
+
 /** Increments the number of elements in the array by a given count
  * and moves the data so the new space starts at index.
- * If the maximum number of elements is reached, the memory allocated is increased by the given count.
- * Data is always initialized with zeros.
+ * If the maximum number of elements is reached, the memory allocated is increased (see \ref iupArrayCreate).
+ * The new elements are initialized with zeros.
  * Returns the pointer that contains the array.
  * \ingroup iarray */
 IUP_SDK_API void* iupArrayInsert(Iarray* iarray, int index, int insert_count);
@@ -70,6 +78,18 @@ IUP_SDK_API void* iupArrayInsert(Iarray* iarray, int index, int insert_count);
  * \ingroup iarray */
 IUP_SDK_API void iupArrayRemove(Iarray* iarray, int index, int remove_count);
 
+/** Makes sure the array has room for max_count elements, without changing the number of elements.
+ * Use it before adding many elements when the final count is known.
+ * The new memory is not initialized, but elements will be when added.
+ * Returns the pointer that contains the array.
+ * \ingroup iarray */
+IUP_SDK_API void* iupArrayReserve(Iarray* iarray, int max_count);
+
+/** Releases the memory not used by the current number of elements.
+ * The pointer that contains the array may change.
+ * \ingroup iarray */
+IUP_SDK_API void iupArrayShrink(Iarray* iarray);
+
 /** Returns the actual number of elements in the array.
  * \ingroup iarray */
 IUP_SDK_API int iupArrayCount(Iarray* iarray);
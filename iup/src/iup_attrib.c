@@ -214,22 +214,22 @@ IUP_API char* IupGetAttributes(Ihandle *ih)
 void iupAttribUpdateFromParent(Ihandle* ih)
 {
   Iclass* ic = ih->iclass;
-  char *name = iupTableFirst(ic->attrib_func);
+  char *name = iupTableFirst(ic->attrib_func);  /* names are atoms */
   while (name)
   {
     /* if inheritable and NOT defined at the element */
-    if (iupClassObjectCurAttribIsInherit(ic) && !iupAttribGet(ih, name))
+    if (iupClassObjectCurAttribIsInherit(ic) && !iupTableGetAtom(ih->attrib, name))
     {
       /* check in the parent tree if the attribute is defined */
       Ihandle* parent = ih->parent;
       while (parent)
       {
-        char* value = iupTableGet(parent->attrib, name);
+        char* value = iupTableGetAtom(parent->attrib, name);
         if (value)
         {
           int inherit;
           /* set on the class */
-          iupClassObjectSetAttribute(ih, name, value, &inherit);
+          iupClassObjectSetAttributeAtom(ih, name, name, value, &inherit);
           break;
         }
         parent = parent->parent;
@@ -240,29 +240,35 @@ void iupAttribUpdateFromParent(Ihandle* ih)
   }
 }
 
-static int iAttribIsInherit(Ihandle* ih, const  char* name)
+/* names without an atom can still be stored with ids */
+static char* iAttribGetTable(Ihandle* ih, const char* name, const char* atom)
+{
+  return atom? iupTableGetAtom(ih->attrib, atom): iupTableGet(ih->attrib, name);
+}
+
+static int iAttribIsInherit(Ihandle* ih, const  char* name, const char* atom)
 {
   int inherit;
   char *def_value;
-  iupClassObjectGetAttributeInfo(ih, name, &def_value, &inherit);
+  iupClassObjectGetAttributeInfoAtom(ih, name, atom, &def_value, &inherit);
   return inherit;
 }
 
-static void iAttribNotifyChildren(Ihandle *ih, const char* name, const char *value)
+static void iAttribNotifyChildren(Ihandle *ih, const char* name, const char* atom, const char *value)
 {
   int inherit;
   Ihandle* child = ih->firstchild;
   while (child)
   {
-    if (!iupTableGet(child->attrib, name))
+    if (!iAttribGetTable(child, name, atom))
     {
       /* set only if an inheritable attribute at the child */
-      if (iAttribIsInherit(child, name))
+      if (iAttribIsInherit(child, name, atom))
       {
         /* set on the class */
-        iupClassObjectSetAttribute(child, name, value, &inherit);
+        iupClassObjectSetAttributeAtom(child, name, atom, value, &inherit);
 
-        iAttribNotifyChildren(child, name, value);
+        iAttribNotifyChildren(child, name, atom, value);
       }
     }
 
@@ -272,14 +278,14 @@ static void iAttribNotifyChildren(Ihandle *ih, const char* name, const char *val
 
 void iupAttribUpdateChildren(Ihandle* ih)
 {
-  char *name = iupTableFirst(ih->attrib);
+  char *name = iupTableFirst(ih->attrib);  /* names are atoms */
   while (name)
   {
-    if (!iupATTRIB_ISINTERNAL(name) && iAttribIsInherit(ih, name))
+    if (!iupATTRIB_ISINTERNAL(name) && iAttribIsInherit(ih, name, name))
     {
       /* retrieve from the table */
-      char* value = iupTableGet(ih->attrib, name);
-      iAttribNotifyChildren(ih, name, value);
+      char* value = iupTableGetCurr(ih->attrib);
+      iAttribNotifyChildren(ih, name, name, value);
     }
 
     name = iupTableNext(ih->attrib);
@@ -315,19 +321,19 @@ void iupAttribUpdate(Ihandle* ih)
   /* for all defined attributes updates the native system */
   for (i = 0; i < count; i++)
   {
-    name = name_array[i];
+    name = name_array[i];  /* names are atoms */
 
     /* retrieve from the table */
-    value = iupTableGet(ih->attrib, name);
+    value = iupTableGetAtom(ih->attrib, name);
 
     /* set on the class */
-    store = iupClassObjectSetAttribute(ih, name, value, &inherit);
+    store = iupClassObjectSetAttributeAtom(ih, name, name, value, &inherit);
 
     if (inherit)
-      iAttribNotifyChildren(ih, name, value);
+      iAttribNotifyChildren(ih, name, name, value);
 
     if (store == 0)
-      iupTableRemove(ih->attrib, name); /* remove from the table according to the class SetAttribute */
+      iupTableRemoveAtom(ih->attrib, name); /* remove from the table according to the class SetAttribute */
   }
 
   free(name_array);
@@ -641,10 +647,112 @@ IUP_API void IupSetRGBId2(Ihandle *ih, const char* name, int lin, int col, unsig
   IupStoreAttributeId2(ih, name, lin, col, value);
 }
 
-IUP_API void IupSetAttribute(Ihandle *ih, const char* name, const char *value)
+/* Sets the attribute in the hash table using the atom of the name.
+   Without the atom the name is used, names with ids are stored
+   as the atom of the name without the id, so no atom is created for them.
+   Returns the atom, or NULL if the name has no atom. */
+static const char* iAttribSetAtom(Ihandle* ih, const char* name, const char* atom, const char* value, Itable_Types itemType)
+{
+  if (!value)
+  {
+    if (atom)
+      iupTableRemoveAtom(ih->attrib, atom);
+    else
+      iupTableRemove(ih->attrib, name);
+  }
+  else
+  {
+    if (atom)
+      iupTableSetAtom(ih->attrib, atom, (void*)value, itemType);
+    else
+    {
+      iupTableSet(ih->attrib, name, (void*)value, itemType);
+      atom = iupAtomFind(name);
+    }
+  }
+
+  return atom;
+}
+
+static void iAttribSetAttribute(Ihandle *ih, const char* name, const char* atom, const char *value)
 {
   int inherit;
 
+  if (iupATTRIB_ISINTERNAL(name))
+    iAttribSetAtom(ih, name, atom, value, IUPTABLE_POINTER);
+  else
+  {
+    if (iupClassObjectSetAttributeAtom(ih, name, atom, value, &inherit)!=0) /* store strings and pointers */
+      atom = iAttribSetAtom(ih, name, atom, value, IUPTABLE_POINTER);
+
+    if (inherit)
+      iAttribNotifyChildren(ih, name, atom, value);
+  }
+}
+
+static void iAttribStoreAttribute(Ihandle *ih, const char* name, const char* atom, const char *value)
+{
+  int inherit;
+
+  if (iupATTRIB_ISINTERNAL(name))
+    iAttribSetAtom(ih, name, atom, value, IUPTABLE_STRING);
+  else
+  {
+    int store = 1;
+
+    if (iupATTRIB_LANGUAGE_STRING(value))
+      iupATTRIB_GET_LANGUAGE_STRING(value, store);
+
+    if (iupClassObjectSetAttributeAtom(ih, name, atom, value, &inherit)==1) /* store only strings */
+    {
+      if (store)
+        atom = iAttribSetAtom(ih, name, atom, value, IUPTABLE_STRING);
+      else
+        atom = iAttribSetAtom(ih, name, atom, value, IUPTABLE_POINTER);
+    }
+
+    if (inherit)
+      iAttribNotifyChildren(ih, name, atom, value);
+  }
+}
+
+static char* iAttribGetAttribute(Ihandle *ih, const char* name, const char* atom)
+{
+  if (iupATTRIB_ISINTERNAL(name))
+    return iAttribGetTable(ih, name, atom);
+  else
+  {
+    int inherit;
+    char *value, *def_value;
+
+    value = iupClassObjectGetAttributeAtom(ih, name, atom, &def_value, &inherit);
+
+    if (!value)
+    {
+      value = iAttribGetTable(ih, name, atom);
+
+      if (!value && inherit)
+      {
+        while (!value)
+        {
+          ih = ih->parent;
+          if (!ih)
+            break;
+
+          value = iAttribGetTable(ih, name, atom);
+        }
+      }
+    }
+
+    if (!value)
+      value = def_value;
+
+    return value;
+  }
+}
+
+IUP_API void IupSetAttribute(Ihandle *ih, const char* name, const char *value)
+{
   iupASSERT(name!=NULL);
   if (!name)
     return;
@@ -659,16 +767,7 @@ IUP_API void IupSetAttribute(Ihandle *ih, const char* name, const char *value)
   if (!iupObjectCheck(ih))
     return;
 
-  if (iupATTRIB_ISINTERNAL(name))
-    iupAttribSet(ih, name, value);
-  else
-  {
-    if (iupClassObjectSetAttribute(ih, name, value, &inherit)!=0) /* store strings and pointers */
-      iupAttribSet(ih, name, value);
-
-    if (inherit)
-      iAttribNotifyChildren(ih, name, value);
-  }
+  iAttribSetAttribute(ih, name, iupAtomFind(name), value);
 }
 
 IUP_API void IupSetStrAttribute(Ihandle *ih, const char* name, const char *value)
@@ -678,8 +777,6 @@ IUP_API void IupSetStrAttribute(Ihandle *ih, const char* name, const char *value
 
 IUP_API void IupStoreAttribute(Ihandle *ih, const char* name, const char *value)
 {
-  int inherit;
-
   if (!name)
     return;
 
@@ -693,39 +790,20 @@ IUP_API void IupStoreAttribute(Ihandle *ih, const char* name, const char *value)
   if (!iupObjectCheck(ih))
     return;
 
-  if (iupATTRIB_ISINTERNAL(name))
-    iupAttribSetStr(ih, name, value);
-  else
-  {
-    int store = 1;
-
-    if (iupATTRIB_LANGUAGE_STRING(value))
-      iupATTRIB_GET_LANGUAGE_STRING(value, store);
-
-    if (iupClassObjectSetAttribute(ih, name, value, &inherit)==1) /* store only strings */
-    {
-      if (store)
-        iupAttribSetStr(ih, name, value);
-      else
-        iupAttribSet(ih, name, value);
-    }
-
-    if (inherit)
-      iAttribNotifyChildren(ih, name, value);
-  }
+  iAttribStoreAttribute(ih, name, iupAtomFind(name), value);
 }
 
-static void iAttribResetChildren(Ihandle *ih, const char* name)
+static void iAttribResetChildren(Ihandle *ih, const char* name, const char* atom)
 {
   Ihandle* child = ih->firstchild;
   while (child)
   {
     /* set only if an inheritable attribute at the child */
-    if (iAttribIsInherit(child, name))
+    if (iAttribIsInherit(child, name, atom))
     {
-      iupAttribSet(child, name, NULL);
+      iAttribSetAtom(child, name, atom, NULL, IUPTABLE_POINTER);
 
-      iAttribResetChildren(child, name);
+      iAttribResetChildren(child, name, atom);
     }
 
     child = child->brother;
@@ -734,6 +812,8 @@ static void iAttribResetChildren(Ihandle *ih, const char* name)
 
 IUP_API void IupResetAttribute(Ihandle *ih, const char* name)
 {
+  const char* atom;
+
   iupASSERT(name!=NULL);
   if (!name)
     return;
@@ -742,10 +822,12 @@ IUP_API void IupResetAttribute(Ihandle *ih, const char* name)
   if (!iupObjectCheck(ih))
     return;
 
-  iupAttribSet(ih, name, NULL);
+  atom = iupAtomFind(name);
 
-  if (iAttribIsInherit(ih, name))
-    iAttribResetChildren(ih, name);
+  iAttribSetAtom(ih, name, atom, NULL, IUPTABLE_POINTER);
+
+  if (iAttribIsInherit(ih, name, atom))
+    iAttribResetChildren(ih, name, atom);
 }
 
 IUP_API char* IupGetAttribute(Ihandle *ih, const char* name)
@@ -761,35 +843,73 @@ IUP_API char* IupGetAttribute(Ihandle *ih, const char* name)
   if (!iupObjectCheck(ih))
     return NULL;
 
-  if (iupATTRIB_ISINTERNAL(name))
-    return iupAttribGet(ih, name);
-  else
-  {
-    int inherit;
-    char *value, *def_value;
+  return iAttribGetAttribute(ih, name, iupAtomFind(name));
+}
 
-    value = iupClassObjectGetAttribute(ih, name, &def_value, &inherit);
+IUP_API const char* IupAttribAtom(const char* name)
+{
+  iupASSERT(name!=NULL);
+  if (!name)
+    return NULL;
 
-    if (!value)
-      value = iupAttribGet(ih, name);
+  return iupAtomGet(name);
+}
 
-    if (!value && inherit)
-    {
-      while (!value)
-      {
-        ih = ih->parent;
-        if (!ih)
-          break;
+IUP_API void IupSetAttributeAtom(Ihandle *ih, const char* atom, const char *value)
+{
+  iupASSERT(atom!=NULL);
+  if (!atom)
+    return;
 
-        value = iupAttribGet(ih, name);
-      }
-    }
+  if (!ih)
+  {
+    IupSetGlobal(atom, value);
+    return;
+  }
 
-    if (!value)
-      value = def_value;
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return;
 
-    return value;
+  /* a regular string is also accepted, but without the speed up */
+  iAttribSetAttribute(ih, atom, iupAtomCheck(atom)? atom: iupAtomFind(atom), value);
+}
+
+IUP_API void IupSetStrAttributeAtom(Ihandle *ih, const char* atom, const char *value)
+{
+  iupASSERT(atom!=NULL);
+  if (!atom)
+    return;
+
+  if (!ih)
+  {
+    IupStoreGlobal(atom, value);
+    return;
   }
+
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return;
+
+  /* a regular string is also accepted, but without the speed up */
+  iAttribStoreAttribute(ih, atom, iupAtomCheck(atom)? atom: iupAtomFind(atom), value);
+}
+
+IUP_API char* IupGetAttributeAtom(Ihandle *ih, const char* atom)
+{
+  iupASSERT(atom!=NULL);
+  if (!atom)
+    return NULL;
+
+  if (!ih)
+    return IupGetGlobal(atom);
+
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return NULL;
+
+  /* a regular string is also accepted, but without the speed up */
+  return iAttribGetAttribute(ih, atom, iupAtomCheck(atom)? atom: iupAtomFind(atom));
 }
 
 IUP_API float IupGetFloat(Ihandle *ih, const char* name)
@@ -1148,170 +1268,229 @@ IUP_SDK_API void iupAttribSetDouble(Ihandle *ih, const char* name, double num)
   iupAttribSetStr(ih, name, value);
 }
 
+static int iAttribStrToBoolean(const char* value)
+{
+  if (value)
+  {
+    if (iupStrBoolean(value))
+      return 1;
+  }
+  return 0;
+}
+
+static int iAttribStrToInt(const char* value)
+{
+  int i = 0;
+  if (value)
+  {
+    if (!iupStrToInt(value, &i))
+    {
+      if (iupStrBoolean(value))
+        i = 1;
+    }
+  }
+  return i;
+}
+
+static float iAttribStrToFloat(const char* value)
+{
+  float f = 0;
+  if (value)
+    iupStrToFloat(value, &f);
+  return f;
+}
+
+static double iAttribStrToDouble(const char* value)
+{
+  double f = 0;
+  if (value)
+    iupStrToDouble(value, &f);
+  return f;
+}
+
+static void iAttribSetStrId2(Ihandle *ih, const char* name, int lin, int col, const char* value)
+{
+  if (!value)
+    iupTableRemoveId2(ih->attrib, name, lin, col);
+  else
+  {
+    int store = 1;
+
+    if (iupATTRIB_LANGUAGE_STRING(value))
+      iupATTRIB_GET_LANGUAGE_STRING(value, store);
+
+    if (store)
+      iupTableSetId2(ih->attrib, name, lin, col, (void*)value, IUPTABLE_STRING);
+    else
+      iupTableSetId2(ih->attrib, name, lin, col, (void*)value, IUPTABLE_POINTER);
+  }
+}
+
+/* same as iupAttribGetStr, but the ids are not formatted in the name,
+   col is IUPTABLE_NOID for names with only one id */
+static char* iAttribGetStrId2(Ihandle* ih, const char* name, int lin, int col)
+{
+  char* value;
+  if (!ih || !name)
+    return NULL;
+
+  value = iupTableGetId2(ih->attrib, name, lin, col);
+
+  if (!value && !iupATTRIB_ISINTERNAL(name))
+  {
+    int inherit;
+    char *def_value;
+    iupClassObjectGetAttributeInfoId2(ih, name, lin, col, &def_value, &inherit);
+
+    if (inherit)
+    {
+      while (!value)
+      {
+        ih = ih->parent;
+        if (!ih)
+          break;
+
+        value = iupTableGetId2(ih->attrib, name, lin, col);
+      }
+    }
+
+    if (!value)
+      value = def_value;
+  }
+
+  return value;
+}
+
 IUP_SDK_API void iupAttribSetId(Ihandle *ih, const char* name, int id, const char* value)
 {
-  char nameid[100];
-  iAttribSetNameId(nameid, name, id);
-  iupAttribSet(ih, nameid, value);
+  if (!value)
+    iupTableRemoveId(ih->attrib, name, id);
+  else
+    iupTableSetId(ih->attrib, name, id, (void*)value, IUPTABLE_POINTER);
 }
 
 IUP_SDK_API void iupAttribSetStrId(Ihandle *ih, const char* name, int id, const char* value)
 {
-  char nameid[100];
-  iAttribSetNameId(nameid, name, id);
-  iupAttribSetStr(ih, nameid, value);
+  iAttribSetStrId2(ih, name, id, IUPTABLE_NOID, value);
 }
 
 IUP_SDK_API void iupAttribSetId2(Ihandle *ih, const char* name, int lin, int col, const char* value)
 {
-  char nameid[100];
-  iAttribSetNameId2(nameid, name, lin, col);
-  iupAttribSet(ih, nameid, value);
+  if (!value)
+    iupTableRemoveId2(ih->attrib, name, lin, col);
+  else
+    iupTableSetId2(ih->attrib, name, lin, col, (void*)value, IUPTABLE_POINTER);
 }
 
 IUP_SDK_API void iupAttribSetStrId2(Ihandle *ih, const char* name, int lin, int col, const char* value)
 {
-  char nameid[100];
-  iAttribSetNameId2(nameid, name, lin, col);
-  iupAttribSetStr(ih, nameid, value);
+  iAttribSetStrId2(ih, name, lin, col, value);
 }
 
 IUP_SDK_API void iupAttribSetIntId(Ihandle *ih, const char* name, int id, int num)
 {
-  char nameid[100];
-  iAttribSetNameId(nameid, name, id);
-  iupAttribSetInt(ih, nameid, num);
+  char value[20];  /* +4,294,967,296 */
+  sprintf(value, "%d", num);
+  iAttribSetStrId2(ih, name, id, IUPTABLE_NOID, value);
 }
 
 IUP_SDK_API void iupAttribSetIntId2(Ihandle *ih, const char* name, int lin, int col, int num)
 {
-  char nameid[100];
-  iAttribSetNameId2(nameid, name, lin, col);
-  iupAttribSetInt(ih, nameid, num);
+  char value[20];  /* +4,294,967,296 */
+  sprintf(value, "%d", num);
+  iAttribSetStrId2(ih, name, lin, col, value);
 }
 
 IUP_SDK_API void iupAttribSetFloatId(Ihandle *ih, const char* name, int id, float num)
 {
-  char nameid[100];
-  iAttribSetNameId(nameid, name, id);
-  iupAttribSetFloat(ih, nameid, num);
+  char value[80];
+  sprintf(value, IUP_FLOAT2STR, num);
+  iAttribSetStrId2(ih, name, id, IUPTABLE_NOID, value);
 }
 
 IUP_SDK_API void iupAttribSetDoubleId(Ihandle *ih, const char* name, int id, double num)
 {
-  char nameid[100];
-  iAttribSetNameId(nameid, name, id);
-  iupAttribSetDouble(ih, nameid, num);
+  char value[80];
+  sprintf(value, IUP_DOUBLE2STR, num);
+  iAttribSetStrId2(ih, name, id, IUPTABLE_NOID, value);
 }
 
 IUP_SDK_API void iupAttribSetFloatId2(Ihandle *ih, const char* name, int lin, int col, float num)
 {
-  char nameid[100];
-  iAttribSetNameId2(nameid, name, lin, col);
-  iupAttribSetFloat(ih, nameid, num);
+  char value[80];
+  sprintf(value, IUP_FLOAT2STR, num);
+  iAttribSetStrId2(ih, name, lin, col, value);
 }
 
 IUP_SDK_API void iupAttribSetDoubleId2(Ihandle *ih, const char* name, int lin, int col, double num)
 {
-  char nameid[100];
-  iAttribSetNameId2(nameid, name, lin, col);
-  iupAttribSetDouble(ih, nameid, num);
+  char value[80];
+  sprintf(value, IUP_DOUBLE2STR, num);
+  iAttribSetStrId2(ih, name, lin, col, value);
 }
 
 IUP_SDK_API char* iupAttribGetId(Ihandle* ih, const char* name, int id)
 {
-  char nameid[100];
-  iAttribSetNameId(nameid, name, id);
-  return iupAttribGet(ih, nameid);
+  if (!ih || !name)
+    return NULL;
+  return iupTableGetId(ih->attrib, name, id);
 }
 
 IUP_SDK_API int iupAttribGetIntId(Ihandle* ih, const char* name, int id)
 {
-  char nameid[100];
-  iAttribSetNameId(nameid, name, id);
-  return iupAttribGetInt(ih, nameid);
+  return iAttribStrToInt(iAttribGetStrId2(ih, name, id, IUPTABLE_NOID));
 }
 
 IUP_SDK_API int iupAttribGetBooleanId(Ihandle* ih, const char* name, int id)
 {
-  char nameid[100];
-  iAttribSetNameId(nameid, name, id);
-  return iupAttribGetBoolean(ih, nameid);
+  return iAttribStrToBoolean(iAttribGetStrId2(ih, name, id, IUPTABLE_NOID));
 }
 
 IUP_SDK_API float iupAttribGetFloatId(Ihandle* ih, const char* name, int id)
 {
-  char nameid[100];
-  iAttribSetNameId(nameid, name, id);
-  return iupAttribGetFloat(ih, nameid);
+  return iAttribStrToFloat(iAttribGetStrId2(ih, name, id, IUPTABLE_NOID));
 }
 
 IUP_SDK_API double iupAttribGetDoubleId(Ihandle* ih, const char* name, int id)
 {
-  char nameid[100];
-  iAttribSetNameId(nameid, name, id);
-  return iupAttribGetDouble(ih, nameid);
+  return iAttribStrToDouble(iAttribGetStrId2(ih, name, id, IUPTABLE_NOID));
 }
 
 IUP_SDK_API char* iupAttribGetId2(Ihandle* ih, const char* name, int lin, int col)
 {
-  char nameid[100];
-  iAttribSetNameId2(nameid, name, lin, col);
-  return iupAttribGet(ih, nameid);
+  if (!ih || !name)
+    return NULL;
+  return iupTableGetId2(ih->attrib, name, lin, col);
 }
 
 IUP_SDK_API int iupAttribGetIntId2(Ihandle* ih, const char* name, int lin, int col)
 {
-  char nameid[100];
-  iAttribSetNameId2(nameid, name, lin, col);
-  return iupAttribGetInt(ih, nameid);
+  return iAttribStrToInt(iAttribGetStrId2(ih, name, lin, col));
 }
 
 IUP_SDK_API int iupAttribGetBooleanId2(Ihandle* ih, const char* name, int lin, int col)
 {
-  char nameid[100];
-  iAttribSetNameId2(nameid, name, lin, col);
-  return iupAttribGetBoolean(ih, nameid);
+  return iAttribStrToBoolean(iAttribGetStrId2(ih, name, lin, col));
 }
 
 IUP_SDK_API float iupAttribGetFloatId2(Ihandle* ih, const char* name, int lin, int col)
 {
-  char nameid[100];
-  iAttribSetNameId2(nameid, name, lin, col);
-  return iupAttribGetFloat(ih, nameid);
+  return iAttribStrToFloat(iAttribGetStrId2(ih, name, lin, col));
 }
 
 IUP_SDK_API double iupAttribGetDoubleId2(Ihandle* ih, const char* name, int lin, int col)
 {
-  char nameid[100];
-  iAttribSetNameId2(nameid, name, lin, col);
-  return iupAttribGetDouble(ih, nameid);
+  return iAttribStrToDouble(iAttribGetStrId2(ih, name, lin, col));
 }
 
 IUP_SDK_API int iupAttribGetBoolean(Ihandle* ih, const char* name)
 {
-  char *value = iupAttribGetStr(ih, name);
-  if (value)
-  {
-    if (iupStrBoolean(value))
-      return 1;
-  }
-  return 0;
+  return iAttribStrToBoolean(iupAttribGetStr(ih, name));
 }
 
 IUP_SDK_API int iupAttribGetInt(Ihandle* ih, const char* name)
 {
-  int i = 0;
-  char *value = iupAttribGetStr(ih, name);
-  if (value)
-  {
-    if (!iupStrToInt(value, &i))
-    {
-      if (iupStrBoolean(value))
-        i = 1;
-    }
-  }
-  return i;
+  return iAttribStrToInt(iupAttribGetStr(ih, name));
 }
 
 IUP_SDK_API int iupAttribGetIntInt(Ihandle *ih, const char* name, int *i1, int *i2, char sep)
@@ -1330,20 +1509,12 @@ IUP_SDK_API int iupAttribGetIntInt(Ihandle *ih, const char* name, int *i1, int *
 
 IUP_SDK_API float iupAttribGetFloat(Ihandle* ih, const char* name)
 {
-  float f = 0;
-  char *value = iupAttribGetStr(ih, name);
-  if (value)
-    iupStrToFloat(value, &f);
-  return f;
+  return iAttribStrToFloat(iupAttribGetStr(ih, name));
 }
 
 IUP_SDK_API double iupAttribGetDouble(Ihandle* ih, const char* name)
 {
-  double f = 0;
-  char *value = iupAttribGetStr(ih, name);
-  if (value)
-    iupStrToDouble(value, &f);
-  return f;
+  return iAttribStrToDouble(iupAttribGetStr(ih, name));
 }
 
 IUP_SDK_API char* iupAttribGet(Ihandle* ih, const char* name)
@@ -6,6 +6,7 @@
  */
 
 #include <stdio.h> 
+#include <stdlib.h> 
 
 #include "iup.h"
 
@@ -17,6 +18,8 @@
 #include "iup_assert.h" 
 #include "iup_str.h" 
 #include "iup_drv.h" 
+#include "iup_layout.h" 
+#include "iup_dialog.h" 
 
 
 IUP_API Ihandle* IupGetDialog(Ihandle* ih)
@@ -45,28 +48,66 @@ IUP_API Ihandle* IupGetDialog(Ihandle* ih)
   return NULL;
 }
 
-static void iChildTreeDetach(Ihandle* parent, Ihandle* child)
+static void iChildTreeInvalidateArray(Ihandle* parent)
+{
+  if (parent->childarray)
+  {
+    free(parent->childarray);
+    parent->childarray = NULL;
+  }
+}
+
+static Ihandle** iChildTreeGetArray(Ihandle* parent)
+{
+  if (!parent->childarray && parent->childcount > 0)
+  {
+    Ihandle *c;
+    int pos = 0;
+
+    parent->childarray = (Ihandle**)malloc(parent->childcount * sizeof(Ihandle*));
+    if (!parent->childarray)
+      return NULL;  /* the callers will walk the list */
+
+    for (c = parent->firstchild; c && pos < parent->childcount; c = c->brother, pos++)
+      parent->childarray[pos] = c;
+  }
+
+  return parent->childarray;
+}
+
+static int iChildTreeDetach(Ihandle* parent, Ihandle* child)
 {
   Ihandle *c, 
           *c_prev = NULL;
+  int pos = 0;
 
   /* Removes the child entry inside the parent's child list */
-  for (c = parent->firstchild; c; c = c->brother)
+  for (c = parent->firstchild; c; c = c->brother, pos++)
   {
     if (c == child) /* Found the right child */
     {
+      iupDialogRemoveChildNames(child);
+
       if (c_prev == NULL)
         parent->firstchild = child->brother;
       else
         c_prev->brother = child->brother;
+
+      if (parent->lastchild == child)
+        parent->lastchild = c_prev;
+      parent->childcount--;
+      iChildTreeInvalidateArray(parent);
+      iupLayoutSetDirty(parent);
         
       child->brother = NULL;
       child->parent = NULL;
-      return;
+      return pos;
     }
 
     c_prev = c;
   }
+
+  return -1;
 }
 
 IUP_API void IupDetach(Ihandle *child)
@@ -86,24 +127,22 @@ IUP_API void IupDetach(Ihandle *child)
 
   parent = child->parent;
 
-  pos = IupGetChildPos(parent, child);
-
-  iChildTreeDetach(parent, child);
+  pos = iChildTreeDetach(parent, child);
   iupClassObjectChildRemoved(parent, child, pos);
 }
 
-static int iChildTreeFind(Ihandle* parent, Ihandle* child)
+static Ihandle* iChildTreeGetLast(Ihandle* parent)
 {
-  Ihandle *c;
+  Ihandle* last = parent->lastchild;
 
-  /* Finds the reference child entry inside the parent's child list */
-  for (c = parent->firstchild; c; c = c->brother)
+  /* the links may have been changed directly, without iupChildTreeUpdate */
+  if (!last || last->parent != parent || last->brother)
   {
-    if (c == child) /* Found the right child */
-      return 1;
+    iupChildTreeUpdate(parent);
+    last = parent->lastchild;
   }
 
-  return 0;
+  return last;
 }
 
 static void iChildTreeInsert(Ihandle* parent, Ihandle* ref_child, Ihandle* child)
@@ -111,10 +150,17 @@ static void iChildTreeInsert(Ihandle* parent, Ihandle* ref_child, Ihandle* child
   Ihandle *c, 
           *c_prev = NULL;
 
+  iupLayoutSetDirty(parent);
+  child->flags |= IUP_LAYOUT_DIRTY;  /* natural size can depend on the parent */
+
   if (parent->firstchild == NULL)
   {
     parent->firstchild = child;
+    parent->lastchild = child;
+    parent->childcount = 1;
+    iChildTreeInvalidateArray(parent);
     child->parent = parent;
+    iupDialogAddChildNames(child);
     return;
   }
 
@@ -127,6 +173,12 @@ static void iChildTreeInsert(Ihandle* parent, Ihandle* ref_child, Ihandle* child
     child->parent = parent;
     child->brother = ref_child->brother;
     ref_child->brother = child;
+
+    if (!child->brother)
+      parent->lastchild = child;
+    parent->childcount++;
+    iChildTreeInvalidateArray(parent);
+    iupDialogAddChildNames(child);
     return;
   }
 
@@ -143,6 +195,9 @@ static void iChildTreeInsert(Ihandle* parent, Ihandle* ref_child, Ihandle* child
       else
         c_prev->brother = child;
 
+      parent->childcount++;
+      iChildTreeInvalidateArray(parent);
+      iupDialogAddChildNames(child);
       return;
     }
 
@@ -150,20 +205,6 @@ static void iChildTreeInsert(Ihandle* parent, Ihandle* ref_child, Ihandle* child
   }
 }
 
-static int iChildTreeCount(Ihandle* ih)
-{
-  int num = 0;
-
-  ih = ih->firstchild;
-  while(ih)
-  {
-    num++;
-    ih = ih->brother;
-  }
-
-  return num;
-}
-
 IUP_API Ihandle* IupInsert(Ihandle* parent, Ihandle* ref_child, Ihandle* child)
 {
   /* ref_child can be NULL */
@@ -196,12 +237,12 @@ IUP_API Ihandle* IupInsert(Ihandle* parent, Ihandle* ref_child, Ihandle* child)
   if (parent->iclass->childtype == IUP_CHILDNONE)
     return NULL;
   if (parent->iclass->childtype > IUP_CHILDMANY && 
-      iChildTreeCount(parent) == parent->iclass->childtype-IUP_CHILDMANY)
+      parent->childcount == parent->iclass->childtype-IUP_CHILDMANY)
     return NULL;
 
 
   /* if already at the parent box, allow to move even if mapped */
-  if (parent->iclass->nativetype == IUP_TYPEVOID && iChildTreeFind(parent, child))
+  if (parent->iclass->nativetype == IUP_TYPEVOID && child->parent == parent)
   {
     iChildTreeDetach(parent, child);
     iChildTreeInsert(parent, ref_child, child);
@@ -222,15 +263,36 @@ IUP_API Ihandle* IupInsert(Ihandle* parent, Ihandle* ref_child, Ihandle* child)
 IUP_SDK_API void iupChildTreeAppend(Ihandle* parent, Ihandle* child)
 {
   child->parent = parent;
+  iupLayoutSetDirty(child);
 
   if (parent->firstchild == NULL)
+  {
     parent->firstchild = child;
+    parent->childcount = 0;
+  }
   else
+    iChildTreeGetLast(parent)->brother = child;
+
+  parent->lastchild = child;
+  parent->childcount++;
+  iChildTreeInvalidateArray(parent);
+
+  iupDialogAddChildNames(child);
+}
+
+IUP_SDK_API void iupChildTreeUpdate(Ihandle* parent)
+{
+  Ihandle *c;
+
+  parent->lastchild = NULL;
+  parent->childcount = 0;
+  iChildTreeInvalidateArray(parent);
+  iupLayoutSetDirty(parent);
+
+  for (c = parent->firstchild; c; c = c->brother)
   {
-    Ihandle* c = parent->firstchild;
-    while (c->brother)
-      c = c->brother;
-    c->brother = child;
+    parent->lastchild = c;
+    parent->childcount++;
   }
 }
 
@@ -262,12 +324,12 @@ IUP_API Ihandle* IupAppend(Ihandle* parent, Ihandle* child)
   if (parent->iclass->childtype == IUP_CHILDNONE)
     return NULL;
   if (parent->iclass->childtype > IUP_CHILDMANY && 
-      iChildTreeCount(parent) == parent->iclass->childtype-IUP_CHILDMANY)
+      parent->childcount == parent->iclass->childtype-IUP_CHILDMANY)
     return NULL;
 
 
   /* if already at the parent box, allow to move even if mapped */
-  if (parent->iclass->nativetype == IUP_TYPEVOID && iChildTreeFind(parent, child))
+  if (parent->iclass->nativetype == IUP_TYPEVOID && child->parent == parent)
   {
     iChildTreeDetach(parent, child);
     iupChildTreeAppend(parent, child);
@@ -332,7 +394,7 @@ IUP_API int IupReparent(Ihandle* child, Ihandle* parent, Ihandle* ref_child)
   if (parent->iclass->childtype == IUP_CHILDNONE)
     return IUP_ERROR;
   if (parent->iclass->childtype > IUP_CHILDMANY && 
-      iChildTreeCount(parent) == parent->iclass->childtype-IUP_CHILDMANY)
+      parent->childcount == parent->iclass->childtype-IUP_CHILDMANY)
     return IUP_ERROR;
 
 
@@ -345,9 +407,7 @@ IUP_API int IupReparent(Ihandle* child, Ihandle* parent, Ihandle* ref_child)
   /* detach from old parent */
   old_parent = child->parent;
 
-  pos = IupGetChildPos(old_parent, child);
-
-  iChildTreeDetach(old_parent, child);
+  pos = iChildTreeDetach(old_parent, child);
   iupClassObjectChildRemoved(old_parent, child, pos);
 
  
@@ -373,34 +433,60 @@ IUP_API int IupReparent(Ihandle* child, Ihandle* parent, Ihandle* ref_child)
 
 IUP_API Ihandle* IupGetChild(Ihandle* ih, int pos)
 {
-  int p;
+  Ihandle** child_array;
   Ihandle* child;
 
   iupASSERT(iupObjectCheck(ih));
   if (!iupObjectCheck(ih))
     return NULL;
 
-  for (p = 0, child = ih->firstchild; child; child = child->brother, p++)
-  {
-    if (p == pos)
-      return child;
-  }
+  if (pos < 0 || pos >= ih->childcount)
+    return NULL;
 
-  return NULL;
+  if (pos == 0)
+    return ih->firstchild;
+
+  child_array = iChildTreeGetArray(ih);
+  if (child_array)
+    return child_array[pos];
+
+  for (child = ih->firstchild; child && pos > 0; child = child->brother)
+    pos--;
+  return child;
 }
 
 IUP_API int IupGetChildPos(Ihandle* ih, Ihandle* child)
 {
   int pos;
-  Ihandle* c;
+  Ihandle** child_array;
 
   iupASSERT(iupObjectCheck(ih));
   if (!iupObjectCheck(ih))
     return -1;
 
-  for (pos = 0, c = ih->firstchild; c; c = c->brother, pos++)
+  if (!child || child->parent != ih)
+    return -1;
+
+  if (child == ih->firstchild)
+    return 0;
+  if (child == ih->lastchild && !child->brother)
+    return ih->childcount - 1;
+
+  child_array = iChildTreeGetArray(ih);
+  if (!child_array)
+  {
+    Ihandle* c;
+    for (c = ih->firstchild, pos = 0; c; c = c->brother, pos++)
+    {
+      if (c == child)
+        return pos;
+    }
+    return -1;
+  }
+
+  for (pos = 0; pos < ih->childcount; pos++)
   {
-    if (c == child)
+    if (child_array[pos] == child)
       return pos;
   }
   return -1;
@@ -427,7 +513,7 @@ IUP_API int IupGetChildCount(Ihandle* ih)
   if (!iupObjectCheck(ih))
     return -1;
 
-  return iChildTreeCount(ih);
+  return ih->childcount;
 }
 
 IUP_API Ihandle* IupGetNextChild(Ihandle* ih, Ihandle* child)
@@ -38,6 +38,12 @@ IUP_SDK_API InativeHandle* iupChildTreeGetNativeParentHandle(Ihandle* ih);
  * \ingroup childtree */
 IUP_SDK_API void iupChildTreeAppend(Ihandle* parent, Ihandle* child);
 
+/** Updates the last child, the number of children and the child index of the parent.
+ * Must be called after the firstchild and brother links are changed directly,
+ * without using the other child tree functions.
+ * \ingroup childtree */
+IUP_SDK_API void iupChildTreeUpdate(Ihandle* parent);
+
 /** Checks if the element is in the parent tree.\n 
  * Which means the element is a grand-parent of parent.
  * \ingroup childtree */
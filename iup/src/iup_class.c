@@ -263,7 +263,7 @@ IUP_SDK_API Iclass* iupClassNew(Iclass* parent)
     ic->parent = parent;
   }
   else
-    ic->attrib_func = iupTableCreate(IUPTABLE_STRINGINDEXED);
+    ic->attrib_func = iupTableCreate(IUPTABLE_ATOMINDEXED);
 
   return ic;
 }
@@ -277,7 +277,9 @@ typedef enum _IattribFlags{
   IUPAF_NO_SAVE=512,   /**< can NOT be directly saved, should have at least manual processing */
   IUPAF_NOT_SUPPORTED=1024,  /**< not supported in that driver */
   IUPAF_IHANDLENAME=2048,    /**< is an Ihandle* name, associated with IupSetHandle */
-  IUPAF_IHANDLE=4096         /**< is an Ihandle* */
+  IUPAF_IHANDLE=4096,        /**< is an Ihandle* */
+  IUPAF_LAYOUT=8192          /**< changes the natural size, setting it marks the element dirty for \ref IupRefresh.
+                                  Automatically set for common attributes (SIZE, FONT, TITLE, MARGIN, ...). Not used for ID attributes. */
 } IattribFlags;
 
 #define IUPAF_SAMEASSYSTEM ((char*)-1)  /**< means that the default value is the same as the system default value, used only in \ref iupClassRegisterAttribute */
@@ -449,8 +451,18 @@ char* iupClassObjectGetAttributeId(Ihandle* ih, const char* name, int id);
 int   iupClassObjectSetAttributeId2(Ihandle* ih, const char* name, int id1, int id2, const char* value);
 char* iupClassObjectGetAttributeId2(Ihandle* ih, const char* name, int id1, int id2);
 
-/* Used only in iupAttribGetStr */
+/* Same as above but also receives the atom of the name (see \ref atom).
+ * atom is the result of iupAtomFind(name) and can be NULL,
+ * then the name is used.
+ */
+int   iupClassObjectSetAttributeAtom(Ihandle* ih, const char* name, const char* atom, const char* value, int *inherit);
+char* iupClassObjectGetAttributeAtom(Ihandle* ih, const char* name, const char* atom, char* *def_value, int *inherit);
+
+/* Used only in iupAttribGetStr and iupAttribGet*Id* */
 void  iupClassObjectGetAttributeInfo(Ihandle* ih, const char* name, char* *def_value, int *inherit);
+void  iupClassObjectGetAttributeInfoAtom(Ihandle* ih, const char* name, const char* atom, char* *def_value, int *inherit);
+/* Same as above but the name does not include the ids, used in iupAttribGet*Id* */
+void  iupClassObjectGetAttributeInfoId2(Ihandle* ih, const char* name, int lin, int col, char* *def_value, int *inherit);
 
 /* Used only in iupAttribIsNotString */
 int   iupClassObjectAttribIsNotString(Ihandle* ih, const char* name);
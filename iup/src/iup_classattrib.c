@@ -19,6 +19,7 @@
 #include "iup_assert.h"
 #include "iup_register.h"
 #include "iup_globalattrib.h"
+#include "iup_layout.h"
 
 
 typedef struct _IattribFunc
@@ -53,6 +54,44 @@ int iupClassIsGlobalDefault(const char* name, int colors)
   return 0;
 }
 
+static int iClassIsLayoutAttrib(const char* name)
+{
+  /* common attributes used to compute the natural size or the layout of the children,
+     class specific attributes must be registered with IUPAF_LAYOUT */
+  static const char* layout_names[] = {
+    "SIZE", "RASTERSIZE", "MINSIZE", "MAXSIZE", "EXPAND", "FLOATING",
+    "FONT", "FONTFACE", "FONTSIZE", "FONTSTYLE",
+    "TITLE", "IMAGE", "IMPRESS", "IMPRESSBORDER", "BACKIMAGE", "FITTOBACKIMAGE",
+    "BORDER", "DECORATION", "DECORSIZE", "MENU", "PADDING", "SPACING", "SPIN",
+    "TEXTORIENTATION", "SHOWLINES", "VISIBLECOLUMNS", "VISIBLELINES", "VISIBLEITEMS",
+    "APPENDITEM", "REMOVEITEM", "XAUTOHIDE", "YAUTOHIDE",
+    "MARGIN", "CMARGIN", "NMARGIN", "NCMARGIN", "GAP", "CGAP", "NGAP", "NCGAP",
+    "ALIGNMENT", "HOMOGENEOUS", "EXPANDCHILDREN", "NORMALIZESIZE", "NORMALIZE",
+    "ORIENTATION", "NUMDIV", "SIZECOL", "SIZELIN", "CHILDSIZEALL", "CX", "CY"
+  };
+  int i, count = sizeof(layout_names) / sizeof(layout_names[0]);
+
+  for (i = 0; i < count; i++)
+  {
+    if (iupStrEqual(name, layout_names[i]))
+      return 1;
+  }
+  return 0;
+}
+
+static void iClassSetLayoutDirty(Ihandle* ih, const char* name, IattribFunc* afunc)
+{
+  /* only attributes that change the natural size or the layout of the children */
+  if (!afunc || (afunc->flags & (IUPAF_LAYOUT | IUPAF_READONLY)) != IUPAF_LAYOUT)
+    return;
+
+  /* EXPAND is also inherited by child containers (see iupBaseContainerUpdateExpand) */
+  if (ih->iclass->childtype != IUP_CHILDNONE && iupStrEqual(name, "EXPAND"))
+    iupLayoutSetDirtyChildren(ih);
+  else
+    iupLayoutSetDirty(ih);
+}
+
 /* '*' is used in IupMatrix to indicate a full line or column
    ':' is the regular separator for Lin:Col specification
    '-' the minus sign, so we can specify negative values */
@@ -174,6 +213,11 @@ int iupClassObjectSetAttributeId(Ihandle* ih, const char* name, int id, const ch
 }
 
 int iupClassObjectSetAttribute(Ihandle* ih, const char* name, const char * value, int *inherit)
+{
+  return iupClassObjectSetAttributeAtom(ih, name, iupAtomFind(name), value, inherit);
+}
+
+int iupClassObjectSetAttributeAtom(Ihandle* ih, const char* name, const char* atom, const char * value, int *inherit)
 {
   IattribFunc* afunc;
 
@@ -226,7 +270,9 @@ int iupClassObjectSetAttribute(Ihandle* ih, const char* name, const char * value
 
   /* if not has_attrib_id, or not found an ID, or not found the partial name, check using the full name */
 
-  afunc = (IattribFunc*)iupTableGet(ih->iclass->attrib_func, name);
+  /* names with ids, such as "BUTTON1", have no atom but can be registered */
+  afunc = atom? (IattribFunc*)iupTableGetAtom(ih->iclass->attrib_func, atom): (IattribFunc*)iupTableGet(ih->iclass->attrib_func, name);
+  iClassSetLayoutDirty(ih, name, afunc);
   *inherit = 1; /* default is inheritable */
   if (afunc)
   {
@@ -343,6 +389,11 @@ char* iupClassObjectGetAttributeId(Ihandle* ih, const char* name, int id)
 }
 
 char* iupClassObjectGetAttribute(Ihandle* ih, const char* name, char* *def_value, int *inherit)
+{
+  return iupClassObjectGetAttributeAtom(ih, name, iupAtomFind(name), def_value, inherit);
+}
+
+char* iupClassObjectGetAttributeAtom(Ihandle* ih, const char* name, const char* atom, char* *def_value, int *inherit)
 {
   IattribFunc* afunc;
 
@@ -389,7 +440,7 @@ char* iupClassObjectGetAttribute(Ihandle* ih, const char* name, char* *def_value
 
   /* if not has_attrib_id, or not found an ID, or not found the partial name, check using the full name */
 
-  afunc = (IattribFunc*)iupTableGet(ih->iclass->attrib_func, name);
+  afunc = atom? (IattribFunc*)iupTableGetAtom(ih->iclass->attrib_func, atom): (IattribFunc*)iupTableGet(ih->iclass->attrib_func, name);
   *def_value = NULL;
   *inherit = 1; /* default is inheritable */
   if (afunc)
@@ -421,6 +472,11 @@ char* iupClassObjectGetAttribute(Ihandle* ih, const char* name, char* *def_value
 }
 
 void iupClassObjectGetAttributeInfo(Ihandle* ih, const char* name, char* *def_value, int *inherit)
+{
+  iupClassObjectGetAttributeInfoAtom(ih, name, iupAtomFind(name), def_value, inherit);
+}
+
+void iupClassObjectGetAttributeInfoAtom(Ihandle* ih, const char* name, const char* atom, char* *def_value, int *inherit)
 {
   IattribFunc* afunc;
 
@@ -445,7 +501,50 @@ void iupClassObjectGetAttributeInfo(Ihandle* ih, const char* name, char* *def_va
 
   /* if not has_attrib_id, or not found an ID, or not found the partial name, check using the full name */
 
-  afunc = (IattribFunc*)iupTableGet(ih->iclass->attrib_func, name);
+  afunc = atom? (IattribFunc*)iupTableGetAtom(ih->iclass->attrib_func, atom): (IattribFunc*)iupTableGet(ih->iclass->attrib_func, name);
+  *def_value = NULL;
+  *inherit = 1; /* default is inheritable */
+  if (afunc)
+  {
+    *def_value = iClassGetDefaultValue(afunc);
+    *inherit = !(afunc->flags & IUPAF_NO_INHERIT) &&  /* is inheritable */
+               !(afunc->flags & IUPAF_NO_STRING);     /* is a string */
+  }
+}
+
+void iupClassObjectGetAttributeInfoId2(Ihandle* ih, const char* name, int lin, int col, char* *def_value, int *inherit)
+{
+  IattribFunc* afunc;
+  /* col is IUPTABLE_NOID for names with only one id */
+  int has_id = (col == IUPTABLE_NOID)? (lin != IUP_INVALID_ID): (lin != IUP_INVALID_ID || col != IUP_INVALID_ID);
+
+  if (ih->iclass->has_attrib_id!=0)
+  {
+    /* same partial name that would be found in the full name */
+    const char* name_id = iClassFindId(name);
+    const char* partial_name = NULL;
+    if (name_id)
+    {
+      partial_name = iClassCutNameId(name, name_id);
+      if (!partial_name)
+        partial_name = "IDVALUE";
+    }
+    else if (has_id)
+      partial_name = (name[0] == 0)? "IDVALUE": name;
+
+    if (partial_name)
+    {
+      afunc = (IattribFunc*)iupTableGet(ih->iclass->attrib_func, partial_name);
+      if (afunc && afunc->flags & IUPAF_HAS_ID)
+      {
+        *def_value = NULL;  /* id numbered attributes have default value NULL always */
+        *inherit = 0;       /* id numbered attributes are NON inheritable always */
+        return;
+      }
+    }
+  }
+
+  afunc = (IattribFunc*)iupTableGetId2(ih->iclass->attrib_func, name, lin, col);
   *def_value = NULL;
   *inherit = 1; /* default is inheritable */
   if (afunc)
@@ -574,6 +673,8 @@ IUP_SDK_API void iupClassRegisterAttribute(Iclass* ic, const char* name,
     afunc->default_value = _default_value;
   afunc->system_default = _system_default;
   afunc->flags = _flags;
+  if (iClassIsLayoutAttrib(name))
+    afunc->flags |= IUPAF_LAYOUT;
 
   if (iupClassIsGlobalDefault(afunc->default_value, 0))
     afunc->call_global_default = 1;
@@ -676,7 +777,7 @@ IUP_SDK_API void iupClassRegisterReplaceAttribFlags(Iclass* ic, const char* name
 {
   IattribFunc* afunc = (IattribFunc*)iupTableGet(ic->attrib_func, name);
   if (afunc)
-    afunc->flags = _flags;
+    afunc->flags = _flags | (afunc->flags & IUPAF_LAYOUT);  /* keep the layout flag */
 }
 
 IUP_SDK_API void iupClassRegisterCallback(Iclass* ic, const char* name, const char* format)
@@ -827,7 +928,7 @@ IUP_API void IupSaveClassAttributes(Ihandle* ih)
   name = iupTableFirst(ic->attrib_func);
   while (name)
   {
-    IattribFunc* afunc = (IattribFunc*)iupTableGet(ic->attrib_func, name);
+    IattribFunc* afunc = (IattribFunc*)iupTableGetAtom(ic->attrib_func, name);
     if (afunc && !(afunc->flags & IUPAF_NO_STRING) &&  /* is a string */
                  !(afunc->flags & IUPAF_READONLY) &&   /* not read-only */
                  !(afunc->flags & IUPAF_WRITEONLY) &&  /* not write-only */
@@ -932,7 +1033,7 @@ IUP_API void IupCopyClassAttributes(Ihandle* src_ih, Ihandle* dst_ih)
   name = iupTableFirst(ic->attrib_func);
   while (name)
   {
-    IattribFunc* afunc = (IattribFunc*)iupTableGet(ic->attrib_func, name);
+    IattribFunc* afunc = (IattribFunc*)iupTableGetAtom(ic->attrib_func, name);
     if (afunc && !(afunc->flags & IUPAF_NO_STRING) &&  /* is a string */
                  !(afunc->flags & IUPAF_READONLY) &&   /* not read-only */
                  !(afunc->flags & IUPAF_WRITEONLY) &&  /* not write-only */
@@ -1002,7 +1103,7 @@ IUP_API void IupCopyClassAttributes(Ihandle* src_ih, Ihandle* dst_ih)
   name = iupTableFirst(ic->attrib_func);
   while (name)
   {
-    IattribFunc* afunc = (IattribFunc*)iupTableGet(ic->attrib_func, name);
+    IattribFunc* afunc = (IattribFunc*)iupTableGetAtom(ic->attrib_func, name);
     if (afunc && !(afunc->flags & IUPAF_NO_STRING) &&   /* is a string */
                  !(afunc->flags & IUPAF_READONLY) &&    /* not read-only */
                  !(afunc->flags & IUPAF_WRITEONLY) &&   /* not write-only */
@@ -1042,7 +1143,7 @@ void iupClassObjectEnsureDefaultAttributes(Ihandle* ih)
         if ((!ih->handle &&  (afunc->flags & IUPAF_NOT_MAPPED)) ||
              (ih->handle && !(afunc->flags & IUPAF_NOT_MAPPED)))
         {
-          char* value = iupAttribGet(ih, name);
+          char* value = iupTableGetAtom(ih->attrib, name);  /* name is an atom */
           if (!value)  /* if set will be updated later */
             afunc->set(ih, iClassGetDefaultValue(afunc));
         }
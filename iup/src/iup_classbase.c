@@ -20,6 +20,7 @@
 #include "iup_attrib.h"
 #include "iup_layout.h"
 #include "iup_assert.h"
+#include "iup_dialog.h"
 
 
 IUP_SDK_API void iupBaseCallValueChangedCb(Ihandle* ih)
@@ -394,7 +395,6 @@ static Ihandle* iBaseFindNamedChild(Ihandle* ih, const char* name)
 IUP_API Ihandle* IupGetDialogChild(Ihandle* ih, const char* name)
 {
   Ihandle *child, *dialog;
-  char attrib[1024] = "_IUP_DIALOG_CHILD_";
 
   iupASSERT(iupObjectCheck(ih));
   if (!iupObjectCheck(ih))
@@ -404,16 +404,24 @@ IUP_API Ihandle* IupGetDialogChild(Ihandle* ih, const char* name)
     return NULL;
 
   dialog = IupGetDialog(ih);
-  if (dialog) ih = dialog;
- 
-  strcat(attrib, name);
-  child = (Ihandle*)iupAttribGet(ih, attrib);
-  if (child) return child;
+  if (dialog)
+  {
+    ih = dialog;
+
+    child = iupDialogFindChildName(dialog, name);
+    if (child) return child;
+  }
 
   if (ih->firstchild)
   {
     child = iBaseFindNamedChild(ih, name);
-    if (child) return child;
+    if (child)
+    {
+      /* not in the index yet, add it if it is not a case insensitive match */
+      if (dialog && iupStrEqual(name, iupAttribGet(child, "NAME")))
+        iupDialogSetChildName(child, NULL, name);
+      return child;
+    }
   }
 
   ih = IupGetAttributeHandle(ih, "MENU");
@@ -427,31 +435,8 @@ IUP_API Ihandle* IupGetDialogChild(Ihandle* ih, const char* name)
 
 IUP_SDK_API int iupBaseSetNameAttrib(Ihandle* ih, const char* value)
 {
-  if (!value)
-  {
-    /* remove old name cache */
-    value = iupAttribGet(ih, "NAME");
-    if (value)
-    {
-      Ihandle* dialog;
-      char attrib[1024] = "_IUP_DIALOG_CHILD_";
-      strcat(attrib, value);
-      dialog = (Ihandle*)iupAttribGet(ih, attrib);
-      if (dialog)
-        iupAttribSet(dialog, attrib, NULL);
-    }
-  }
-  else
-  {
-    Ihandle* dialog = IupGetDialog(ih);
-    if (dialog)
-    {
-      char attrib[1024] = "_IUP_DIALOG_CHILD_";
-      strcat(attrib, value);
-      iupAttribSet(dialog, attrib, (char*)ih);
-      iupAttribSet(ih, attrib, (char*)dialog);
-    }
-  }
+  /* update the dialog index, the current value is the old name */
+  iupDialogSetChildName(ih, iupAttribGet(ih, "NAME"), value);
   return 1;
 }
 
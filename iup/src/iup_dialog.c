@@ -24,6 +24,7 @@
 #include "iup_drvfont.h"
 #include "iup_focus.h"
 #include "iup_str.h"
+#include "iup_table.h"
 #define _IUPDLG_PRIVATE
 #include "iup_dialog.h"
 
@@ -304,11 +305,23 @@ static void iDialogDestroyMethod(Ihandle* ih)
     ih->data->menu = NULL;
   }
 
+  if (ih->data->child_names)
+  {
+    iupTableDestroy(ih->data->child_names);
+    ih->data->child_names = NULL;
+  }
+
   iupDlgListRemove(ih);
 }
 
 static int iDialogSetMenuAttrib(Ihandle* ih, const char* value);
 
+static char* iDialogGetChildNameStatsAttrib(Ihandle* ih)
+{
+  int count = ih->data->child_names? iupTableCount(ih->data->child_names): 0;
+  return iupStrReturnStrf("%d:%d:%d", ih->data->child_names_hits, ih->data->child_names_misses, count);
+}
+
 static void iDialogComputeNaturalSizeMethod(Ihandle* ih, int *w, int *h, int *children_expand)
 {
   int decorwidth, decorheight;
@@ -458,6 +471,100 @@ char* iupDialogGetChildIdStr(Ihandle* ih)
   return iupStrReturnStrf("iup-%s-%d", ih->iclass->name, dialog->data->child_id);
 }
 
+static Ihandle* iDialogGetTop(Ihandle* ih)
+{
+  /* same as IupGetDialog, but does not consider menus */
+  while (ih->parent)
+    ih = ih->parent;
+
+  if (ih->iclass->nativetype == IUP_TYPEDIALOG && ih->data)
+    return ih;
+  else
+    return NULL;
+}
+
+static void iDialogAddChildName(Ihandle* dialog, Ihandle* ih, const char* name, int replace)
+{
+  if (!dialog->data->child_names)
+    dialog->data->child_names = iupTableCreate(IUPTABLE_STRINGINDEXED);
+
+  /* when the same name is used more than once, 
+     keep the first one, unless NAME is being set */
+  if (replace || !iupTableGet(dialog->data->child_names, name))
+    iupTableSet(dialog->data->child_names, name, ih, IUPTABLE_POINTER);
+}
+
+static void iDialogRemoveChildName(Ihandle* dialog, Ihandle* ih, const char* name)
+{
+  /* remove only if it is the element in the index, 
+     another element with the same name will be found by IupGetDialogChild later */
+  if (dialog->data->child_names && iupTableGet(dialog->data->child_names, name) == ih)
+    iupTableRemove(dialog->data->child_names, name);
+}
+
+static void iDialogAddChildNamesRec(Ihandle* dialog, Ihandle* ih)
+{
+  Ihandle* child;
+  char* name = iupAttribGet(ih, "NAME");
+  if (name)
+    iDialogAddChildName(dialog, ih, name, 0);
+
+  for (child = ih->firstchild; child; child = child->brother)
+    iDialogAddChildNamesRec(dialog, child);
+}
+
+static void iDialogRemoveChildNamesRec(Ihandle* dialog, Ihandle* ih)
+{
+  Ihandle* child;
+  char* name = iupAttribGet(ih, "NAME");
+  if (name)
+    iDialogRemoveChildName(dialog, ih, name);
+
+  for (child = ih->firstchild; child; child = child->brother)
+    iDialogRemoveChildNamesRec(dialog, child);
+}
+
+void iupDialogAddChildNames(Ihandle* ih)
+{
+  Ihandle* dialog = iDialogGetTop(ih);
+  if (dialog && dialog != ih)
+    iDialogAddChildNamesRec(dialog, ih);
+}
+
+void iupDialogRemoveChildNames(Ihandle* ih)
+{
+  Ihandle* dialog = iDialogGetTop(ih);
+  if (dialog && dialog != ih && dialog->data->child_names)
+    iDialogRemoveChildNamesRec(dialog, ih);
+}
+
+void iupDialogSetChildName(Ihandle* ih, const char* old_name, const char* new_name)
+{
+  Ihandle* dialog = iDialogGetTop(ih);
+  if (!dialog || dialog == ih)
+    return;
+
+  if (old_name)
+    iDialogRemoveChildName(dialog, ih, old_name);
+  if (new_name)
+    iDialogAddChildName(dialog, ih, new_name, 1);
+}
+
+Ihandle* iupDialogFindChildName(Ihandle* dialog, const char* name)
+{
+  Ihandle* child = NULL;
+
+  if (dialog->data->child_names)
+    child = (Ihandle*)iupTableGet(dialog->data->child_names, name);
+
+  if (child)
+    dialog->data->child_names_hits++;
+  else
+    dialog->data->child_names_misses++;
+
+  return child;
+}
+
 static void iDialogListCheckLastVisible(int was_modal)
 {
   if (iupDlgListVisibleCount() <= 0)
@@ -1240,6 +1347,14 @@ static int iDialogSetSimulateModalAttrib(Ihandle *ih, const char *value)
   return 0;
 }
 
+static int iDialogSetShrinkAttrib(Ihandle *ih, const char *value)
+{
+  /* shrink affects all the containers */
+  iupLayoutSetDirtyChildren(ih);
+  (void)value;
+  return 1;
+}
+
 static int iDialogSetParentDialogAttrib(Ihandle *ih, const char *value)
 {
   Ihandle* parent = IupGetHandle(value);
@@ -1430,7 +1545,8 @@ Iclass* iupDialogNewClass(void)
   iupClassRegisterAttribute(ic, "DEFAULTESC",   NULL, NULL, NULL, NULL, IUPAF_IHANDLENAME|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "DIALOGFRAME",  NULL, iDialogSetDialogFrameAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "PARENTDIALOG", NULL, iDialogSetParentDialogAttrib, NULL, NULL, IUPAF_NO_DEFAULTVALUE | IUPAF_IHANDLENAME | IUPAF_NO_INHERIT);
-  iupClassRegisterAttribute(ic, "SHRINK",       NULL, NULL, NULL, NULL, IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "SHRINK",       NULL, iDialogSetShrinkAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "CHILDNAMESTATS", iDialogGetChildNameStatsAttrib, NULL, NULL, NULL, IUPAF_READONLY|IUPAF_NOT_MAPPED|IUPAF_NO_DEFAULTVALUE|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "STARTFOCUS",   NULL, NULL, NULL, NULL, IUPAF_NO_DEFAULTVALUE | IUPAF_IHANDLENAME | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "MODAL",        NULL, NULL, NULL, NULL, IUPAF_READONLY|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "PLACEMENT",    NULL, NULL, "NORMAL", NULL, IUPAF_NO_INHERIT);
@@ -34,6 +34,14 @@ void iupDialogHide(Ihandle* ih);
 int iupDialogGetChildId(Ihandle* ih);
 char* iupDialogGetChildIdStr(Ihandle* ih);
 
+/* Index of the children NAME attribute, used by IupGetDialogChild. 
+   Elements are added when attached to the dialog or when NAME is set,
+   and removed when detached. All functions do nothing if ih is not inside a dialog. */
+void iupDialogAddChildNames(Ihandle* ih);      /* ih and all its children */
+void iupDialogRemoveChildNames(Ihandle* ih);   /* ih and all its children */
+void iupDialogSetChildName(Ihandle* ih, const char* old_name, const char* new_name);
+Ihandle* iupDialogFindChildName(Ihandle* dialog, const char* name);
+
 /* Returns the size of the decoration */
 void iupdrvDialogGetDecoration(Ihandle* ih, int *border, int *caption, int *menu);
 
@@ -74,6 +82,9 @@ struct _IcontrolData
     child_id,       /* serial number used by child controls */
     cmd_show;       /* parameters for ShowWindow in Windows driver */
   Ihandle* menu;
+  struct _Itable* child_names;  /* NAME -> Ihandle* of the children, created only when necessary */
+  int child_names_hits, /* statistics of iupDialogFindChildName */
+    child_names_misses;
 };
 
 
@@ -1541,6 +1541,7 @@ static void iExpanderChildAddedMethod(Ihandle* ih, Ihandle* child)
     ih->firstchild = child->brother; /* the actual bar */
     child->brother = ih->firstchild->brother;
     ih->firstchild->brother = child;
+    iupChildTreeUpdate(ih);
   }
 
   iExpanderOpenCloseChild(ih, 0, 0, ih->data->state);
@@ -730,9 +730,7 @@ static int iExportImagePrintBuffer(Iarray *buffer, const char *format, va_list a
   if (len < 0)
     return len;
 
-  iupArrayAdd(buffer, len);
-
-  data = (char*)iupArrayGetData(buffer);
+  data = (char*)iupArrayAddUninit(buffer, len);
 
   memcpy(data + count, str, len);
 
@@ -1107,9 +1105,11 @@ IUP_SDK_API int iupImageExportToString(Ihandle* ih, char **str, const char* form
     ret = iExportSaveImageC(NULL, ih, name, NULL, buffer);
 
   count = iupArrayCount(buffer);
-  *str = iupArrayInc(buffer);
+  *str = iupArrayAddUninit(buffer, 1);
   (*str)[count] = 0;
 
+  /* release the memory not used by the string */
+  iupArrayShrink(buffer);
   *str = iupArrayReleaseData(buffer);
 
   iupArrayDestroy(buffer);
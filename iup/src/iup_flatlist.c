@@ -1014,7 +1014,10 @@ static int iFlatListSetInsertItemAttrib(Ihandle* ih, int pos, const char* value)
 static int iFlatListSetRemoveItemAttrib(Ihandle* ih, const char* value)
 {
   if (!value || iupStrEqualNoCase(value, "ALL"))
+  {
     iFlatListRemoveItem(ih, 0, iupArrayCount(ih->data->items_array));
+    iupArrayShrink(ih->data->items_array);  /* release the memory of large lists */
+  }
   else
   {
     int pos;
@@ -1142,6 +1145,10 @@ static int iFlatListDropData_CB(Ihandle *ih, char* type, void* data, int len, in
 
     /* Copy all selected items */
     int src_pos = 1;  /* IUP starts at 1 */
+
+    /* reserve memory for all the selected items at once */
+    iupArrayReserve(ih->data->items_array, iupArrayCount(ih->data->items_array) + iupStrCountChar(buffer, '+'));
+
     while (buffer[src_pos - 1] != '\0')
     {
       if (buffer[src_pos - 1] == '+')
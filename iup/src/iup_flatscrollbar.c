@@ -1104,8 +1104,12 @@ IUP_SDK_API void iupFlatScrollBarSetChildrenPosition(Ihandle* ih)
     iupBaseSetPosition(sb_horiz, 0, ih->currentheight - sb_size);
   }
 
-  IupSetAttribute(sb_vert, "ZORDER", "TOP");
-  IupSetAttribute(sb_horiz, "ZORDER", "TOP");
+  /* keep the scrollbars over the other children,
+     only when they were moved or the children were computed again */
+  if (sb_vert->flags & IUP_LAYOUT_CHANGED || ih->flags & IUP_LAYOUT_CHILDREN)
+    IupSetAttribute(sb_vert, "ZORDER", "TOP");
+  if (sb_horiz->flags & IUP_LAYOUT_CHANGED || ih->flags & IUP_LAYOUT_CHILDREN)
+    IupSetAttribute(sb_horiz, "ZORDER", "TOP");
 }
 
 IUP_SDK_API void iupFlatScrollBarMotionUpdate(Ihandle* ih, int x, int y)
@@ -1176,6 +1180,7 @@ static void iChildTreeInsertFirst(Ihandle* ih, Ihandle* child)
   }
 
   ih->firstchild = child;
+  iupChildTreeUpdate(ih);
 }
 
 IUP_SDK_API int iupFlatScrollBarCreate(Ihandle* ih)
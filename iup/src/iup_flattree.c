@@ -520,7 +520,7 @@ static void iFlatTreeRebuildArray(Ihandle *ih, int num)
   int depth = 0;
   
   if (num > 0)
-    iupArrayAdd(ih->data->node_array, num);  /* increment the array */
+    iupArrayAddUninit(ih->data->node_array, num);  /* increment the array, all elements are updated below */
   else if (num < 0)
   {
     int count = iupArrayCount(ih->data->node_array);
@@ -21,6 +21,7 @@
 #include "iup_str.h"
 #include "iup_strmessage.h"
 #include "iup_attrib.h"
+#include "iup_layout.h"
 
 
 static Itable *iglobal_table = NULL;
@@ -200,6 +201,18 @@ IUP_API char* IupGetGlobal(const char *name)
     iupdrvGetKeyState(str);
     return str;
   }
+  if (iupStrEqual(name, "LAYOUTVISITED"))
+  {
+    int visited;
+    iupLayoutGetStats(&visited, NULL);
+    return iupStrReturnInt(visited);
+  }
+  if (iupStrEqual(name, "LAYOUTUPDATED"))
+  {
+    int updated;
+    iupLayoutGetStats(NULL, &updated);
+    return iupStrReturnInt(updated);
+  }
   if (iupStrEqual(name, "SCREENSIZE"))
   {
     int w, h;
@@ -17,7 +17,107 @@
 #include "iup_layout.h"
 #include "iup_assert.h" 
 
- 
+
+/* statistics of the last layout computation */
+static int iLayoutVisited = 0;  /* elements visited by all the steps */
+static int iLayoutUpdated = 0;  /* elements updated in the native system */
+
+void iupLayoutGetStats(int *visited, int *updated)
+{
+  if (visited) *visited = iLayoutVisited;
+  if (updated) *updated = iLayoutUpdated;
+}
+
+IUP_SDK_API void iupLayoutSetDirty(Ihandle* ih)
+{
+  /* the natural size of all the parents depends on the element */
+  while (ih)
+  {
+    ih->flags |= IUP_LAYOUT_DIRTY;
+    ih = ih->parent;
+  }
+}
+
+static void iLayoutSetDirtyTree(Ihandle* ih)
+{
+  Ihandle* child;
+
+  ih->flags |= IUP_LAYOUT_DIRTY;
+
+  for (child = ih->firstchild; child; child = child->brother)
+    iLayoutSetDirtyTree(child);
+}
+
+IUP_SDK_API void iupLayoutSetDirtyChildren(Ihandle* ih)
+{
+  iLayoutSetDirtyTree(ih);
+  iupLayoutSetDirty(ih->parent);
+}
+
+static void iLayoutUpdateChanged(Ihandle* ih)
+{
+  Ihandle* child;
+
+  if (ih->flags & IUP_FLOATING_IGNORE)
+    return;
+
+  iLayoutVisited++;
+
+  /* update size and position of the native control only if changed */
+  if (ih->flags & IUP_LAYOUT_CHANGED)
+  {
+    iupClassObjectLayoutUpdate(ih);
+    iLayoutUpdated++;
+  }
+
+  ih->flags &= ~(IUP_LAYOUT_CHANGED | IUP_LAYOUT_VISITED);
+
+  /* update its children, 
+     if a child was not visited then its subtree did not change */
+  for (child = ih->firstchild; child; child = child->brother)
+  {
+    if (!child->handle)
+      continue;
+
+    if (child->flags & IUP_LAYOUT_VISITED)
+      iLayoutUpdateChanged(child);
+    else if (child->flags & IUP_FLOATING)
+      iupLayoutUpdate(child);  /* FLOATING=YES, position is not computed by the container, but it is still updated */
+  }
+}
+
+static void iLayoutComputeDirty(Ihandle* ih)
+{
+  int shrink = iupAttribGetBoolean(ih, "SHRINK");
+
+  /* Compute the natural size for all elements in the dialog,   
+     using the minimum visible size and the defined user size.
+     The minimum visible size is the size where all the controls can display
+     all their contents.
+     The defined user size is used to increase the value of the minimum visible size for containers,
+     for standard controls will replace the minimum visible size.
+     So the native size will be the maximum value between 
+     minimum visible size and defined user size.
+     Also calculates the expand configuration for each element, but expand is used only in SetChildrenCurrentSize.
+     SEQUENCE: will first calculate the native size for the children, then for the element. 
+     Elements that are not dirty will simply use the last computed natural size. */
+  iupBaseComputeNaturalSize(ih);
+
+  /* Set the current size (not reflected in the native element yet) based on
+     the natural size and the expand configuration. 
+     If shrink is 0 (default) the current size of containers can be only larger than the natural size,
+     the result will depend on the EXPAND attribute.
+     If shrink is 1 the containers can be resized to sizes smaller than the natural size.
+     SEQUENCE: will first calculate the current size of the element, then for the children. 
+     Children are skipped if the element size did not change and its natural size was not computed again. */
+  iupBaseSetCurrentSize(ih, 0, 0, shrink);
+
+  /* Now that the current size is known, set the position of the elements 
+     relative to the parent.
+     SEQUENCE: will first set the position of the element, then for the children. */
+  iupBaseSetPosition(ih, 0, 0);
+}
+
 IUP_API void IupRefreshChildren(Ihandle* ih)
 {
   int shrink;
@@ -42,6 +142,13 @@ IUP_API void IupRefreshChildren(Ihandle* ih)
 
   shrink = iupAttribGetBoolean(dialog, "SHRINK");
 
+  iLayoutVisited = 0;
+  iLayoutUpdated = 0;
+
+  /* compute again all the children */
+  for (child = ih->firstchild; child; child = child->brother)
+    iLayoutSetDirtyTree(child);
+
   /* children only iupBaseComputeNaturalSize */
   {
     int w=0, h=0, children_expand=ih->expand;
@@ -74,13 +181,20 @@ IUP_API void IupRefresh(Ihandle* ih)
   if (!iupObjectCheck(ih))
     return;
 
+  /* compute only what changed since the last layout,
+     also when not inside a dialog, to be computed later */
+  iupLayoutSetDirty(ih);
+
   dialog = IupGetDialog(ih);
   if (dialog)
   {
-    iupLayoutCompute(dialog);
+    iLayoutVisited = 0;
+    iLayoutUpdated = 0;
+
+    iLayoutComputeDirty(dialog);
 
     if (dialog->handle)
-      iupLayoutUpdate(dialog);
+      iLayoutUpdateChanged(dialog);
   }
 }
 
@@ -145,9 +259,14 @@ IUP_SDK_API void iupLayoutUpdate(Ihandle* ih)
   if (ih->flags & IUP_FLOATING_IGNORE)
     return;
 
+  iLayoutVisited++;
+  iLayoutUpdated++;
+
   /* update size and position of the native control */
   iupClassObjectLayoutUpdate(ih);
 
+  ih->flags &= ~(IUP_LAYOUT_CHANGED | IUP_LAYOUT_VISITED);
+
   /* update its children */
   for (child = ih->firstchild; child; child = child->brother)
   {
@@ -160,32 +279,13 @@ void iupLayoutCompute(Ihandle* ih)
 {
   /* usually called only for the dialog */
 
-  int shrink = iupAttribGetBoolean(ih, "SHRINK");
+  iLayoutVisited = 0;
+  iLayoutUpdated = 0;
 
-  /* Compute the natural size for all elements in the dialog,   
-     using the minimum visible size and the defined user size.
-     The minimum visible size is the size where all the controls can display
-     all their contents.
-     The defined user size is used to increase the value of the minimum visible size for containers,
-     for standard controls will replace the minimum visible size.
-     So the native size will be the maximum value between 
-     minimum visible size and defined user size.
-     Also calculates the expand configuration for each element, but expand is used only in SetChildrenCurrentSize.
-     SEQUENCE: will first calculate the native size for the children, then for the element. */
-  iupBaseComputeNaturalSize(ih);
+  /* compute everything again */
+  iLayoutSetDirtyTree(ih);
 
-  /* Set the current size (not reflected in the native element yet) based on
-     the natural size and the expand configuration. 
-     If shrink is 0 (default) the current size of containers can be only larger than the natural size,
-     the result will depend on the EXPAND attribute.
-     If shrink is 1 the containers can be resized to sizes smaller than the natural size.
-     SEQUENCE: will first calculate the current size of the element, then for the children. */
-  iupBaseSetCurrentSize(ih, 0, 0, shrink);
-
-  /* Now that the current size is known, set the position of the elements 
-     relative to the parent.
-     SEQUENCE: will first set the position of the element, then for the children. */
-  iupBaseSetPosition(ih, 0, 0);
+  iLayoutComputeDirty(ih);
 }
 
 IUP_SDK_API void iupLayoutApplyMinMaxSize(Ihandle* ih, int *w, int *h)
@@ -211,6 +311,26 @@ IUP_SDK_API void iupLayoutApplyMinMaxSize(Ihandle* ih, int *w, int *h)
 
 void iupBaseComputeNaturalSize(Ihandle* ih)
 {
+  iLayoutVisited++;
+
+  /* use the last computed natural size if nothing changed,
+     the dialog natural size depends on its current size so it is always computed */
+  if (!(ih->flags & IUP_LAYOUT_DIRTY) &&
+      ih->iclass->nativetype != IUP_TYPEDIALOG &&
+      ih->cacheduserwidth == ih->userwidth &&
+      ih->cacheduserheight == ih->userheight)
+  {
+    ih->naturalwidth = ih->cachedwidth;
+    ih->naturalheight = ih->cachedheight;
+    ih->expand = ih->cachedexpand;
+    return;
+  }
+
+  /* cleared before computing, so if a child is marked during the computation 
+     the element will also remain dirty */
+  ih->flags &= ~IUP_LAYOUT_DIRTY;
+  ih->flags |= IUP_LAYOUT_CHILDREN;
+
   /* always initialize the natural size using the user size */
   ih->naturalwidth = ih->userwidth;
   ih->naturalheight = ih->userheight;
@@ -262,10 +382,18 @@ void iupBaseComputeNaturalSize(Ihandle* ih)
 
   /* crop the natural size */
   iupLayoutApplyMinMaxSize(ih, &(ih->naturalwidth), &(ih->naturalheight));
+
+  ih->cachedwidth = ih->naturalwidth;
+  ih->cachedheight = ih->naturalheight;
+  ih->cachedexpand = ih->expand;
+  ih->cacheduserwidth = ih->userwidth;
+  ih->cacheduserheight = ih->userheight;
 }
 
 void iupBaseSetCurrentSize(Ihandle* ih, int w, int h, int shrink)
 {
+  iLayoutVisited++;
+
   if (ih->iclass->nativetype == IUP_TYPEDIALOG)
   {
     /* w and h parameters here are ignored, because they are always 0 for the dialog. */
@@ -295,15 +423,39 @@ void iupBaseSetCurrentSize(Ihandle* ih, int w, int h, int shrink)
       ih->expand & IUP_EXPAND_WFREE || ih->expand & IUP_EXPAND_HFREE)
     iupLayoutApplyMinMaxSize(ih, &(ih->currentwidth), &(ih->currentheight));
 
-  if (ih->firstchild)
+  /* if the size did not change since the last layout and 
+     the natural size was not computed again, then the children size will not change */
+  if (ih->firstchild && 
+      (ih->currentwidth != ih->layoutwidth || ih->currentheight != ih->layoutheight ||
+       ih->flags & IUP_LAYOUT_CHILDREN))
     iupClassObjectSetChildrenCurrentSize(ih, shrink);
 }
 
 void iupBaseSetPosition(Ihandle* ih, int x, int y)
 {
+  iLayoutVisited++;
+
   ih->x = x;
   ih->y = y;
 
-  if (ih->firstchild)
+  /* the current size is already computed, 
+     but it may have been set by the parent without iupBaseSetCurrentSize.
+     Elements computed again are also updated, even if the size is the same. */
+  if (ih->x != ih->layoutx || ih->y != ih->layouty ||
+      ih->currentwidth != ih->layoutwidth || ih->currentheight != ih->layoutheight ||
+      ih->flags & IUP_LAYOUT_CHILDREN)
+  {
+    ih->layoutx = ih->x;
+    ih->layouty = ih->y;
+    ih->layoutwidth = ih->currentwidth;
+    ih->layoutheight = ih->currentheight;
+    ih->flags |= IUP_LAYOUT_CHANGED;
+  }
+
+  ih->flags |= IUP_LAYOUT_VISITED;
+
+  if (ih->firstchild && ih->flags & IUP_LAYOUT_CHANGED)
     iupClassObjectSetChildrenPosition(ih, x, y);
+
+  ih->flags &= ~IUP_LAYOUT_CHILDREN;
 }
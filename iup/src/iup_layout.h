@@ -15,6 +15,18 @@ extern "C" {
 void iupLayoutCompute(Ihandle* ih);  /* can be called before map */
 IUP_SDK_API void iupLayoutUpdate(Ihandle* ih);   /* called after map */
 
+/* Incremental layout used by IupRefresh.
+   When the natural size of an element may have changed, it must be marked as dirty,
+   its parents are also marked. Only dirty elements have their natural size computed again,
+   and only elements with a new size or position are updated in the native system.
+   Setting an attribute, adding or removing children, already mark the element. */
+IUP_SDK_API void iupLayoutSetDirty(Ihandle* ih);
+IUP_SDK_API void iupLayoutSetDirtyChildren(Ihandle* ih);  /* also all its children */
+
+/* Number of elements visited and updated in the native system by the last layout computation.
+   Returned by the LAYOUTVISITED and LAYOUTUPDATED global attributes. */
+void iupLayoutGetStats(int *visited, int *updated);
+
 IUP_SDK_API void iupLayoutApplyMinMaxSize(Ihandle* ih, int *w, int *h);
 
 /* Other functions declared in <iup.h> and implemented here. 
@@ -262,6 +262,8 @@ int iupListSetIdValueAttrib(Ihandle* ih, int pos, const char* value)
     else if (pos == count)
       iupdrvListAppendItem(ih, value);
   }
+
+  iupLayoutSetDirty(ih);  /* items are used to compute the natural size */
   return 0;
 }
 
@@ -285,6 +287,8 @@ static int iListSetInsertItemAttrib(Ihandle* ih, int id, const char* value)
       iupdrvListInsertItem(ih, pos, value);
     else if (pos == -2)
       iupdrvListAppendItem(ih, value);
+
+    iupLayoutSetDirty(ih);  /* items are used to compute the natural size */
   }
   return 0;
 }
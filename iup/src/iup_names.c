@@ -11,6 +11,7 @@
 
 #include "iup_str.h"
 #include "iup_table.h"
+#include "iup_array.h"
 #include "iup_names.h"
 #include "iup_object.h"
 #include "iup_class.h"
@@ -23,113 +24,129 @@
    Do not confuse with the NAME attribute. */
 
 static Itable *inames_strtable = NULL;   /* table indexed by name containing Ihandle* address */
+static Itable *inames_ihtable = NULL;    /* table indexed by Ihandle* address containing an Iarray of names,
+                                            so the names of a handle can be found without searching all names */
 
 void iupNamesInit(void)
 {
   inames_strtable = iupTableCreate(IUPTABLE_STRINGINDEXED);
+  inames_ihtable = iupTableCreate(IUPTABLE_POINTERINDEXED);
 }
 
-void iupNamesFinish(void)
+static void iNamesDestroyArray(Iarray* names_array)
 {
-  iupTableDestroy(inames_strtable);
-  inames_strtable = NULL;
+  char** names = (char**)iupArrayGetData(names_array);
+  int i, count = iupArrayCount(names_array);
+  for (i = 0; i < count; i++)
+    free(names[i]);
+  iupArrayDestroy(names_array);
 }
 
-static Ihandle* iNameGetTopParent(Ihandle* ih)
+void iupNamesFinish(void)
 {
-  Ihandle* parent = ih;
-  while (parent->parent)
-    parent = parent->parent;
-  return parent;
+  char* key = iupTableFirst(inames_ihtable);
+  while (key)
+  {
+    iNamesDestroyArray((Iarray*)iupTableGetCurr(inames_ihtable));
+    key = iupTableNext(inames_ihtable);
+  }
+
+  iupTableDestroy(inames_ihtable);
+  inames_ihtable = NULL;
+
+  iupTableDestroy(inames_strtable);
+  inames_strtable = NULL;
 }
 
-static int iNameCheckArray(Ihandle** ih_array, int count, Ihandle* ih)
+static void iNamesAdd(Ihandle* ih, const char* name)
 {
-  int i;
-  for (i = 0; i < count; i++)
+  char** names;
+  Iarray* names_array = (Iarray*)iupTableGet(inames_ihtable, (char*)ih);
+  if (!names_array)
   {
-    if (ih_array[i] == ih)
-      return 0;
+    names_array = iupArrayCreate(2, sizeof(char*));
+    iupTableSet(inames_ihtable, (char*)ih, names_array, IUPTABLE_POINTER);
   }
-  return 1;
+
+  names = (char**)iupArrayInc(names_array);
+  names[iupArrayCount(names_array) - 1] = iupStrDup(name);
 }
 
-void iupNamesDestroyHandles(void)
+static void iNamesRemove(Ihandle* ih, const char* name)
 {
-  char *name;
-  Ihandle** ih_array, *ih;
-  int count, i = 0;
-
-  count = iupTableCount(inames_strtable);
-  if (!count)
+  char** names;
+  int i, count;
+  Iarray* names_array = (Iarray*)iupTableGet(inames_ihtable, (char*)ih);
+  if (!names_array)
     return;
 
-  ih_array = (Ihandle**)malloc(count * sizeof(Ihandle*));
-  memset(ih_array, 0, count * sizeof(Ihandle*));
-
-  /* store the handles before updating so we can remove elements in the loop */
-  name = iupTableFirst(inames_strtable);
-  while (name)
+  names = (char**)iupArrayGetData(names_array);
+  count = iupArrayCount(names_array);
+  for (i = 0; i < count; i++)
   {
-    ih = (Ihandle*)iupTableGetCurr(inames_strtable);
-    if (iupObjectCheck(ih))   /* here must be a handle */
+    if (iupStrEqual(names[i], name))
     {
-      /* only need to destroy the top parent handle */
-      ih = iNameGetTopParent(ih);
-
-      /* check if already in the array */
-      if (iNameCheckArray(ih_array, i, ih))
-      {
-        ih_array[i] = ih;
-        i++;
-      }
+      free(names[i]);
+      iupArrayRemove(names_array, i, 1);
+      break;
     }
-    name = iupTableNext(inames_strtable);
   }
 
-  count = i;
-  for (i = 0; i < count; i++)
+  if (iupArrayCount(names_array) == 0)
   {
-    if (iupObjectCheck(ih_array[i]))  /* here must be a handle */
-      IupDestroy(ih_array[i]);
+    iupArrayDestroy(names_array);
+    iupTableRemove(inames_ihtable, (char*)ih);
   }
+}
 
-  free(ih_array);
+static Ihandle* iNameGetTopParent(Ihandle* ih)
+{
+  Ihandle* parent = ih;
+  while (parent->parent)
+    parent = parent->parent;
+  return parent;
 }
 
-IUP_SDK_API void iupNamesDestroyHandlesSelected(const char* attrib_name, void* attrib_value)
+static void iNamesDestroyHandles(const char* attrib_name, void* attrib_value)
 {
-  char *name;
+  char *key;
   Ihandle** ih_array, *ih;
+  Itable* ih_found;
   int count, i = 0;
 
-  count = iupTableCount(inames_strtable);
+  /* one entry for each named handle */
+  count = iupTableCount(inames_ihtable);
   if (!count)
     return;
 
   ih_array = (Ihandle**)malloc(count * sizeof(Ihandle*));
   memset(ih_array, 0, count * sizeof(Ihandle*));
+  ih_found = iupTableCreate(IUPTABLE_POINTERINDEXED);
 
   /* store the handles before updating so we can remove elements in the loop */
-  name = iupTableFirst(inames_strtable);
-  while (name)
+  key = iupTableFirst(inames_ihtable);
+  while (key)
   {
-    ih = (Ihandle*)iupTableGetCurr(inames_strtable);
-    if (iupObjectCheck(ih) && ((attrib_value && iupAttribGet(ih, attrib_name) == attrib_value) || (!attrib_value && iupAttribGet(ih, attrib_name))))
+    ih = (Ihandle*)key;
+    if (iupObjectCheck(ih) &&   /* here must be a handle */
+        (!attrib_name || (attrib_value && iupAttribGet(ih, attrib_name) == attrib_value) || (!attrib_value && iupAttribGet(ih, attrib_name))))
     {
       /* only need to destroy the top parent handle */
       ih = iNameGetTopParent(ih);
 
       /* check if already in the array */
-      if (iNameCheckArray(ih_array, i, ih))
+      if (!iupTableGet(ih_found, (char*)ih))
       {
+        iupTableSet(ih_found, (char*)ih, ih, IUPTABLE_POINTER);
         ih_array[i] = ih;
         i++;
       }
     }
-    name = iupTableNext(inames_strtable);
+    key = iupTableNext(inames_ihtable);
   }
 
+  iupTableDestroy(ih_found);
+
   count = i;
   for (i = 0; i < count; i++)
   {
@@ -140,23 +157,38 @@ IUP_SDK_API void iupNamesDestroyHandlesSelected(const char* attrib_name, void* a
   free(ih_array);
 }
 
+void iupNamesDestroyHandles(void)
+{
+  iNamesDestroyHandles(NULL, NULL);
+}
+
+IUP_SDK_API void iupNamesDestroyHandlesSelected(const char* attrib_name, void* attrib_value)
+{
+  iNamesDestroyHandles(attrib_name, attrib_value);
+}
+
 void iupRemoveNames(Ihandle* ih)
 {
   /* called from IupDestroy */
-  char *name;
+  Iarray* names_array;
 
   /* ih here is an Ihandle* */
 
-  /* check for at least one name (the last one set) */
-  name = iupAttribGetHandleName(ih);
-  if (name)
-    iupTableRemove(inames_strtable, name);
+  /* remove all its names */
+  names_array = (Iarray*)iupTableGet(inames_ihtable, (char*)ih);
+  if (names_array)
+  {
+    char** names = (char**)iupArrayGetData(names_array);
+    int i, count = iupArrayCount(names_array);
+    for (i = 0; i < count; i++)
+      iupTableRemove(inames_strtable, names[i]);
+
+    iupTableRemove(inames_ihtable, (char*)ih);
+    iNamesDestroyArray(names_array);
+  }
 
   /* clear also the NAME attribute */
   iupBaseSetNameAttrib(ih, NULL);
-
-  /* Do NOT search for other names, this would implying in checking in all store names.
-     So, some names may have left invalid on the handle names database. */
 }
 
 IUP_API Ihandle *IupGetHandle(const char *name)
@@ -168,41 +200,55 @@ IUP_API Ihandle *IupGetHandle(const char *name)
 
 int iupNamesFindAll(Ihandle *ih, char** names, int n)
 {
-  int i = 0;
-  char* name = iupTableFirst(inames_strtable);
-  while (name)
+  char** ih_names;
+  int i, count;
+  Iarray* names_array = (Iarray*)iupTableGet(inames_ihtable, (char*)ih);
+  if (!names_array)
+    return 0;
+
+  ih_names = (char**)iupArrayGetData(names_array);
+  count = iupArrayCount(names_array);
+  if (n != 0 && n != -1 && n < count)
+    count = n;
+
+  if (names)
   {
-    if ((Ihandle*)iupTableGetCurr(inames_strtable) == ih)
-    {
-      if (names)
-        names[i] = name;
-
-      i++;
-      if (i == n && n != 0 && n != -1)
-        break;
-    }
-
-    name = iupTableNext(inames_strtable);
+    for (i = 0; i < count; i++)
+      names[i] = ih_names[i];
   }
 
-  return i;
+  return count;
 }
 
 static char* iNameFindHandle(Ihandle *ih)
 {
-  /* search for a name */
-  char* name = iupTableFirst(inames_strtable);
-  while (name)
+  /* return the first name, if any */
+  Iarray* names_array = (Iarray*)iupTableGet(inames_ihtable, (char*)ih);
+  if (names_array)
   {
-    /* return the first one found */
-    if ((Ihandle*)iupTableGetCurr(inames_strtable) == ih)
-      return name;
-
-    name = iupTableNext(inames_strtable);
+    char** names = (char**)iupArrayGetData(names_array);
+    return names[0];
   }
   return NULL;
 }
 
+static void iNameUpdateCache(Ihandle* ih, const char* name)
+{
+  /* clear the name from the cache if it is a valid handle */
+  if (iupObjectCheck(ih))
+  {
+    char* last_name = iupAttribGet(ih, "HANDLENAME");
+    if (last_name && iupStrEqual(last_name, name))
+    {
+      iupAttribSet(ih, "HANDLENAME", NULL);  /* remove also from the cache */
+
+      last_name = iNameFindHandle(ih);
+      if (last_name)
+        iupAttribSetStr(ih, "HANDLENAME", last_name);  /* if found another name save it in the cache */
+    }
+  }
+}
+
 IUP_API Ihandle* IupSetHandle(const char *name, Ihandle *ih)
 {
   Ihandle *old_ih;
@@ -217,32 +263,28 @@ IUP_API Ihandle* IupSetHandle(const char *name, Ihandle *ih)
 
   old_ih = iupTableGet(inames_strtable, name);
 
+  /* the name is moving to another handle, or being removed */
+  if (old_ih && old_ih != ih)
+  {
+    iNamesRemove(old_ih, name);
+
+    if (!ih)
+      iupTableRemove(inames_strtable, name);
+
+    iNameUpdateCache(old_ih, name);
+  }
+
   if (ih != NULL)
   {
     iupTableSet(inames_strtable, name, ih, IUPTABLE_POINTER);
 
+    if (old_ih != ih)
+      iNamesAdd(ih, name);
+
     /* save the name in the cache if it is a valid handle */
     if (iupObjectCheck(ih))
       iupAttribSetStr(ih, "HANDLENAME", name);
   }
-  else
-  {
-    iupTableRemove(inames_strtable, name);
-
-    /* clear the name from the cache if it is a valid handle */
-    if (iupObjectCheck(old_ih))
-    {
-      char* last_name = iupAttribGet(old_ih, "HANDLENAME");
-      if (last_name && iupStrEqual(last_name, name))
-      {
-        iupAttribSet(old_ih, "HANDLENAME", NULL);  /* remove also from the cache */
-
-        last_name = iNameFindHandle(old_ih);
-        if (last_name)
-          iupAttribSetStr(old_ih, "HANDLENAME", last_name);  /* if found another name save it in the cache */
-      }
-    }
-  }
 
   return old_ih;
 }
@@ -30,8 +30,9 @@ static Ihandle* iHandleCreate(void)
   ih->sig[3] = 0;
 
   ih->serial = -1;
+  ih->flags = IUP_LAYOUT_DIRTY;
 
-  ih->attrib = iupTableCreate(IUPTABLE_STRINGINDEXED);
+  ih->attrib = iupTableCreate(IUPTABLE_ATOMINDEXED);
 
   return ih;
 }
@@ -39,6 +40,7 @@ static Ihandle* iHandleCreate(void)
 static void iHandleDestroy(Ihandle* ih)
 {
   iupTableDestroy(ih->attrib);
+  if (ih->childarray) free(ih->childarray);
   memset(ih, 0, sizeof(Ihandle));
   free(ih);
 }
@@ -107,7 +107,11 @@ enum Iflags {
   IUP_FLOATING_IGNORE  = 0x02,   /**< is a floating element. FLOATING=Ignore. Do not compute layout. */
   IUP_MAXSIZE     = 0x04,   /**< has the MAXSIZE attribute set */
   IUP_MINSIZE     = 0x08,   /**< has the MAXSIZE attribute set */
-  IUP_INTERNAL    = 0x10    /**< it is an internal element of the container */
+  IUP_INTERNAL    = 0x10,   /**< it is an internal element of the container */
+  IUP_LAYOUT_DIRTY    = 0x20,  /**< natural size must be computed again, also set in all the parents. See \ref iupLayoutSetDirty */
+  IUP_LAYOUT_CHILDREN = 0x40,  /**< natural size was computed again, children size and position must be computed again */
+  IUP_LAYOUT_CHANGED  = 0x80,  /**< size or position changed, native element must be updated */
+  IUP_LAYOUT_VISITED  = 0x100  /**< position was computed, checked by the native update */
 };
 
 
@@ -130,6 +134,13 @@ struct Ihandle_
   Ihandle* firstchild;   /**< first child control in the hierarchy tree */
   Ihandle* brother;      /**< next control inside parent */
   IcontrolData* data;    /**< private control data. automatically freed if not NULL in destroy */
+  Ihandle* lastchild;    /**< last child control, maintained by the child tree functions */
+  int childcount;        /**< number of children, maintained by the child tree functions */
+  Ihandle** childarray;  /**< children indexed by position, built only when needed by IupGetChild and IupGetChildPos */
+  int cachedwidth, cachedheight;   /**< natural size from the last computation, used while IUP_LAYOUT_DIRTY is not set */
+  int cacheduserwidth, cacheduserheight; /**< user size when the natural size was cached, if changed the cache is ignored */
+  int cachedexpand;      /**< expand from the last computation */
+  int layoutx, layouty, layoutwidth, layoutheight; /**< position and size from the last computation, used to detect changes */
 };
 
 
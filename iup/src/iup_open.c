@@ -119,4 +119,6 @@ IUP_API void IupClose(void)
   iupNamesFinish();         /* release names hash table */
 
   iupStrGetMemory(-1); /* Frees internal buffer */
+
+  iupAtomFinish();     /* release attribute names, after all tables are destroyed */
 }
@@ -88,6 +88,9 @@ IUP_API int IupMap(Ihandle* ih)
     return IUP_ERROR;
   }
 
+  /* the native element must receive its size and position */
+  iupLayoutSetDirty(ih);
+
   /* update FONT, must be before several other attributes, so we do it here */
   if (ih->iclass->nativetype != IUP_TYPEVOID &&
       ih->iclass->nativetype != IUP_TYPEIMAGE &&
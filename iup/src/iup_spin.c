@@ -163,10 +163,8 @@ static int iSpinCreateMethod(Ihandle* ih, void** params)
   IupSetCallback(bt_down, "K_cSP",     (Icallback) iSpinK_cSP);
 
   /* manually add the buttons as a children */
-  ih->firstchild = bt_up;
-  bt_up->parent = ih;
-  bt_up->brother = bt_down;
-  bt_down->parent = ih;
+  iupChildTreeAppend(ih, bt_up);
+  iupChildTreeAppend(ih, bt_down);
   
   /* avoid inheritance from parent */
   IupSetAttribute(ih, "GAP",    "0");
@@ -329,137 +329,377 @@ static char *iStrDupUntilNoCase(char **str, char sep)
   }
 }
 
-IUP_SDK_API char *iupStrGetLargeMem(int *size)
+/* The returned buffers are stored per thread.
+   If the compiler does not support thread local storage,
+   the buffers are shared by all threads as before. */
+#if defined(_MSC_VER)
+#define ISTR_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__)
+#define ISTR_THREAD_LOCAL __thread
+#endif
+
+#ifdef ISTR_THREAD_LOCAL
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#else
+#define ISTR_THREAD_LOCAL
+#define ISTR_SHARED_BUFFERS
+#endif
+
+#define ISTR_MAX_BUFFERS 50
+#define ISTR_SMALL_MAX_BUFFERS 100
+#define ISTR_SMALL_SIZE 80  /* maximum for iupStrReturnFloat and iupStrReturnDouble */
+#define ISTR_LARGE_MAX_BUFFERS 10
+#define ISTR_LARGE_SIZE SHRT_MAX
+#define ISTR_MIN_SIZE 64
+#define ISTR_ARENA_MIN_SIZE 4096
+
+typedef struct _IstrArenaBlock
 {
-#define LARGE_MAX_BUFFERS 10
-#define LARGE_SIZE SHRT_MAX
-  static char buffers[LARGE_MAX_BUFFERS][LARGE_SIZE];
-  static int buffers_index = -1;
-  char* ret_str;
+  struct _IstrArenaBlock* next;
+  int size, used;
+  /* followed by the block data */
+}
+IstrArenaBlock;
+
+typedef struct _IstrBuffers
+{
+  char* buffers[ISTR_MAX_BUFFERS];
+  int buffers_sizes[ISTR_MAX_BUFFERS];
+  int buffers_index;
+
+  char small_buffers[ISTR_SMALL_MAX_BUFFERS][ISTR_SMALL_SIZE];
+  int small_index;
+
+  char* large_buffers[ISTR_LARGE_MAX_BUFFERS];
+  int large_index;
+
+  IstrArenaBlock* arena;  /* the current block is the first, and the largest */
+  int arena_level;
+}
+IstrBuffers;
+
+/* only the pointer is thread local, the buffers are allocated when first used */
+static ISTR_THREAD_LOCAL IstrBuffers* istr_buffers = NULL;
 
-  /* init buffers array */
-  if (buffers_index == -1)
+static void iStrFreeBuffers(IstrBuffers* buffers)
+{
+  int i;
+
+  for (i = 0; i < ISTR_MAX_BUFFERS; i++)
   {
-    int i;
-    /* clear all memory */
-    for (i=0; i<LARGE_MAX_BUFFERS; i++)
-      memset(buffers[i], 0, sizeof(char)*LARGE_SIZE);
+    if (buffers->buffers[i])
+      free(buffers->buffers[i]);
+  }
 
-    buffers_index = 0;
+  for (i = 0; i < ISTR_LARGE_MAX_BUFFERS; i++)
+  {
+    if (buffers->large_buffers[i])
+      free(buffers->large_buffers[i]);
   }
 
-  /* DON'T clear memory everytime because the buffer is too large */
-  ret_str = buffers[buffers_index];
-  ret_str[0] = 0;
+  while (buffers->arena)
+  {
+    IstrArenaBlock* next = buffers->arena->next;
+    free(buffers->arena);
+    buffers->arena = next;
+  }
 
-  buffers_index++;
-  if (buffers_index == LARGE_MAX_BUFFERS)
-    buffers_index = 0;
+  free(buffers);
+}
 
-  if (size) *size = LARGE_SIZE;
-  return ret_str;
-#undef LARGE_MAX_BUFFERS
-#undef LARGE_SIZE 
+/* The thread local pointer is also stored in a thread specific key,
+   so the buffers are released when the thread ends. */
+#if defined(ISTR_SHARED_BUFFERS)
+#define iStrSetThreadBuffers(_buffers)
+#elif defined(WIN32)
+static INIT_ONCE istr_key_once = INIT_ONCE_STATIC_INIT;
+static DWORD istr_key = FLS_OUT_OF_INDEXES;
+
+static void WINAPI iStrThreadEnd(void* buffers)
+{
+  if (buffers)
+  {
+    iStrFreeBuffers((IstrBuffers*)buffers);
+    istr_buffers = NULL;
+  }
 }
 
-static char* iupStrGetSmallMem(void)
+static BOOL CALLBACK iStrCreateKey(PINIT_ONCE once, void* param, void** context)
 {
-#define SMALL_MAX_BUFFERS 100
-#define SMALL_SIZE 80  /* maximum for iupStrReturnFloat and iupStrReturnDouble */
-  static char buffers[SMALL_MAX_BUFFERS][SMALL_SIZE];
-  static int buffers_index = -1;
-  char* ret_str;
+  (void)once; (void)param; (void)context;
+  istr_key = FlsAlloc(iStrThreadEnd);
+  return TRUE;
+}
 
-  /* init buffers array */
-  if (buffers_index == -1)
+static void iStrSetThreadBuffers(IstrBuffers* buffers)
+{
+  InitOnceExecuteOnce(&istr_key_once, iStrCreateKey, NULL, NULL);
+  if (istr_key != FLS_OUT_OF_INDEXES)
+    FlsSetValue(istr_key, buffers);
+}
+#else
+static pthread_once_t istr_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t istr_key;
+static int istr_key_created = 0;
+
+static void iStrThreadEnd(void* buffers)
+{
+  if (buffers)
   {
-    int i;
-    /* clear all memory */
-    for (i = 0; i<SMALL_MAX_BUFFERS; i++)
-      memset(buffers[i], 0, sizeof(char)*SMALL_SIZE);
-    
-    buffers_index = 0;
+    iStrFreeBuffers((IstrBuffers*)buffers);
+    istr_buffers = NULL;
   }
+}
+
+static void iStrCreateKey(void)
+{
+  istr_key_created = pthread_key_create(&istr_key, iStrThreadEnd) == 0;
+}
+
+static void iStrSetThreadBuffers(IstrBuffers* buffers)
+{
+  pthread_once(&istr_key_once, iStrCreateKey);
+  if (istr_key_created)
+    pthread_setspecific(istr_key, buffers);
+}
+#endif
+
+static IstrBuffers* iStrGetBuffers(void)
+{
+  if (!istr_buffers)
+  {
+    istr_buffers = (IstrBuffers*)calloc(1, sizeof(IstrBuffers));
+    if (istr_buffers)
+      iStrSetThreadBuffers(istr_buffers);
+  }
+  return istr_buffers;
+}
+
+static void iStrReleaseBuffers(void)
+{
+  if (!istr_buffers)
+    return;
+
+  iStrSetThreadBuffers(NULL);
+  iStrFreeBuffers(istr_buffers);
+  istr_buffers = NULL;
+}
+
+static char* iStrArenaAlloc(IstrBuffers* buffers, int size)
+{
+  IstrArenaBlock* block = buffers->arena;
+  char* ret_str;
 
-  /* always clear memory before returning a new buffer */
-  memset(buffers[buffers_index], 0, SMALL_SIZE);
-  ret_str = buffers[buffers_index];
+  /* keep the next allocation aligned */
+  size = (size + (int)sizeof(double) - 1) & ~((int)sizeof(double) - 1);
 
-  buffers_index++;
-  if (buffers_index == SMALL_MAX_BUFFERS)
-    buffers_index = 0;
+  if (!block || block->used + size > block->size)
+  {
+    /* the block size grows geometrically */
+    int block_size = block? 2 * block->size: ISTR_ARENA_MIN_SIZE;
+    while (block_size < size)
+      block_size *= 2;
+
+    block = (IstrArenaBlock*)malloc(sizeof(IstrArenaBlock) + block_size);
+    if (!block)
+      return NULL;
 
+    block->size = block_size;
+    block->used = 0;
+    block->next = buffers->arena;
+    buffers->arena = block;
+  }
+
+  ret_str = (char*)(block + 1) + block->used;
+  block->used += size;
   return ret_str;
-#undef SMALL_MAX_BUFFERS
-#undef SMALL_SIZE 
 }
 
-IUP_SDK_API char *iupStrGetMemory(int size)
+IUP_SDK_API void iupStrArenaBegin(void)
 {
-#define MAX_BUFFERS 50
-  static char* buffers[MAX_BUFFERS];
-  static int buffers_sizes[MAX_BUFFERS];
-  static int buffers_index = -1;
+  IstrBuffers* buffers = iStrGetBuffers();
+  if (buffers)
+    buffers->arena_level++;
+}
 
-  if (size == -1) /* Frees memory */
+IUP_SDK_API void iupStrArenaEnd(void)
+{
+  IstrBuffers* buffers = istr_buffers;
+  if (!buffers || buffers->arena_level == 0)
+    return;
+
+  buffers->arena_level--;
+  if (buffers->arena_level == 0 && buffers->arena)
   {
-    int i;
-    buffers_index = -1;
-    for (i = 0; i < MAX_BUFFERS; i++)
+    /* release everything in one step,
+       but keep the largest block for the next scope */
+    IstrArenaBlock* block = buffers->arena->next;
+    while (block)
     {
-      if (buffers[i]) 
-      {
-        free(buffers[i]);
-        buffers[i] = NULL;
-      }
-      buffers_sizes[i] = 0;
+      IstrArenaBlock* next = block->next;
+      free(block);
+      block = next;
     }
+
+    buffers->arena->next = NULL;
+    buffers->arena->used = 0;
+  }
+}
+
+IUP_SDK_API char *iupStrGetLargeMem(int *size)
+{
+  IstrBuffers* buffers = iStrGetBuffers();
+  char* ret_str;
+
+  if (!buffers)
     return NULL;
+
+  if (buffers->arena_level)
+    ret_str = iStrArenaAlloc(buffers, ISTR_LARGE_SIZE);
+  else
+  {
+    /* allocated only once, the size is fixed */
+    if (!buffers->large_buffers[buffers->large_index])
+      buffers->large_buffers[buffers->large_index] = (char*)malloc(ISTR_LARGE_SIZE);
+
+    ret_str = buffers->large_buffers[buffers->large_index];
+
+    buffers->large_index++;
+    if (buffers->large_index == ISTR_LARGE_MAX_BUFFERS)
+      buffers->large_index = 0;
   }
+
+  if (!ret_str)
+    return NULL;
+
+  /* DON'T clear memory because the buffer is too large */
+  ret_str[0] = 0;
+
+  if (size) *size = ISTR_LARGE_SIZE;
+  return ret_str;
+}
+
+static char* iupStrGetSmallMem(void)
+{
+  IstrBuffers* buffers = iStrGetBuffers();
+  char* ret_str;
+
+  if (!buffers)
+    return NULL;
+
+  if (buffers->arena_level)
+    ret_str = iStrArenaAlloc(buffers, ISTR_SMALL_SIZE);
   else
   {
-    char* ret_str;
+    ret_str = buffers->small_buffers[buffers->small_index];
 
-    /* init buffers array */
-    if (buffers_index == -1)
-    {
-      memset(buffers, 0, sizeof(char*)*MAX_BUFFERS);
-      memset(buffers_sizes, 0, sizeof(int)*MAX_BUFFERS);
-      buffers_index = 0;
-    }
+    buffers->small_index++;
+    if (buffers->small_index == ISTR_SMALL_MAX_BUFFERS)
+      buffers->small_index = 0;
+  }
 
-    /* first alocation */
-    if (!(buffers[buffers_index]))
-    {
-      buffers_sizes[buffers_index] = size+1;
-      buffers[buffers_index] = (char*)malloc(buffers_sizes[buffers_index]);
-    }
-    else if (buffers_sizes[buffers_index] < size+1)  /* reallocate if necessary */
+  /* always filled with sprintf, no need to clear */
+  if (ret_str)
+    ret_str[0] = 0;
+  return ret_str;
+}
+
+/* Returns a buffer with size+1 bytes.
+   When clear is 0 only the first byte is set to 0,
+   used when the caller always writes a complete string. */
+static char* iStrGetMemory(int size, int clear)
+{
+  IstrBuffers* buffers = iStrGetBuffers();
+  char* ret_str;
+
+  if (!buffers)
+    return NULL;
+
+  if (buffers->arena_level)
+    ret_str = iStrArenaAlloc(buffers, size + 1);
+  else
+  {
+    int index = buffers->buffers_index;
+
+    /* grow geometrically, so a buffer is not reallocated for every small increment */
+    if (buffers->buffers_sizes[index] < size + 1)
     {
-      buffers_sizes[buffers_index] = size+1;
-      buffers[buffers_index] = (char*)realloc(buffers[buffers_index], buffers_sizes[buffers_index]);
+      int new_size = buffers->buffers_sizes[index]? buffers->buffers_sizes[index]: ISTR_MIN_SIZE;
+      while (new_size < size + 1)
+        new_size *= 2;
+
+      /* the previous contents are not preserved */
+      if (buffers->buffers[index])
+        free(buffers->buffers[index]);
+
+      buffers->buffers[index] = (char*)malloc(new_size);
+      buffers->buffers_sizes[index] = buffers->buffers[index]? new_size: 0;
     }
 
-    /* always clear memory before returning a new buffer */
-    memset(buffers[buffers_index], 0, buffers_sizes[buffers_index]);
-    ret_str = buffers[buffers_index];
+    ret_str = buffers->buffers[index];
 
-    buffers_index++;
-    if (buffers_index == MAX_BUFFERS)
-      buffers_index = 0;
+    buffers->buffers_index++;
+    if (buffers->buffers_index == ISTR_MAX_BUFFERS)
+      buffers->buffers_index = 0;
+  }
 
-    return ret_str;
+  if (!ret_str)
+    return NULL;
+
+  /* clear only the requested size, not the full buffer */
+  if (clear)
+    memset(ret_str, 0, size + 1);
+  else
+    ret_str[0] = 0;
+
+  return ret_str;
+}
+
+IUP_SDK_API char *iupStrGetMemory(int size)
+{
+  if (size == -1) /* Frees memory */
+  {
+    iStrReleaseBuffers();
+    return NULL;
   }
-#undef MAX_BUFFERS
+
+  return iStrGetMemory(size, 1);
 }
 
+#define ISTR_STRF_MAX_SIZE 10240
+
 IUP_SDK_API char* iupStrReturnStrf(const char* format, ...)
 {
-  char* str = iupStrGetMemory(10240);
+  char buffer[ISTR_SMALL_SIZE];
+  char* str;
+  int len;
   va_list arglist;
+
+  /* format first in a local buffer, so only the actual length is allocated */
   va_start(arglist, format);
-  vsnprintf(str, 10240, format, arglist);
+  len = vsnprintf(buffer, ISTR_SMALL_SIZE, format, arglist);
   va_end(arglist);
+  if (len < 0)
+    return NULL;
+  if (len > ISTR_STRF_MAX_SIZE)
+    len = ISTR_STRF_MAX_SIZE;  /* truncated */
+
+  str = iStrGetMemory(len, 0);
+  if (!str)
+    return NULL;
+
+  if (len < ISTR_SMALL_SIZE)
+    memcpy(str, buffer, len + 1);
+  else
+  {
+    va_start(arglist, format);
+    vsnprintf(str, len + 1, format, arglist);
+    va_end(arglist);
+  }
   return str;
 }
 
@@ -468,7 +708,9 @@ IUP_SDK_API char* iupStrReturnStr(const char* str)
   if (str)
   {
     int size = (int)strlen(str)+1;
-    char* ret_str = iupStrGetMemory(size);
+    char* ret_str = iStrGetMemory(size, 0);
+    if (!ret_str)
+      return NULL;
     memcpy(ret_str, str, size);
     return ret_str;
   }
@@ -544,7 +786,9 @@ IUP_SDK_API char* iupStrReturnStrStr(const char *str1, const char *str2, char se
     int size1=0, size2=0;
     if (str1) size1 = (int)strlen(str1);
     if (str2) size2 = (int)strlen(str2);
-    ret_str = iupStrGetMemory(size1+size2+2);
+    ret_str = iStrGetMemory(size1+size2+2, 0);
+    if (!ret_str)
+      return NULL;
     if (str1 && size1) memcpy(ret_str, str1, size1);
     ret_str[size1] = sep;
     if (str2 && size2) memcpy(ret_str+size1+1, str2, size2);
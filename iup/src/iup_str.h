@@ -105,17 +105,32 @@ IUP_SDK_API void iupStrCopyN(char* dst_str, int dst_max_size, const char* src_st
 
 
 
-/** Returns a buffer with the specified size+1. \n
- * The buffer is resused after 50 calls. It must NOT be freed.
- * Use size=-1 to free all the internal buffers.
+/** Returns a buffer with the specified size+1, filled with zeros. \n
+ * The buffer is resused after 50 calls. It must NOT be freed. \n
+ * Buffers are stored per thread, so they can be used from worker threads,
+ * they are released when the thread ends.
+ * Use size=-1 to free all the internal buffers of the current thread.
  * \ingroup str */
 IUP_SDK_API char* iupStrGetMemory(int size);
 
 /** Returns a very large buffer to be used in unknown size string construction.
- * Use snprintf or vsnprintf with the given size.
+ * Use snprintf or vsnprintf with the given size. \n
+ * The buffer is resused after 10 calls. It is NOT filled with zeros.
  * \ingroup str */
 IUP_SDK_API char* iupStrGetLargeMem(int *size);
 
+/** Starts a scope where all the buffers returned by \ref iupStrGetMemory,
+ * \ref iupStrGetLargeMem and the iupStrReturn* functions in the current thread
+ * are NOT reused, they remain valid until \ref iupStrArenaEnd.
+ * Use it around loops that call many attribute getters. Scopes can be nested.
+ * \ingroup str */
+IUP_SDK_API void iupStrArenaBegin(void);
+
+/** Ends the scope started by \ref iupStrArenaBegin.
+ * At the outermost scope all its buffers are released at once.
+ * \ingroup str */
+IUP_SDK_API void iupStrArenaEnd(void);
+
 
 
 /** Converts a string into lower case. Can be used in-place. \n
@@ -161,7 +176,8 @@ IUP_SDK_API int iupStrIsAscii(const char* str);
 
 /** Returns combined values in a formatted string using \ref iupStrGetMemory.
  * This is not supposed to be used for very large strings,
- * just for combinations of numeric data or constant strings.
+ * just for combinations of numeric data or constant strings, it is truncated at 10240 characters.
+ * Returns NULL if the memory could not be allocated.
  * \ingroup str */
 IUP_SDK_API char* iupStrReturnStrf(const char* format, ...);
 
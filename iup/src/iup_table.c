@@ -1,6 +1,7 @@
 /** \file
  * \brief iupTable functions.
- * Implementation by Danny Reinhold and Antonio Scuri. 
+ * Implementation by Danny Reinhold and Antonio Scuri.
+ * Open addressing version with full key verification.
  *
  * See Copyright Notice in "iup.h"
  */
@@ -10,83 +11,89 @@
 #include <string.h>
 #include <memory.h>
 
-#include "iup_export.h"
+#include "iup.h"
 #include "iup_table.h"
 #include "iup_str.h"
 #include "iup_assert.h"
 
 /* #define DEBUGTABLE 1 */
 
-/* Adjust these parameters for optimal performance and memory usage */
+/* Adjust these parameters for optimal performance and memory usage.
+   Sizes must be a power of 2, so the hash can be masked instead of divided. */
 static const unsigned int itable_maxTableSizeIndex = 8;
-static const unsigned int itable_hashTableSize[] = { 31, 101, 401, 1601, 4001, 8009, 16001, 32003, 64007 };
-static const unsigned int itable_resizeLimit = 2;
-static const unsigned int itable_itemGrow = 5;
+static const unsigned int itable_hashTableSize[] = { 16, 64, 256, 1024, 4096, 8192, 16384, 32768, 65536 };
+
+/* Maximum load (used + removed slots) is 3/4 of the table size.
+   After a resize the load is at most 1/2. */
+#define ITABLE_FULL(_used, _size) ((_used)*4 >= (_size)*3)
 
 /* Iteration context.
  */
 typedef struct _ItableContext
 {
   unsigned int entryIndex;  /* index at the Itable::entries array */
-  unsigned int itemIndex;   /* index at the ItableEntry::items array */
 } ItableContext;
 
-/* A key of an item.
- * To avoid lots of string comparisons we store
- * a keyindex as an integer.
- * To find a key in an item list we only have to
- * do integer comparisons.
- * Additionally the key itself is stored in
- * keyStr. In a string indexed hashtable this is
- * a duplicated string, in a pointer indexed hash table
- * this is simply the pointer (in this case keyIndex
- * and keyStr are equal).
-*/
-typedef struct _ItableKey
-{
-  unsigned long keyIndex;  /* the secondary hash number */
-  const char   *keyStr;
-}
-ItableKey;
-
-/* An item in the hash table.
- * Such an item is stored in the item list of
- * an entry.
- */
-typedef struct _ItableItem
+/* An atom is stored after a header with its hash number,
+   so the hash of an atom is never computed again.
+   Names with an id ("NAME1", "NAME1:2", "NAME*:2", "NAME1:*") also store
+   the atom of the name without the id and the id numbers. */
+typedef struct _IatomHeader
 {
-  Itable_Types  itemType;
-  ItableKey     key;
-  void*         value;
+  const char*  base;  /* atom without the id, or the atom itself */
+  int          lin, col;  /* IUPTABLE_NOID if not used, IUP_INVALID_ID for "*" */
+  unsigned int hash;
+  unsigned int tag;  /* IATOM_TAG, to detect strings that are not atoms */
 }
-ItableItem;
+IatomHeader;
+
+#define IATOM_TAG 0x41544F4DU  /* "ATOM" */
+
+#define iAtomHeader(_atom) (((const IatomHeader*)(_atom)) - 1)
+#define iAtomHash(_atom) (iAtomHeader(_atom)->hash)
+
+/* "*" in a name id */
+#define ITABLE_ANYID IUP_INVALID_ID
+#define iTableIsValidId(_id) ((_id) >= 0 || (_id) == ITABLE_ANYID)
+
+/* Marks an entry that was removed.
+   The probe sequence must continue over it, but it can be reused by an insert. */
+static const char itable_removedKey[1] = "";
+#define ITABLE_REMOVED ((const char*)itable_removedKey)
 
 /* An entry in the hash table.
- * An entry is chosen by an index in the hash table
- * and contains a list of items.
- * The number of items in this list is stored
- * in nextItemIndex.
- * size is the current size of the items array.
+ * The key is stored together with its full hash number.
+ * In an atom indexed hashtable the key is the atom of the name
+ * without the id, plus the id numbers,
+ * so names with ids do not need to be formatted or stored.
+ * To find a key we compare first the hash numbers,
+ * then the key pointers, and only then the strings.
+ * In a string indexed hashtable keyStr is a
+ * duplicated string, in a pointer indexed hash table
+ * this is simply the pointer.
+ * keyStr is NULL for an empty entry.
  */
 typedef struct _ItableEntry
 {
-  unsigned int  nextItemIndex;
-  unsigned int  itemsSize;
-  ItableItem*   items;
+  unsigned int  keyHash;
+  Itable_Types  itemType;
+  const char   *keyStr;
+  int           keyLin, keyCol;  /* IUPTABLE_NOID if not used */
+  void         *value;
+  char         *keyName;  /* full name of a key with ids, created only by the iteration */
 }
 ItableEntry;
 
 
 /* A hash table.
- * entries is an array of entries. Select an
- * entry by its index.
- * size is the number of entries in the hash table...
+ * entries is a contiguous array of entriesSize entries (a power of 2).
+ * Collisions are resolved with linear probing.
  */
 struct _Itable
 {
   unsigned int         entriesSize;
-  unsigned int         numberOfEntries;
-  unsigned int         tableSizeIndex;  /* index into itable_hashTableSize array */
+  unsigned int         numberOfEntries;  /* used entries */
+  unsigned int         numberOfRemoved;  /* removed entries, still part of probe sequences */
   Itable_IndexTypes    indexType;  /* type of the index: string or pointer. */
   ItableEntry          *entries;
   ItableContext        context;
@@ -95,27 +102,29 @@ struct _Itable
 
 /* Prototypes of private functions */
 
-static void iTableFreeItemArray(Itable_IndexTypes indexType, unsigned int nextFreeIndex, 
-                                                            ItableItem *items);
-static unsigned int iTableGetEntryIndex(Itable *it, const char *key, unsigned long *keyIndex);
-static unsigned int iTableFindItem(Itable *it, const char *key, ItableEntry **entry, 
-                                                          unsigned int *itemIndex,
-                                                          unsigned long *keyIndex);
-static unsigned int iTableResize(Itable *it);
-static void iTableAdd(Itable *it, ItableKey *key, void *value, Itable_Types itemType);
-static void iTableUpdateArraySize(ItableEntry *entry);   
+static unsigned int iTableHashStr(const char *key, unsigned int len);
+static unsigned int iTableHashKey(Itable *it, const char *key);
+static const char* iTableGetKey(Itable *it, const char *key, int create, int *lin, int *col, unsigned int *keyHash);
+static const char* iTableGetKeyId(Itable *it, char* nameid, const char *name, int create, int *lin, int *col, unsigned int *keyHash);
+static const char* iTableGetKeyAtom(const char *atom, int *lin, int *col, unsigned int *keyHash);
+static char* iTableGetEntryKey(ItableEntry *entry);
+static void iTableSetItem(Itable *it, const char *key, int lin, int col, unsigned int keyHash, void *value, Itable_Types itemType);
+static int iTableFindItem(Itable *it, const char *key, int lin, int col, unsigned int keyHash, unsigned int *entryIndex);
+static int iTableResize(Itable *it);
+static void iTableFreeEntry(Itable *it, ItableEntry *entry);
+static unsigned int iTableNextUsed(Itable *it, unsigned int entryIndex);
 
 #ifdef DEBUGTABLE
 static void iTableShowStatistics(Itable *it);
-static void iTableCheckDuplicated(ItableItem *item, unsigned int nextItemIndex, 
-                                              const char *key, 
-                                              unsigned long keyIndex);
 #endif
 
+#define iTableIsUsed(_entry) ((_entry)->keyStr && (_entry)->keyStr != ITABLE_REMOVED)
+#define iTableCheckContext(_it) ((_it)->context.entryIndex != (unsigned int)-1)
+
 
 IUP_SDK_API Itable *iupTableCreate(Itable_IndexTypes indexType)
 {
-  return iupTableCreateSized(indexType, 1);  /* 101 shows to be a better start for IUP */
+  return iupTableCreateSized(indexType, 1);  /* 64 shows to be a better start for IUP */
 }
 
 
@@ -129,12 +138,12 @@ IUP_SDK_API Itable *iupTableCreateSized(Itable_IndexTypes indexType, unsigned in
   if (initialSizeIndex > itable_maxTableSizeIndex)
     initialSizeIndex = itable_maxTableSizeIndex;
 
-  it->entriesSize    = itable_hashTableSize[initialSizeIndex];
-  it->tableSizeIndex  = initialSizeIndex;
+  it->entriesSize     = itable_hashTableSize[initialSizeIndex];
   it->numberOfEntries = 0;
+  it->numberOfRemoved = 0;
   it->indexType       = indexType;
 
-  it->entries = (ItableEntry *)malloc(it->entriesSize * sizeof(ItableEntry));
+  it->entries = (ItableEntry *)calloc(it->entriesSize, sizeof(ItableEntry));
   iupASSERT(it->entries!=NULL);
   if (!it->entries)
   {
@@ -142,10 +151,7 @@ IUP_SDK_API Itable *iupTableCreateSized(Itable_IndexTypes indexType, unsigned in
     return 0;
   }
 
-  memset(it->entries, 0, it->entriesSize * sizeof(ItableEntry));
-
   it->context.entryIndex = (unsigned int)-1;
-  it->context.itemIndex = (unsigned int)-1;
 
   return it;
 }
@@ -157,22 +163,22 @@ IUP_SDK_API void iupTableClear(Itable *it)
   if (!it)
     return;
 
-  for (i = 0; i < it->entriesSize; i++)
+  if (it->numberOfEntries)
   {
-    ItableEntry *entry = &(it->entries[i]);
-    if (entry->items)
+    for (i = 0; i < it->entriesSize; i++)
     {
-      iTableFreeItemArray(it->indexType, entry->nextItemIndex, entry->items);
-      entry->items = NULL;
+      ItableEntry *entry = &(it->entries[i]);
+      if (iTableIsUsed(entry))
+        iTableFreeEntry(it, entry);
     }
   }
 
   it->numberOfEntries = 0;
+  it->numberOfRemoved = 0;
 
   memset(it->entries, 0, it->entriesSize * sizeof(ItableEntry));
 
   it->context.entryIndex = (unsigned int)-1;
-  it->context.itemIndex = (unsigned int)-1;
 }
 
 IUP_SDK_API void iupTableDestroy(Itable *it)
@@ -210,64 +216,102 @@ IUP_SDK_API void iupTableSetFunc(Itable *it, const char *key, Ifunc func)
 
 IUP_SDK_API void iupTableSet(Itable *it, const char *key, void *value, Itable_Types itemType)
 {
-  unsigned int  itemIndex,
-                itemFound;
-  unsigned long keyIndex;
-  ItableEntry  *entry;
-  ItableItem   *item;
-  void         *v;
+  unsigned int keyHash;
+  int lin, col;
 
   iupASSERT(it!=NULL);
   iupASSERT(key!=NULL);
   if (!it || !key || !value)
     return;
 
-  itemFound = iTableFindItem(it, key, &entry, &itemIndex, &keyIndex);
+  key = iTableGetKey(it, key, 1, &lin, &col, &keyHash);
+  if (key)
+    iTableSetItem(it, key, lin, col, keyHash, value, itemType);
+}
 
-#ifdef DEBUGTABLE
-  if (it->indexType == IUPTABLE_STRINGINDEXED)
-    iTableCheckDuplicated(&(entry->items[0]), entry->nextItemIndex, key, keyIndex);
-#endif
+IUP_SDK_API void iupTableSetAtom(Itable *it, const char *atom, void *value, Itable_Types itemType)
+{
+  unsigned int keyHash;
+  int lin, col;
 
-  if (!itemFound)
+  iupASSERT(it!=NULL);
+  iupASSERT(atom!=NULL);
+  iupASSERT(it->indexType == IUPTABLE_ATOMINDEXED);
+  if (!it || !atom || !value)
+    return;
+
+  atom = iTableGetKeyAtom(atom, &lin, &col, &keyHash);
+  iTableSetItem(it, atom, lin, col, keyHash, value, itemType);
+}
+
+IUP_SDK_API void iupTableSetId(Itable *it, const char *name, int id, void *value, Itable_Types itemType)
+{
+  iupTableSetId2(it, name, id, IUPTABLE_NOID, value, itemType);
+}
+
+IUP_SDK_API void iupTableSetId2(Itable *it, const char *name, int lin, int col, void *value, Itable_Types itemType)
+{
+  char nameid[100];
+  unsigned int keyHash;
+  const char* key;
+
+  iupASSERT(it!=NULL);
+  iupASSERT(name!=NULL);
+  if (!it || !name || !value)
+    return;
+
+  key = iTableGetKeyId(it, nameid, name, 1, &lin, &col, &keyHash);
+  if (key)
+    iTableSetItem(it, key, lin, col, keyHash, value, itemType);
+}
+
+static void iTableSetItem(Itable *it, const char *key, int lin, int col, unsigned int keyHash, void *value, Itable_Types itemType)
+{
+  unsigned int  entryIndex;
+  ItableEntry  *entry;
+  void         *v;
+
+  if (!iTableFindItem(it, key, lin, col, keyHash, &entryIndex))
   {
     /* create a new item */
 
-    /* first check if the hash table has to be reorganized */
-    if (iTableResize(it))
+    /* first check if the hash table has to be reorganized,
+       a removed entry that is reused does not increase the load. */
+    if (!it->entries[entryIndex].keyStr && iTableResize(it))
     {
-      /* We have to search for the entry again, since it may
-       * have been moved by iTableResize. */
-      iTableFindItem(it, key, &entry, &itemIndex, &keyIndex);
+      /* We have to search for the entry again,
+       * since it was moved by iTableResize. */
+      iTableFindItem(it, key, lin, col, keyHash, &entryIndex);
     }
 
-    iTableUpdateArraySize(entry);
+    entry = &(it->entries[entryIndex]);
+
+    if (entry->keyStr == ITABLE_REMOVED)
+      it->numberOfRemoved--;
 
-    /* add the item at the end of the item array */
     if (itemType == IUPTABLE_STRING)
       v = iupStrDup(value);
     else
       v = value;
 
-    item = &(entry->items[entry->nextItemIndex]);
+    entry->keyHash  = keyHash;
+    entry->itemType = itemType;
+    entry->keyStr   = it->indexType == IUPTABLE_STRINGINDEXED? iupStrDup(key) : key;
+    entry->keyLin   = lin;
+    entry->keyCol   = col;
+    entry->value    = v;
 
-    item->itemType     = itemType;
-    item->key.keyIndex = keyIndex;
-    item->key.keyStr   = it->indexType == IUPTABLE_STRINGINDEXED? iupStrDup(key) : key;
-    item->value        = v;
-
-    entry->nextItemIndex++;
     it->numberOfEntries++;
   }
   else
   {
     /* change an existing item */
-    item = &(entry->items[itemIndex]);
+    entry = &(it->entries[entryIndex]);
 
-    if (itemType == IUPTABLE_STRING && item->itemType == IUPTABLE_STRING)
+    if (itemType == IUPTABLE_STRING && entry->itemType == IUPTABLE_STRING)
     {
       /* this will avoid to free + alloc of a new pointer */
-      if (iupStrEqual((char*)item->value, (char*)value))
+      if (iupStrEqual((char*)entry->value, (char*)value))
         return;
     }
 
@@ -276,82 +320,142 @@ IUP_SDK_API void iupTableSet(Itable *it, const char *key, void *value, Itable_Ty
     else
       v = value;
 
-    if (item->itemType == IUPTABLE_STRING)
-      free(item->value);
+    if (entry->itemType == IUPTABLE_STRING)
+      free(entry->value);
 
-    item->value = v;
-    item->itemType = itemType;
+    entry->value = v;
+    entry->itemType = itemType;
   }
 }
 
-static void iTableRemoveItem(Itable *it, ItableEntry *entry, unsigned int itemIndex)
+static void iTableRemoveItem(Itable *it, unsigned int entryIndex)
 {
-  ItableItem   *item;
-  unsigned int  i;
-
-  item = &(entry->items[itemIndex]);
+  ItableEntry *entry = &(it->entries[entryIndex]);
 
-  if (it->indexType == IUPTABLE_STRINGINDEXED)
-  {
-    free((void *)item->key.keyStr);
-    item->key.keyStr = NULL;
-  }
+  iTableFreeEntry(it, entry);
 
-  if (item->itemType == IUPTABLE_STRING)
+  /* if the next entry is empty no probe sequence passes here,
+     so the entry can be released instead of marked as removed. */
+  if (!it->entries[(entryIndex + 1) & (it->entriesSize - 1)].keyStr)
+    entry->keyStr = NULL;
+  else
   {
-    free(item->value);
-    item->value = NULL;
+    entry->keyStr = ITABLE_REMOVED;
+    it->numberOfRemoved++;
   }
 
-  /* re-order the remaining items */
-  for (i = itemIndex; i < entry->nextItemIndex-1; i++)
-    entry->items[i] = entry->items[i+1];
+  entry->value = NULL;
+  entry->keyHash = 0;
 
-  /* clear the released item */
-  memset(entry->items + entry->nextItemIndex-1, 0, sizeof (ItableItem));
-
-  entry->nextItemIndex--;
   it->numberOfEntries--;
 }
 
 IUP_SDK_API void iupTableRemove(Itable *it, const char *key)
 {
-  unsigned int itemFound,
-               itemIndex;
-  unsigned long keyIndex;
-  ItableEntry  *entry;
+  unsigned int entryIndex, keyHash;
+  int lin, col;
 
   iupASSERT(it!=NULL);
   iupASSERT(key!=NULL);
   if (!it || !key)
     return;
 
-  itemFound = iTableFindItem(it, key, &entry, &itemIndex, &keyIndex);
-  if (itemFound)
-    iTableRemoveItem(it, entry, itemIndex);
+  key = iTableGetKey(it, key, 0, &lin, &col, &keyHash);
+  if (key && iTableFindItem(it, key, lin, col, keyHash, &entryIndex))
+    iTableRemoveItem(it, entryIndex);
+}
+
+IUP_SDK_API void iupTableRemoveAtom(Itable *it, const char *atom)
+{
+  unsigned int entryIndex, keyHash;
+  int lin, col;
+
+  iupASSERT(it!=NULL);
+  iupASSERT(atom!=NULL);
+  if (!it || !atom)
+    return;
+
+  atom = iTableGetKeyAtom(atom, &lin, &col, &keyHash);
+  if (iTableFindItem(it, atom, lin, col, keyHash, &entryIndex))
+    iTableRemoveItem(it, entryIndex);
+}
+
+IUP_SDK_API void iupTableRemoveId(Itable *it, const char *name, int id)
+{
+  iupTableRemoveId2(it, name, id, IUPTABLE_NOID);
+}
+
+IUP_SDK_API void iupTableRemoveId2(Itable *it, const char *name, int lin, int col)
+{
+  char nameid[100];
+  unsigned int entryIndex, keyHash;
+  const char* key;
+
+  iupASSERT(it!=NULL);
+  iupASSERT(name!=NULL);
+  if (!it || !name)
+    return;
+
+  key = iTableGetKeyId(it, nameid, name, 0, &lin, &col, &keyHash);
+  if (key && iTableFindItem(it, key, lin, col, keyHash, &entryIndex))
+    iTableRemoveItem(it, entryIndex);
 }
 
 IUP_SDK_API void* iupTableGet(Itable *it, const char *key)
 {
-  unsigned int  itemFound,
-                itemIndex;
-  unsigned long keyIndex;
-  ItableEntry  *entry;
-  void         *value = 0;
+  unsigned int entryIndex, keyHash;
+  int lin, col;
 
   iupASSERT(it!=NULL);
   iupASSERT(key!=NULL);
   if (!it || !key)
     return 0;
 
-  itemFound = iTableFindItem(it, key, &entry, &itemIndex, &keyIndex);
-  if (itemFound)
-  {
-    ItableItem* item = &(entry->items[itemIndex]);
-    value = item->value;
-  }
+  key = iTableGetKey(it, key, 0, &lin, &col, &keyHash);
+  if (key && iTableFindItem(it, key, lin, col, keyHash, &entryIndex))
+    return it->entries[entryIndex].value;
+
+  return 0;
+}
+
+IUP_SDK_API void* iupTableGetAtom(Itable *it, const char *atom)
+{
+  unsigned int entryIndex, keyHash;
+  int lin, col;
+
+  iupASSERT(it!=NULL);
+  iupASSERT(atom!=NULL);
+  if (!it || !atom)
+    return 0;
+
+  atom = iTableGetKeyAtom(atom, &lin, &col, &keyHash);
+  if (iTableFindItem(it, atom, lin, col, keyHash, &entryIndex))
+    return it->entries[entryIndex].value;
+
+  return 0;
+}
+
+IUP_SDK_API void* iupTableGetId(Itable *it, const char *name, int id)
+{
+  return iupTableGetId2(it, name, id, IUPTABLE_NOID);
+}
+
+IUP_SDK_API void* iupTableGetId2(Itable *it, const char *name, int lin, int col)
+{
+  char nameid[100];
+  unsigned int entryIndex, keyHash;
+  const char* key;
+
+  iupASSERT(it!=NULL);
+  iupASSERT(name!=NULL);
+  if (!it || !name)
+    return 0;
 
-  return value;
+  key = iTableGetKeyId(it, nameid, name, 0, &lin, &col, &keyHash);
+  if (key && iTableFindItem(it, key, lin, col, keyHash, &entryIndex))
+    return it->entries[entryIndex].value;
+
+  return 0;
 }
 
 IUP_SDK_API Ifunc iupTableGetFunc(Itable *it, const char *key, void **value)
@@ -366,46 +470,67 @@ IUP_SDK_API Ifunc iupTableGetFunc(Itable *it, const char *key, void **value)
 
 IUP_SDK_API void* iupTableGetTyped(Itable *it, const char *key, Itable_Types *itemType)
 {
-  unsigned int  itemFound,
-                itemIndex;
-  unsigned long keyIndex;
-  ItableEntry  *entry;
-  void         *value = 0;
+  unsigned int entryIndex, keyHash;
+  int lin, col;
 
   iupASSERT(it!=NULL);
   iupASSERT(key!=NULL);
   if (!it || !key)
     return 0;
 
-  itemFound = iTableFindItem(it, key, &entry, &itemIndex, &keyIndex);
-  if (itemFound)
+  key = iTableGetKey(it, key, 0, &lin, &col, &keyHash);
+  if (key && iTableFindItem(it, key, lin, col, keyHash, &entryIndex))
   {
-    ItableItem* item = &(entry->items[itemIndex]);
+    ItableEntry* entry = &(it->entries[entryIndex]);
 
-    value = item->value;
-    if (itemType) 
-      *itemType = item->itemType;
+    if (itemType)
+      *itemType = entry->itemType;
+
+    return entry->value;
   }
 
-  return value;
+  return 0;
+}
+
+IUP_SDK_API void* iupTableGetTypedAtom(Itable *it, const char *atom, Itable_Types *itemType)
+{
+  unsigned int entryIndex, keyHash;
+  int lin, col;
+
+  iupASSERT(it!=NULL);
+  iupASSERT(atom!=NULL);
+  if (!it || !atom)
+    return 0;
+
+  atom = iTableGetKeyAtom(atom, &lin, &col, &keyHash);
+  if (iTableFindItem(it, atom, lin, col, keyHash, &entryIndex))
+  {
+    ItableEntry* entry = &(it->entries[entryIndex]);
+
+    if (itemType)
+      *itemType = entry->itemType;
+
+    return entry->value;
+  }
+
+  return 0;
 }
 
 IUP_SDK_API void iupTableSetCurr(Itable *it, void* value, Itable_Types itemType)
 {
   void* v;
-  ItableItem *item;
+  ItableEntry *entry;
 
   iupASSERT(it!=NULL);
-  if (!it || it->context.entryIndex == (unsigned int)-1
-         || it->context.itemIndex == (unsigned int)-1)
+  if (!it || !iTableCheckContext(it))
     return;
 
-  item = &(it->entries[it->context.entryIndex].items[it->context.itemIndex]);
+  entry = &(it->entries[it->context.entryIndex]);
 
-  if (itemType == IUPTABLE_STRING && item->itemType == IUPTABLE_STRING)
+  if (itemType == IUPTABLE_STRING && entry->itemType == IUPTABLE_STRING)
   {
     /* this will avoid to free + alloc of a new pointer */
-    if (iupStrEqual((char*)item->value, (char*)value))
+    if (iupStrEqual((char*)entry->value, (char*)value))
       return;
   }
 
@@ -414,364 +539,730 @@ IUP_SDK_API void iupTableSetCurr(Itable *it, void* value, Itable_Types itemType)
   else
     v = value;
 
-  if (item->itemType == IUPTABLE_STRING)
-    free(item->value);
-
-  item->value = v;
-  item->itemType = itemType;
+  if (entry->itemType == IUPTABLE_STRING)
+    free(entry->value);
 
+  entry->value = v;
+  entry->itemType = itemType;
 }
 
 IUP_SDK_API void* iupTableGetCurr(Itable *it)
 {
   iupASSERT(it!=NULL);
-  if (!it || it->context.entryIndex == (unsigned int)-1
-         || it->context.itemIndex == (unsigned int)-1)
+  if (!it || !iTableCheckContext(it))
     return 0;
-  else
-  {
-    ItableItem* item = &(it->entries[it->context.entryIndex].items[it->context.itemIndex]);
-    return item->value;
-  }
+
+  return it->entries[it->context.entryIndex].value;
 }
 
 IUP_SDK_API int iupTableGetCurrType(Itable *it)
 {
   iupASSERT(it!=NULL);
-  if (!it || it->context.entryIndex == (unsigned int)-1
-         || it->context.itemIndex == (unsigned int)-1)
+  if (!it || !iTableCheckContext(it))
     return -1;
 
-  return it->entries[it->context.entryIndex].items[it->context.itemIndex].itemType;
+  return it->entries[it->context.entryIndex].itemType;
+}
+
+static int iTableFirst(Itable *it)
+{
+  it->context.entryIndex = (unsigned int)-1;
+
+  if (it->numberOfEntries == 0)
+    return 0;
+
+  /* find the first used entry */
+  it->context.entryIndex = iTableNextUsed(it, 0);
+  return iTableCheckContext(it);
+}
+
+static int iTableNext(Itable *it)
+{
+  if (!iTableCheckContext(it))
+    return 0;
+
+  /* find the next used entry */
+  it->context.entryIndex = iTableNextUsed(it, it->context.entryIndex + 1);
+  return iTableCheckContext(it);
 }
 
 IUP_SDK_API char *iupTableFirst(Itable *it)
 {
-  unsigned int entryIndex;
+  iupASSERT(it!=NULL);
+  if (!it || !iTableFirst(it))
+    return 0;
+
+  return iTableGetEntryKey(&(it->entries[it->context.entryIndex]));
+}
 
+IUP_SDK_API char *iupTableNext(Itable *it)
+{
   iupASSERT(it!=NULL);
-  if (!it)
+  if (!it || !iTableNext(it))
     return 0;
 
-  it->context.entryIndex = (unsigned int)-1;
-  it->context.itemIndex = (unsigned int)-1;
+  return iTableGetEntryKey(&(it->entries[it->context.entryIndex]));
+}
 
-  /* find the first used entry */
-  for (entryIndex = 0; entryIndex < it->entriesSize; entryIndex++)
-  {
-    if (it->entries[entryIndex].nextItemIndex > 0)
-    {
-      it->context.entryIndex = entryIndex;
-      it->context.itemIndex = 0;
-      return (char*)it->entries[entryIndex].items[0].key.keyStr;
-    }
-  }
+IUP_SDK_API const char *iupTableFirstId(Itable *it, int *lin, int *col)
+{
+  ItableEntry *entry;
 
-  return 0;
+  iupASSERT(it!=NULL);
+  if (!it || !iTableFirst(it))
+    return 0;
+
+  /* the key is returned without the id, so no atom is created */
+  entry = &(it->entries[it->context.entryIndex]);
+  if (lin) *lin = entry->keyLin;
+  if (col) *col = entry->keyCol;
+  return entry->keyStr;
 }
 
-IUP_SDK_API char *iupTableNext(Itable *it)
+IUP_SDK_API const char *iupTableNextId(Itable *it, int *lin, int *col)
+{
+  ItableEntry *entry;
+
+  iupASSERT(it!=NULL);
+  if (!it || !iTableNext(it))
+    return 0;
+
+  entry = &(it->entries[it->context.entryIndex]);
+  if (lin) *lin = entry->keyLin;
+  if (col) *col = entry->keyCol;
+  return entry->keyStr;
+}
+
+IUP_SDK_API char *iupTableRemoveCurr(Itable *it)
 {
+  unsigned int entryIndex;
+
   iupASSERT(it!=NULL);
-  if (!it || it->context.entryIndex == (unsigned int)-1
-         || it->context.itemIndex == (unsigned int)-1)
+  if (!it || !iTableCheckContext(it))
+    return 0;
+
+  entryIndex = it->context.entryIndex;
+
+  /* removing an entry never moves the other entries,
+     so the iteration can continue from the same position */
+  iTableRemoveItem(it, entryIndex);
+
+  it->context.entryIndex = iTableNextUsed(it, entryIndex + 1);
+  if (!iTableCheckContext(it))
     return 0;
 
-  if (it->context.itemIndex + 1 < it->entries[it->context.entryIndex].nextItemIndex)
+  return iTableGetEntryKey(&(it->entries[it->context.entryIndex]));
+}
+
+
+/********************************************/
+/*           Private functions              */
+/********************************************/
+
+
+static void iTableFreeEntry(Itable *it, ItableEntry *entry)
+{
+  /* atoms are shared, they are not released here */
+  if (it->indexType == IUPTABLE_STRINGINDEXED)
+    free((void *)entry->keyStr);
+
+  if (entry->keyName)
   {
-    /* key in the current entry */
-    it->context.itemIndex++;
-    return (char*)it->entries[it->context.entryIndex].items[it->context.itemIndex].key.keyStr;
+    free((void*)iAtomHeader(entry->keyName));
+    entry->keyName = NULL;
   }
-  else
+
+  if (entry->itemType == IUPTABLE_STRING)
+    free(entry->value);
+}
+
+static unsigned int iTableNextUsed(Itable *it, unsigned int entryIndex)
+{
+  for (; entryIndex < it->entriesSize; entryIndex++)
   {
-    unsigned int entryIndex;
-    /* find the next used entry */
-    for (entryIndex = it->context.entryIndex+1; entryIndex < it->entriesSize; entryIndex++)
-    {
-      if (it->entries[entryIndex].nextItemIndex > 0)
-      {
-        it->context.entryIndex = entryIndex;
-        it->context.itemIndex = 0;
-        return (char*)it->entries[entryIndex].items[0].key.keyStr;
-      }
-    }
+    if (iTableIsUsed(&(it->entries[entryIndex])))
+      return entryIndex;
   }
 
-  return 0;
+  return (unsigned int)-1;
 }
 
-IUP_SDK_API char *iupTableRemoveCurr(Itable *it)
+/* since the table size is a power of 2 only the lower bits are used as index,
+   so mix the upper bits into the lower bits */
+#define iTableHashMix(_checksum)  \
+  {                               \
+    _checksum ^= _checksum >> 16; \
+    _checksum *= 0x45d9f3bU;      \
+    _checksum ^= _checksum >> 16; \
+  }
+
+static unsigned int iTableHashStr(const char *key, unsigned int len)
 {
-  char* key;
-  ItableEntry  *entry;
-  unsigned int itemIndex;
+  register unsigned int checksum = 0;
 
-  iupASSERT(it!=NULL);
-  if (!it || it->context.entryIndex == (unsigned int)-1
-         || it->context.itemIndex == (unsigned int)-1)
-    return 0;
+  /* len can be (unsigned int)-1 to use all the string */
+  while (len && *key)
+  {
+    checksum *= 31;
+    checksum += *key;
+    key++;
+    len--;
+  }
+
+  iTableHashMix(checksum);
+
+  return checksum;  /* this is NOT dependent from table size */
+}
+
+static unsigned int iTableHashId(unsigned int checksum, int lin, int col)
+{
+  if (lin == IUPTABLE_NOID && col == IUPTABLE_NOID)
+    return checksum;  /* same as the atom */
+
+  checksum ^= (unsigned int)lin * 0x9e3779b1U;
+  checksum ^= (unsigned int)col * 0x85ebca77U;
+
+  iTableHashMix(checksum);
+
+  return checksum;
+}
 
-  entry = &it->entries[it->context.entryIndex];
-  itemIndex = it->context.itemIndex;
+static unsigned int iTableHashKey(Itable *it, const char *key)
+{
+  register unsigned int checksum;
+  size_t p;
+
+  if (it->indexType != IUPTABLE_POINTERINDEXED)
+    return iTableHashStr(key, (unsigned int)-1);
+
+  /* Pointer indexed, the lower bits are always 0 because of alignment */
+  p = (size_t)key;
+  checksum = (unsigned int)(p >> 3) ^ (unsigned int)((p >> 16) >> 16);
+
+  iTableHashMix(checksum);
+
+  return checksum;  /* this is NOT dependent from table size */
+}
 
-  if (it->context.itemIndex + 1 < it->entries[it->context.entryIndex].nextItemIndex)
+/* Same rule used by the class to find where the id starts */
+static const char* iTableFindId(const char* name)
+{
+  while (*name)
   {
-    /* key in the current entry */
-    it->context.itemIndex++;
-    key = (char*)it->entries[it->context.entryIndex].items[it->context.itemIndex].key.keyStr;
+    if ((*name >= '0' && *name <= '9') || *name == '*' || *name == ':' || *name == '-')
+      return name;
 
-    iTableRemoveItem(it, entry, itemIndex);
-    return key;
+    name++;
   }
-  else
+  return NULL;
+}
+
+static int iTableParseNumber(const char* *id, int *num)
+{
+  const char* s = *id;
+  int count = 0;
+
+  if (*s == '*')
   {
-    unsigned int entryIndex;
-    /* find the next used entry */
-    for (entryIndex = it->context.entryIndex+1; entryIndex < it->entriesSize; entryIndex++)
-    {
-      if (it->entries[entryIndex].nextItemIndex > 0)
-      {
-        it->context.entryIndex = entryIndex;
-        it->context.itemIndex = 0;
-        key = (char*)it->entries[entryIndex].items[0].key.keyStr;
+    *num = ITABLE_ANYID;
+    *id = s + 1;
+    return 1;
+  }
 
-        iTableRemoveItem(it, entry, itemIndex);
-        return key;
-       }
-    }
+  /* only the form that sprintf("%d") creates, so the name can be restored */
+  if (*s == '0' && s[1] >= '0' && s[1] <= '9')
+    return 0;
+
+  *num = 0;
+  while (*s >= '0' && *s <= '9')
+  {
+    if (count == 9)
+      return 0;
+
+    *num = *num * 10 + (*s - '0');
+    count++;
+    s++;
   }
 
-  return 0;
+  *id = s;
+  return count != 0;
 }
 
+/* Parses "1", "1:2", "*:2" and "1:*". Other forms are not considered ids. */
+static int iTableParseId(const char* id, int *lin, int *col)
+{
+  if (!iTableParseNumber(&id, lin))
+    return 0;
+
+  if (*id == 0)
+  {
+    *col = IUPTABLE_NOID;
+    return *lin != ITABLE_ANYID;
+  }
 
-/********************************************/
-/*           Private functions              */
-/********************************************/
+  if (*id != ':')
+    return 0;
+  id++;
+
+  if (!iTableParseNumber(&id, col) || *id != 0)
+    return 0;
 
+  return !(*lin == ITABLE_ANYID && *col == ITABLE_ANYID);
+}
 
-static void iTableFreeItemArray(Itable_IndexTypes indexType, unsigned int nextFreeIndex, ItableItem *items)
+/* The inverse of iTableParseId, the same format used by IupSetAttributeId2 */
+static void iTableNameId(char* nameid, const char* name, int lin, int col)
 {
-  unsigned int i;
-  ItableItem* item;
+  if (col == IUPTABLE_NOID)
+  {
+    if (lin == ITABLE_ANYID)
+      sprintf(nameid, "%s", name);
+    else
+      sprintf(nameid, "%s%d", name, lin);
+  }
+  else if (lin == ITABLE_ANYID && col == ITABLE_ANYID)
+    sprintf(nameid, "%s", name);
+  else if (lin == ITABLE_ANYID)
+    sprintf(nameid, "%s*:%d", name, col);
+  else if (col == ITABLE_ANYID)
+    sprintf(nameid, "%s%d:*", name, lin);
+  else
+    sprintf(nameid, "%s%d:%d", name, lin, col);
+}
 
-  /* Used only in iupTableClear */
+static const char* iAtomFind(const char* name, unsigned int len);
+static const char* iAtomGet(const char* name, unsigned int len);
 
-  iupASSERT(items!=NULL);
-  if (!items)
-    return;
+static const char* iTableGetKey(Itable *it, const char *key, int create, int *lin, int *col, unsigned int *keyHash)
+{
+  const char* id;
 
-  if (indexType == IUPTABLE_STRINGINDEXED)
+  if (it->indexType != IUPTABLE_ATOMINDEXED)
   {
-    for (i = 0; i < nextFreeIndex; i++)
-    {
-      item = items + i;
-      free((void *)(item->key.keyStr));
-      item->key.keyStr = NULL;
-    }
+    *lin = IUPTABLE_NOID;
+    *col = IUPTABLE_NOID;
+    *keyHash = iTableHashKey(it, key);
+    return key;
+  }
+
+  /* names with ids use the atom of the name without the id */
+  id = iTableFindId(key);
+  if (id && iTableParseId(id, lin, col))
+    key = create? iAtomGet(key, (unsigned int)(id - key)): iAtomFind(key, (unsigned int)(id - key));
+  else
+  {
+    *lin = IUPTABLE_NOID;
+    *col = IUPTABLE_NOID;
+    key = create? iAtomGet(key, (unsigned int)strlen(key)): iAtomFind(key, (unsigned int)strlen(key));
   }
 
-  for (i = 0; i < nextFreeIndex; i++)
+  if (!key)
+    return NULL;
+
+  *keyHash = iTableHashId(iAtomHash(key), *lin, *col);
+  return key;
+}
+
+static const char* iTableGetKeyId(Itable *it, char* nameid, const char *name, int create, int *lin, int *col, unsigned int *keyHash)
+{
+  if (it->indexType == IUPTABLE_ATOMINDEXED && !iTableFindId(name) &&
+      iTableIsValidId(*lin) && (iTableIsValidId(*col) || *col == IUPTABLE_NOID))
   {
-    item = items + i;
+    const char* key = create? iAtomGet(name, (unsigned int)strlen(name)): iAtomFind(name, (unsigned int)strlen(name));
+    if (!key)
+      return NULL;
 
-    if (item->itemType == IUPTABLE_STRING)
+    /* "*" alone is the name without the id */
+    if (*lin == ITABLE_ANYID && (*col == IUPTABLE_NOID || *col == ITABLE_ANYID))
     {
-      free(item->value);
-      item->value = NULL;
+      *lin = IUPTABLE_NOID;
+      *col = IUPTABLE_NOID;
     }
+
+    *keyHash = iTableHashId(iAtomHash(key), *lin, *col);
+    return key;
   }
 
-  free(items);
+  /* other table types, names that contain id characters and negative ids,
+     use the full name as key */
+  iupASSERT(it->indexType != IUPTABLE_POINTERINDEXED);
+  iTableNameId(nameid, name, *lin, *col);
+  return iTableGetKey(it, nameid, create, lin, col, keyHash);
 }
 
-static unsigned int iTableGetEntryIndex(Itable *it, const char *key, unsigned long *keyIndex)
+static const char* iTableGetKeyAtom(const char *atom, int *lin, int *col, unsigned int *keyHash)
 {
-  if (it->indexType == IUPTABLE_STRINGINDEXED)
+  const IatomHeader* header = iAtomHeader(atom);
+  *lin = header->lin;
+  *col = header->col;
+  *keyHash = iTableHashId(iAtomHash(header->base), header->lin, header->col);
+  return header->base;
+}
+
+static char* iTableGetEntryKey(ItableEntry *entry)
+{
+  IatomHeader* header;
+  char* key;
+
+  if (entry->keyLin == IUPTABLE_NOID && entry->keyCol == IUPTABLE_NOID)
+    return (char*)entry->keyStr;
+
+  if (entry->keyName)
+    return entry->keyName;
+
+  /* the key must remain valid after the iteration, so the full name is kept
+     in the entry until it is removed. It is not added to the atom table,
+     but it has the same header, so it can still be used in the iupTable*Atom functions. */
+  header = (IatomHeader*)malloc(sizeof(IatomHeader) + strlen(entry->keyStr) + 30);
+  iupASSERT(header!=NULL);
+  if (!header)
+    return NULL;
+
+  key = (char*)(header + 1);
+  iTableNameId(key, entry->keyStr, entry->keyLin, entry->keyCol);
+
+  header->base = entry->keyStr;
+  header->lin = entry->keyLin;
+  header->col = entry->keyCol;
+  header->hash = iTableHashStr(key, (unsigned int)strlen(key));
+  header->tag = IATOM_TAG;
+
+  entry->keyName = key;
+  return key;
+}
+
+static int iTableFindItem(Itable *it, const char *key, int lin, int col, unsigned int keyHash, unsigned int *entryIndex)
+{
+  unsigned int mask = it->entriesSize - 1,
+               index = keyHash & mask,
+               freeIndex = (unsigned int)-1;
+  ItableEntry *entry;
+
+  for (;;)
   {
-    register unsigned int checksum = 0;
+    entry = &(it->entries[index]);
 
-/*     Original version
-    unsigned int i;
-    for (i = 0; key[i]; i++)
-      checksum = checksum*31 + key[i];  
-*/
+    if (!entry->keyStr)
+      break;
 
-    while (*key)
+    if (entry->keyStr == ITABLE_REMOVED)
+    {
+      if (freeIndex == (unsigned int)-1)
+        freeIndex = index;
+    }
+    else if (entry->keyHash == keyHash)
     {
-      checksum *= 31;
-      checksum += *key;
-      key++;
+      /* atoms and pointers are always found by the pointer,
+         other strings must be compared */
+      if (entry->keyStr == key?
+            (entry->keyLin == lin && entry->keyCol == col):
+            (it->indexType == IUPTABLE_STRINGINDEXED && strcmp(entry->keyStr, key) == 0))
+      {
+        *entryIndex = index;
+        return 1;
+      }
     }
 
-    *keyIndex = checksum;            /* this could NOT be dependent from table size */
-  }
-  else
-  {
-    /* Pointer indexed */
-    *keyIndex = (unsigned long)key;   /* this could NOT be dependent from table size */
+    index = (index + 1) & mask;
   }
 
-  return (unsigned int)((*keyIndex) % it->entriesSize);
+  /* if not found "entryIndex" will have the insert position,
+     preferably a removed entry. */
+
+  *entryIndex = (freeIndex != (unsigned int)-1)? freeIndex: index;
+  return 0;
 }
 
-#ifdef DEBUGTABLE
-static void iTableCheckDuplicated(ItableItem *item, unsigned int nextItemIndex, const char *key, 
-                                                                          unsigned long keyIndex)
+static int iTableResize(Itable *it)
 {
-  unsigned int i;
-  for (i = 0; i < nextItemIndex; i++, item++)
+  unsigned int   newSize,
+                 i;
+  ItableEntry   *newEntries,
+                *entry;
+
+  /* check if we do not need to resize the hash table */
+  if (!ITABLE_FULL(it->numberOfEntries + it->numberOfRemoved + 1, it->entriesSize))
+    return 0;
+
+  /* if most of the load are removed entries,
+     only rebuild the table with the same size */
+  newSize = it->entriesSize;
+  while (ITABLE_FULL((it->numberOfEntries + 1) * 3 / 2, newSize))
+    newSize *= 2;
+
+  newEntries = (ItableEntry *)calloc(newSize, sizeof(ItableEntry));
+  iupASSERT(newEntries!=NULL);
+  if (!newEntries)
+    return 0;
+
+  /* move the entries to the new array without duplicating memory. */
+  for (i = 0; i < it->entriesSize; i++)
   {
-    if (!iupStrEqual((char*)item->key.keyStr, (char*)key) && 
-        item->key.keyIndex == keyIndex)
+    entry = &(it->entries[i]);
+
+    if (iTableIsUsed(entry))
     {
-      fprintf(stderr, "#ERROR# Duplicated key index (%ld): %s %s \n", keyIndex, 
-                                                                     (char*)item->key.keyStr, 
-                                                                     (char*)key);
+      unsigned int index = entry->keyHash & (newSize - 1);
+      while (newEntries[index].keyStr)
+        index = (index + 1) & (newSize - 1);
+
+      newEntries[index] = *entry;
     }
   }
+
+  free(it->entries);
+
+  it->entries         = newEntries;
+  it->entriesSize     = newSize;
+  it->numberOfRemoved = 0;
+
+  it->context.entryIndex = (unsigned int)-1;
+
+  return 1;
 }
-#endif
 
-static unsigned int iTableFindItem(Itable *it, const char *key, ItableEntry **entry, 
-                                                          unsigned int *itemIndex,
-                                                          unsigned long *keyIndex)
+
+
+/********************************************/
+/*                 Atoms                    */
+/********************************************/
+
+
+/* Atoms are allocated sequentially in large blocks,
+   they are never released individually. */
+#define IATOM_BLOCK_SIZE 4096
+
+typedef struct _IatomBlock
 {
-  unsigned int entryIndex,
-               itemFound,
-               i;
-  ItableItem  *item;
+  struct _IatomBlock* next;
+  unsigned int        used;
+  unsigned int        size;
+  /* followed by the atoms data */
+}
+IatomBlock;
 
-  entryIndex = iTableGetEntryIndex(it, key, keyIndex);
+/* The atom table is a set with open addressing, the same way as Itable.
+   Atoms are never removed from the set. */
+static const char** iatom_entries = NULL;
+static unsigned int iatom_size = 0;
+static unsigned int iatom_count = 0;
+static IatomBlock* iatom_blocks = NULL;
 
-  *entry = &(it->entries[entryIndex]);
+static const char* iAtomFindItem(const char* name, unsigned int len, unsigned int hash, unsigned int *entryIndex)
+{
+  unsigned int mask = iatom_size - 1,
+               index = hash & mask;
 
-  item = &((*entry)->items[0]);
-  for (i = 0; i < (*entry)->nextItemIndex; i++, item++)
+  for (;;)
   {
-    if (it->indexType == IUPTABLE_STRINGINDEXED)
-      itemFound = item->key.keyIndex == *keyIndex; 
-/*    itemFound = iupStrEqual(item->key.keyStr, key);  This is the original safe version */
-    else
-      itemFound = item->key.keyStr == key;
+    const char* atom = iatom_entries[index];
+
+    if (!atom)
+      break;
+
+    if (iAtomHash(atom) == hash && strncmp(atom, name, len) == 0 && atom[len] == 0)
+      return atom;
+
+    index = (index + 1) & mask;
+  }
+
+  *entryIndex = index;
+  return NULL;
+}
+
+static int iAtomResize(void)
+{
+  unsigned int newSize = iatom_size? iatom_size * 2: 1024,
+               i;
+  const char** newEntries;
+
+  newEntries = (const char**)calloc(newSize, sizeof(const char*));
+  iupASSERT(newEntries!=NULL);
+  if (!newEntries)
+    return 0;
 
-    if (itemFound)
+  for (i = 0; i < iatom_size; i++)
+  {
+    const char* atom = iatom_entries[i];
+    if (atom)
     {
-      *itemIndex = i;
-      return 1;
+      unsigned int index = iAtomHash(atom) & (newSize - 1);
+      while (newEntries[index])
+        index = (index + 1) & (newSize - 1);
+
+      newEntries[index] = atom;
     }
   }
 
-  /* if not found "entry", "itemIndex" and "keyIndex" will have the new insert position. */
+  if (iatom_entries)
+    free((void*)iatom_entries);
 
-  *itemIndex = i;
-  return 0;
+  iatom_entries = newEntries;
+  iatom_size = newSize;
+  return 1;
 }
 
-static void iTableUpdateArraySize(ItableEntry *entry)
+static char* iAtomAlloc(unsigned int size)
 {
-  if (entry->nextItemIndex >= entry->itemsSize)
+  char* data;
+
+  /* keep the header of the next atom aligned */
+  size = (size + sizeof(double) - 1) & ~(unsigned int)(sizeof(double) - 1);
+
+  if (!iatom_blocks || iatom_blocks->used + size > iatom_blocks->size)
   {
-    /* we have to expand the item array */
-    unsigned int newSize;
+    unsigned int blockSize = size > IATOM_BLOCK_SIZE? size: IATOM_BLOCK_SIZE;
+    IatomBlock* block = (IatomBlock*)malloc(sizeof(IatomBlock) + blockSize);
+    iupASSERT(block!=NULL);
+    if (!block)
+      return NULL;
+
+    block->used = 0;
+    block->size = blockSize;
+    block->next = iatom_blocks;
+    iatom_blocks = block;
+  }
 
-    newSize = entry->itemsSize + itable_itemGrow;
+  data = (char*)(iatom_blocks + 1) + iatom_blocks->used;
+  iatom_blocks->used += size;
+  return data;
+}
 
-    entry->items = (ItableItem *)realloc(entry->items, newSize * sizeof(ItableItem));
-    iupASSERT(entry->items!=NULL);
-    if (!entry->items)
-      return;
+/* name can be a partial string, only len characters are used */
+static const char* iAtomFind(const char* name, unsigned int len)
+{
+  unsigned int entryIndex;
 
-    memset(entry->items + entry->itemsSize, 0, itable_itemGrow * sizeof(ItableItem));
+  if (!iatom_entries)
+    return NULL;
 
-    entry->itemsSize = newSize;
-  }
+  return iAtomFindItem(name, len, iTableHashStr(name, len), &entryIndex);
 }
 
-static void iTableAdd(Itable *it, ItableKey *key, void *value, Itable_Types itemType)
+static const char* iAtomGet(const char* name, unsigned int len)
 {
-  unsigned int entryIndex;
-  unsigned long keyIndex;
-  ItableEntry *entry;
-  ItableItem* item;
+  unsigned int entryIndex, hash;
+  const char *atom, *base = NULL, *id;
+  IatomHeader* header;
+  int lin = IUPTABLE_NOID, col = IUPTABLE_NOID;
+
+  hash = iTableHashStr(name, len);
+
+  if (iatom_entries)
+  {
+    atom = iAtomFindItem(name, len, hash, &entryIndex);
+    if (atom)
+      return atom;
+  }
+
+  /* a name with an id also references the atom of the name without the id,
+     it must be created before the entry index is computed, because of the resize.
+     Names without the id never contain id characters, so they are not partial strings here. */
+  id = iTableFindId(name);
+  if (id && (unsigned int)(id - name) < len && iTableParseId(id, &lin, &col))
+  {
+    base = iAtomGet(name, (unsigned int)(id - name));
+    if (!base)
+      return NULL;
+  }
+  else
+  {
+    lin = IUPTABLE_NOID;
+    col = IUPTABLE_NOID;
+  }
+
+  /* maximum load is 1/2 */
+  if ((iatom_count + 1) * 2 > iatom_size)
+  {
+    if (!iAtomResize())
+      return NULL;
+  }
 
-  entryIndex = iTableGetEntryIndex(it, key->keyStr, &keyIndex);
+  iAtomFindItem(name, len, hash, &entryIndex);
 
-  entry = &(it->entries[entryIndex]);
-  iTableUpdateArraySize(entry);
+  header = (IatomHeader*)iAtomAlloc(sizeof(IatomHeader) + len + 1);
+  if (!header)
+    return NULL;
 
-  /* add a new item at the end of the item array without duplicating memory. */
-  item = &(entry->items[entry->nextItemIndex]);
-  item->itemType     = itemType;
-  item->key.keyIndex = keyIndex;
-  item->key.keyStr   = key->keyStr;
-  item->value        = value;
+  atom = (const char*)(header + 1);
+  memcpy((char*)atom, name, len);
+  ((char*)atom)[len] = 0;
 
-  entry->nextItemIndex++;
-  it->numberOfEntries++;
+  header->base = base? base: atom;
+  header->lin = lin;
+  header->col = col;
+  header->hash = hash;
+  header->tag = IATOM_TAG;
+
+  iatom_entries[entryIndex] = atom;
+  iatom_count++;
+
+  return atom;
 }
 
-static unsigned int iTableResize(Itable *it)
+IUP_SDK_API const char* iupAtomFind(const char* name)
 {
-  unsigned int   newSizeIndex,
-                 entryIndex,
-                 i;
-  Itable        *newTable;
-  ItableItem    *item;
+  iupASSERT(name!=NULL);
+  if (!name)
+    return NULL;
 
-  /* check if we do not need to resize the hash table */
-  if (it->numberOfEntries == 0 ||
-     it->tableSizeIndex >= itable_maxTableSizeIndex ||
-     it->entriesSize / it->numberOfEntries >= itable_resizeLimit)
-    return 0;
+  return iAtomFind(name, (unsigned int)strlen(name));
+}
 
-  /* create a new hash table and copy the contents of
-   * the current table into the new one
-   */
-  newSizeIndex = it->tableSizeIndex + 1;
-  newTable = iupTableCreateSized(it->indexType, newSizeIndex);
+IUP_SDK_API int iupAtomCheck(const char* atom)
+{
+  IatomBlock* block = iatom_blocks;
 
-  for (entryIndex = 0; entryIndex < it->entriesSize; entryIndex++)
+  /* atoms are aligned like their header */
+  if (!atom || ((size_t)atom & (sizeof(double) - 1)) != 0)
+    return 0;
+
+  /* the header is read only if the string is inside an atom block */
+  while (block)
   {
-    ItableEntry *entry = &(it->entries[entryIndex]);
+    const char* data = (const char*)(block + 1);
+    if (atom > data && atom < data + block->used)
+      return iAtomHeader(atom)->tag == IATOM_TAG;
 
-    if (entry->items)
-    {
-      item = &(entry->items[0]);
+    block = block->next;
+  }
 
-      for (i = 0; i < entry->nextItemIndex; i++, item++)
-      {
-        iTableAdd(newTable, &(item->key), item->value, item->itemType);
-      }     
+  return 0;
+}
 
-      free(entry->items);
-      entry->items = NULL;
-    }
-  }
+IUP_SDK_API const char* iupAtomGet(const char* name)
+{
+  iupASSERT(name!=NULL);
+  if (!name)
+    return NULL;
 
-  free(it->entries);
+  return iAtomGet(name, (unsigned int)strlen(name));
+}
 
-  it->entriesSize    = newTable->entriesSize;
-  it->tableSizeIndex  = newTable->tableSizeIndex;
-  it->numberOfEntries = newTable->numberOfEntries;
-  it->entries         = newTable->entries;
+void iupAtomFinish(void)
+{
+  while (iatom_blocks)
+  {
+    IatomBlock* next = iatom_blocks->next;
+    free(iatom_blocks);
+    iatom_blocks = next;
+  }
 
-  free(newTable);
+  if (iatom_entries)
+    free((void*)iatom_entries);
 
-  return 1;
+  iatom_entries = NULL;
+  iatom_size = 0;
+  iatom_count = 0;
 }
 
 #ifdef DEBUGTABLE
 static void iTableShowStatistics(Itable *it)
 {
-  unsigned int nofSlots        = 0;
-  unsigned int nofKeys         = 0;
-  double optimalNofKeysPerSlot = 0.0;
-  unsigned int nofSlotsWithMoreKeys = 0;
-  unsigned int nofSlotsWithLessKeys = 0;
-
+  unsigned int nofProbes = 0,
+               maxProbes = 0;
   unsigned int entryIndex;
+
   fprintf(stderr, "\n--- HASH TABLE STATISTICS ---\n");
   if (!it)
   {
@@ -779,25 +1270,27 @@ static void iTableShowStatistics(Itable *it)
     return;
   }
 
-  nofSlots = it->entriesSize;
-  nofKeys  = it->numberOfEntries;
-  optimalNofKeysPerSlot = (double)nofKeys / (double)nofSlots;
-
   for (entryIndex = 0; entryIndex < it->entriesSize; entryIndex++)
   {
     ItableEntry *entry = &(it->entries[entryIndex]);
 
-    if (entry->nextItemIndex > optimalNofKeysPerSlot + 3)
-      nofSlotsWithMoreKeys++;
-    else if (entry->nextItemIndex < optimalNofKeysPerSlot - 3)
-      nofSlotsWithLessKeys++;
+    if (iTableIsUsed(entry))
+    {
+      unsigned int home = entry->keyHash & (it->entriesSize - 1);
+      unsigned int probes = ((entryIndex - home) & (it->entriesSize - 1)) + 1;
+      nofProbes += probes;
+      if (probes > maxProbes)
+        maxProbes = probes;
+    }
   }
 
-  fprintf(stderr, "Number of slots: %d\n", nofSlots);
-  fprintf(stderr, "Number of keys: %d\n", nofKeys);
-  fprintf(stderr, "Optimal number of keys per slot: %f\n", optimalNofKeysPerSlot);
-  fprintf(stderr, "Number of slots with much more keys: %d\n", nofSlotsWithMoreKeys);
-  fprintf(stderr, "Number of slots with far less keys: %d\n", nofSlotsWithLessKeys);
+  fprintf(stderr, "Number of slots: %d\n", it->entriesSize);
+  fprintf(stderr, "Number of keys: %d\n", it->numberOfEntries);
+  fprintf(stderr, "Number of removed slots: %d\n", it->numberOfRemoved);
+  fprintf(stderr, "Load factor: %f\n", (double)it->numberOfEntries / (double)it->entriesSize);
+  if (it->numberOfEntries)
+    fprintf(stderr, "Average number of probes: %f\n", (double)nofProbes / (double)it->numberOfEntries);
+  fprintf(stderr, "Maximum number of probes: %d\n", maxProbes);
   fprintf(stderr, "\n");
 }
 #endif
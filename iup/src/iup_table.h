@@ -1,5 +1,6 @@
 /** \file
  * \brief Simple hash table C API.
+ * Open addressing with linear probing, keys are always fully compared.
  * Does not allow 0 values for items...
  *
  * See Copyright Notice in "iup.h"
@@ -27,9 +28,18 @@ extern "C"
 typedef enum _Itable_IndexTypes
 {
   IUPTABLE_POINTERINDEXED = 10, /**< a pointer address is used as key. */
-  IUPTABLE_STRINGINDEXED        /**< a string as key */
+  IUPTABLE_STRINGINDEXED,       /**< a string as key */
+  IUPTABLE_ATOMINDEXED          /**< a string as key, but stored as an atom (see \ref atom). \n
+                                     Can also be accessed with the iupTable*Atom functions. \n
+                                     Names with ids ("NAME1", "NAME1:2", "NAME*:2", "NAME1:*")
+                                     are stored as the atom of "NAME" plus the id numbers,
+                                     and can also be accessed with the iupTable*Id functions. */
 } Itable_IndexTypes;
 
+/** Used in the iupTable*Id functions when the key has no id.
+ * \ingroup table */
+#define IUPTABLE_NOID (-2147483647 - 1)
+
 /** How the value is interpreted.
  * \ingroup table */
 typedef enum _Itable_Types
@@ -54,9 +64,10 @@ IUP_SDK_API Itable *iupTableCreate(Itable_IndexTypes indexType);
 /** Creates a hash table with the specified initial size.
  * Use this function if you expect the table to become very large.
  * initialSizeIndex is an array into the (internal) list of
- * possible hash table sizes. Currently only indexes from 0 to 8
- * are supported. If you specify a higher value here, the maximum
- * allowed value will be used.
+ * possible initial hash table sizes (16, 64, 256, 1024, 4096, ..., 65536).
+ * Currently only indexes from 0 to 8 are supported.
+ * If you specify a higher value here, the maximum allowed value will be used.
+ * The table always grows when needed.
  * \ingroup table */
 IUP_SDK_API Itable *iupTableCreateSized(Itable_IndexTypes indexType, unsigned int initialSizeIndex);
 
@@ -111,7 +122,10 @@ IUP_SDK_API void iupTableRemove(Itable *it, const char *key);
  * Do NOT change the content of the hash table during iteration.
  * During an iteration you can use context with
  * iupTableGetCurr() to access the value of the key
- * very fast.
+ * very fast. \n
+ * In IUPTABLE_ATOMINDEXED tables keys without ids are returned as atoms.
+ * Keys with ids are returned as the full name, kept by the table until the key is removed,
+ * which can also be used in the iupTable*Atom functions.
  * \ingroup table */
 IUP_SDK_API char *iupTableFirst(Itable *it);
 
@@ -144,6 +158,101 @@ IUP_SDK_API void iupTableSetCurr(Itable *it, void *value, Itable_Types itemType)
  * \ingroup table */
 IUP_SDK_API char *iupTableRemoveCurr(Itable *it);
 
+/** Same as \ref iupTableSet but the key is an atom. \n
+ * Valid only for IUPTABLE_ATOMINDEXED tables.
+ * \ingroup table */
+IUP_SDK_API void iupTableSetAtom(Itable *it, const char *atom, void *value, Itable_Types itemType);
+
+/** Same as \ref iupTableGet but the key is an atom,
+ * no string hashing or comparison is done. \n
+ * Valid only for IUPTABLE_ATOMINDEXED tables.
+ * \ingroup table */
+IUP_SDK_API void *iupTableGetAtom(Itable *it, const char *atom);
+
+/** Same as \ref iupTableGetTyped but the key is an atom. \n
+ * Valid only for IUPTABLE_ATOMINDEXED tables.
+ * \ingroup table */
+IUP_SDK_API void *iupTableGetTypedAtom(Itable *it, const char *atom, Itable_Types *itemType);
+
+/** Same as \ref iupTableRemove but the key is an atom. \n
+ * Valid only for IUPTABLE_ATOMINDEXED tables.
+ * \ingroup table */
+IUP_SDK_API void iupTableRemoveAtom(Itable *it, const char *atom);
+
+/** Same as \ref iupTableSet but the key is the name plus an id,
+ * like the attributes set with IupSetAttributeId. \n
+ * In IUPTABLE_ATOMINDEXED tables the name is not formatted with the id,
+ * the result is the same as using the formatted name in \ref iupTableSet.
+ * \ingroup table */
+IUP_SDK_API void iupTableSetId(Itable *it, const char *name, int id, void *value, Itable_Types itemType);
+
+/** Same as \ref iupTableSetId but using two ids, like IupSetAttributeId2.
+ * \ingroup table */
+IUP_SDK_API void iupTableSetId2(Itable *it, const char *name, int lin, int col, void *value, Itable_Types itemType);
+
+/** Same as \ref iupTableGet but the key is the name plus an id.
+ * \ingroup table */
+IUP_SDK_API void *iupTableGetId(Itable *it, const char *name, int id);
+
+/** Same as \ref iupTableGet but the key is the name plus two ids.
+ * \ingroup table */
+IUP_SDK_API void *iupTableGetId2(Itable *it, const char *name, int lin, int col);
+
+/** Same as \ref iupTableRemove but the key is the name plus an id.
+ * \ingroup table */
+IUP_SDK_API void iupTableRemoveId(Itable *it, const char *name, int id);
+
+/** Same as \ref iupTableRemove but the key is the name plus two ids.
+ * \ingroup table */
+IUP_SDK_API void iupTableRemoveId2(Itable *it, const char *name, int lin, int col);
+
+/** Same as \ref iupTableFirst but returns the key without the id,
+ * and the ids separately. A key with a single id returns IUPTABLE_NOID in col,
+ * a key without an id returns IUPTABLE_NOID in both. \n
+ * Contrary to \ref iupTableFirst, the full name is not converted into an atom.
+ * \ingroup table */
+IUP_SDK_API const char *iupTableFirstId(Itable *it, int *lin, int *col);
+
+/** Same as \ref iupTableNext, see \ref iupTableFirstId.
+ * \ingroup table */
+IUP_SDK_API const char *iupTableNextId(Itable *it, int *lin, int *col);
+
+
+
+/** \defgroup atom Atoms
+ * \par
+ * An atom is a string stored only once in a process-wide table.
+ * Two atoms with the same contents have the same address,
+ * so they can be compared by pointer and their hash is never computed again.
+ * Attribute names are stored as atoms.
+ * \par
+ * Atoms are valid until IupClose.
+ * \par
+ * The atom table is not protected by a lock,
+ * it must be used only from the main thread, like all the attribute functions.
+ * \par
+ * See \ref iup_table.h
+ * \ingroup util */
+
+/** Returns the atom of the given string, creating it if necessary.
+ * \ingroup atom */
+IUP_SDK_API const char *iupAtomGet(const char *name);
+
+/** Returns the atom of the given string if it already exists, or NULL.
+ * It never creates an atom. Names with ids are stored in atom indexed tables
+ * as the atom of the name without the id, so their full names usually have no atom.
+ * \ingroup atom */
+IUP_SDK_API const char *iupAtomFind(const char *name);
+
+/** Returns 1 if the string was returned by \ref iupAtomGet, or 0 if it is a regular string.
+ * The string is first located in the atom memory blocks, so any string can be checked.
+ * \ingroup atom */
+IUP_SDK_API int iupAtomCheck(const char *atom);
+
+/** Releases all atoms. Called only from IupClose.
+ * \ingroup atom */
+void iupAtomFinish(void);
+
 
 #ifdef __cplusplus
 }
@@ -12,7 +12,7 @@ SRCMATRIXEX := $(addprefix matrixex/, $(SRCMATRIXEX))
 
 SRCMATRIX = iupmat_key.c iupmat_mark.c iupmat_aux.c iupmat_mem.c iupmat_mouse.c iupmat_numlc.c \
             iupmat_colres.c iupmat_draw.c iupmat_getset.c iupmatrix.c \
-            iupmat_scroll.c iupmat_edit.c iupmat_ex.c
+            iupmat_scroll.c iupmat_edit.c iupmat_ex.c iupmat_cache.c iupmat_sort.c
 SRCMATRIX := $(addprefix matrix/, $(SRCMATRIX))
 
 SRC = iup_controls.c \
@@ -26,17 +26,116 @@
 #include "iupmat_numlc.h"
 
 
-int iupMatrixAuxIsFullVisibleLast(ImatLinColData *p)
+/**************************************************************************/
+/* Size sums                                                              */
+/**************************************************************************/
+
+/* The sizes are also stored in a Fenwick tree (binary indexed tree),
+   so the sum of the sizes before an index and the index at a given position 
+   are computed in O(log n) instead of walking the dt array. */
+
+#define iMatrixAuxLowBit(_i) ((_i) & (-(_i)))
+
+void iupMatrixAuxBuildSizeSums(ImatLinColData* p)
 {
-  int i, sum = 0;
+  int i, j, n = p->num;
+  int* sums = p->size_sums;
 
-  for(i = p->first; i <= p->last; i++)
+  p->total_visible_size = 0;
+  p->total_size = 0;
+
+  for (i = 1; i <= n; i++)
   {
-    sum += p->dt[i].size;
-    if (i==p->first)
-      sum -= p->first_offset;
+    int size = p->dt[i - 1].size;
+    sums[i] = size;
+
+    if (i - 1 >= p->num_noscroll)
+      p->total_visible_size += size;
+    p->total_size += size;
   }
 
+  for (i = 1; i <= n; i++)
+  {
+    j = i + iMatrixAuxLowBit(i);
+    if (j <= n)
+      sums[j] += sums[i];
+  }
+}
+
+void iupMatrixAuxSetSize(ImatLinColData* p, int index, int size)
+{
+  int i, delta = size - p->dt[index].size;
+  if (!delta)
+    return;
+
+  p->dt[index].size = size;
+
+  for (i = index + 1; i <= p->num; i += iMatrixAuxLowBit(i))
+    p->size_sums[i] += delta;
+
+  if (index >= p->num_noscroll)
+    p->total_visible_size += delta;
+  p->total_size += delta;
+}
+
+/* Returns the sum of the sizes of the columns/lines before the index. */
+int iupMatrixAuxGetSizeSum(ImatLinColData* p, int index)
+{
+  int sum = 0;
+
+  if (index > p->num)
+    index = p->num;
+
+  for (; index > 0; index -= iMatrixAuxLowBit(index))
+    sum += p->size_sums[index];
+
+  return sum;
+}
+
+/* Returns the largest index where the sum of the sizes before it is <= pos, 
+   in other words the column/line that contains the position. 
+   Returns num if the position is after the last column/line. */
+int iupMatrixAuxGetSizeIndex(ImatLinColData* p, int pos)
+{
+  int index = 0, mask = 1;
+
+  if (pos < 0)
+    return 0;
+
+  while (mask * 2 <= p->num)
+    mask *= 2;
+
+  for (; mask > 0; mask /= 2)
+  {
+    int i = index + mask;
+    if (i <= p->num && p->size_sums[i] <= pos)
+    {
+      index = i;
+      pos -= p->size_sums[i];
+    }
+  }
+
+  return index;
+}
+
+int iupMatrixAuxGetNoScrollSize(ImatLinColData* p)
+{
+  return iupMatrixAuxGetSizeSum(p, p->num_noscroll);
+}
+
+int iupMatrixAuxGetScrollPos(ImatLinColData* p)
+{
+  return iupMatrixAuxGetSizeSum(p, p->first) - iupMatrixAuxGetSizeSum(p, p->num_noscroll) + p->first_offset;
+}
+
+
+/**************************************************************************/
+
+
+int iupMatrixAuxIsFullVisibleLast(ImatLinColData *p)
+{
+  int sum = iupMatrixAuxGetSizeSum(p, p->last + 1) - iupMatrixAuxGetSizeSum(p, p->first) - p->first_offset;
+
   if (sum > p->current_visible_size)
     return 0;
   else
@@ -83,17 +182,18 @@ int iupMatrixAuxIsCellVisible(Ihandle* ih, int lin, int col)
 
 void iupMatrixAuxAdjustFirstFromLast(ImatLinColData* p)
 {
-  int i, sum = 0;
+  int i, sum, last_sum;
 
   /* adjust "first" according to "last" */
 
-  i = p->last;
-  sum = p->dt[i].size;
-  while (i>p->num_noscroll && sum < p->current_visible_size)
-  {
-    i--;
-    sum += p->dt[i].size;
-  }
+  /* find the largest index where the sum from it up to "last" fills the visible size */
+  last_sum = iupMatrixAuxGetSizeSum(p, p->last + 1);
+  i = iupMatrixAuxGetSizeIndex(p, last_sum - p->current_visible_size);
+  if (i > p->last)
+    i = p->last;
+  if (i < p->num_noscroll)
+    i = p->num_noscroll;
+  sum = last_sum - iupMatrixAuxGetSizeSum(p, i);
 
   if (i == p->num_noscroll && sum < p->current_visible_size)
   {
@@ -103,7 +203,7 @@ void iupMatrixAuxAdjustFirstFromLast(ImatLinColData* p)
   }
   else
   {
-    /* the "while" found an index for first */
+    /* found an index for first */
     p->first = i;
 
     /* position at the remaing space */
@@ -113,35 +213,29 @@ void iupMatrixAuxAdjustFirstFromLast(ImatLinColData* p)
 
 void iupMatrixAuxAdjustFirstFromScrollPos(ImatLinColData* p, int scroll_pos)
 {
-  int index, sp, offset = 0;
+  int index, offset, noscroll_size = iupMatrixAuxGetNoScrollSize(p);
 
-  sp = 0;
-  for(index = p->num_noscroll; index < p->num; index++)
-  {
-    sp += p->dt[index].size;
-    if (sp > scroll_pos)
-    {
-      sp -= p->dt[index].size; /* get the previous value */
-      offset = scroll_pos - sp;
-      break;
-    }
-  }
+  index = iupMatrixAuxGetSizeIndex(p, noscroll_size + scroll_pos);
+  if (index < p->num_noscroll)
+    index = p->num_noscroll;
 
-  if (index == p->num)
+  if (index >= p->num)
   {
     if (p->num == p->num_noscroll)
     {
-      /* did NOT go trough the "for" above */
+      /* there are no scrollable cells */
       offset = scroll_pos;
-      index = p->num_noscroll; /* redundant, just for the record */
+      index = p->num_noscroll;
     }
     else
     {
-      /* go all the way trough the "for" above, but still sp < scroll_pos */
-      offset = scroll_pos - sp;
+      /* scroll_pos is after the last cell */
+      offset = scroll_pos - (p->total_size - noscroll_size);
       index = p->num-1;
     }
   }
+  else
+    offset = noscroll_size + scroll_pos - iupMatrixAuxGetSizeSum(p, index);
 
   p->first = index;
   p->first_offset = offset;
@@ -155,7 +249,7 @@ void iupMatrixAuxAdjustFirstFromScrollPos(ImatLinColData* p, int scroll_pos)
 */
 void iupMatrixAuxUpdateScrollPos(Ihandle* ih, int m)
 {
-  int i, sb, SB, scroll_pos;
+  int sb, SB, scroll_pos;
   char* POS;
   ImatLinColData *p;
 
@@ -190,10 +284,7 @@ void iupMatrixAuxUpdateScrollPos(Ihandle* ih, int m)
   }
 
   /* must check if it is a valid position */
-  scroll_pos = 0;
-  for(i = p->num_noscroll; i < p->first; i++)
-    scroll_pos += p->dt[i].size;
-  scroll_pos += p->first_offset;
+  scroll_pos = iupMatrixAuxGetScrollPos(p);
 
   if (scroll_pos + p->current_visible_size > p->total_visible_size)
   {
@@ -218,22 +309,18 @@ void iupMatrixAuxUpdateLast(ImatLinColData *p)
 {
   if (p->current_visible_size > 0)
   {
-    int i, sum = 0;
+    int i;
 
     /* Find which is the last column/line.
        Start in the first visible and continue adding the widths
-       up to the visible size */
-    for(i = p->first; i < p->num; i++)
-    {
-      sum += p->dt[i].size;
-      if (i==p->first)
-        sum -= p->first_offset;
-
-      if(sum >= p->current_visible_size)
-        break;
-    }
-
-    if (i == p->num)
+       up to the visible size. 
+       It is the first index where the sum including it reaches the end position. */
+    int end_pos = iupMatrixAuxGetSizeSum(p, p->first) + p->first_offset + p->current_visible_size;
+    i = iupMatrixAuxGetSizeIndex(p, end_pos - 1);
+    if (i < p->first)
+      i = p->first;
+
+    if (i >= p->num)
     {
       if (p->num == p->num_noscroll)
         p->last = p->num_noscroll;
@@ -250,40 +337,69 @@ void iupMatrixAuxUpdateLast(ImatLinColData *p)
   }
 }
 
-/* Fill the sizes array with the width/heigh of all the columns/lines.
-   Calculate the value of total_visible_size */
-static void iMatrixAuxFillSizeVec(Ihandle* ih, int m)
+static int iMatrixAuxGetSize(Ihandle* ih, int m, int index)
 {
-  int i;
+  if (m == IMAT_PROCESS_LIN)
+    return iupMatrixGetLineHeight(ih, index, 1);
+  else
+    return iupMatrixGetColumnWidth(ih, index, 1);
+}
+
+/* Fill the sizes array with the width/heigh of the given columns/lines. */
+static void iMatrixAuxFillSizes(Ihandle* ih, int m, int base, int count)
+{
+  int i, def_size = -1;
+  const char *SIZE, *RASTERSIZE;
   ImatLinColData *p;
 
   if (m == IMAT_PROCESS_LIN)
+  {
     p = &(ih->data->lines);
+    SIZE = "HEIGHT";
+    RASTERSIZE = "RASTERHEIGHT";
+  }
   else
+  {
     p = &(ih->data->columns);
+    SIZE = "WIDTH";
+    RASTERSIZE = "RASTERWIDTH";
+  }
 
-  /* Calculate total width/height of the matrix and the width/height of each column */
-  p->total_visible_size = 0;
-  p->total_size = 0;
-  for (i = 0; i < p->num; i++)
+  for (i = base; i < base + count && i < p->num; i++)
   {
-    if (m == IMAT_PROCESS_LIN)
-      p->dt[i].size = iupMatrixGetLineHeight(ih, i, 1);
+    /* all the columns/lines without a size attribute have the same default size, 
+       so compute it only once */
+    if (i != 0 && !ih->data->use_title_size &&
+        !iupAttribGetId(ih, SIZE, i) && !iupAttribGetId(ih, RASTERSIZE, i))
+    {
+      if (def_size == -1)
+        def_size = iMatrixAuxGetSize(ih, m, i);
+
+      p->dt[i].size = def_size;
+    }
     else
-      p->dt[i].size = iupMatrixGetColumnWidth(ih, i, 1);
+      p->dt[i].size = iMatrixAuxGetSize(ih, m, i);
+  }
+}
 
-    if (i >= p->num_noscroll)
-      p->total_visible_size += p->dt[i].size;
+/* Fill the sizes array with the width/heigh of all the columns/lines.
+   Calculate the value of total_visible_size */
+static void iMatrixAuxFillSizeVec(Ihandle* ih, int m)
+{
+  ImatLinColData *p = (m == IMAT_PROCESS_LIN)? &(ih->data->lines): &(ih->data->columns);
 
-    p->total_size += p->dt[i].size;
-  }
+  /* Calculate the width/height of each column/line */
+  iMatrixAuxFillSizes(ih, m, 0, p->num);
+
+  /* Calculate total width/height of the matrix */
+  iupMatrixAuxBuildSizeSums(p);
 }
 
 static int iMatrixAuxUpdateVisibleSize(Ihandle* ih, int m)
 {
   char *D, *AUTOHIDE, *MAX;
   ImatLinColData *p;
-  int canvas_size, fixed_size, i, SB;
+  int canvas_size, fixed_size, SB;
 
   if (m == IMAT_PROCESS_LIN)
   {
@@ -310,9 +426,7 @@ static int iMatrixAuxUpdateVisibleSize(Ihandle* ih, int m)
     canvas_size = iupMatrixGetWidth(ih);
   }
 
-  fixed_size = 0;
-  for (i=0; i<p->num_noscroll; i++)
-    fixed_size += p->dt[i].size;
+  fixed_size = iupMatrixAuxGetNoScrollSize(p);
 
   /* Matrix useful area is the current size minus the non scrollable area */
   p->current_visible_size = canvas_size - fixed_size;
@@ -342,13 +456,9 @@ static int iMatrixAuxUpdateVisibleSize(Ihandle* ih, int m)
   return IupGetInt(ih, "SB_RESIZE");
 }
 
-int iupMatrixAuxCalcSizes(Ihandle* ih)
+static int iMatrixAuxUpdateVisible(Ihandle* ih)
 {
   int sb_resize_col, sb_resize_lin;
-  ih->data->need_calcsize = 0;  /* do it before UpdateVisibleSize */
-
-  iMatrixAuxFillSizeVec(ih, IMAT_PROCESS_COL);
-  iMatrixAuxFillSizeVec(ih, IMAT_PROCESS_LIN);
 
   /* this could change the size of the drawing area, 
      and trigger a resize event, then another calcsize. */
@@ -380,6 +490,64 @@ int iupMatrixAuxCalcSizes(Ihandle* ih)
   return sb_resize_col || sb_resize_lin;
 }
 
+int iupMatrixAuxCalcSizes(Ihandle* ih)
+{
+  /* when only need_calcvisible is set the sizes are already up to date */
+  int fill = ih->data->need_calcsize || !ih->data->need_calcvisible;
+
+  ih->data->need_calcsize = 0;  /* do it before UpdateVisibleSize */
+  ih->data->need_calcvisible = 0;
+
+  if (fill)
+  {
+    iMatrixAuxFillSizeVec(ih, IMAT_PROCESS_COL);
+    iMatrixAuxFillSizeVec(ih, IMAT_PROCESS_LIN);
+  }
+
+  return iMatrixAuxUpdateVisible(ih);
+}
+
+void iupMatrixAuxUpdateSize(Ihandle* ih, int m, int index)
+{
+  ImatLinColData *p = (m == IMAT_PROCESS_LIN)? &(ih->data->lines): &(ih->data->columns);
+
+  if (ih->data->need_calcsize)  /* sizes will be all computed later */
+    return;
+
+  iupMatrixAuxSetSize(p, index, iMatrixAuxGetSize(ih, m, index));
+
+  ih->data->need_redraw = 1;
+  ih->data->need_calcvisible = 1;
+}
+
+void iupMatrixAuxUpdateSizeRange(Ihandle* ih, int m, int base, int count)
+{
+  ImatLinColData *p = (m == IMAT_PROCESS_LIN)? &(ih->data->lines): &(ih->data->columns);
+
+  if (ih->data->need_calcsize)
+  {
+    /* sizes will be all computed later, 
+       just keep the sums consistent with the dt array */
+    iupMatrixAuxBuildSizeSums(p);
+    return;
+  }
+
+  /* the dt array was already shifted, only the new columns/lines must be computed */
+  iMatrixAuxFillSizes(ih, m, base, count);
+
+  /* only integers are added, no attributes are consulted */
+  iupMatrixAuxBuildSizeSums(p);
+
+  /* the size of the line/column of titles depends on all the titles */
+  if (m == IMAT_PROCESS_LIN)
+    iupMatrixAuxSetSize(&(ih->data->columns), 0, iMatrixAuxGetSize(ih, IMAT_PROCESS_COL, 0));
+  else
+    iupMatrixAuxSetSize(&(ih->data->lines), 0, iMatrixAuxGetSize(ih, IMAT_PROCESS_LIN, 0));
+
+  ih->data->need_redraw = 1;
+  ih->data->need_calcvisible = 1;
+}
+
 int iupMatrixAuxCallLeaveCellCb(Ihandle* ih)
 {
   if (ih->data->columns.num > 1 && ih->data->lines.num > 1)
@@ -17,6 +17,15 @@ int   iupMatrixAuxIsCellStartVisible(Ihandle* ih, int lin, int col);
 int   iupMatrixAuxIsCellVisible(Ihandle* ih, int lin, int col);
 
 int   iupMatrixAuxCalcSizes(Ihandle* ih);
+void  iupMatrixAuxUpdateSize(Ihandle* ih, int m, int index);
+void  iupMatrixAuxUpdateSizeRange(Ihandle* ih, int m, int base, int count);
+
+void  iupMatrixAuxBuildSizeSums(ImatLinColData* p);
+void  iupMatrixAuxSetSize(ImatLinColData* p, int index, int size);
+int   iupMatrixAuxGetSizeSum(ImatLinColData* p, int index);
+int   iupMatrixAuxGetSizeIndex(ImatLinColData* p, int pos);
+int   iupMatrixAuxGetNoScrollSize(ImatLinColData* p);
+int   iupMatrixAuxGetScrollPos(ImatLinColData* p);
 
 void  iupMatrixAuxAdjustFirstFromLast(ImatLinColData* p);
 void  iupMatrixAuxAdjustFirstFromScrollPos(ImatLinColData* p, int scroll_pos);
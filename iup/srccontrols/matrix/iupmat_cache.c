@@ -0,0 +1,572 @@
+/** \file
+ * \brief iupmatrix control
+ * cache of values in callback mode and cache of displayed values
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+/**************************************************************************/
+/*  When VALUES_RANGE_CB is defined the values are requested by blocks    */
+/*  and stored in tiles of cells. The tiles are kept in a hash table      */
+/*  and discarded in LRU order when the maximum number is reached.        */
+/**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iup.h"
+#include "iupcbs.h"
+
+#include <cd.h>
+
+#include "iup_object.h"
+#include "iup_attrib.h"
+#include "iup_str.h"
+#include "iup_stdcontrols.h"
+#include "iup_drvfont.h"
+
+#include "iupmat_def.h"
+#include "iupmat_cache.h"
+
+
+#define IMAT_TILE_LIN 32    /* lines in a tile */
+#define IMAT_TILE_COL 16    /* columns in a tile */
+#define IMAT_TILE_CELLS (IMAT_TILE_LIN*IMAT_TILE_COL)
+
+#define IMAT_CACHE_TILES_DEF 64
+#define IMAT_CACHE_TILES_MIN 4
+#define IMAT_CACHE_HASH_SIZE 256   /* must be a power of 2 */
+
+typedef struct _ImatTile
+{
+  int tile_lin, tile_col;        /* first cell of the tile divided by the tile size */
+  char* values[IMAT_TILE_CELLS];
+  struct _ImatTile* hash_next;
+  struct _ImatTile *lru_prev, *lru_next;  /* lru_prev is more recently used */
+} ImatTile;
+
+struct _ImatCache
+{
+  ImatTile* hash[IMAT_CACHE_HASH_SIZE];
+  ImatTile *lru_first, *lru_last;  /* most and least recently used */
+  int tile_count, tile_max;
+  int prefetch;          /* lines fetched before and after the visible lines */
+  int hits, misses, fetches;
+};
+
+static int iMatrixCacheHash(int tile_lin, int tile_col)
+{
+  return (tile_lin * 31 + tile_col) & (IMAT_CACHE_HASH_SIZE - 1);
+}
+
+static ImatTile* iMatrixCacheFindTile(ImatCache* cache, int tile_lin, int tile_col)
+{
+  ImatTile* tile = cache->hash[iMatrixCacheHash(tile_lin, tile_col)];
+  while (tile)
+  {
+    if (tile->tile_lin == tile_lin && tile->tile_col == tile_col)
+      return tile;
+    tile = tile->hash_next;
+  }
+  return NULL;
+}
+
+static void iMatrixCacheLruRemove(ImatCache* cache, ImatTile* tile)
+{
+  if (tile->lru_prev)
+    tile->lru_prev->lru_next = tile->lru_next;
+  else
+    cache->lru_first = tile->lru_next;
+
+  if (tile->lru_next)
+    tile->lru_next->lru_prev = tile->lru_prev;
+  else
+    cache->lru_last = tile->lru_prev;
+
+  tile->lru_prev = NULL;
+  tile->lru_next = NULL;
+}
+
+static void iMatrixCacheLruInsert(ImatCache* cache, ImatTile* tile)
+{
+  tile->lru_prev = NULL;
+  tile->lru_next = cache->lru_first;
+  if (cache->lru_first)
+    cache->lru_first->lru_prev = tile;
+  cache->lru_first = tile;
+  if (!cache->lru_last)
+    cache->lru_last = tile;
+}
+
+static void iMatrixCacheTouchTile(ImatCache* cache, ImatTile* tile)
+{
+  if (cache->lru_first != tile)
+  {
+    iMatrixCacheLruRemove(cache, tile);
+    iMatrixCacheLruInsert(cache, tile);
+  }
+}
+
+static void iMatrixCacheFreeValues(ImatTile* tile)
+{
+  int i;
+  for (i = 0; i < IMAT_TILE_CELLS; i++)
+  {
+    if (tile->values[i])
+    {
+      free(tile->values[i]);
+      tile->values[i] = NULL;
+    }
+  }
+}
+
+static void iMatrixCacheRemoveTile(ImatCache* cache, ImatTile* tile)
+{
+  ImatTile** link = &(cache->hash[iMatrixCacheHash(tile->tile_lin, tile->tile_col)]);
+  while (*link != tile)
+    link = &((*link)->hash_next);
+  *link = tile->hash_next;
+
+  iMatrixCacheLruRemove(cache, tile);
+  iMatrixCacheFreeValues(tile);
+  free(tile);
+  cache->tile_count--;
+}
+
+static void iMatrixCacheTrim(ImatCache* cache, int max)
+{
+  while (cache->tile_count > max && cache->lru_last)
+    iMatrixCacheRemoveTile(cache, cache->lru_last);
+}
+
+static ImatTile* iMatrixCacheNewTile(ImatCache* cache, int tile_lin, int tile_col)
+{
+  int h = iMatrixCacheHash(tile_lin, tile_col);
+  ImatTile* tile;
+
+  /* reuse the least recently used tile */
+  iMatrixCacheTrim(cache, cache->tile_max - 1);
+
+  tile = (ImatTile*)calloc(1, sizeof(ImatTile));
+  tile->tile_lin = tile_lin;
+  tile->tile_col = tile_col;
+  tile->hash_next = cache->hash[h];
+  cache->hash[h] = tile;
+  iMatrixCacheLruInsert(cache, tile);
+  cache->tile_count++;
+  return tile;
+}
+
+static void iMatrixCacheFetch(Ihandle* ih, int tile_lin1, int tile_col1, int tile_lin2, int tile_col2)
+{
+  /* Call VALUES_RANGE_CB once for the block of tiles,
+     then copy the returned values into the tiles. */
+  ImatCache* cache = ih->data->cache;
+  IFniiiiV values_range_cb = (IFniiiiV)IupGetCallback(ih, "VALUES_RANGE_CB");
+  int lin1 = tile_lin1 * IMAT_TILE_LIN;
+  int col1 = tile_col1 * IMAT_TILE_COL;
+  int lin2 = (tile_lin2 + 1) * IMAT_TILE_LIN - 1;
+  int col2 = (tile_col2 + 1) * IMAT_TILE_COL - 1;
+  int width, tile_lin, tile_col;
+  char** values;
+
+  if (lin2 > ih->data->lines.num - 1) lin2 = ih->data->lines.num - 1;
+  if (col2 > ih->data->columns.num - 1) col2 = ih->data->columns.num - 1;
+  if (!values_range_cb || lin1 > lin2 || col1 > col2)
+    return;
+
+  width = col2 - col1 + 1;
+  values = (char**)calloc((lin2 - lin1 + 1) * width, sizeof(char*));
+
+  values_range_cb(ih, lin1, col1, lin2, col2, values);
+  cache->fetches++;
+
+  for (tile_lin = tile_lin1; tile_lin <= tile_lin2; tile_lin++)
+  {
+    for (tile_col = tile_col1; tile_col <= tile_col2; tile_col++)
+    {
+      int lin, col, tlin1 = tile_lin * IMAT_TILE_LIN, tcol1 = tile_col * IMAT_TILE_COL;
+      int tlin2 = tlin1 + IMAT_TILE_LIN - 1, tcol2 = tcol1 + IMAT_TILE_COL - 1;
+      ImatTile* tile = iMatrixCacheFindTile(cache, tile_lin, tile_col);
+      if (tile)
+      {
+        iMatrixCacheFreeValues(tile);
+        iMatrixCacheTouchTile(cache, tile);
+      }
+      else
+        tile = iMatrixCacheNewTile(cache, tile_lin, tile_col);
+
+      if (tlin2 > lin2) tlin2 = lin2;
+      if (tcol2 > col2) tcol2 = col2;
+
+      for (lin = tlin1; lin <= tlin2; lin++)
+      {
+        for (col = tcol1; col <= tcol2; col++)
+        {
+          char* value = values[(lin - lin1) * width + (col - col1)];
+          if (value)
+            tile->values[(lin - tlin1) * IMAT_TILE_COL + (col - tcol1)] = iupStrDup(value);
+        }
+      }
+    }
+  }
+
+  free(values);
+}
+
+void iupMatrixCacheCreate(Ihandle* ih)
+{
+  ImatCache* cache = (ImatCache*)calloc(1, sizeof(ImatCache));
+  cache->tile_max = iupAttribGetInt(ih, "CACHETILES");
+  if (cache->tile_max < IMAT_CACHE_TILES_MIN)
+    cache->tile_max = IMAT_CACHE_TILES_DEF;
+  cache->prefetch = iupAttribGetInt(ih, "CACHEPREFETCH");
+  ih->data->cache = cache;
+}
+
+void iupMatrixCacheClear(Ihandle* ih)
+{
+  ImatCache* cache = ih->data->cache;
+  if (cache)
+    iMatrixCacheTrim(cache, 0);
+}
+
+void iupMatrixCacheRelease(Ihandle* ih)
+{
+  if (ih->data->cache)
+  {
+    iupMatrixCacheClear(ih);
+    free(ih->data->cache);
+    ih->data->cache = NULL;
+  }
+}
+
+char* iupMatrixCacheGetValue(Ihandle* ih, int lin, int col)
+{
+  ImatCache* cache = ih->data->cache;
+  int tile_lin = lin / IMAT_TILE_LIN;
+  int tile_col = col / IMAT_TILE_COL;
+  ImatTile* tile = iMatrixCacheFindTile(cache, tile_lin, tile_col);
+
+  if (tile)
+    cache->hits++;
+  else
+  {
+    cache->misses++;
+    iMatrixCacheFetch(ih, tile_lin, tile_col, tile_lin, tile_col);
+
+    tile = iMatrixCacheFindTile(cache, tile_lin, tile_col);
+    if (!tile)
+      return NULL;
+  }
+
+  iMatrixCacheTouchTile(cache, tile);
+  return tile->values[(lin % IMAT_TILE_LIN) * IMAT_TILE_COL + (col % IMAT_TILE_COL)];
+}
+
+void iupMatrixCacheFetchRange(Ihandle* ih, int lin1, int col1, int lin2, int col2)
+{
+  /* Called by the draw for each visible rectangle.
+     Each run of missing tiles in a row of tiles is requested at once,
+     and runs with the same columns in consecutive rows are merged in a single block,
+     so the tiles already in the cache are not requested again. */
+  ImatCache* cache = ih->data->cache;
+  int tile_lin, tile_col, tile_lin1, tile_col1, tile_lin2, tile_col2;
+  int miss_lin1 = -1, miss_col1 = 0, miss_lin2 = 0, miss_col2 = 0;
+  int free_tiles;
+
+  /* when sorted the displayed lines are not contiguous in the data,
+     then the tiles are fetched one by one when the values are needed */
+  if (!cache || ih->data->sort_has_index)
+    return;
+
+  if (lin1 > 0)
+  {
+    lin1 -= cache->prefetch;
+    if (lin1 < 1) lin1 = 1;
+    lin2 += cache->prefetch;
+  }
+  if (lin2 > ih->data->lines.num - 1) lin2 = ih->data->lines.num - 1;
+  if (col2 > ih->data->columns.num - 1) col2 = ih->data->columns.num - 1;
+  if (lin1 > lin2 || col1 > col2)
+    return;
+
+  tile_lin1 = lin1 / IMAT_TILE_LIN;
+  tile_col1 = col1 / IMAT_TILE_COL;
+  tile_lin2 = lin2 / IMAT_TILE_LIN;
+  tile_col2 = col2 / IMAT_TILE_COL;
+
+  /* the fetched tiles can not be more than the cache,
+     the remaining are fetched one by one when the values are needed */
+  free_tiles = cache->tile_max;
+
+  for (tile_lin = tile_lin1; tile_lin <= tile_lin2 && free_tiles > 0; tile_lin++)
+  {
+    tile_col = tile_col1;
+    while (tile_col <= tile_col2 && free_tiles > 0)
+    {
+      ImatTile* tile = iMatrixCacheFindTile(cache, tile_lin, tile_col);
+      if (tile)
+      {
+        iMatrixCacheTouchTile(cache, tile);
+        tile_col++;
+      }
+      else
+      {
+        int run_col1 = tile_col, run_col2;
+
+        while (tile_col <= tile_col2 && tile_col - run_col1 < free_tiles &&
+               !iMatrixCacheFindTile(cache, tile_lin, tile_col))
+          tile_col++;
+        run_col2 = tile_col - 1;
+        free_tiles -= run_col2 - run_col1 + 1;
+
+        if (miss_lin1 != -1 && miss_lin2 == tile_lin - 1 && miss_col1 == run_col1 && miss_col2 == run_col2)
+          miss_lin2 = tile_lin;  /* same run of the previous row */
+        else
+        {
+          if (miss_lin1 != -1)
+            iMatrixCacheFetch(ih, miss_lin1, miss_col1, miss_lin2, miss_col2);
+
+          miss_lin1 = miss_lin2 = tile_lin;
+          miss_col1 = run_col1;
+          miss_col2 = run_col2;
+        }
+      }
+    }
+  }
+
+  if (miss_lin1 != -1)
+    iMatrixCacheFetch(ih, miss_lin1, miss_col1, miss_lin2, miss_col2);
+}
+
+void iupMatrixCacheInvalidate(Ihandle* ih, int lin1, int col1, int lin2, int col2)
+{
+  ImatCache* cache = ih->data->cache;
+  ImatTile *tile, *next;
+
+  if (!cache)
+    return;
+
+  tile = cache->lru_first;
+  while (tile)
+  {
+    int tlin1 = tile->tile_lin * IMAT_TILE_LIN, tcol1 = tile->tile_col * IMAT_TILE_COL;
+
+    next = tile->lru_next;
+
+    if (tlin1 <= lin2 && tlin1 + IMAT_TILE_LIN - 1 >= lin1 &&
+        tcol1 <= col2 && tcol1 + IMAT_TILE_COL - 1 >= col1)
+      iMatrixCacheRemoveTile(cache, tile);
+
+    tile = next;
+  }
+}
+
+int iupMatrixCacheSetInvalidateAttrib(Ihandle* ih, const char* value)
+{
+  int lin1, col1, lin2, col2;
+
+  if (!ih->data->cache)
+    return 0;
+
+  if (!value || iupStrEqualNoCase(value, "ALL"))
+    iupMatrixCacheClear(ih);
+  else if (sscanf(value, "%d:%d-%d:%d", &lin1, &col1, &lin2, &col2) == 4)
+    iupMatrixCacheInvalidate(ih, lin1, col1, lin2, col2);
+  else if (iupStrToIntInt(value, &lin1, &col1, ':') == 2)
+    iupMatrixCacheInvalidate(ih, lin1, col1, lin1, col1);
+  else
+    return 0;
+
+  ih->data->need_redraw = 1;
+  return 0;
+}
+
+int iupMatrixCacheSetTilesAttrib(Ihandle* ih, const char* value)
+{
+  ImatCache* cache = ih->data->cache;
+  if (cache)
+  {
+    int tile_max;
+    if (!iupStrToInt(value, &tile_max) || tile_max < IMAT_CACHE_TILES_MIN)
+      tile_max = IMAT_CACHE_TILES_DEF;
+    cache->tile_max = tile_max;
+    iMatrixCacheTrim(cache, tile_max);
+  }
+  return 1;
+}
+
+int iupMatrixCacheSetPrefetchAttrib(Ihandle* ih, const char* value)
+{
+  ImatCache* cache = ih->data->cache;
+  if (cache)
+  {
+    if (!iupStrToInt(value, &cache->prefetch) || cache->prefetch < 0)
+      cache->prefetch = 0;
+  }
+  return 1;
+}
+
+char* iupMatrixCacheGetStatsAttrib(Ihandle* ih)
+{
+  ImatCache* cache = ih->data->cache;
+  if (!cache)
+    return NULL;
+  return iupStrReturnStrf("%d:%d:%d:%d", cache->hits, cache->misses, cache->fetches, cache->tile_count);
+}
+
+
+/**************************************************************************/
+/*  The formatted values of numeric columns are kept in a small hash      */
+/*  table of cells, so the visible cells are not formatted again at each  */
+/*  redraw. The text width is measured only once for each entry.          */
+/*  All entries are invalidated at once by changing the stamp.            */
+/**************************************************************************/
+
+#define IMAT_DISPLAY_CACHE_SIZE 1024   /* must be a power of 2 */
+#define IMAT_DISPLAY_TEXT_MAX 32        /* longer values are not cached */
+
+typedef struct _ImatDisplayEntry
+{
+  int lin, col;          /* lin is the internal line (after sort) */
+  unsigned int stamp;    /* valid only when equal to the cache stamp */
+  int width;             /* text width in pixels, -1 if not measured yet */
+  char text[IMAT_DISPLAY_TEXT_MAX];
+} ImatDisplayEntry;
+
+struct _ImatDisplayCache
+{
+  ImatDisplayEntry entries[IMAT_DISPLAY_CACHE_SIZE];
+  unsigned int stamp;
+
+  /* not notified when changed, checked before draw */
+  char* font;
+  char* decimal_symbol;
+  int precision;
+};
+
+static ImatDisplayEntry* iMatrixDisplayCacheEntry(ImatDisplayCache* dcache, int lin, int col)
+{
+  return dcache->entries + (((unsigned int)lin * 37 + (unsigned int)col) & (IMAT_DISPLAY_CACHE_SIZE - 1));
+}
+
+static int iMatrixDisplayCacheCheckContext(Ihandle* ih, ImatDisplayCache* dcache)
+{
+  char* font = IupGetAttribute(ih, "FONT");
+  char* decimal_symbol = IupGetGlobal("DEFAULTDECIMALSYMBOL");
+  int precision = IupGetInt(NULL, "DEFAULTPRECISION");
+
+  if (precision == dcache->precision &&
+      iupStrEqual(font, dcache->font) &&
+      iupStrEqual(decimal_symbol, dcache->decimal_symbol))
+    return 1;
+
+  if (dcache->font) free(dcache->font);
+  if (dcache->decimal_symbol) free(dcache->decimal_symbol);
+  dcache->font = iupStrDup(font);
+  dcache->decimal_symbol = iupStrDup(decimal_symbol);
+  dcache->precision = precision;
+  return 0;
+}
+
+void iupMatrixDisplayCacheClear(Ihandle* ih)
+{
+  ImatDisplayCache* dcache = ih->data->display_cache;
+  if (dcache)
+  {
+    dcache->stamp++;
+    if (dcache->stamp == 0)
+    {
+      memset(dcache->entries, 0, sizeof(dcache->entries));
+      dcache->stamp = 1;
+    }
+  }
+}
+
+void iupMatrixDisplayCacheRelease(Ihandle* ih)
+{
+  ImatDisplayCache* dcache = ih->data->display_cache;
+  if (dcache)
+  {
+    if (dcache->font) free(dcache->font);
+    if (dcache->decimal_symbol) free(dcache->decimal_symbol);
+    free(dcache);
+    ih->data->display_cache = NULL;
+  }
+}
+
+void iupMatrixDisplayCacheCheck(Ihandle* ih)
+{
+  ImatDisplayCache* dcache = ih->data->display_cache;
+  if (dcache && !iMatrixDisplayCacheCheckContext(ih, dcache))
+    iupMatrixDisplayCacheClear(ih);
+}
+
+void iupMatrixDisplayCacheInvalidate(Ihandle* ih, int lin, int col)
+{
+  ImatDisplayCache* dcache = ih->data->display_cache;
+  if (dcache)
+  {
+    ImatDisplayEntry* entry = iMatrixDisplayCacheEntry(dcache, lin, col);
+    if (entry->lin == lin && entry->col == col)
+      entry->stamp = 0;
+  }
+}
+
+char* iupMatrixDisplayCacheGet(Ihandle* ih, int lin, int col)
+{
+  ImatDisplayCache* dcache = ih->data->display_cache;
+  if (dcache)
+  {
+    ImatDisplayEntry* entry = iMatrixDisplayCacheEntry(dcache, lin, col);
+    if (entry->stamp == dcache->stamp && entry->lin == lin && entry->col == col)
+      return entry->text;
+  }
+  return NULL;
+}
+
+char* iupMatrixDisplayCacheSet(Ihandle* ih, int lin, int col, char* value)
+{
+  ImatDisplayCache* dcache = ih->data->display_cache;
+  ImatDisplayEntry* entry;
+  int len = (int)strlen(value);
+
+  if (len >= IMAT_DISPLAY_TEXT_MAX)
+    return value;
+
+  if (!dcache)
+  {
+    dcache = (ImatDisplayCache*)calloc(1, sizeof(ImatDisplayCache));
+    dcache->stamp = 1;
+    iMatrixDisplayCacheCheckContext(ih, dcache);
+    ih->data->display_cache = dcache;
+  }
+
+  entry = iMatrixDisplayCacheEntry(dcache, lin, col);
+  entry->lin = lin;
+  entry->col = col;
+  entry->stamp = dcache->stamp;
+  entry->width = -1;
+  memcpy(entry->text, value, len + 1);
+  return entry->text;
+}
+
+int iupMatrixDisplayCacheGetWidth(Ihandle* ih, const char* value)
+{
+  /* value can be any string, the width is stored only when it is the text of an entry */
+  ImatDisplayCache* dcache = ih->data->display_cache;
+  int width;
+
+  if (dcache && value >= (char*)dcache->entries && value < (char*)(dcache->entries + IMAT_DISPLAY_CACHE_SIZE))
+  {
+    ImatDisplayEntry* entry = dcache->entries + (value - (char*)dcache->entries) / sizeof(ImatDisplayEntry);
+    if (entry->width == -1)
+      iupdrvFontGetMultiLineStringSize(ih, value, &entry->width, NULL);
+    return entry->width;
+  }
+
+  iupdrvFontGetMultiLineStringSize(ih, value, &width, NULL);
+  return width;
+}
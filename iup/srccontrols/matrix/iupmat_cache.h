@@ -0,0 +1,43 @@
+/** \file
+ * \brief iupmatrix. cache of values in callback mode and cache of displayed values.
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+#ifndef __IUPMAT_CACHE_H
+#define __IUPMAT_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void  iupMatrixCacheCreate(Ihandle* ih);
+void  iupMatrixCacheRelease(Ihandle* ih);
+
+/* lin is the internal line (after sort) */
+char* iupMatrixCacheGetValue(Ihandle* ih, int lin, int col);
+/* lin1 and lin2 are the displayed lines */
+void  iupMatrixCacheFetchRange(Ihandle* ih, int lin1, int col1, int lin2, int col2);
+void  iupMatrixCacheInvalidate(Ihandle* ih, int lin1, int col1, int lin2, int col2);
+void  iupMatrixCacheClear(Ihandle* ih);
+
+int   iupMatrixCacheSetInvalidateAttrib(Ihandle* ih, const char* value);
+int   iupMatrixCacheSetTilesAttrib(Ihandle* ih, const char* value);
+int   iupMatrixCacheSetPrefetchAttrib(Ihandle* ih, const char* value);
+char* iupMatrixCacheGetStatsAttrib(Ihandle* ih);
+
+/* Formatted values of numeric columns, used for draw and fit.
+   lin is the internal line (after sort). The returned text is valid until the next Set. */
+void  iupMatrixDisplayCacheRelease(Ihandle* ih);
+void  iupMatrixDisplayCacheClear(Ihandle* ih);
+void  iupMatrixDisplayCacheCheck(Ihandle* ih);
+void  iupMatrixDisplayCacheInvalidate(Ihandle* ih, int lin, int col);
+char* iupMatrixDisplayCacheGet(Ihandle* ih, int lin, int col);
+char* iupMatrixDisplayCacheSet(Ihandle* ih, int lin, int col, char* value);
+int   iupMatrixDisplayCacheGetWidth(Ihandle* ih, const char* value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
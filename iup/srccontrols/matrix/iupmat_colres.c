@@ -99,11 +99,13 @@ void iupMatrixColResFinish(Ihandle* ih, int x)
   iupAttribSetIntId(ih, "RASTERWIDTH", ih->data->colres_drag_col, width);
   iupAttribSetId(ih, "WIDTH", ih->data->colres_drag_col, NULL);
 
-  ih->data->need_calcsize = 1;
+  /* update only the size of this column */
+  iupMatrixAuxUpdateSize(ih, IMAT_PROCESS_COL, ih->data->colres_drag_col);
 
   if (!ih->data->edit_hide_onfocus && ih->data->editing)
   {
-    iupMatrixAuxCalcSizes(ih);
+    if (ih->data->need_calcsize || ih->data->need_calcvisible)
+      iupMatrixAuxCalcSizes(ih);
     iupMatrixEditUpdatePos(ih);
   }
 
@@ -36,6 +36,7 @@ extern "C" {
 #define IMAT_IS_NUMERIC  1      /* Is numeric */
 #define IMAT_HAS_FORMAT  2      /* has format for lin!= 0 */
 #define IMAT_HAS_FORMATTITLE 4  /* has format for lin== 0 */
+#define IMAT_HAS_STORE   8      /* has a typed store for lin!=0 */
 
 enum{IMAT_TYPE_TEXT,
      IMAT_TYPE_COLOR,
@@ -91,6 +92,9 @@ typedef struct _ImatLinColData
 
   int total_size;   /* Sum of the widths/heights of all columns/lines */
 
+  int* size_sums;   /* Fenwick tree of the widths/heights, size_sums[i] has the sum of a range that ends at i-1,
+                       used to compute offsets and find cells in O(log n) (allocated after map) */
+
   int focus_cell;   /* index of the current cell */
 } ImatLinColData;
 
@@ -99,8 +103,13 @@ typedef struct _ImatNumericData
   unsigned char quantity;
   unsigned char unit, unit_shown;
   unsigned char flags;  
+  double* store;        /* typed values, one for each line, used when IMAT_HAS_STORE (allocated with lines.num_alloc) */
+  unsigned char* store_valid;  /* bitmap, bit set when the line has a typed value and NO string value */
 } ImatNumericData;
 
+typedef struct _ImatCache ImatCache;  /* defined in iupmat_cache.c */
+typedef struct _ImatDisplayCache ImatDisplayCache;  /* defined in iupmat_cache.c */
+
 typedef struct _ImatMergedData
 {
   int start_lin;
@@ -134,6 +143,7 @@ struct _IcontrolData
   int w, h;
   int callback_mode;
   int need_calcsize;
+  int need_calcvisible;  /* sizes were updated incrementally, only the visible area and the scrollbars must be updated */
   int need_redraw;
   int inside_markedit_cb;   /* avoid recursion */
   int last_sort_col;
@@ -144,6 +154,7 @@ struct _IcontrolData
   int use_title_size;   /* use title contents when calculating cell size */
   int limit_expand; /* limit expand to maximum size */
   int undo_redo, 
+      find_index,   /* notify IupMatrixEx of cell changes, for FINDINDEX */
       flat,
       show_fill_value;
 
@@ -182,14 +193,36 @@ struct _IcontrolData
   char numeric_buffer_set[80];
   ImatNumericData* numeric_columns;   /* information for numeric columns (allocated after map) */
   ImatNumericConvertFunc numeric_convert_func;
+  ImatDisplayCache* display_cache;    /* formatted values (allocated when used) */
 
   /* Column Sort */
   int* sort_line_index;     /* Remap index of the line */
   int sort_has_index;       /* has a remap index of columns/lines */
+  int sort_inverted;        /* SORTCOLUMN=INVERT was used after the last sort */
+  int* sort_changed_lines;  /* internal lines changed after the last sort, used by SORTCOLUMN=UPDATE */
+  int sort_changed_count,   /* -1 if too many lines changed */
+      sort_changed_max;
 
   /* merged ranges */
   ImatMergedData* merge_info;  /* must free if not NULL */
   int merge_info_max, merge_info_count;
+
+  /* Callback mode */
+  ImatCache* cache;   /* values of VALUES_RANGE_CB (allocated after map) */
+  unsigned char callback_cell_flags;  /* IMAT_HAS_* of the cell attributes set, cells are not allocated in callback mode */
+
+  /* Retained buffer, used only when RETAINEDBUFFER=Yes (the canvas is a CD_IUPDBUFFER) */
+  int retained_buffer,   /* the off-screen image is kept between redraws */
+      retained_valid,    /* the image contains the last drawn frame */
+      retained_partial;  /* redraw requested by the matrix itself, the image can be reused */
+  int retained_w, retained_h;
+  int retained_lin_pos, retained_col_pos;      /* scroll position in pixels of the last drawn frame */
+  int retained_focus_lin, retained_focus_col;  /* focus cell of the last drawn frame, -1 if not drawn */
+  int dirty_lin1, dirty_col1, dirty_lin2, dirty_col2;  /* cells to be redrawn, dirty_lin1=-1 if none */
+
+  /* Redraw statistics */
+  int redraw_cells;      /* cells, including titles, painted in the last frame */
+  int redraw_full_count, redraw_partial_count;
 };
 
 
@@ -204,6 +237,10 @@ int iupMatrixIsCharacter(int c);
 #define iupMATRIX_CHECK_COL(_ih, _col) ((_col >= 0) && (_col < (_ih)->data->columns.num))
 #define iupMATRIX_CHECK_LIN(_ih, _lin) ((_lin >= 0) && (_lin < (_ih)->data->lines.num))
 
+#define iupMATRIX_STORE_ISVALID(_nd, _lin)  ((_nd)->store_valid[(_lin) >> 3] & (1 << ((_lin) & 7)))
+#define iupMATRIX_STORE_SETVALID(_nd, _lin) ((_nd)->store_valid[(_lin) >> 3] |= (unsigned char)(1 << ((_lin) & 7)))
+#define iupMATRIX_STORE_CLRVALID(_nd, _lin) ((_nd)->store_valid[(_lin) >> 3] &= (unsigned char)~(1 << ((_lin) & 7)))
+
 int iupMatrixGetScrollbar(Ihandle* ih);
 int iupMatrixGetScrollbarSize(Ihandle* ih);
 int iupMatrixGetWidth(Ihandle* ih);
@@ -32,6 +32,7 @@
 #include "iupmat_aux.h"
 #include "iupmat_getset.h"
 #include "iupmat_mark.h"
+#include "iupmat_cache.h"
 
 
 #define IMAT_FEEDBACK_SIZE 16
@@ -502,8 +503,7 @@ static void iMatrixDrawText(Ihandle* ih, int x1, int x2, int y1, int y2, int col
 
   if (lin == 0 || ih->data->hidden_text_marks)
   {
-    int text_w;
-    iupdrvFontGetMultiLineStringSize(ih, text, &text_w, NULL);
+    int text_w = iupMatrixDisplayCacheGetWidth(ih, text);
     if (text_w > x2 - x1 + 1 - IMAT_PADDING_W - IMAT_FRAME_W)
     {
       if (lin == 0)
@@ -752,7 +752,7 @@ static void iMatrixDrawCellValue(Ihandle* ih, int x1, int x2, int y1, int y2, in
   if (draw_cb && !iMatrixDrawCallDrawCB(ih, lin, col, x1, x2, y1, y2, draw_cb))
     return;
 
-  value = iupMatrixGetValueDisplay(ih, lin, col);
+  value = iupMatrixGetValueDisplayCached(ih, lin, col);
 
   /* Put the text */
   if (value && *value)
@@ -981,6 +981,9 @@ static void iMatrixDrawTitleLines(Ihandle* ih, int lin1, int lin2)
   active = iupdrvIsActive(ih);
   draw_cb = (IFniiiiiiC)IupGetCallback(ih, "DRAW_CB");
 
+  if (ih->data->cache)
+    iupMatrixCacheFetchRange(ih, lin1, 0, lin2, 0);
+
   col_alignment = iupMatrixGetColAlignment(ih, 0);
 
   /* Draw the titles */
@@ -997,6 +1000,7 @@ static void iMatrixDrawTitleLines(Ihandle* ih, int lin1, int lin2)
       merged = iupMatrixGetMerged(ih, lin, 0);
 
     y2 = y1 + ih->data->lines.dt[lin].size;
+    ih->data->redraw_cells++;
 
     if (merged)
     {
@@ -1095,6 +1099,10 @@ static void iMatrixDrawTitleColumns(Ihandle* ih, int col1, int col2)
   framehighlight = iupAttribGetInt(ih, "FRAMETITLEHIGHLIGHT");
   active = iupdrvIsActive(ih);
   draw_cb = (IFniiiiiiC)IupGetCallback(ih, "DRAW_CB");
+
+  if (ih->data->cache)
+    iupMatrixCacheFetchRange(ih, 0, col1, 0, col2);
+
   col_alignment = iupMatrixGetColAlignmentLin0(ih);
   lin_alignment = iupMatrixGetLinAlignment(ih, 0);
 
@@ -1112,6 +1120,7 @@ static void iMatrixDrawTitleColumns(Ihandle* ih, int col1, int col2)
       merged = iupMatrixGetMerged(ih, 0, col);
 
     x2 = x1 + ih->data->columns.dt[col].size;
+    ih->data->redraw_cells++;
 
     if (merged)
     {
@@ -1294,6 +1303,9 @@ static void iMatrixDrawCells(Ihandle* ih, int lin1, int col1, int lin2, int col2
   draw_cb = (IFniiiiiiC)IupGetCallback(ih, "DRAW_CB");
   toggle_centered = iupAttribGetBoolean(ih, "TOGGLECENTERED");
 
+  if (ih->data->cache)
+    iupMatrixCacheFetchRange(ih, lin1, col1, lin2, col2);  /* a single VALUES_RANGE_CB for the block */
+
   for (col = col1; col <= col2; col++)  /* For all the columns in the region */
   {
     int last_x2, last_y2;
@@ -1323,6 +1335,8 @@ static void iMatrixDrawCells(Ihandle* ih, int lin1, int col1, int lin2, int col2
       y2 = y1 + ih->data->lines.dt[lin].size;
       last_y2 = y2;
 
+      ih->data->redraw_cells++;
+
       if (merged)
       {
         int startLin, endLin, startCol, endCol;
@@ -1479,16 +1493,154 @@ static void iMatrixDrawMatrix(Ihandle* ih)
   }
 }
 
+#ifndef USE_OLD_DRAW
+static void iMatrixDrawAddDirty(Ihandle* ih, int lin1, int col1, int lin2, int col2)
+{
+  if (ih->data->dirty_lin1 == -1)
+  {
+    ih->data->dirty_lin1 = lin1;
+    ih->data->dirty_col1 = col1;
+    ih->data->dirty_lin2 = lin2;
+    ih->data->dirty_col2 = col2;
+  }
+  else
+  {
+    if (lin1 < ih->data->dirty_lin1) ih->data->dirty_lin1 = lin1;
+    if (col1 < ih->data->dirty_col1) ih->data->dirty_col1 = col1;
+    if (lin2 > ih->data->dirty_lin2) ih->data->dirty_lin2 = lin2;
+    if (col2 > ih->data->dirty_col2) ih->data->dirty_col2 = col2;
+  }
+}
+
+/* Returns the visible scrollable columns/lines that intersect the interval [pos1,pos2] in pixels */
+static int iMatrixDrawGetVisibleRange(ImatLinColData* p, int pos1, int pos2, int *index1, int *index2)
+{
+  int i, pos = iupMatrixAuxGetNoScrollSize(p) - p->first_offset;
+
+  *index1 = -1;
+  for (i = p->first; i <= p->last && pos <= pos2; i++)
+  {
+    int size = p->dt[i].size;
+    if (size && pos + size - 1 >= pos1)
+    {
+      if (*index1 == -1)
+        *index1 = i;
+      *index2 = i;
+    }
+    pos += size;
+  }
+
+  return *index1 != -1;
+}
+
+/* Draw the titles and cells inside the range, lin=0 and col=0 are the titles.
+   The non scrollable part of the range is always drawn entirely. */
+static void iMatrixDrawRange(Ihandle* ih, int lin1, int col1, int lin2, int col2)
+{
+  int lin_noscroll = ih->data->lines.num_noscroll;
+  int col_noscroll = ih->data->columns.num_noscroll;
+
+  if (lin1 == 0 && col1 == 0)
+    iMatrixDrawTitleCorner(ih);
+
+  if (lin1 == 0)
+  {
+    if (col1 < col_noscroll && col_noscroll > 1)
+      iMatrixDrawTitleColumns(ih, 1, col_noscroll - 1);
+    if (col2 >= col_noscroll)
+      iMatrixDrawTitleColumns(ih, col1 > col_noscroll ? col1 : col_noscroll, col2);
+    lin1 = 1;
+  }
+
+  if (col1 == 0)
+  {
+    if (lin1 < lin_noscroll && lin_noscroll > 1)
+      iMatrixDrawTitleLines(ih, 1, lin_noscroll - 1);
+    if (lin2 >= lin_noscroll)
+      iMatrixDrawTitleLines(ih, lin1 > lin_noscroll ? lin1 : lin_noscroll, lin2);
+    col1 = 1;
+  }
+
+  if (lin1 > lin2 || col1 > col2)
+    return;
+
+  if (lin1 < lin_noscroll)
+  {
+    if (col1 < col_noscroll)
+      iMatrixDrawCells(ih, 1, 1, lin_noscroll - 1, col_noscroll - 1);
+    if (col2 >= col_noscroll)
+      iMatrixDrawCells(ih, 1, col1 > col_noscroll ? col1 : col_noscroll, lin_noscroll - 1, col2);
+  }
+
+  if (lin2 >= lin_noscroll)
+  {
+    if (lin1 < lin_noscroll)
+      lin1 = lin_noscroll;
+
+    if (col1 < col_noscroll)
+      iMatrixDrawCells(ih, lin1, 1, lin2, col_noscroll - 1);
+    if (col2 >= col_noscroll)
+      iMatrixDrawCells(ih, lin1, col1 > col_noscroll ? col1 : col_noscroll, lin2, col2);
+  }
+}
+
+/* Reuse the retained image of the previous frame.
+   Shift the scrollable area by the scroll difference, 
+   then draw only the exposed lines/columns and the cells marked as dirty.
+   Returns 0 if everything must be redrawn. */
+static int iMatrixDrawRetained(Ihandle* ih)
+{
+  cdCanvas* cd_canvas = ih->data->cd_canvas;
+  int width = iupMatrixGetWidth(ih);
+  int height = iupMatrixGetHeight(ih);
+  int x0 = iupMatrixAuxGetNoScrollSize(&ih->data->columns);
+  int y0 = iupMatrixAuxGetNoScrollSize(&ih->data->lines);
+  int dx = ih->data->retained_col_pos - iupMatrixAuxGetScrollPos(&ih->data->columns);
+  int dy = ih->data->retained_lin_pos - iupMatrixAuxGetScrollPos(&ih->data->lines);
+  int index1, index2;
+
+  if (abs(dx) >= width - x0 || abs(dy) >= height - y0)
+    return 0;
+
+  cdCanvasClip(cd_canvas, CD_CLIPOFF);
+
+  /* the non scrollable area is not changed, 
+     remember that the CD Y axis is inverted */
+  if (dx > 0)
+    cdCanvasScrollArea(cd_canvas, x0, width - 1 - dx, iupMATRIX_INVERTYAXIS(ih, height - 1), iupMATRIX_INVERTYAXIS(ih, 0), dx, 0);
+  else if (dx < 0)
+    cdCanvasScrollArea(cd_canvas, x0 - dx, width - 1, iupMATRIX_INVERTYAXIS(ih, height - 1), iupMATRIX_INVERTYAXIS(ih, 0), dx, 0);
+
+  if (dy > 0)
+    cdCanvasScrollArea(cd_canvas, 0, width - 1, iupMATRIX_INVERTYAXIS(ih, height - 1 - dy), iupMATRIX_INVERTYAXIS(ih, y0), 0, -dy);
+  else if (dy < 0)
+    cdCanvasScrollArea(cd_canvas, 0, width - 1, iupMATRIX_INVERTYAXIS(ih, height - 1), iupMATRIX_INVERTYAXIS(ih, y0 - dy), 0, -dy);
+
+  /* exposed columns, including their titles */
+  if (dx && iMatrixDrawGetVisibleRange(&ih->data->columns, dx > 0 ? x0 : width + dx, dx > 0 ? x0 + dx - 1 : width - 1, &index1, &index2))
+    iMatrixDrawRange(ih, 0, index1, ih->data->lines.num - 1, index2);
+
+  /* exposed lines, including their titles */
+  if (dy && iMatrixDrawGetVisibleRange(&ih->data->lines, dy > 0 ? y0 : height + dy, dy > 0 ? y0 + dy - 1 : height - 1, &index1, &index2))
+    iMatrixDrawRange(ih, index1, 0, index2, ih->data->columns.num - 1);
+
+  /* erase the previous focus feedback */
+  if (ih->data->retained_focus_lin != -1)
+    iMatrixDrawAddDirty(ih, ih->data->retained_focus_lin, ih->data->retained_focus_col, ih->data->retained_focus_lin, ih->data->retained_focus_col);
+
+  if (ih->data->dirty_lin1 != -1)
+    iMatrixDrawRange(ih, ih->data->dirty_lin1, ih->data->dirty_col1, ih->data->dirty_lin2, ih->data->dirty_col2);
+
+  return 1;
+}
+#endif
+
 void iupMatrixDrawCells(Ihandle* ih, int lin1, int col1, int lin2, int col2)
 {
 #ifdef USE_OLD_DRAW
   iMatrixDrawCells(ih, lin1, col1, lin2, col2);
 #else
-  (void)ih;
-  (void)lin1;
-  (void)col1;
-  (void)lin2;
-  (void)col2;
+  iMatrixDrawAddDirty(ih, lin1, col1, lin2, col2);
 #endif
 }
 
@@ -1497,9 +1649,7 @@ void iupMatrixDrawTitleColumns(Ihandle* ih, int col1, int col2)
 #ifdef USE_OLD_DRAW
   iMatrixDrawTitleColumns(ih, col1, col2);
 #else
-  (void)ih;
-  (void)col1;
-  (void)col2;
+  iMatrixDrawAddDirty(ih, 0, col1, 0, col2);
 #endif
 }
 
@@ -1508,9 +1658,7 @@ void iupMatrixDrawTitleLines(Ihandle* ih, int lin1, int lin2)
 #ifdef USE_OLD_DRAW
   iMatrixDrawTitleLines(ih, lin1, lin2);
 #else
-  (void)ih;
-  (void)lin1;
-  (void)lin2;
+  iMatrixDrawAddDirty(ih, lin1, 0, lin2, 0);
 #endif
 }
 
@@ -1519,18 +1667,30 @@ void iupMatrixDraw(Ihandle* ih, int update)
 #ifdef USE_OLD_DRAW
   cdCanvasActivate(ih->data->cd_canvas);
 
-  if (ih->data->need_calcsize)
+  if (ih->data->need_calcsize || ih->data->need_calcvisible)
     iupMatrixAuxCalcSizes(ih);
 
   iMatrixDrawMatrix(ih);
 
   ih->data->need_redraw = 0;
+#else
+  ih->data->retained_valid = 0;
 #endif
 
   if (update)
     iupMatrixDrawUpdate(ih);
 }
 
+void iupMatrixDrawScroll(Ihandle* ih, int update)
+{
+#ifdef USE_OLD_DRAW
+  iupMatrixDraw(ih, update);
+#else
+  if (update)
+    iupMatrixDrawUpdate(ih);
+#endif
+}
+
 void iupMatrixDrawUpdate(Ihandle* ih)
 {
 #ifdef USE_OLD_DRAW
@@ -1545,6 +1705,7 @@ void iupMatrixDrawUpdate(Ihandle* ih)
   if (!ih->data->edit_hide_onfocus && ih->data->editing)
     IupUpdate(ih->data->datah);
 #else
+  ih->data->retained_partial = 1;
   iupdrvRedrawNow(ih);
 #endif
 }
@@ -1563,8 +1724,13 @@ static int iMatrixDrawHasFlatScrollBar(Ihandle* ih)
 #ifndef USE_OLD_DRAW
 void iupMatrixDrawCB(Ihandle* ih)
 {
+  /* the retained image can be reused only if the redraw was requested by the matrix itself,
+     and if nothing that affects all the cells was changed */
+  int partial = ih->data->retained_valid && ih->data->retained_partial &&
+                !ih->data->need_redraw && !ih->data->need_calcsize && !ih->data->need_calcvisible;
+
   /* called only from the ACTION callback */
-  if (ih->data->need_calcsize)
+  if (ih->data->need_calcsize || ih->data->need_calcvisible)
   {
     int sb_resize = iupMatrixAuxCalcSizes(ih);  /* does not use cd_canvas, can be done before Activate, */
     if (sb_resize)                              /* but it can trigger a resize+redraw event */
@@ -1579,13 +1745,39 @@ void iupMatrixDrawCB(Ihandle* ih)
 
   cdCanvasActivate(ih->data->cd_canvas);
 
-  iMatrixDrawMatrix(ih);
+  ih->data->redraw_cells = 0;
+
+  if (partial && (ih->data->w != ih->data->retained_w || ih->data->h != ih->data->retained_h ||
+                  ih->data->merge_info_count || iupAttribGetBoolean(ih, "FRAMEBORDER")))
+    partial = 0;
+
+  if (partial)
+  {
+    iupMatrixPrepareDrawData(ih);
+    partial = iMatrixDrawRetained(ih);
+  }
+
+  if (partial)
+    ih->data->redraw_partial_count++;
+  else
+  {
+    iMatrixDrawMatrix(ih);
+    ih->data->redraw_full_count++;
+  }
 
   ih->data->need_redraw = 0;
+  ih->data->dirty_lin1 = -1;
 
   if (ih->data->has_focus)
+  {
     iMatrixDrawFocus(ih);
 
+    ih->data->retained_focus_lin = ih->data->lines.focus_cell;
+    ih->data->retained_focus_col = ih->data->columns.focus_cell;
+  }
+  else
+    ih->data->retained_focus_lin = -1;
+
   if (ih->data->colres_feedback)
     iMatrixDrawColRes(ih);
 
@@ -1593,6 +1785,14 @@ void iupMatrixDrawCB(Ihandle* ih)
 
   cdCanvasDeactivate(ih->data->cd_canvas);
 
+  /* the colres feedback is not part of the retained image */
+  ih->data->retained_valid = ih->data->retained_buffer && !ih->data->colres_feedback;
+  ih->data->retained_partial = 0;
+  ih->data->retained_w = ih->data->w;
+  ih->data->retained_h = ih->data->h;
+  ih->data->retained_lin_pos = iupMatrixAuxGetScrollPos(&ih->data->lines);
+  ih->data->retained_col_pos = iupMatrixAuxGetScrollPos(&ih->data->columns);
+
   if (!ih->data->edit_hide_onfocus && ih->data->editing)
     IupUpdate(ih->data->datah);
 }
@@ -1636,7 +1836,7 @@ int iupMatrixDrawSetRedrawAttrib(Ihandle* ih, const char* value)
 
     iupMatrixPrepareDrawData(ih);
 
-    if (ih->data->need_calcsize)
+    if (ih->data->need_calcsize || ih->data->need_calcvisible)
       iupMatrixAuxCalcSizes(ih);
 
     /* ignore empty area, draw only cells */
@@ -1685,6 +1885,7 @@ int iupMatrixDrawSetRedrawAttrib(Ihandle* ih, const char* value)
   ih->data->need_redraw = 0;
   iupMatrixDrawUpdate(ih);
 #else
+  ih->data->retained_valid = 0;
   IupRedraw(ih, 0);  /* redraw now */
   (void)value;
 #endif
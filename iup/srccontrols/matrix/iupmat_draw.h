@@ -12,7 +12,8 @@
 extern "C" {
 #endif
 
-/* Render the specified cells only, does nothing when using IupDraw */
+/* Render the specified cells only. When using IupDraw nothing is drawn,
+   but the cells are marked to be redrawn when RETAINEDBUFFER=Yes. */
 void iupMatrixDrawCells(Ihandle* ih, int lin1, int col1, int lin2, int col2);
 void iupMatrixDrawTitleColumns(Ihandle* ih, int col1, int col2);
 void iupMatrixDrawTitleLines(Ihandle* ih, int lin1, int lin2);
@@ -21,11 +22,16 @@ void iupMatrixDrawTitleLines(Ihandle* ih, int lin1, int lin2);
    Optionally update the display by calling iupMatrixDrawUpdate. */
 void iupMatrixDraw(Ihandle* ih, int update);
 
+/* Same as iupMatrixDraw, but called when only first/first_offset were changed,
+   so the retained buffer can be scrolled instead of redrawn. */
+void iupMatrixDrawScroll(Ihandle* ih, int update);
+
 /* Update the display only, only calls IupUpdate when using IupDraw */
 void iupMatrixDrawUpdate(Ihandle* ih);
 
 #ifndef USE_OLD_DRAW
-/* Redraw everything, called only from the ACTION callback */
+/* Redraw everything, or only what changed when RETAINEDBUFFER=Yes,
+   called only from the ACTION callback */
 void iupMatrixDrawCB(Ihandle* ih);
 #endif
 
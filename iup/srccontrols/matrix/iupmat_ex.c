@@ -27,6 +27,8 @@
 #include "iupmat_getset.h"
 #include "iupmat_draw.h"
 #include "iupmat_aux.h"
+#include "iupmat_sort.h"
+#include "iupmat_cache.h"
 
 
 /* Exported to IupMatrixEx */
@@ -44,6 +46,32 @@ void iupMatrixExSetCellValue(Ihandle* ih, int lin, int col, const char* value)
   iupMatrixModifyValue(ih, lin, col, value);
 }
 
+/* Exported to IupMatrixEx */
+int iupMatrixExGetCellNumber(Ihandle* ih, int lin, int col, double *number)
+{
+  return iupMatrixGetValueStored(ih, lin, col, number);  /* Internal typed value, if any */
+}
+
+/* Exported to IupMatrixEx */
+void iupMatrixExSetCellNumber(Ihandle* ih, int lin, int col, double number)
+{
+  iupMatrixModifyValueNumber(ih, lin, col, number);
+}
+
+/* Exported to IupMatrixEx */
+void iupMatrixExRestoreCellValue(Ihandle* ih, int lin, int col, const char* value)
+{
+  /* Used by Undo/Redo, EDITION_CB is not called,
+     VALUE_EDIT_CB only in callback mode where it stores the value. */
+  iupMatrixSetValue(ih, lin, col, value, ih->data->callback_mode? -1: 0);
+}
+
+/* Exported to IupMatrixEx */
+void iupMatrixExRestoreCellNumber(Ihandle* ih, int lin, int col, double number)
+{
+  iupMatrixSetValueNumber(ih, lin, col, number);  /* no callbacks */
+}
+
 static int iMatrixInitNumericColumns(Ihandle* ih, int col)
 {
   if (!iupMATRIX_CHECK_COL(ih, col))
@@ -55,16 +83,39 @@ static int iMatrixInitNumericColumns(Ihandle* ih, int col)
   return 1;
 }
 
+static int iMatrixIsNumericStoreActive(unsigned char flags)
+{
+  return (flags & IMAT_IS_NUMERIC) && (flags & IMAT_HAS_STORE);
+}
+
+static void iMatrixNumericDisplayChanged(Ihandle* ih)
+{
+  /* the displayed text of the numeric cells changed */
+  iupMatrixDisplayCacheClear(ih);
+  if (ih->data->find_index) iupAttribSetClassObject(ih, "FINDINDEXCLEAR", NULL);
+}
+
 static int iMatrixSetNumericFlag(Ihandle* ih, int col, unsigned char attr, int set)
 {
+  unsigned char old_flags;
+
   if (!iMatrixInitNumericColumns(ih, col))
     return 0;
 
+  old_flags = ih->data->numeric_columns[col].flags;
+
+  /* format or conversion may have changed */
+  iMatrixNumericDisplayChanged(ih);
+
   if (set)
     ih->data->numeric_columns[col].flags |= attr;
   else
     ih->data->numeric_columns[col].flags &= ~attr;
 
+  /* the typed store is used only while the column is numeric */
+  if (iMatrixIsNumericStoreActive(old_flags) != iMatrixIsNumericStoreActive(ih->data->numeric_columns[col].flags))
+    iupMatrixSetNumericStore(ih, col, iMatrixIsNumericStoreActive(ih->data->numeric_columns[col].flags));
+
   return 1;
 }
 
@@ -87,6 +138,15 @@ static int iMatrixSetNumericFormatAttrib(Ihandle* ih, int col, const char* value
   return iMatrixSetNumericFlag(ih, col, IMAT_HAS_FORMAT, value!=NULL);
 }
 
+static int iMatrixSetNumericStoreAttrib(Ihandle* ih, int col, const char* value)
+{
+  if (ih->data->callback_mode)
+    return 0;
+
+  iMatrixSetNumericFlag(ih, col, IMAT_HAS_STORE, iupStrBoolean(value));
+  return 1;
+}
+
 static int iMatrixSetNumericFormatPrecisionAttrib(Ihandle* ih, int col, const char* value)
 {
   int precision;
@@ -107,6 +167,20 @@ static int iMatrixSetNumericFormatPrecisionAttrib(Ihandle* ih, int col, const ch
   return 0;
 }
 
+static int iMatrixSetNumericFormatDefAttrib(Ihandle* ih, const char* value)
+{
+  iMatrixNumericDisplayChanged(ih);
+  (void)value;
+  return 1;
+}
+
+static int iMatrixSetNumericDecimalSymbolAttrib(Ihandle* ih, const char* value)
+{
+  iMatrixNumericDisplayChanged(ih);
+  (void)value;
+  return 1;
+}
+
 static char* iMatrixGetNumericDecimalSymbolAttrib(Ihandle* ih)
 {
   char* value = iupAttribGet(ih, "NUMERICDECIMALSYMBOL");
@@ -146,6 +220,7 @@ static int iMatrixSetNumericUnitIndexAttrib(Ihandle* ih, int col, const char* va
       return 0;
 
     /* no need to check for a valid unit since it is done by the actual unit implementation */
+    iMatrixNumericDisplayChanged(ih);
     ih->data->numeric_columns[col].unit = (unsigned char)unit;
     return 1;
   }
@@ -161,67 +236,25 @@ static int iMatrixSetNumericUnitShownIndexAttrib(Ihandle* ih, int col, const cha
       return 0;
 
     /* no need to check for a valid unit since it is done by the actual unit implementation */
+    iMatrixNumericDisplayChanged(ih);
     ih->data->numeric_columns[col].unit_shown = (unsigned char)unit_shown;
     return 1;
   }
   return 0;
 }
 
-static IFniii   iMatrixQSort_sort_cb = NULL;
-static Ihandle* iMatrixQSort_ih = NULL;
-static int      iMatrixQSort_col = 0;
-
-static int iMatrixCompareCallbackFunc(const void* elem1, const void* elem2)
-{
-  int lin1 = *((int*)elem1);
-  int lin2 = *((int*)elem2);
-  return iMatrixQSort_sort_cb(iMatrixQSort_ih, iMatrixQSort_col, lin1, lin2);
-}
-
-typedef struct _ImatSortNumber {
-  int lin;
-  double number;
-} ImatSortNumber;
-
-static int iMatrixCompareNumberFunc(const void* elem1, const void* elem2)
-{
-  ImatSortNumber* num1 = (ImatSortNumber*)elem1;
-  ImatSortNumber* num2 = (ImatSortNumber*)elem2;
-  if (num1->number < num2->number)
-    return -1;
-  if (num1->number > num2->number)
-    return 1;
-  return 0;
-}
-
-static int iMatrixQSort_utf8 = 0;
-static int iMatrixQSort_casesensitive = 1;
-
-typedef struct _ImatSortText {
-  int lin;
-  char* text;
-} ImatSortText;
-
-static int iMatrixCompareTextFunc(const void* elem1, const void* elem2)
-{
-  ImatSortText* txt1 = (ImatSortText*)elem1;
-  ImatSortText* txt2 = (ImatSortText*)elem2;
-  if ((!txt1->text || txt1->text[0]==0) && (!txt2->text || txt2->text[0]==0)) return 0;
-  if (!txt1->text || txt1->text[0]==0) return -1;    /* txt1 < txt2 => -1 */
-  if (!txt2->text || txt2->text[0]==0) return 1;
-  return iupStrCompare(txt1->text, txt2->text, iMatrixQSort_casesensitive, iMatrixQSort_utf8);
-}
-
 static int iMatrixSetSortColumnAttrib(Ihandle* ih, int col, const char* value)
 {
   int lines_num = ih->data->lines.num;
   int lin, lin1=1, lin2=lines_num-1;   /* ALL */
   int ascending;
   int* sort_line_index;
-  IFniii sort_cb;
 
   /* Notice that sort_line_index[0] is always 0 */
 
+  /* the find index is stored by displayed line */
+  if (ih->data->find_index) iupAttribSetClassObject(ih, "FINDINDEXCLEAR", NULL);
+
   if (!ih->data->sort_line_index)
     ih->data->sort_line_index = (int*)calloc(ih->data->lines.num_alloc, sizeof(int));
 
@@ -260,6 +293,8 @@ static int iMatrixSetSortColumnAttrib(Ihandle* ih, int col, const char* value)
       sort_line_index[l2] = tmp;
     }
 
+    ih->data->sort_inverted = !ih->data->sort_inverted;
+
     if (iupStrEqualNoCase(iupAttribGetId(ih, "SORTSIGN", ih->data->last_sort_col), "UP"))
       iupAttribSetId(ih, "SORTSIGN", ih->data->last_sort_col, "DOWN");
     else
@@ -269,82 +304,35 @@ static int iMatrixSetSortColumnAttrib(Ihandle* ih, int col, const char* value)
     return 0;
   }
 
+  if (iupStrEqualNoCase(value, "UPDATE"))
+  {
+    if (!ih->data->sort_has_index || !ih->data->last_sort_col)
+      return 0;
+
+    /* same column and interval of the last sort, only the changed lines are moved */
+    IupGetIntInt(ih, "SORTCOLUMNINTERVAL", &lin1, &lin2);
+    iupMatrixSortUpdateLines(ih, ih->data->last_sort_col, lin1, lin2);
+
+    iupMatrixDraw(ih, 1);
+    return 0;
+  }
+
   if (!iupMATRIX_CHECK_COL(ih, col))
     return 0;
 
   if (!iupStrEqualNoCase(value, "ALL"))
     iupStrToIntInt(value, &lin1, &lin2, '-');
 
-  iupAttribSetStrf(ih, "SORTCOLUMNINTERVAL", "%d,%d", lin1, lin2);
-
   if (lin1 < 1) lin1 = 1;
   if (lin2 < lin1) lin2 = lin1;
+  if (lin2 > lines_num-1) lin2 = lines_num-1;
 
-  ascending = iupStrEqualNoCase(iupAttribGetStr(ih, "SORTCOLUMNORDER"), "ASCENDING");
-  
-  sort_cb = (IFniii)IupGetCallback(ih, "SORTCOLUMNCOMPARE_CB");
-  if (sort_cb)
-  {
-    iMatrixQSort_sort_cb = sort_cb;
-    iMatrixQSort_ih = ih;
-    iMatrixQSort_col = col;
-    qsort(sort_line_index+lin1,lin2-lin1+1,sizeof(int),iMatrixCompareCallbackFunc);
-  }
-  else
-  {
-    if (ih->data->numeric_columns && ih->data->numeric_columns[col].flags & IMAT_IS_NUMERIC)
-    {
-      ImatSortNumber* sort_line_number = (ImatSortNumber*)malloc((lin2-lin1+1)*sizeof(ImatSortNumber));
-
-      for (lin=lin1; lin<=lin2; lin++)
-      {
-        sort_line_number[lin-lin1].lin = sort_line_index[lin];
-        sort_line_number[lin-lin1].number = iupMatrixGetValueNumeric(ih, lin, col);
-      }
-
-      qsort(sort_line_number,lin2-lin1+1,sizeof(ImatSortNumber), iMatrixCompareNumberFunc);
-
-      for (lin=lin1; lin<=lin2; lin++)
-      {
-        if (ascending)
-          sort_line_index[lin] = sort_line_number[lin-lin1].lin;
-        else
-          sort_line_index[lin2 - (lin-lin1)] = sort_line_number[lin-lin1].lin;
-      }
-
-      free(sort_line_number);
-    }
-    else
-    {
-      ImatSortText* sort_line_text = (ImatSortText*)malloc((lin2-lin1+1)*sizeof(ImatSortText));
-
-      for (lin=lin1; lin<=lin2; lin++)
-      {
-        sort_line_text[lin-lin1].lin = sort_line_index[lin];
-        sort_line_text[lin-lin1].text = iupMatrixGetValueDisplay(ih, lin, col);
-
-        if (ih->data->callback_mode)
-          sort_line_text[lin-lin1].text = iupStrDup(sort_line_text[lin-lin1].text);
-      }
-
-      iMatrixQSort_utf8 = IupGetInt(NULL, "UTF8MODE");
-      iMatrixQSort_casesensitive = iupAttribGetInt(ih, "SORTCOLUMNCASESENSITIVE");
-      qsort(sort_line_text,lin2-lin1+1,sizeof(ImatSortText), iMatrixCompareTextFunc);
-
-      for (lin=lin1; lin<=lin2; lin++)
-      {
-        if (ascending)
-          sort_line_index[lin] = sort_line_text[lin-lin1].lin;
-        else
-          sort_line_index[lin2 - (lin-lin1)] = sort_line_text[lin-lin1].lin;
+  iupAttribSetStrf(ih, "SORTCOLUMNINTERVAL", "%d,%d", lin1, lin2);
 
-        if (ih->data->callback_mode && sort_line_text[lin-lin1].text)
-          free(sort_line_text[lin-lin1].text);
-      }
+  ascending = iupStrEqualNoCase(iupAttribGetStr(ih, "SORTCOLUMNORDER"), "ASCENDING");
 
-      free(sort_line_text);
-    }
-  }
+  ih->data->sort_inverted = 0;
+  iupMatrixSortLines(ih, col, lin1, lin2);
 
   iupAttribSetId(ih, "SORTSIGN", ih->data->last_sort_col, NULL);
   if (ascending)
@@ -385,6 +373,12 @@ static char* iMatrixGetUndoRedoAttrib(Ihandle* ih)
   return iupStrReturnBoolean(ih->data->undo_redo); 
 }
 
+static int iMatrixSetFindIndexNotifyAttrib(Ihandle* ih, const char* value)
+{
+  ih->data->find_index = iupStrBoolean(value);
+  return 0;
+}
+
 void iupMatrixRegisterEx(Iclass* ic)
 {
   /* Undocumented features, will be exposed in IupMatrixEx */
@@ -394,10 +388,11 @@ void iupMatrixRegisterEx(Iclass* ic)
   iupClassRegisterAttributeId(ic, "NUMERICFORMAT", NULL, iMatrixSetNumericFormatAttrib, IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId(ic, "NUMERICFORMATPRECISION", iMatrixGetNumericFormatPrecisionAttrib, iMatrixSetNumericFormatPrecisionAttrib, IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId(ic, "NUMERICFORMATTITLE", NULL, iMatrixSetNumericFormatTitleAttrib, IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId(ic, "NUMERICSTORE", NULL, iMatrixSetNumericStoreAttrib, IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId(ic, "NUMERICUNITINDEX", NULL, iMatrixSetNumericUnitIndexAttrib, IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId(ic, "NUMERICUNITSHOWNINDEX", NULL, iMatrixSetNumericUnitShownIndexAttrib, IUPAF_NO_INHERIT);
-  iupClassRegisterAttribute(ic, "NUMERICFORMATDEF", NULL, NULL, NULL, NULL, IUPAF_NO_INHERIT);
-  iupClassRegisterAttribute(ic, "NUMERICDECIMALSYMBOL", iMatrixGetNumericDecimalSymbolAttrib, NULL, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "NUMERICFORMATDEF", NULL, iMatrixSetNumericFormatDefAttrib, NULL, NULL, IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "NUMERICDECIMALSYMBOL", iMatrixGetNumericDecimalSymbolAttrib, iMatrixSetNumericDecimalSymbolAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
 
   iupClassRegisterCallback(ic, "NUMERICGETVALUE_CB", "ii=d");
   iupClassRegisterCallback(ic, "NUMERICSETVALUE_CB", "iid");
@@ -407,6 +402,7 @@ void iupMatrixRegisterEx(Iclass* ic)
   iupClassRegisterAttributeId(ic, "SORTCOLUMN", NULL, iMatrixSetSortColumnAttrib, IUPAF_WRITEONLY|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "SORTCOLUMNORDER", NULL, NULL, IUPAF_SAMEASSYSTEM, "ASCENDING",  IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "SORTCOLUMNCASESENSITIVE", NULL, NULL, IUPAF_SAMEASSYSTEM, "YES", IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "SORTCOLUMNKEYS", NULL, NULL, NULL, NULL, IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "SORTCOLUMNINTERVAL", NULL, NULL, NULL, NULL, IUPAF_READONLY|IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId(ic, "SORTLINEINDEX", iMatrixGetSortLineIndexAttrib, NULL, IUPAF_READONLY | IUPAF_NO_INHERIT);
 
@@ -414,5 +410,8 @@ void iupMatrixRegisterEx(Iclass* ic)
 
   /* IupMatrixEx Attributes - Undo/Redo */
   iupClassRegisterAttribute(ic, "UNDOREDO", iMatrixGetUndoRedoAttrib, iMatrixSetUndoRedoAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
+
+  /* IupMatrixEx Attributes - Find */
+  iupClassRegisterAttribute(ic, "FINDINDEXNOTIFY", NULL, iMatrixSetFindIndexNotifyAttrib, NULL, NULL, IUPAF_WRITEONLY|IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
 }
 
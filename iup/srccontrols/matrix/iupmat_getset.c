@@ -8,6 +8,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
+#include <string.h>
+#include <ctype.h>
 
 #include "iup.h"
 #include "iupcbs.h"
@@ -31,6 +33,9 @@
 #include "iupmat_edit.h"
 #include "iupmat_draw.h"
 #include "iupmat_aux.h"
+#include "iupmat_mem.h"
+#include "iupmat_cache.h"
+#include "iupmat_sort.h"
 
 
 
@@ -55,6 +60,185 @@ void iupMatrixModifyValue(Ihandle* ih, int lin, int col, const char* value)
     iupMatrixSetValue(ih, lin, col, value, -1);    /* call value_edit_cb, but NO numeric conversion */
 }
 
+static int iMatrixHasNumericStore(Ihandle* ih, int col)
+{
+  return ih->data->numeric_columns && (ih->data->numeric_columns[col].flags & IMAT_HAS_STORE) &&
+         (ih->data->numeric_columns[col].flags & IMAT_IS_NUMERIC);
+}
+
+static int iMatrixStrToDoubleStrict(const char* value, double *number)
+{
+  /* the whole string must be a number, or the text would be lost */
+  char* end;
+  if (!value || *value == 0 || isspace((unsigned char)*value))
+    return 0;
+  if (value[strspn(value, "0123456789+-.eE")] != 0)  /* no hexadecimal, inf or nan */
+    return 0;
+  *number = strtod(value, &end);
+  return *end == 0;
+}
+
+static void iMatrixNumberToStr(char* buffer, double number)
+{
+  /* shortest representation that restores the same number */
+  double test;
+  sprintf(buffer, "%.15g", number);
+  if (sscanf(buffer, "%lf", &test) != 1 || test != number)
+    sprintf(buffer, "%.17g", number);
+}
+
+static int iMatrixGetValueStore(Ihandle* ih, int lin, int col, double *number)
+{
+  /* here lin is already the internal line */
+  ImatNumericData* numeric;
+
+  if (lin == 0 || ih->data->callback_mode || !iMatrixHasNumericStore(ih, col))
+    return 0;
+
+  numeric = &(ih->data->numeric_columns[col]);
+  if (!iupMATRIX_STORE_ISVALID(numeric, lin))
+    return 0;
+
+  *number = numeric->store[lin];
+  return 1;
+}
+
+int iupMatrixGetValueStored(Ihandle* ih, int lin, int col, double *number)
+{
+  if (lin != 0 && ih->data->sort_has_index)
+    lin = ih->data->sort_line_index[lin];
+
+  return iMatrixGetValueStore(ih, lin, col, number);
+}
+
+void iupMatrixSetNumericStore(Ihandle* ih, int col, int set)
+{
+  /* move the values between the string cells and the typed store */
+  ImatNumericData* numeric = &(ih->data->numeric_columns[col]);
+  int lin;
+
+  if (ih->data->callback_mode)
+    return;
+
+  if (set)
+  {
+    iupMatrixMemAllocNumericStore(ih, col);
+
+    for (lin = 1; lin < ih->data->lines.num; lin++)
+    {
+      ImatCell* cell = &(ih->data->cells[lin][col]);
+      double number;
+      if (cell->value && iMatrixStrToDoubleStrict(cell->value, &number))
+      {
+        numeric->store[lin] = number;
+        iupMATRIX_STORE_SETVALID(numeric, lin);
+        free(cell->value);
+        cell->value = NULL;
+      }
+    }
+  }
+  else if (numeric->store)
+  {
+    for (lin = 1; lin < ih->data->lines.num; lin++)
+    {
+      if (iupMATRIX_STORE_ISVALID(numeric, lin))
+      {
+        iMatrixNumberToStr(ih->data->numeric_buffer_get, numeric->store[lin]);
+        ih->data->cells[lin][col].value = iupStrDup(ih->data->numeric_buffer_get);
+      }
+    }
+
+    iupMatrixMemReleaseNumericStore(ih, col);
+  }
+
+  iupMatrixDisplayCacheClear(ih);
+}
+
+static void iMatrixUndoPushCell(Ihandle* ih, int lin, int col, const char* old_value, const double* old_number)
+{
+  /* typed values are pushed as numbers, so they are restored with no precision loss */
+  if (old_number)
+    iupAttribSetClassObjectId2(ih, "UNDOPUSHNUMBER", lin, col, (const char*)old_number);
+  else
+    iupAttribSetClassObjectId2(ih, "UNDOPUSHCELL", lin, col, old_value);
+}
+
+static void iMatrixSetValueNumber(Ihandle* ih, int lin, int col, double number, int modify)
+{
+  ImatNumericData* numeric;
+  IFniis value_edit_cb = NULL;
+  char* old_value = NULL;
+  double old_number;
+  int has_old_number = 0;
+
+  if (ih->data->callback_mode || lin == 0 || !iMatrixHasNumericStore(ih, col) || IupGetCallback(ih, "NUMERICSETVALUE_CB"))
+  {
+    char buffer[80];
+    iMatrixNumberToStr(buffer, number);
+    if (modify)
+      iupMatrixModifyValue(ih, lin, col, buffer);
+    else
+      iupMatrixSetValue(ih, lin, col, buffer, ih->data->callback_mode? -1: 0);  /* in callback mode VALUE_EDIT_CB stores the value */
+    return;
+  }
+
+  if (modify && iupMatrixAuxCallEditionCbLinCol(ih, lin, col, 1, 1) == IUP_IGNORE)
+    return;
+
+  if (ih->data->undo_redo)
+  {
+    has_old_number = iupMatrixGetValueStored(ih, lin, col, &old_number);
+    if (!has_old_number)
+      old_value = iupMatrixGetValue(ih, lin, col);
+  }
+
+  if (modify)
+  {
+    value_edit_cb = (IFniis)IupGetCallback(ih, "VALUE_EDIT_CB");
+    if (value_edit_cb)
+      iMatrixNumberToStr(ih->data->numeric_buffer_set, number);
+  }
+
+  if (ih->data->find_index) iupAttribSetClassObjectId2(ih, "FINDINDEXCELL", lin, col, NULL);
+
+  if (ih->data->sort_has_index)
+  {
+    lin = ih->data->sort_line_index[lin];
+    iupMatrixSortSetChanged(ih, lin);
+  }
+
+  if (ih->data->undo_redo) iMatrixUndoPushCell(ih, lin, col, old_value, has_old_number? &old_number: NULL);
+
+  if (ih->data->cells[lin][col].value)
+  {
+    free(ih->data->cells[lin][col].value);
+    ih->data->cells[lin][col].value = NULL;
+  }
+
+  iupMatrixDisplayCacheInvalidate(ih, lin, col);
+
+  numeric = &(ih->data->numeric_columns[col]);
+  numeric->store[lin] = number;
+  iupMATRIX_STORE_SETVALID(numeric, lin);
+
+  if (value_edit_cb)
+    value_edit_cb(ih, lin, col, ih->data->numeric_buffer_set);
+
+  ih->data->need_redraw = 1;
+}
+
+void iupMatrixModifyValueNumber(Ihandle* ih, int lin, int col, double number)
+{
+  /* Same as iupMatrixModifyValue, but avoids the string when the column has a typed store. */
+  iMatrixSetValueNumber(ih, lin, col, number, 1);
+}
+
+void iupMatrixSetValueNumber(Ihandle* ih, int lin, int col, double number)
+{
+  /* Same as iupMatrixModifyValueNumber, but EDITION_CB and VALUE_EDIT_CB are not called. */
+  iMatrixSetValueNumber(ih, lin, col, number, 0);
+}
+
 static char* iMatrixSetValueNumeric(Ihandle* ih, int lin, int col, const char* value, int convert)
 {
   double number;
@@ -89,13 +273,24 @@ void iupMatrixSetValue(Ihandle* ih, int lin, int col, const char* value, int use
 {
   /* NOTICE: this function is NOT called before map */
   char* old_value = NULL;
+  double old_number;
+  int has_old_number = 0;
 
-  if (ih->data->undo_redo) old_value = iupMatrixGetValue(ih, lin, col);
+  if (ih->data->undo_redo)
+  {
+    has_old_number = iupMatrixGetValueStored(ih, lin, col, &old_number);
+    if (!has_old_number)
+      old_value = iupMatrixGetValue(ih, lin, col);
+  }
+  if (ih->data->find_index) iupAttribSetClassObjectId2(ih, "FINDINDEXCELL", lin, col, NULL);
 
   if (lin != 0 && ih->data->sort_has_index)
+  {
     lin = ih->data->sort_line_index[lin];
+    iupMatrixSortSetChanged(ih, lin);
+  }
 
-  if (ih->data->undo_redo) iupAttribSetClassObjectId2(ih, "UNDOPUSHCELL", lin, col, old_value);
+  if (ih->data->undo_redo) iMatrixUndoPushCell(ih, lin, col, old_value, has_old_number? &old_number: NULL);
 
   if (value && ih->data->numeric_columns && ih->data->numeric_columns[col].flags & IMAT_IS_NUMERIC)
   {
@@ -106,12 +301,35 @@ void iupMatrixSetValue(Ihandle* ih, int lin, int col, const char* value, int use
 
   if (!ih->data->callback_mode)
   {
+    iupMatrixDisplayCacheInvalidate(ih, lin, col);
+
     if (ih->data->cells[lin][col].value)
       free(ih->data->cells[lin][col].value);
 
-    ih->data->cells[lin][col].value = iupStrDup(value);
+    if (lin != 0 && iMatrixHasNumericStore(ih, col))
+    {
+      ImatNumericData* numeric = &(ih->data->numeric_columns[col]);
+      double number;
+      if (iMatrixStrToDoubleStrict(value, &number))
+      {
+        /* keep only the typed value */
+        numeric->store[lin] = number;
+        iupMATRIX_STORE_SETVALID(numeric, lin);
+        ih->data->cells[lin][col].value = NULL;
+      }
+      else
+      {
+        iupMATRIX_STORE_CLRVALID(numeric, lin);
+        ih->data->cells[lin][col].value = iupStrDup(value);
+      }
+    }
+    else
+      ih->data->cells[lin][col].value = iupStrDup(value);
   }
 
+  if (ih->data->cache)
+    iupMatrixCacheInvalidate(ih, lin, col, lin, col);  /* the value will be changed in the application */
+
   if (user_edited)
   {
     /* value_edit_cb called when value is "interactively" edited.
@@ -136,16 +354,34 @@ static char* iMatrixGetValueText(Ihandle* ih, int lin, int col)
 
   if (ih->data->callback_mode)
   {
-    /* only called in callback mode */
-    sIFnii value_cb = (sIFnii)IupGetCallback(ih, "VALUE_CB");
-    if (value_cb)
-      value = value_cb(ih, lin, col);
+    if (ih->data->cache)
+      value = iupMatrixCacheGetValue(ih, lin, col);  /* values from VALUES_RANGE_CB */
     else
-      value = NULL; /* application error!!!! value_cb must exist */
+    {
+      /* only called in callback mode */
+      sIFnii value_cb = (sIFnii)IupGetCallback(ih, "VALUE_CB");
+      if (value_cb)
+        value = value_cb(ih, lin, col);
+      else
+        value = NULL; /* application error!!!! value_cb must exist */
+    }
   }
   else
+  {
     value = ih->data->cells[lin][col].value;
 
+    if (!value)
+    {
+      double number;
+      if (iMatrixGetValueStore(ih, lin, col, &number))
+      {
+        /* formatted on demand with maximum precision */
+        iMatrixNumberToStr(ih->data->numeric_buffer_get, number);
+        value = ih->data->numeric_buffer_get;
+      }
+    }
+  }
+
   return value;
 }
 
@@ -156,24 +392,29 @@ double iupMatrixGetValueNumeric(Ihandle* ih, int lin, int col)
 
   /* here lin!=0 */
 
-  char* value = iMatrixGetValueText(ih, lin, col);
-
   translate_cb = (sIFniis)IupGetCallback(ih, "TRANSLATEVALUE_CB");
-  if (translate_cb)
-    value = translate_cb(ih, lin, col, value);
 
-  if (!value)
+  /* typed value, no need to parse a string */
+  if (translate_cb || !iupMatrixGetValueStored(ih, lin, col, &number))
   {
-    dIFnii getvalue_cb = (dIFnii)IupGetCallback(ih, "NUMERICGETVALUE_CB");
-    if (getvalue_cb)
-      number = getvalue_cb(ih, lin, col);
+    char* value = iMatrixGetValueText(ih, lin, col);
+
+    if (translate_cb)
+      value = translate_cb(ih, lin, col, value);
+
+    if (!value)
+    {
+      dIFnii getvalue_cb = (dIFnii)IupGetCallback(ih, "NUMERICGETVALUE_CB");
+      if (getvalue_cb)
+        number = getvalue_cb(ih, lin, col);
+      else
+        return 0;
+    }
     else
-      return 0;
-  }
-  else
-  {
-    if (!iupStrToDouble(value, &number))
-      return 0;
+    {
+      if (!iupStrToDouble(value, &number))
+        return 0;
+    }
   }
 
   if (ih->data->numeric_columns[col].unit_shown != ih->data->numeric_columns[col].unit)
@@ -248,9 +489,27 @@ static char* iMatrixGetValueNumericTitle(Ihandle* ih, int col, const char* value
   return (char*)value;
 }
 
-static char* iMatrixGetValueNumericFormatted(Ihandle* ih, int lin, int col, const char* value)
+static char* iMatrixFormatNumber(Ihandle* ih, int col, double number)
 {
   char *format = NULL;
+
+  if (ih->data->numeric_columns[col].unit_shown != ih->data->numeric_columns[col].unit)
+    number = ih->data->numeric_convert_func(number, ih->data->numeric_columns[col].quantity,
+    ih->data->numeric_columns[col].unit, /* from */
+    ih->data->numeric_columns[col].unit_shown);  /* to */
+
+  if (ih->data->numeric_columns[col].flags & IMAT_HAS_FORMAT)
+    format = iupAttribGetId(ih, "NUMERICFORMAT", col);
+
+  if (format == NULL)
+    format = iupMatrixGetNumericFormatDef(ih);
+
+  iupStrPrintfDoubleLocale(ih->data->numeric_buffer_get, format, number, IupGetAttribute(ih, "NUMERICDECIMALSYMBOL"));  /* this will also check for global "DEFAULTDECIMALSYMBOL" */
+  return ih->data->numeric_buffer_get;
+}
+
+static char* iMatrixGetValueNumericFormatted(Ihandle* ih, int lin, int col, const char* value)
+{
   double number;
 
   /* here lin!=0 */
@@ -269,19 +528,7 @@ static char* iMatrixGetValueNumericFormatted(Ihandle* ih, int lin, int col, cons
       return (char*)value;
   }
 
-  if (ih->data->numeric_columns[col].unit_shown != ih->data->numeric_columns[col].unit)
-    number = ih->data->numeric_convert_func(number, ih->data->numeric_columns[col].quantity,
-    ih->data->numeric_columns[col].unit, /* from */
-    ih->data->numeric_columns[col].unit_shown);  /* to */
-
-  if (ih->data->numeric_columns[col].flags & IMAT_HAS_FORMAT)
-    format = iupAttribGetId(ih, "NUMERICFORMAT", col);
-
-  if (format == NULL)
-    format = iupMatrixGetNumericFormatDef(ih);
-
-  iupStrPrintfDoubleLocale(ih->data->numeric_buffer_get, format, number, IupGetAttribute(ih, "NUMERICDECIMALSYMBOL"));  /* this will also check for global "DEFAULTDECIMALSYMBOL" */
-  return ih->data->numeric_buffer_get;
+  return iMatrixFormatNumber(ih, col, number);
 }
 
 char* iupMatrixGetValueDisplay(Ihandle* ih, int lin, int col)
@@ -291,11 +538,16 @@ char* iupMatrixGetValueDisplay(Ihandle* ih, int lin, int col)
     return iupAttribGetId2(ih, "", lin, col);
   else
   {
-    sIFniis translate_cb;
+    sIFniis translate_cb = (sIFniis)IupGetCallback(ih, "TRANSLATEVALUE_CB");
+    char* value;
+    double number;
 
-    char* value = iMatrixGetValueText(ih, lin, col);
+    /* typed value, format it without parsing a string */
+    if (!translate_cb && iupMatrixGetValueStored(ih, lin, col, &number))
+      return iMatrixFormatNumber(ih, col, number);
+
+    value = iMatrixGetValueText(ih, lin, col);
 
-    translate_cb = (sIFniis)IupGetCallback(ih, "TRANSLATEVALUE_CB");
     if (translate_cb)
       value = translate_cb(ih, lin, col, value);
 
@@ -311,8 +563,42 @@ char* iupMatrixGetValueDisplay(Ihandle* ih, int lin, int col)
   }
 }
 
+char* iupMatrixGetValueDisplayCached(Ihandle* ih, int lin, int col)
+{
+  /* Same as iupMatrixGetValueDisplay, but the formatted values of numeric columns
+     are kept in the display cache. Used for draw and fit, after iupMatrixDisplayCacheCheck. */
+  char* value;
+  double number;
+  int ilin;
+
+  if (!ih->handle || ih->data->callback_mode || lin == 0 ||
+      !ih->data->numeric_columns || !(ih->data->numeric_columns[col].flags & IMAT_IS_NUMERIC) ||
+      IupGetCallback(ih, "TRANSLATEVALUE_CB"))
+    return iupMatrixGetValueDisplay(ih, lin, col);
+
+  ilin = ih->data->sort_has_index? ih->data->sort_line_index[lin]: lin;
+
+  value = iupMatrixDisplayCacheGet(ih, ilin, col);
+  if (value)
+    return value;
+
+  /* values from NUMERICGETVALUE_CB are not cached */
+  if (!ih->data->cells[ilin][col].value && !iMatrixGetValueStore(ih, ilin, col, &number))
+    return iupMatrixGetValueDisplay(ih, lin, col);
+
+  value = iupMatrixGetValueDisplay(ih, lin, col);
+  if (value)
+    value = iupMatrixDisplayCacheSet(ih, ilin, col, value);
+  return value;
+}
+
 void iupMatrixSetCellFlag(Ihandle* ih, int lin, int col, unsigned char attr, int set)
 {
+  /* in callback mode the cells are not allocated, so just remember that the attribute was used,
+     it is never reset because other cells may still have it, also set before map */
+  if (lin != IUP_INVALID_ID && col != IUP_INVALID_ID && set)
+    ih->data->callback_cell_flags |= attr;
+
   if (!ih->handle)
     return;
 
@@ -375,6 +661,8 @@ void iupMatrixPrepareDrawData(Ihandle* ih)
   ih->data->type_cb = (sIFnii)IupGetCallback(ih, "TYPE_CB");
   ih->data->fgcolor_cb = (IFniiIII)IupGetCallback(ih, "FGCOLOR_CB");
   ih->data->bgcolor_cb = (IFniiIII)IupGetCallback(ih, "BGCOLOR_CB");
+
+  iupMatrixDisplayCacheCheck(ih);
 }
 
 static char* iMatrixGetCellAttribute(Ihandle* ih, unsigned char attr, int lin, int col, int *native_parent)
@@ -408,7 +696,7 @@ static char* iMatrixGetCellAttribute(Ihandle* ih, unsigned char attr, int lin, i
     return NULL;
 
   /* 1 -  check for this cell */
-  if (ih->data->callback_mode || ih->data->cells[lin][col].flags & attr)
+  if (ih->data->callback_mode? ih->data->callback_cell_flags & attr: ih->data->cells[lin][col].flags & attr)
     value = iupAttribGetId2(ih, attrib, lin, col);
   if (!value)
   {
@@ -637,7 +925,7 @@ int iupMatrixGetType(Ihandle* ih, int lin, int col)
 
 int iupMatrixGetFrameHorizColor(Ihandle* ih, int lin, int col, long *framecolor, int check_title)
 {
-  if ((ih->data->callback_mode || ih->data->cells[lin][col].flags & IMAT_HAS_FRAMEHORIZCOLOR) ||
+  if ((ih->data->callback_mode? ih->data->callback_cell_flags & IMAT_HAS_FRAMEHORIZCOLOR: ih->data->cells[lin][col].flags & IMAT_HAS_FRAMEHORIZCOLOR) ||
       ih->data->lines.dt[lin].flags & IMAT_HAS_FRAMEHORIZCOLOR)
   {
     char* color = NULL;
@@ -665,7 +953,7 @@ int iupMatrixGetFrameHorizColor(Ihandle* ih, int lin, int col, long *framecolor,
 
 int iupMatrixGetFrameVertColor(Ihandle* ih, int lin, int col, long *framecolor, int check_title)
 {
-  if ((ih->data->callback_mode || ih->data->cells[lin][col].flags & IMAT_HAS_FRAMEVERTCOLOR) ||
+  if ((ih->data->callback_mode? ih->data->callback_cell_flags & IMAT_HAS_FRAMEVERTCOLOR: ih->data->cells[lin][col].flags & IMAT_HAS_FRAMEVERTCOLOR) ||
       ih->data->columns.dt[col].flags & IMAT_HAS_FRAMEVERTCOLOR)
   {
     char* color = NULL;
@@ -944,8 +1232,6 @@ char *iupMatrixGetSize(Ihandle* ih, int index, int m, int pixels_unit)
 
 static int iMatrixGetOffset(int index, int *offset, ImatLinColData *p)
 {
-  int i;
-
   *offset = 0;
 
   /* check if the cell is not empty */
@@ -953,23 +1239,16 @@ static int iMatrixGetOffset(int index, int *offset, ImatLinColData *p)
     return 0;
 
   if (index < p->num_noscroll)
-  {
-    for (i = 0; i < index; i++)
-      *offset += p->dt[i].size;
-  }
+    *offset = iupMatrixAuxGetSizeSum(p, index);
   else
   {
     if (index < p->first ||
         index > p->last)
         return 0;
 
-    for (i = 0; i < p->num_noscroll; i++)
-      *offset += p->dt[i].size;
-
-    /* Find the initial position */
-    *offset -= p->first_offset;  /* index is always greater or equal to first */
-    for (i = p->first; i < index; i++)
-      *offset += p->dt[i].size;
+    /* index is always greater or equal to first */
+    *offset = iupMatrixAuxGetNoScrollSize(p) - p->first_offset + 
+              iupMatrixAuxGetSizeSum(p, index) - iupMatrixAuxGetSizeSum(p, p->first);
   }
 
   return 1;
@@ -988,34 +1267,23 @@ int iupMatrixGetCellOffset(Ihandle* ih, int lin, int col, int *x, int *y)
 
 static int iMatrixGetIndexFromOffset(int pos, ImatLinColData *p)
 {
-  int offset = 0, i;
+  int i, noscroll_size;
 
   if (pos < 0)
     return -1;  /* invalid */
 
-  for (i = 0; i < p->num_noscroll; i++)  /* for all non scrollable cells */
-  {
-    offset += p->dt[i].size;
+  noscroll_size = iupMatrixAuxGetNoScrollSize(p);
+  if (pos < noscroll_size)  /* non scrollable cells */
+    return iupMatrixAuxGetSizeIndex(p, pos);
 
-    if (pos < offset)
-      break;
-  }
+  /* visible cells, convert to a position from the start of the first scrollable cell */
+  pos += iupMatrixAuxGetScrollPos(p);
+  i = iupMatrixAuxGetSizeIndex(p, pos);
+  if (i < p->first)
+    i = p->first;
 
-  if (pos >= offset)
-  {
-    for (i = p->first; i <= p->last; i++)  /* for all visible cells */
-    {
-      offset += p->dt[i].size;
-      if (i == p->first)
-        offset -= p->first_offset;
-
-      if (pos < offset)
-        break;
-    }
-
-    if (i > p->last)
-      i = -1;    /* invisible */
-  }
+  if (i > p->last)
+    i = -1;    /* invisible */
 
   return i;
 }
@@ -1051,26 +1319,16 @@ int iupMatrixGetCellFromXY(Ihandle* ih, int x, int y, int* l, int* c)
 
 static int iMatrixGetCellDim(int index, int* offset, int* size, ImatLinColData *p)
 {
-  int i, visible = 1;
+  int visible = 1;
 
-  *offset = 0;
   if (index < p->num_noscroll)
-  {
-    for (i = 0; i < index; i++)
-      *offset += p->dt[i].size;
-  }
+    *offset = iupMatrixAuxGetSizeSum(p, index);
   else
   {
-    for (i = 0; i < p->num_noscroll; i++)
-      *offset += p->dt[i].size;
+    *offset = iupMatrixAuxGetNoScrollSize(p);
 
-    for (i = p->first; i < index; i++)
-    {
-      *offset += p->dt[i].size;
-
-      if (i == p->first)
-        *offset -= p->first_offset;  /* add only when index greater than first */
-    }
+    if (index > p->first)
+      *offset += iupMatrixAuxGetSizeSum(p, index) - iupMatrixAuxGetSizeSum(p, p->first) - p->first_offset;  /* add only when index greater than first */
 
     if (index < p->first)
       visible = 0;
@@ -15,6 +15,9 @@ extern "C" {
 /* Used for draw, size computation and edition (display).
    The internal value may have been translated, converted or formatted. */
 char* iupMatrixGetValueDisplay(Ihandle* ih, int lin, int col);
+/* Same as iupMatrixGetValueDisplay, but the formatted numeric values are cached.
+   Used only for draw and fit. */
+char* iupMatrixGetValueDisplayCached(Ihandle* ih, int lin, int col);
 /* Used only when sorting numeric values.
    The internal value may have been translated or converted. */
 double iupMatrixGetValueNumeric(Ihandle* ih, int lin, int col);
@@ -25,6 +28,14 @@ char* iupMatrixGetValue(Ihandle* ih, int lin, int col);
 void  iupMatrixSetValue(Ihandle* ih, int lin, int col, const char* value, int user_edited);
 void iupMatrixModifyValue(Ihandle* ih, int lin, int col, const char* value);
 
+/* Typed store of numeric columns (NUMERICSTORE).
+   iupMatrixGetValueStored returns 0 if the cell has no typed value,
+   the number is the internal value (not converted). */
+int  iupMatrixGetValueStored(Ihandle* ih, int lin, int col, double *number);
+void iupMatrixModifyValueNumber(Ihandle* ih, int lin, int col, double number);
+void iupMatrixSetValueNumber(Ihandle* ih, int lin, int col, double number);
+void iupMatrixSetNumericStore(Ihandle* ih, int col, int set);
+
 void iupMatrixSetCellFlag(Ihandle* ih, int lin, int col, unsigned char attr, int set);
 int iupMatrixGetCellOffset(Ihandle* ih, int lin, int col, int *x, int *y);
 
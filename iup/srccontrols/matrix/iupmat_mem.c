@@ -25,6 +25,8 @@
 
 #include "iupmat_def.h"
 #include "iupmat_mem.h"
+#include "iupmat_cache.h"
+#include "iupmat_sort.h"
 
 
 static void iMatrixGetInitialValues(Ihandle* ih)
@@ -50,6 +52,98 @@ static void iMatrixGetInitialValues(Ihandle* ih)
   }
 }
 
+static void iMatrixMemMoveStoreBits(unsigned char* bits, int dst, int src, int count)
+{
+  /* like memmove, but for bits */
+  int i;
+  if (dst > src)
+  {
+    for (i = count - 1; i >= 0; i--)
+    {
+      if (bits[(src + i) >> 3] & (1 << ((src + i) & 7)))
+        bits[(dst + i) >> 3] |= (unsigned char)(1 << ((dst + i) & 7));
+      else
+        bits[(dst + i) >> 3] &= (unsigned char)~(1 << ((dst + i) & 7));
+    }
+  }
+  else
+  {
+    for (i = 0; i < count; i++)
+    {
+      if (bits[(src + i) >> 3] & (1 << ((src + i) & 7)))
+        bits[(dst + i) >> 3] |= (unsigned char)(1 << ((dst + i) & 7));
+      else
+        bits[(dst + i) >> 3] &= (unsigned char)~(1 << ((dst + i) & 7));
+    }
+  }
+}
+
+static void iMatrixMemClearStoreBits(unsigned char* bits, int start, int count)
+{
+  int i;
+  for (i = start; i < start + count; i++)
+    bits[i >> 3] &= (unsigned char)~(1 << (i & 7));
+}
+
+static void iMatrixMemMoveNumericStoreLines(Ihandle* ih, int dst, int src, int count)
+{
+  int col;
+  if (!ih->data->numeric_columns)
+    return;
+
+  for (col = 0; col < ih->data->columns.num; col++)
+  {
+    ImatNumericData* numeric = &(ih->data->numeric_columns[col]);
+    if (numeric->store)
+    {
+      memmove(numeric->store + dst, numeric->store + src, count*sizeof(double));
+      iMatrixMemMoveStoreBits(numeric->store_valid, dst, src, count);
+    }
+  }
+}
+
+static void iMatrixMemClearNumericStoreLines(Ihandle* ih, int start, int count)
+{
+  int col;
+  if (!ih->data->numeric_columns)
+    return;
+
+  for (col = 0; col < ih->data->columns.num; col++)
+  {
+    ImatNumericData* numeric = &(ih->data->numeric_columns[col]);
+    if (numeric->store)
+    {
+      memset(numeric->store + start, 0, count*sizeof(double));
+      iMatrixMemClearStoreBits(numeric->store_valid, start, count);
+    }
+  }
+}
+
+void iupMatrixMemAllocNumericStore(Ihandle* ih, int col)
+{
+  ImatNumericData* numeric = &(ih->data->numeric_columns[col]);
+  if (numeric->store)
+    return;
+
+  numeric->store = (double*)calloc(ih->data->lines.num_alloc, sizeof(double));
+  numeric->store_valid = (unsigned char*)calloc((ih->data->lines.num_alloc + 7) / 8, 1);
+}
+
+void iupMatrixMemReleaseNumericStore(Ihandle* ih, int col)
+{
+  ImatNumericData* numeric = &(ih->data->numeric_columns[col]);
+  if (numeric->store)
+  {
+    free(numeric->store);
+    numeric->store = NULL;
+  }
+  if (numeric->store_valid)
+  {
+    free(numeric->store_valid);
+    numeric->store_valid = NULL;
+  }
+}
+
 void iupMatrixMemAlloc(Ihandle* ih)
 {
   ih->data->lines.num_alloc = ih->data->lines.num;
@@ -70,10 +164,16 @@ void iupMatrixMemAlloc(Ihandle* ih)
 
     iMatrixGetInitialValues(ih);
   }
+  else if (IupGetCallback(ih, "VALUES_RANGE_CB"))
+    iupMatrixCacheCreate(ih);
 
   ih->data->lines.dt = (ImatLinCol*)calloc(ih->data->lines.num_alloc, sizeof(ImatLinCol));
   ih->data->columns.dt = (ImatLinCol*)calloc(ih->data->columns.num_alloc, sizeof(ImatLinCol));
 
+  /* the sums are filled by iupMatrixAuxCalcSizes */
+  ih->data->lines.size_sums = (int*)calloc(ih->data->lines.num_alloc + 1, sizeof(int));
+  ih->data->columns.size_sums = (int*)calloc(ih->data->columns.num_alloc + 1, sizeof(int));
+
   /* numeric_columns is allocated when a NUMERIC* attribute is set */
   /* sort_line_index is allocated when the SORTCOLUMN attribute is set */
 }
@@ -101,6 +201,9 @@ void iupMatrixMemRelease(Ihandle* ih)
     ih->data->cells = NULL;
   }
 
+  iupMatrixCacheRelease(ih);
+  iupMatrixDisplayCacheRelease(ih);
+
   if (ih->data->columns.dt)
   {
     free(ih->data->columns.dt);
@@ -113,8 +216,24 @@ void iupMatrixMemRelease(Ihandle* ih)
     ih->data->lines.dt = NULL;
   }
 
+  if (ih->data->columns.size_sums)
+  {
+    free(ih->data->columns.size_sums);
+    ih->data->columns.size_sums = NULL;
+  }
+
+  if (ih->data->lines.size_sums)
+  {
+    free(ih->data->lines.size_sums);
+    ih->data->lines.size_sums = NULL;
+  }
+
   if (ih->data->numeric_columns)
   {
+    int col;
+    for (col = 0; col < ih->data->columns.num_alloc; col++)
+      iupMatrixMemReleaseNumericStore(ih, col);
+
     free(ih->data->numeric_columns);
     ih->data->numeric_columns = NULL;
   }
@@ -125,6 +244,8 @@ void iupMatrixMemRelease(Ihandle* ih)
     ih->data->sort_line_index = NULL;
   }
 
+  iupMatrixSortRelease(ih);
+
   if (ih->data->merge_info)
   {
     free(ih->data->merge_info);
@@ -139,6 +260,11 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
   int end, diff_num, shift_num, lin;
 
   if (ih->data->undo_redo) iupAttribSetClassObject(ih, "UNDOCLEAR", NULL);
+  if (ih->data->find_index) iupAttribSetClassObject(ih, "FINDINDEXCLEAR", NULL);
+
+  /* cached values are stored by position */
+  iupMatrixCacheClear(ih);
+  iupMatrixDisplayCacheClear(ih);
 
   /* base is the first line where the change started */
 
@@ -158,8 +284,25 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
     }
 
     ih->data->lines.dt = (ImatLinCol*)realloc(ih->data->lines.dt, ih->data->lines.num_alloc*sizeof(ImatLinCol));
+    ih->data->lines.size_sums = (int*)realloc(ih->data->lines.size_sums, (ih->data->lines.num_alloc + 1)*sizeof(int));
     if (ih->data->sort_line_index)
       ih->data->sort_line_index = (int*)realloc(ih->data->sort_line_index, ih->data->lines.num_alloc*sizeof(int));
+
+    if (ih->data->numeric_columns)
+    {
+      int col;
+      for (col = 0; col < ih->data->columns.num; col++)
+      {
+        ImatNumericData* numeric = &(ih->data->numeric_columns[col]);
+        if (numeric->store)
+        {
+          int old_bytes = (old_alloc + 7) / 8, bytes = (ih->data->lines.num_alloc + 7) / 8;
+          numeric->store = (double*)realloc(numeric->store, ih->data->lines.num_alloc*sizeof(double));
+          numeric->store_valid = (unsigned char*)realloc(numeric->store_valid, bytes);
+          memset(numeric->store_valid + old_bytes, 0, bytes - old_bytes);
+        }
+      }
+    }
   }
 
   if (old_num==num)
@@ -179,6 +322,7 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
         for (lin = shift_num-1; lin >= 0; lin--)   /* all columns, shift_num lines */
           memmove(ih->data->cells[lin+end], ih->data->cells[lin+base], ih->data->columns.num_alloc*sizeof(ImatCell));
       memmove(ih->data->lines.dt+end, ih->data->lines.dt+base, shift_num*sizeof(ImatLinCol));
+      iMatrixMemMoveNumericStoreLines(ih, end, base, shift_num);
     }
 
     /* then clear the new space starting at base */
@@ -186,6 +330,7 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
       for (lin = 0; lin < diff_num; lin++)        /* all columns, diff_num lines */
         memset(ih->data->cells[lin+base], 0, ih->data->columns.num_alloc*sizeof(ImatCell));
     memset(ih->data->lines.dt+base, 0, diff_num*sizeof(ImatLinCol));
+    iMatrixMemClearNumericStoreLines(ih, base, diff_num);
 
     /* reset sort indices */
     if (ih->data->sort_has_index) ih->data->sort_has_index = 0;
@@ -223,6 +368,7 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
         for (lin = 0; lin < shift_num; lin++) /* all columns, shift_num lines */
           memmove(ih->data->cells[lin+base], ih->data->cells[lin+end], ih->data->columns.num_alloc*sizeof(ImatCell));
       memmove(ih->data->lines.dt+base, ih->data->lines.dt+end, shift_num*sizeof(ImatLinCol));
+      iMatrixMemMoveNumericStoreLines(ih, base, end, shift_num);
     }
 
     /* then clear the remaining space starting at num */
@@ -230,6 +376,7 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
       for (lin = 0; lin < diff_num; lin++)   /* all columns, diff_num lines */
         memset(ih->data->cells[lin+num], 0, ih->data->columns.num_alloc*sizeof(ImatCell));
     memset(ih->data->lines.dt+num, 0, diff_num*sizeof(ImatLinCol));
+    iMatrixMemClearNumericStoreLines(ih, num, diff_num);
 
     /* reset sort indices */
     if (ih->data->sort_has_index) ih->data->sort_has_index = 0;
@@ -241,6 +388,11 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
   int lin, end, diff_num, shift_num;
 
   if (ih->data->undo_redo) iupAttribSetClassObject(ih, "UNDOCLEAR", NULL);
+  if (ih->data->find_index) iupAttribSetClassObject(ih, "FINDINDEXCLEAR", NULL);
+
+  /* cached values are stored by position */
+  iupMatrixCacheClear(ih);
+  iupMatrixDisplayCacheClear(ih);
 
   /* base is the first column where the change started */
 
@@ -258,6 +410,7 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
     }
 
     ih->data->columns.dt = (ImatLinCol*)realloc(ih->data->columns.dt, ih->data->columns.num_alloc*sizeof(ImatLinCol));
+    ih->data->columns.size_sums = (int*)realloc(ih->data->columns.size_sums, (ih->data->columns.num_alloc + 1)*sizeof(int));
     if (ih->data->numeric_columns)
       ih->data->numeric_columns = (ImatNumericData*)realloc(ih->data->numeric_columns, ih->data->columns.num_alloc*sizeof(ImatNumericData));
   }
@@ -300,6 +453,13 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
     end = base+diff_num;
 
     /* release memory from the opened space */
+    if (ih->data->numeric_columns)
+    {
+      int col;
+      for (col = base; col < end; col++)
+        iupMatrixMemReleaseNumericStore(ih, col);
+    }
+
     if (!ih->data->callback_mode)
     {
       int col;
@@ -17,6 +17,10 @@ void iupMatrixMemRelease(Ihandle* ih);
 void iupMatrixMemReAllocLines  (Ihandle* ih, int old_num, int num, int base);
 void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base);
 
+/* typed store of a numeric column, allocated when NUMERICSTORE is set */
+void iupMatrixMemAllocNumericStore(Ihandle* ih, int col);
+void iupMatrixMemReleaseNumericStore(Ihandle* ih, int col);
+
 #ifdef __cplusplus
 }
 #endif
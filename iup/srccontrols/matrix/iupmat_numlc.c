@@ -462,11 +462,12 @@ int iupMatrixSetAddLinAttrib(Ihandle* ih, const char* value)
   iupMatrixMemReAllocLines(ih, lines_num, lines_num+count, base);
 
   ih->data->lines.num += count;
-  ih->data->need_calcsize = 1;
 
   if (base < lines_num)  /* If before the last line. */
     iMatrixUpdateLineAttributes(ih, base, count, 1);
 
+  iupMatrixAuxUpdateSizeRange(ih, IMAT_PROCESS_LIN, base, count);  /* compute only the new lines */
+
   if (focus_cell_changed)
     iupMatrixAuxCallEnterCellCb(ih);
 
@@ -507,11 +508,12 @@ int iupMatrixSetDelLinAttrib(Ihandle* ih, const char* value)
   iupMatrixMemReAllocLines(ih, lines_num, lines_num-count, base);
 
   ih->data->lines.num -= count;
-  ih->data->need_calcsize = 1;
 
   if (base < lines_num)  /* If before the last line. (always true when deleting) */
     iMatrixUpdateLineAttributes(ih, base, count, 0);
 
+  iupMatrixAuxUpdateSizeRange(ih, IMAT_PROCESS_LIN, base, 0);  /* the removed lines are already out of the dt array */
+
   if (focus_cell_changed)
     iupMatrixAuxCallEnterCellCb(ih);
 
@@ -547,11 +549,12 @@ int iupMatrixSetAddColAttrib(Ihandle* ih, const char* value)
   iupMatrixMemReAllocColumns(ih, columns_num, columns_num+count, base);
 
   ih->data->columns.num += count;
-  ih->data->need_calcsize = 1;
 
   if (base < columns_num)  /* If before the last column. */
     iMatrixUpdateColumnAttributes(ih, base, count, 1);
 
+  iupMatrixAuxUpdateSizeRange(ih, IMAT_PROCESS_COL, base, count);  /* compute only the new columns */
+
   if (focus_cell_changed)
     iupMatrixAuxCallEnterCellCb(ih);
 
@@ -592,11 +595,12 @@ int iupMatrixSetDelColAttrib(Ihandle* ih, const char* value)
   iupMatrixMemReAllocColumns(ih, columns_num, columns_num-count, base);
 
   ih->data->columns.num -= count;
-  ih->data->need_calcsize = 1;
 
   if (base < columns_num)  /* If before the last column. (always true when deleting) */
     iMatrixUpdateColumnAttributes(ih, base, count, 0);
 
+  iupMatrixAuxUpdateSizeRange(ih, IMAT_PROCESS_COL, base, 0);  /* the removed columns are already out of the dt array */
+
   if (focus_cell_changed)
     iupMatrixAuxCallEnterCellCb(ih);
 
@@ -609,7 +613,7 @@ int iupMatrixSetNumLinAttrib(Ihandle* ih, const char* value)
   int num = 0;
   if (iupStrToInt(value, &num))
   {
-    int old_focus_cell;
+    int old_focus_cell, base = 0, old_noscroll = ih->data->lines.num_noscroll;
 
     if (num < 0) num = 0;
 
@@ -618,7 +622,7 @@ int iupMatrixSetNumLinAttrib(Ihandle* ih, const char* value)
     /* can be set before map */
     if (ih->handle)
     {
-      int base;  /* base is after the end */
+      /* base is after the end */
       if (num >= ih->data->lines.num) /* add or alloc */
         base = ih->data->lines.num;   
       else
@@ -632,7 +636,14 @@ int iupMatrixSetNumLinAttrib(Ihandle* ih, const char* value)
     if (ih->data->lines.num_noscroll < 1)
       ih->data->lines.num_noscroll = 1;
 
-    ih->data->need_calcsize = 1;
+    if (ih->handle && ih->data->lines.num_noscroll == old_noscroll)
+      iupMatrixAuxUpdateSizeRange(ih, IMAT_PROCESS_LIN, base, num - base);  /* only the new lines */
+    else
+    {
+      ih->data->need_calcsize = 1;
+      if (ih->handle)
+        iupMatrixAuxBuildSizeSums(&ih->data->lines);
+    }
 
     old_focus_cell = ih->data->lines.focus_cell;
 
@@ -656,7 +667,7 @@ int iupMatrixSetNumColAttrib(Ihandle* ih, const char* value)
   int num = 0;
   if (iupStrToInt(value, &num))
   {
-    int old_focus_cell;
+    int old_focus_cell, base = 0, old_noscroll = ih->data->columns.num_noscroll;
 
     if (num < 0) num = 0;
 
@@ -665,7 +676,7 @@ int iupMatrixSetNumColAttrib(Ihandle* ih, const char* value)
     /* can be set before map */
     if (ih->handle)
     {
-      int base;  /* base is after the end */
+      /* base is after the end */
       if (num >= ih->data->columns.num) /* add or alloc */
         base = ih->data->columns.num;
       else
@@ -679,7 +690,14 @@ int iupMatrixSetNumColAttrib(Ihandle* ih, const char* value)
     if (ih->data->columns.num_noscroll < 1)
       ih->data->columns.num_noscroll = 1;
 
-    ih->data->need_calcsize = 1;
+    if (ih->handle && ih->data->columns.num_noscroll == old_noscroll)
+      iupMatrixAuxUpdateSizeRange(ih, IMAT_PROCESS_COL, base, num - base);  /* only the new columns */
+    else
+    {
+      ih->data->need_calcsize = 1;
+      if (ih->handle)
+        iupMatrixAuxBuildSizeSums(&ih->data->columns);
+    }
 
     old_focus_cell = ih->data->lines.focus_cell;
 
@@ -173,7 +173,7 @@ void iupMatrixScrollToVisible(Ihandle* ih, int lin, int col)
     if (!ih->data->edit_hide_onfocus && ih->data->editing)
         iupMatrixEditUpdatePos(ih);
 
-    iupMatrixDraw(ih, 1);
+    iupMatrixDrawScroll(ih, 1);
   }
 }
 
@@ -208,7 +208,7 @@ void iupMatrixScrollMove(iupMatrixScrollMoveFunc func, Ihandle* ih, int mode, in
     if (!ih->data->edit_hide_onfocus && ih->data->editing)
         iupMatrixEditUpdatePos(ih);
 
-    iupMatrixDraw(ih, 0);
+    iupMatrixDrawScroll(ih, 0);
   }
 }
 
@@ -0,0 +1,635 @@
+/** \file
+ * \brief iupmatrix control
+ * sort of lines
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+/**************************************************************************/
+/*  The values of the key columns are retrieved once for each line, then  */
+/*  a stable merge sort compares only the stored keys. A single numeric   */
+/*  key uses a radix sort of the bits of the double. Lines changed after  */
+/*  the last sort are recorded, so SORTCOLUMN=UPDATE can insert only      */
+/*  them in the already sorted lines.                                     */
+/**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iup.h"
+#include "iupcbs.h"
+
+#include <cd.h>
+
+#include "iup_object.h"
+#include "iup_attrib.h"
+#include "iup_str.h"
+#include "iup_stdcontrols.h"
+
+#include "iupmat_def.h"
+#include "iupmat_getset.h"
+#include "iupmat_sort.h"
+
+
+#define IMAT_SORT_MAXKEYS 8
+#define IMAT_SORT_INSERTION 16   /* runs sorted by insertion before merging */
+#define IMAT_SORT_RADIX_MIN 64   /* below that the merge sort is faster */
+
+typedef struct _ImatSortKey
+{
+  int col;
+  int ascending;
+  int numeric;
+  double* numbers;   /* one for each entry, when numeric */
+  char** texts;      /* one for each entry, when not numeric */
+} ImatSortKey;
+
+typedef struct _ImatSortContext
+{
+  Ihandle* ih;
+  IFniii sort_cb;
+  int utf8, casesensitive, dup_text;
+  int key_count;
+  ImatSortKey keys[IMAT_SORT_MAXKEYS];
+  int count;
+  int* lines;    /* internal line of each entry */
+  void* memory;  /* single block for all the arrays */
+} ImatSortContext;
+
+
+/**************************************************************************/
+/*  Keys                                                                  */
+/**************************************************************************/
+
+static void iMatrixSortParseKeys(Ihandle* ih, ImatSortContext* ctx, int col)
+{
+  const char* value = iupAttribGetStr(ih, "SORTCOLUMNKEYS");
+  int ascending = iupStrEqualNoCase(iupAttribGetStr(ih, "SORTCOLUMNORDER"), "ASCENDING");
+  int k;
+
+  ctx->keys[0].col = col;
+  ctx->keys[0].ascending = ctx->sort_cb ? 1 : ascending;  /* the callback defines the order of the main column */
+  ctx->key_count = 1;
+
+  /* "col[:ASCENDING|:DESCENDING],col..." */
+  while (value && *value && ctx->key_count < IMAT_SORT_MAXKEYS)
+  {
+    int key_col = 0, key_ascending = ascending;
+    const char* next = strchr(value, ',');
+    int len = next ? (int)(next - value) : (int)strlen(value);
+    const char* order = (const char*)memchr(value, ':', len);
+
+    if (order)
+    {
+      if (iupStrEqualNoCasePartial(order + 1, "DESCENDING"))
+        key_ascending = 0;
+      else if (iupStrEqualNoCasePartial(order + 1, "ASCENDING"))
+        key_ascending = 1;
+    }
+
+    if (iupStrToInt(value, &key_col) && iupMATRIX_CHECK_COL(ih, key_col) && key_col != col)
+    {
+      ctx->keys[ctx->key_count].col = key_col;
+      ctx->keys[ctx->key_count].ascending = key_ascending;
+      ctx->key_count++;
+    }
+
+    value = next ? next + 1 : NULL;
+  }
+
+  /* SORTCOLUMN=INVERT reversed the last sort */
+  if (ih->data->sort_inverted)
+  {
+    for (k = 0; k < ctx->key_count; k++)
+      ctx->keys[k].ascending = !ctx->keys[k].ascending;
+  }
+}
+
+static int iMatrixSortInit(Ihandle* ih, ImatSortContext* ctx, int col, int count)
+{
+  int k, num_count = 0, txt_count = 0;
+  char* mem;
+
+  memset(ctx, 0, sizeof(ImatSortContext));
+  ctx->ih = ih;
+  ctx->sort_cb = (IFniii)IupGetCallback(ih, "SORTCOLUMNCOMPARE_CB");
+  ctx->utf8 = IupGetInt(NULL, "UTF8MODE");
+  ctx->casesensitive = iupAttribGetInt(ih, "SORTCOLUMNCASESENSITIVE");
+  /* text can be stored in temporary buffers */
+  ctx->dup_text = ih->data->callback_mode || IupGetCallback(ih, "TRANSLATEVALUE_CB") != NULL;
+  ctx->count = count;
+
+  iMatrixSortParseKeys(ih, ctx, col);
+
+  /* the callback does not need stored keys */
+  if (!ctx->sort_cb)
+  {
+    for (k = 0; k < ctx->key_count; k++)
+    {
+      int key_col = ctx->keys[k].col;
+      ctx->keys[k].numeric = ih->data->numeric_columns && (ih->data->numeric_columns[key_col].flags & IMAT_IS_NUMERIC);
+      if (ctx->keys[k].numeric)
+        num_count++;
+      else
+        txt_count++;
+    }
+  }
+
+  /* doubles first to keep their alignment */
+  ctx->memory = calloc(count, num_count*sizeof(double) + txt_count*sizeof(char*) + sizeof(int));
+  if (!ctx->memory)
+    return 0;
+
+  mem = (char*)ctx->memory;
+  for (k = 0; k < num_count + txt_count; k++)
+  {
+    if (ctx->keys[k].numeric)
+    {
+      ctx->keys[k].numbers = (double*)mem;
+      mem += count * sizeof(double);
+    }
+  }
+  for (k = 0; k < num_count + txt_count; k++)
+  {
+    if (!ctx->keys[k].numeric)
+    {
+      ctx->keys[k].texts = (char**)mem;
+      mem += count * sizeof(char*);
+    }
+  }
+  ctx->lines = (int*)mem;
+
+  return 1;
+}
+
+static void iMatrixSortRelease(ImatSortContext* ctx)
+{
+  if (ctx->dup_text)
+  {
+    int k, i;
+    for (k = 0; k < ctx->key_count; k++)
+    {
+      if (ctx->keys[k].texts)
+      {
+        for (i = 0; i < ctx->count; i++)
+        {
+          if (ctx->keys[k].texts[i])
+            free(ctx->keys[k].texts[i]);
+        }
+      }
+    }
+  }
+
+  free(ctx->memory);
+}
+
+static void iMatrixSortSetEntry(ImatSortContext* ctx, int i, int lin)
+{
+  /* lin is the displayed line, keys are retrieved only here */
+  Ihandle* ih = ctx->ih;
+  int k;
+
+  ctx->lines[i] = ih->data->sort_line_index[lin];
+
+  for (k = 0; k < ctx->key_count; k++)
+  {
+    ImatSortKey* key = &(ctx->keys[k]);
+
+    if (key->numbers)
+    {
+      double number = iupMatrixGetValueNumeric(ih, lin, key->col);
+      if (number == 0) number = 0;  /* -0 and +0 are equal */
+      key->numbers[i] = number;
+    }
+    else if (key->texts)
+    {
+      char* text = iupMatrixGetValueDisplay(ih, lin, key->col);
+      if (text && text[0] == 0)
+        text = NULL;
+      if (text && ctx->dup_text)
+        text = iupStrDup(text);
+      key->texts[i] = text;
+    }
+  }
+}
+
+static void iMatrixSortFreeEntry(ImatSortContext* ctx, int i)
+{
+  if (ctx->dup_text)
+  {
+    int k;
+    for (k = 0; k < ctx->key_count; k++)
+    {
+      if (ctx->keys[k].texts && ctx->keys[k].texts[i])
+      {
+        free(ctx->keys[k].texts[i]);
+        ctx->keys[k].texts[i] = NULL;
+      }
+    }
+  }
+}
+
+static int iMatrixSortCompareKeys(ImatSortContext* ctx, int i1, int i2)
+{
+  int k;
+
+  for (k = 0; k < ctx->key_count; k++)
+  {
+    ImatSortKey* key = &(ctx->keys[k]);
+    int ret;
+
+    if (ctx->sort_cb)
+      ret = ctx->sort_cb(ctx->ih, key->col, ctx->lines[i1], ctx->lines[i2]);
+    else if (key->numbers)
+    {
+      double number1 = key->numbers[i1],
+             number2 = key->numbers[i2];
+      ret = (number1 < number2) ? -1 : (number1 > number2) ? 1 : 0;
+    }
+    else
+    {
+      char *text1 = key->texts[i1],
+           *text2 = key->texts[i2];
+      if (!text1 || !text2)  /* empty text is smaller */
+        ret = (text1 == text2) ? 0 : (!text1) ? -1 : 1;
+      else
+        ret = iupStrCompare(text1, text2, ctx->casesensitive, ctx->utf8);
+    }
+
+    if (ret)
+      return key->ascending ? ret : -ret;
+  }
+
+  return 0;
+}
+
+
+/**************************************************************************/
+/*  Merge Sort (stable)                                                   */
+/**************************************************************************/
+
+static int iMatrixSortCompare(ImatSortContext* ctx, int i1, int i2)
+{
+  int ret = iMatrixSortCompareKeys(ctx, i1, i2);
+  if (ret)
+    return ret;
+  /* equal keys keep the previous order */
+  return i1 - i2;
+}
+
+static void iMatrixSortInsertion(ImatSortContext* ctx, int* order, int start, int end)
+{
+  int i;
+  for (i = start + 1; i < end; i++)
+  {
+    int j = i, entry = order[i];
+    while (j > start && iMatrixSortCompare(ctx, order[j - 1], entry) > 0)
+    {
+      order[j] = order[j - 1];
+      j--;
+    }
+    order[j] = entry;
+  }
+}
+
+static int* iMatrixSortMerge(ImatSortContext* ctx, int* order, int* temp, int count)
+{
+  /* returns the array with the result, order or temp */
+  int start, width;
+
+  for (start = 0; start < count; start += IMAT_SORT_INSERTION)
+  {
+    int end = start + IMAT_SORT_INSERTION;
+    if (end > count) end = count;
+    iMatrixSortInsertion(ctx, order, start, end);
+  }
+
+  for (width = IMAT_SORT_INSERTION; width < count; width *= 2)
+  {
+    int* swap;
+
+    for (start = 0; start < count; start += 2 * width)
+    {
+      int mid = start + width, end = start + 2 * width;
+      int i, j, t = start;
+      if (mid > count) mid = count;
+      if (end > count) end = count;
+
+      i = start; j = mid;
+
+      /* runs already in order are just copied */
+      if (j < end && iMatrixSortCompare(ctx, order[j - 1], order[j]) <= 0)
+      {
+        memcpy(temp + start, order + start, (end - start) * sizeof(int));
+        continue;
+      }
+
+      while (i < mid && j < end)
+      {
+        if (iMatrixSortCompare(ctx, order[j], order[i]) < 0)
+          temp[t++] = order[j++];
+        else
+          temp[t++] = order[i++];
+      }
+      while (i < mid)
+        temp[t++] = order[i++];
+      while (j < end)
+        temp[t++] = order[j++];
+    }
+
+    swap = order; order = temp; temp = swap;
+  }
+
+  return order;
+}
+
+
+/**************************************************************************/
+/*  Radix Sort (stable), only for a single numeric key                    */
+/**************************************************************************/
+
+static void iMatrixSortRadixKey(double number, int ascending, int little_endian, unsigned char* key)
+{
+  /* the IEEE 754 bits, most significant byte first, transformed so unsigned order is numeric order */
+  unsigned char bytes[8];
+  int b, negative;
+
+  memcpy(bytes, &number, 8);
+  for (b = 0; b < 8; b++)
+    key[b] = little_endian ? bytes[7 - b] : bytes[b];
+
+  negative = key[0] & 0x80;
+  for (b = 0; b < 8; b++)
+  {
+    if (negative)
+      key[b] = (unsigned char)~key[b];
+    else if (b == 0)
+      key[b] |= 0x80;
+
+    if (!ascending)
+      key[b] = (unsigned char)~key[b];
+  }
+}
+
+static int* iMatrixSortRadix(ImatSortContext* ctx, int* order, int* temp, int count)
+{
+  /* returns the array with the result, order or temp */
+  ImatSortKey* key = &(ctx->keys[0]);
+  unsigned char* keys = (unsigned char*)malloc(count * 8);
+  int* counts = (int*)calloc(8 * 256, sizeof(int));
+  double one = 1;
+  int little_endian = (((unsigned char*)&one)[0] == 0);
+  int i, b;
+
+  if (!keys || !counts)
+  {
+    free(keys);
+    free(counts);
+    return iMatrixSortMerge(ctx, order, temp, count);
+  }
+
+  /* all the histograms in a single pass */
+  for (i = 0; i < count; i++)
+  {
+    unsigned char* k = keys + i * 8;
+    iMatrixSortRadixKey(key->numbers[i], key->ascending, little_endian, k);
+    for (b = 0; b < 8; b++)
+      counts[b * 256 + k[b]]++;
+  }
+
+  /* least significant byte first */
+  for (b = 7; b >= 0; b--)
+  {
+    int* count_b = counts + b * 256;
+    int d, sum = 0, *swap;
+
+    /* all entries with the same byte, nothing to do */
+    if (count_b[keys[order[0] * 8 + b]] == count)
+      continue;
+
+    for (d = 0; d < 256; d++)
+    {
+      int c = count_b[d];
+      count_b[d] = sum;
+      sum += c;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+      int entry = order[i];
+      temp[count_b[keys[entry * 8 + b]]++] = entry;
+    }
+
+    swap = order; order = temp; temp = swap;
+  }
+
+  free(keys);
+  free(counts);
+  return order;
+}
+
+
+/**************************************************************************/
+/*  Exported                                                              */
+/**************************************************************************/
+
+void iupMatrixSortLines(Ihandle* ih, int col, int lin1, int lin2)
+{
+  ImatSortContext ctx;
+  int count = lin2 - lin1 + 1;
+  int *order, *temp, *result;
+  int i;
+
+  /* the new order will not include any pending changes */
+  ih->data->sort_changed_count = 0;
+
+  if (count < 2 || !iMatrixSortInit(ih, &ctx, col, count))
+    return;
+
+  order = (int*)malloc(2 * count * sizeof(int));
+  if (!order)
+  {
+    iMatrixSortRelease(&ctx);
+    return;
+  }
+  temp = order + count;
+
+  for (i = 0; i < count; i++)
+  {
+    iMatrixSortSetEntry(&ctx, i, lin1 + i);
+    order[i] = i;
+  }
+
+  if (ctx.key_count == 1 && ctx.keys[0].numbers && count >= IMAT_SORT_RADIX_MIN)
+    result = iMatrixSortRadix(&ctx, order, temp, count);
+  else
+    result = iMatrixSortMerge(&ctx, order, temp, count);
+
+  for (i = 0; i < count; i++)
+    ih->data->sort_line_index[lin1 + i] = ctx.lines[result[i]];
+
+  free(order);
+  iMatrixSortRelease(&ctx);
+}
+
+static int iMatrixSortFindPosition(ImatSortContext* ctx, int* clean, int start, int clean_count, int entry, int probe)
+{
+  /* first clean line greater than the entry, equal lines stay before it.
+     The probe entry receives the keys of the clean line being compared. */
+  int end = clean_count;
+
+  while (start < end)
+  {
+    int mid = (start + end) / 2;
+    int ret;
+
+    iMatrixSortSetEntry(ctx, probe, clean[mid]);
+    ret = iMatrixSortCompareKeys(ctx, probe, entry);
+    iMatrixSortFreeEntry(ctx, probe);
+
+    if (ret <= 0)
+      start = mid + 1;
+    else
+      end = mid;
+  }
+
+  return start;
+}
+
+void iupMatrixSortUpdateLines(Ihandle* ih, int col, int lin1, int lin2)
+{
+  ImatSortContext ctx;
+  int count = lin2 - lin1 + 1;
+  int changed_count = ih->data->sort_changed_count;
+  int *clean, *changed, *order, *result, *new_index;
+  unsigned char* marks;
+  int i, lin, clean_count = 0, dirty_count = 0, pos = 0, c;
+
+  if (changed_count == 0 || count < 2)
+    return;
+
+  if (changed_count < 0)  /* too many changes */
+  {
+    iupMatrixSortLines(ih, col, lin1, lin2);
+    return;
+  }
+
+  marks = (unsigned char*)calloc(ih->data->lines.num, 1);
+  if (!marks)
+    return;
+
+  for (i = 0; i < changed_count; i++)
+  {
+    lin = ih->data->sort_changed_lines[i];
+    if (lin > 0 && lin < ih->data->lines.num)
+      marks[lin] = 1;
+  }
+  ih->data->sort_changed_count = 0;
+
+  /* displayed lines, separated in changed lines and lines still in order */
+  clean = (int*)malloc(count * 3 * sizeof(int));
+  if (!clean)
+  {
+    free(marks);
+    return;
+  }
+  changed = clean + count;
+  new_index = changed + count;
+
+  for (lin = lin1; lin <= lin2; lin++)
+  {
+    if (marks[ih->data->sort_line_index[lin]])
+      changed[dirty_count++] = lin;
+    else
+      clean[clean_count++] = lin;
+  }
+  free(marks);
+
+  /* one more entry to probe the clean lines */
+  if (dirty_count == 0 || !iMatrixSortInit(ih, &ctx, col, dirty_count + 1))
+  {
+    free(clean);
+    return;
+  }
+
+  order = (int*)malloc(2 * dirty_count * sizeof(int));
+  if (!order)
+  {
+    iMatrixSortRelease(&ctx);
+    free(clean);
+    return;
+  }
+
+  for (i = 0; i < dirty_count; i++)
+  {
+    iMatrixSortSetEntry(&ctx, i, changed[i]);
+    order[i] = i;
+  }
+  result = iMatrixSortMerge(&ctx, order, order + dirty_count, dirty_count);
+
+  /* insert the sorted changed lines in the clean lines, searching only after the previous one */
+  c = 0;
+  for (i = 0; i < dirty_count; i++)
+  {
+    int entry = result[i];
+    int p = iMatrixSortFindPosition(&ctx, clean, c, clean_count, entry, dirty_count);
+
+    for (; c < p; c++)
+      new_index[pos++] = ih->data->sort_line_index[clean[c]];
+
+    new_index[pos++] = ctx.lines[entry];
+  }
+  for (; c < clean_count; c++)
+    new_index[pos++] = ih->data->sort_line_index[clean[c]];
+
+  memcpy(ih->data->sort_line_index + lin1, new_index, count * sizeof(int));
+
+  free(order);
+  iMatrixSortRelease(&ctx);
+  free(clean);
+}
+
+void iupMatrixSortSetChanged(Ihandle* ih, int lin)
+{
+  /* lin is the internal line */
+  int max_count;
+
+  if (!ih->data->sort_has_index || ih->data->sort_changed_count < 0)
+    return;
+
+  /* after that a full sort is faster */
+  max_count = ih->data->lines.num / 4 + 16;
+  if (ih->data->sort_changed_count >= max_count)
+  {
+    ih->data->sort_changed_count = -1;
+    return;
+  }
+
+  if (ih->data->sort_changed_count == ih->data->sort_changed_max)
+  {
+    int new_max = ih->data->sort_changed_max ? 2 * ih->data->sort_changed_max : 32;
+    int* new_lines = (int*)realloc(ih->data->sort_changed_lines, new_max * sizeof(int));
+    if (!new_lines)
+    {
+      ih->data->sort_changed_count = -1;
+      return;
+    }
+    ih->data->sort_changed_lines = new_lines;
+    ih->data->sort_changed_max = new_max;
+  }
+
+  ih->data->sort_changed_lines[ih->data->sort_changed_count] = lin;
+  ih->data->sort_changed_count++;
+}
+
+void iupMatrixSortRelease(Ihandle* ih)
+{
+  if (ih->data->sort_changed_lines)
+  {
+    free(ih->data->sort_changed_lines);
+    ih->data->sort_changed_lines = NULL;
+  }
+  ih->data->sort_changed_count = 0;
+  ih->data->sort_changed_max = 0;
+}
@@ -0,0 +1,27 @@
+/** \file
+ * \brief iupmatrix. sort of lines.
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+#ifndef __IUPMAT_SORT_H
+#define __IUPMAT_SORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* lin1 and lin2 are the displayed lines, the result is stored in sort_line_index */
+void iupMatrixSortLines(Ihandle* ih, int col, int lin1, int lin2);
+/* moves only the lines changed since the last sort */
+void iupMatrixSortUpdateLines(Ihandle* ih, int col, int lin1, int lin2);
+
+/* lin is the internal line (after sort) */
+void iupMatrixSortSetChanged(Ihandle* ih, int lin);
+void iupMatrixSortRelease(Ihandle* ih);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -32,6 +32,7 @@
 #include "iup_stdcontrols.h"
 #include "iup_controls.h"
 #include "iup_register.h"
+#include "iup_layout.h"
 #include "iup_assert.h"
 #include "iup_flatscrollbar.h"
 
@@ -47,6 +48,7 @@
 #include "iupmat_mark.h"
 #include "iupmat_edit.h"
 #include "iupmat_draw.h"
+#include "iupmat_cache.h"
 
 
 int iupMatrixIsValid(Ihandle* ih, int check_cells)
@@ -659,13 +661,14 @@ static void iMatrixFitColText(Ihandle* ih, int col)
   /* find the largest cel in the col */
   int lin, max_width = 0, max;
 
+  iupMatrixDisplayCacheCheck(ih);
+
   for (lin = 0; lin < ih->data->lines.num; lin++)
   {
-    char* title_value = iupMatrixGetValueDisplay(ih, lin, col);
+    char* title_value = iupMatrixGetValueDisplayCached(ih, lin, col);
     if (title_value && title_value[0])
     {
-      int w;
-      iupdrvFontGetMultiLineStringSize(ih, title_value, &w, NULL);
+      int w = iupMatrixDisplayCacheGetWidth(ih, title_value);
       if (w > max_width)
         max_width = w;
     }
@@ -683,9 +686,11 @@ static void iMatrixFitLineText(Ihandle* ih, int line)
   /* find the highest cel in the line */
   int col, max_height = 0, max;
 
+  iupMatrixDisplayCacheCheck(ih);
+
   for (col = 0; col < ih->data->columns.num; col++)
   {
-    char* title_value = iupMatrixGetValueDisplay(ih, line, col);
+    char* title_value = iupMatrixGetValueDisplayCached(ih, line, col);
     if (title_value && title_value[0])
     {
       int h;
@@ -886,13 +891,47 @@ static int iMatrixSetMoveLinAttrib(Ihandle* ih, int from_lin, const char* value)
   return 0;
 }
 
-static int iMatrixSetSizeAttrib(Ihandle* ih, int pos, const char* value)
+static int iMatrixSetSizeAttrib(Ihandle* ih, const char* name, int m, int pos, const char* value)
 {
-  (void)pos;
-  (void)value;
-  ih->data->need_calcsize = 1;
+  ImatLinColData *p = (m == IMAT_PROCESS_LIN)? &(ih->data->lines): &(ih->data->columns);
+
+  if (!ih->handle || ih->data->need_calcsize || pos < 0 || pos >= p->num)
+  {
+    ih->data->need_calcsize = 1;
+    iupLayoutSetDirty(ih);
+    IupUpdate(ih);  /* post a redraw */
+    return 1;  /* always save in the hash table, so when FONT is changed SIZE can be updated */
+  }
+
+  /* store it before, the size is computed from the attribute */
+  iupAttribSetStrId(ih, name, pos, value);
+
+  /* update only the size of this column/line */
+  iupMatrixAuxUpdateSize(ih, m, pos);
+  iupLayoutSetDirty(ih);  /* the visible columns/lines are used to compute the natural size */
+
   IupUpdate(ih);  /* post a redraw */
-  return 1;  /* always save in the hash table, so when FONT is changed SIZE can be updated */
+  return 0;
+}
+
+static int iMatrixSetWidthAttrib(Ihandle* ih, int pos, const char* value)
+{
+  return iMatrixSetSizeAttrib(ih, "WIDTH", IMAT_PROCESS_COL, pos, value);
+}
+
+static int iMatrixSetHeightAttrib(Ihandle* ih, int pos, const char* value)
+{
+  return iMatrixSetSizeAttrib(ih, "HEIGHT", IMAT_PROCESS_LIN, pos, value);
+}
+
+static int iMatrixSetRasterWidthAttrib(Ihandle* ih, int pos, const char* value)
+{
+  return iMatrixSetSizeAttrib(ih, "RASTERWIDTH", IMAT_PROCESS_COL, pos, value);
+}
+
+static int iMatrixSetRasterHeightAttrib(Ihandle* ih, int pos, const char* value)
+{
+  return iMatrixSetSizeAttrib(ih, "RASTERHEIGHT", IMAT_PROCESS_LIN, pos, value);
 }
 
 static char* iMatrixGetWidthAttrib(Ihandle* ih, int col)
@@ -974,6 +1013,11 @@ static char* iMatrixGetCellSizeAttrib(Ihandle* ih, int lin, int col)
   return NULL;
 }
 
+static char* iMatrixGetRedrawStatsAttrib(Ihandle* ih)
+{
+  return iupStrReturnStrf("%d:%d:%d", ih->data->redraw_cells, ih->data->redraw_full_count, ih->data->redraw_partial_count);
+}
+
 static int iMatrixSetNeedRedraw(Ihandle* ih)
 {
   ih->data->need_redraw = 1;
@@ -987,6 +1031,7 @@ static int iMatrixSetFlatAttrib(Ihandle* ih, const char* value)
   else
     ih->data->flat = 0;
 
+  ih->data->need_redraw = 1;
   IupUpdate(ih);  /* post a redraw */
   return 0; /* do not store value in hash table */
 }
@@ -1771,7 +1816,7 @@ static int iMatrixResize_CB(Ihandle* ih)
 
   if (old_w != ih->data->w || old_h != ih->data->h)
   {
-    ih->data->need_calcsize = 1;
+    ih->data->need_calcsize = 1;  /* also catches pending WIDTHDEF, HEIGHTDEF and FONT changes */
 
     if (ih->data->edit_hide_onfocus)
     {
@@ -1795,12 +1840,13 @@ static int iMatrixRedraw_CB(Ihandle* ih)
   if (!ih->data->cd_canvas)
     return IUP_DEFAULT;
 
+#ifdef USE_OLD_DRAW
   if (ih->data->callback_mode ||  /* in callback mode the values are not changed by attributes, so we can NOT wait for a REDRAW */
       ih->data->need_redraw ||    /* if some of the attributes that do not automatically redraw were set */
-      ih->data->need_calcsize)    /* if something changed the matrix size */
+      ih->data->need_calcsize ||  /* if something changed the matrix size */
+      ih->data->need_calcvisible)
     iupMatrixDraw(ih, 0);
 
-#ifdef USE_OLD_DRAW
   iupMatrixDrawUpdate(ih);
 #else
   iupMatrixDrawCB(ih);
@@ -1861,6 +1907,8 @@ static int iMatrixCreateMethod(Ihandle* ih, void **params)
   ih->data->mark_lin2 = -1;
   ih->data->mark_col2 = -1;
   ih->data->edit_hide_onfocus = 1;
+  ih->data->retained_focus_lin = -1;
+  ih->data->dirty_lin1 = -1;
 
   return IUP_NOERROR;
 }
@@ -1875,12 +1923,17 @@ static int iMatrixMapMethod(Ihandle* ih)
 #ifdef USE_OLD_CDIUP
   ih->data->cd_canvas = cdCreateCanvas(CD_IUPDBUFFER, ih);
 #else
-  ih->data->cd_canvas = cdCreateCanvas(CD_IUPDRAW, ih);
+  /* the double buffer image is kept between redraws, so it can be scrolled */
+  ih->data->retained_buffer = iupAttribGetBoolean(ih, "RETAINEDBUFFER");
+  if (ih->data->retained_buffer)
+    ih->data->cd_canvas = cdCreateCanvas(CD_IUPDBUFFER, ih);
+  else
+    ih->data->cd_canvas = cdCreateCanvas(CD_IUPDRAW, ih);
 #endif
   if (!ih->data->cd_canvas)
     return IUP_ERROR;
 
-  if (IupGetCallback(ih, "VALUE_CB"))
+  if (IupGetCallback(ih, "VALUE_CB") || IupGetCallback(ih, "VALUES_RANGE_CB"))
   {
     ih->data->callback_mode = 1;
 
@@ -1907,6 +1960,8 @@ static void iMatrixUnMapMethod(Ihandle* ih)
     ih->data->cd_canvas = NULL;
   }
 
+  ih->data->retained_valid = 0;
+
   iupMatrixMemRelease(ih);
 }
 
@@ -2194,6 +2249,7 @@ Iclass* iupMatrixNewClass(void)
   iupClassRegisterCallback(ic, "VALUECHANGED_CB", "");
   /* --- Callback Mode --- */
   iupClassRegisterCallback(ic, "VALUE_CB", "ii=s");
+  iupClassRegisterCallback(ic, "VALUES_RANGE_CB", "iiiiV");
   iupClassRegisterCallback(ic, "VALUE_EDIT_CB", "iis");
   iupClassRegisterCallback(ic, "MARK_CB", "ii");
   iupClassRegisterCallback(ic, "MARKEDIT_CB", "iii");
@@ -2258,21 +2314,21 @@ Iclass* iupMatrixNewClass(void)
 
   /* IupMatrix Attributes - SIZE */
   iupClassRegisterAttribute(ic, "COUNT", iMatrixGetCountAttrib, NULL, NULL, NULL, IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttribute(ic, "NUMLIN", iMatrixGetNumLinAttrib, iupMatrixSetNumLinAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttribute(ic, "NUMCOL", iMatrixGetNumColAttrib, iupMatrixSetNumColAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "NUMLIN", iMatrixGetNumLinAttrib, iupMatrixSetNumLinAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT | IUPAF_LAYOUT);
+  iupClassRegisterAttribute(ic, "NUMCOL", iMatrixGetNumColAttrib, iupMatrixSetNumColAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT | IUPAF_LAYOUT);
   iupClassRegisterAttribute(ic, "NUMLIN_NOSCROLL", iMatrixGetNumLinNoScrollAttrib, iMatrixSetNumLinNoScrollAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "NUMCOL_NOSCROLL", iMatrixGetNumColNoScrollAttrib, iMatrixSetNumColNoScrollAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "NOSCROLLASTITLE", iMatrixGetNoScrollAsTitleAttrib, iMatrixSetNoScrollAsTitleAttrib, IUPAF_SAMEASSYSTEM, "NO", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttribute(ic, "NUMLIN_VISIBLE", iMatrixGetNumLinVisibleAttrib, NULL, IUPAF_SAMEASSYSTEM, "3", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttribute(ic, "NUMCOL_VISIBLE", iMatrixGetNumColVisibleAttrib, NULL, IUPAF_SAMEASSYSTEM, "4", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttribute(ic, "NUMLIN_VISIBLE_LAST", NULL, NULL, NULL, NULL, IUPAF_NO_INHERIT);
-  iupClassRegisterAttribute(ic, "NUMCOL_VISIBLE_LAST", NULL, NULL, NULL, NULL, IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "NUMLIN_VISIBLE", iMatrixGetNumLinVisibleAttrib, NULL, IUPAF_SAMEASSYSTEM, "3", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT | IUPAF_LAYOUT);
+  iupClassRegisterAttribute(ic, "NUMCOL_VISIBLE", iMatrixGetNumColVisibleAttrib, NULL, IUPAF_SAMEASSYSTEM, "4", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT | IUPAF_LAYOUT);
+  iupClassRegisterAttribute(ic, "NUMLIN_VISIBLE_LAST", NULL, NULL, NULL, NULL, IUPAF_NO_INHERIT | IUPAF_LAYOUT);
+  iupClassRegisterAttribute(ic, "NUMCOL_VISIBLE_LAST", NULL, NULL, NULL, NULL, IUPAF_NO_INHERIT | IUPAF_LAYOUT);
   iupClassRegisterAttribute(ic, "WIDTHDEF", NULL, NULL, IUPAF_SAMEASSYSTEM, "80", IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "HEIGHTDEF", NULL, NULL, IUPAF_SAMEASSYSTEM, "8", IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId(ic, "WIDTH", iMatrixGetWidthAttrib, iMatrixSetSizeAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId(ic, "HEIGHT", iMatrixGetHeightAttrib, iMatrixSetSizeAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId(ic, "RASTERWIDTH", iMatrixGetRasterWidthAttrib, iMatrixSetSizeAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId(ic, "RASTERHEIGHT", iMatrixGetRasterHeightAttrib, iMatrixSetSizeAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId(ic, "WIDTH", iMatrixGetWidthAttrib, iMatrixSetWidthAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId(ic, "HEIGHT", iMatrixGetHeightAttrib, iMatrixSetHeightAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId(ic, "RASTERWIDTH", iMatrixGetRasterWidthAttrib, iMatrixSetRasterWidthAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId(ic, "RASTERHEIGHT", iMatrixGetRasterHeightAttrib, iMatrixSetRasterHeightAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "FITTOSIZE", NULL, iMatrixSetFitToSizeAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "FITTOTEXT", NULL, iMatrixSetFitToTextAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId(ic, "FITMAXHEIGHT", NULL, NULL, IUPAF_NO_INHERIT);
@@ -2310,6 +2366,12 @@ Iclass* iupMatrixNewClass(void)
   iupClassRegisterAttribute(ic, "EDITING", iMatrixGetEditingAttrib, NULL, NULL, NULL, IUPAF_READONLY | IUPAF_NO_SAVE | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "EDITNEXT", iMatrixGetEditNextAttrib, iMatrixSetEditNextAttrib, IUPAF_SAMEASSYSTEM, "LIN", IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "REDRAW", NULL, iupMatrixDrawSetRedrawAttrib, NULL, NULL, IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "REDRAWSTATS", iMatrixGetRedrawStatsAttrib, NULL, NULL, NULL, IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_DEFAULTVALUE | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "RETAINEDBUFFER", NULL, NULL, NULL, NULL, IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "INVALIDATE", NULL, iupMatrixCacheSetInvalidateAttrib, NULL, NULL, IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "CACHETILES", NULL, iupMatrixCacheSetTilesAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "CACHEPREFETCH", NULL, iupMatrixCacheSetPrefetchAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "CACHESTATS", iupMatrixCacheGetStatsAttrib, NULL, NULL, NULL, IUPAF_READONLY | IUPAF_NO_DEFAULTVALUE | IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId2(ic, "CLEARVALUE", NULL, iMatrixSetClearValueAttrib, IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId2(ic, "CLEARATTRIB", NULL, iMatrixSetClearAttribAttrib, IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
 
@@ -2330,7 +2392,7 @@ Iclass* iupMatrixNewClass(void)
 
   /* IupMatrix Attributes - GENERAL */
   iupClassRegisterAttribute(ic, "USETITLESIZE", iMatrixGetUseTitleSizeAttrib, iMatrixSetUseTitleSizeAttrib, IUPAF_SAMEASSYSTEM, "NO", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttribute(ic, "LIMITEXPAND", iMatrixGetLimitExpandAttrib, iMatrixSetLimitExpandAttrib, IUPAF_SAMEASSYSTEM, "NO", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "LIMITEXPAND", iMatrixGetLimitExpandAttrib, iMatrixSetLimitExpandAttrib, IUPAF_SAMEASSYSTEM, "NO", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT | IUPAF_LAYOUT);
   iupClassRegisterAttribute(ic, "HIDDENTEXTMARKS", iMatrixGetHiddenTextMarksAttrib, iMatrixSetHiddenTextMarksAttrib, IUPAF_SAMEASSYSTEM, "NO", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
 
   iupClassRegisterAttribute(ic, "READONLY", NULL, NULL, NULL, NULL, IUPAF_NO_INHERIT);
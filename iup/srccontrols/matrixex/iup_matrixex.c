@@ -1062,6 +1062,8 @@ static void iMatrixExDestroyMethod(Ihandle* ih)
   if (matex_data->find_dlg)
     IupDestroy(matex_data->find_dlg);
 
+  iupMatrixExFindRelease(matex_data);
+
   if (matex_data->undo_stack)
   {
     iupAttribSetClassObject(ih, "UNDOCLEAR", NULL);
@@ -7,6 +7,8 @@
 #ifndef __IUP_MATRIXEX_H 
 #define __IUP_MATRIXEX_H 
 
+#include <stdio.h>
+
 #include "iup_array.h"
 
 #ifdef __cplusplus
@@ -14,16 +16,21 @@ extern "C" {
 #endif
 
 
+typedef struct _ImatExFindIndex ImatExFindIndex;  /* defined in iupmatex_find.c */
+
 typedef struct _ImatExData
 {
   Ihandle* ih;  /* self reference */
 
   int busy, busy_count, busy_undo_block,
-      busy_progress_abort;
+      busy_progress_abort, busy_readonly;
   IFniis busy_cb;
   Ihandle* busy_progress_dlg;
 
   Ihandle* find_dlg;
+  Iarray* find_results;         /* cells found by FINDALL */
+  ImatExFindIndex* find_index;  /* FINDINDEXid, one for each column */
+  int find_index_count;
 
   Iarray* undo_stack;
   int undo_stack_pos;
@@ -32,6 +39,7 @@ typedef struct _ImatExData
 
 /* Busy */
 void iupMatrixExBusyStart(ImatExData* matex_data, int count, const char* busyname);
+void iupMatrixExBusyStartReadOnly(ImatExData* matex_data, int count, const char* busyname);  /* no undo block */
 int iupMatrixExBusyInc(ImatExData* matex_data);
 void iupMatrixExBusyEnd(ImatExData* matex_data);
 
@@ -45,10 +53,34 @@ void iupMatrixExSortShowDialog(ImatExData* matex_data);
 
 /* Find */
 void iupMatrixExFindShowDialog(ImatExData* matex_data);
+void iupMatrixExFindRelease(ImatExData* matex_data);
 
 /* Visible */
 int iupMatrixExIsColumnVisible(Ihandle* ih, int col);
 int iupMatrixExIsLineVisible(Ihandle* ih, int lin);
+char* iupMatrixExGetVisibleLines(Ihandle* ih, int num_lin);    /* [0..num_lin], must be freed, NULL if out of memory */
+char* iupMatrixExGetVisibleColumns(Ihandle* ih, int num_col);  /* [0..num_col], must be freed, NULL if out of memory */
+
+/* Export */
+typedef struct _ImatExWriter
+{
+  FILE* file;   /* when NULL data is accumulated in memory */
+  char* buffer;
+  int len, size;
+  int error;    /* a write to the file or an allocation failed */
+} ImatExWriter;
+
+void iupMatrixExWriterInit(ImatExWriter* writer, FILE* file);
+void iupMatrixExWriterRelease(ImatExWriter* writer);  /* flush to file and free the buffer */
+void iupMatrixExWriterData(ImatExWriter* writer, const char* data, int len);
+void iupMatrixExWriterStr(ImatExWriter* writer, const char* str);
+void iupMatrixExWriterChar(ImatExWriter* writer, char c);
+char* iupMatrixExWriterGetString(ImatExWriter* writer);  /* memory only, zero terminated, NULL if failed */
+int iupMatrixExIsBinary(const char* data, long size);
+void iupMatrixExPasteBinary(Ihandle* ih, const char* data, long size, int lin, int col);
+
+/* Clipboard */
+int iupMatrixExPasteCheckSize(Ihandle* ih, int lin, int col, int data_num_lin, int data_num_col);
 
 /* Common */
 void iupMatrixExCheckLimitsOrder(int *v1, int *v2, int min, int max);
@@ -67,6 +99,10 @@ void iupMatrixExRegisterSort(Iclass* ic);
 /* Implemented in IupMatrix */
 char* iupMatrixExGetCellValue(Ihandle* ih, int lin, int col, int display);
 void  iupMatrixExSetCellValue(Ihandle* ih, int lin, int col, const char* value);  /* NO numeric conversion */
+int   iupMatrixExGetCellNumber(Ihandle* ih, int lin, int col, double *number);  /* returns 0 if not in a NUMERICSTORE column */
+void  iupMatrixExSetCellNumber(Ihandle* ih, int lin, int col, double number);  /* NO numeric conversion */
+void  iupMatrixExRestoreCellValue(Ihandle* ih, int lin, int col, const char* value);  /* NO callbacks, used by Undo/Redo */
+void  iupMatrixExRestoreCellNumber(Ihandle* ih, int lin, int col, double number);
 
 
 #ifdef __cplusplus
@@ -68,7 +68,7 @@ static void iMatrixExBusyShowProgress(ImatExData* matex_data, int count, const c
   IupShowXY(matex_data->busy_progress_dlg, x, y);
 }
 
-void iupMatrixExBusyStart(ImatExData* matex_data, int count, const char* busyname)
+static void iMatrixExBusyStart(ImatExData* matex_data, int count, const char* busyname, int undo)
 {
   /* can not start a new one if already busy */
   iupASSERT(!matex_data->busy);
@@ -78,6 +78,7 @@ void iupMatrixExBusyStart(ImatExData* matex_data, int count, const char* busynam
   matex_data->busy = 1;
   matex_data->busy_count = 0;
   matex_data->busy_undo_block = 0;
+  matex_data->busy_readonly = !undo;
 
   IupStoreAttribute(matex_data->ih, "_IUPMATEX_OLDCURSOR", IupGetAttribute(matex_data->ih, "CURSOR"));
   IupSetAttribute(matex_data->ih, "CURSOR", "BUSY");
@@ -94,13 +95,25 @@ void iupMatrixExBusyStart(ImatExData* matex_data, int count, const char* busynam
     matex_data->busy = 2;
   }
 
-  if (iupStrBoolean(iupAttribGetClassObject(matex_data->ih, "UNDOREDO")))
+  if (undo && iupStrBoolean(iupAttribGetClassObject(matex_data->ih, "UNDOREDO")))
   {
     matex_data->busy_undo_block = 1;
     iupMatrixExUndoPushBegin(matex_data, busyname);
   }
 }
 
+void iupMatrixExBusyStart(ImatExData* matex_data, int count, const char* busyname)
+{
+  iMatrixExBusyStart(matex_data, count, busyname, 1);
+}
+
+void iupMatrixExBusyStartReadOnly(ImatExData* matex_data, int count, const char* busyname)
+{
+  /* for operations that do not change cells, like exporting, 
+     so an empty undo block is not created */
+  iMatrixExBusyStart(matex_data, count, busyname, 0);
+}
+
 int iupMatrixExBusyInc(ImatExData* matex_data)
 {
   if (matex_data->busy)
@@ -156,7 +169,10 @@ void iupMatrixExBusyEnd(ImatExData* matex_data)
     matex_data->busy = 0;
     matex_data->busy_undo_block = 0;
 
-    IupSetAttribute(matex_data->ih,"REDRAW","ALL");
+    /* exporting does not change the cells */
+    if (!matex_data->busy_readonly)
+      IupSetAttribute(matex_data->ih,"REDRAW","ALL");
+    matex_data->busy_readonly = 0;
   }
 }
 
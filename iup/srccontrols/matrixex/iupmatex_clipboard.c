@@ -18,6 +18,16 @@
 #include "iup_str.h"
 #include "iup_matrixex.h"
 
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 
 static void iMatrixExMarkedCellLimits(const char* marked, int num_lin, int num_col, int *lin1, int *lin2, int *col1, int *col2)
 {
@@ -133,22 +143,7 @@ static int iMatrixExMarkedCellConsistent(const char* marked, int num_lin, int nu
   return 1;
 }
 
-static void iMatrixExArrayAddChar(Iarray* data, char c)
-{
-  int last_count = iupArrayCount(data);
-  char* str_data = (char*)iupArrayInc(data);
-  str_data[last_count] = c;
-}
-
-static void iMatrixExArrayAddStr(Iarray* data, char* str)
-{
-  int add_count = (int)strlen(str);
-  int last_count = iupArrayCount(data);
-  char* str_data = (char*)iupArrayAdd(data, add_count);
-  memcpy(str_data+last_count, str, add_count);
-}
-
-static void iMatrixExArrayAddCell(ImatExData* matex_data, Iarray* data, int lin, int col, char sep)
+static void iMatrixExWriteCell(ImatExData* matex_data, ImatExWriter* writer, int lin, int col, char sep)
 {
   char* value = iupMatrixExGetCellValue(matex_data->ih, lin, col, 1);  /* get displayed value */
 
@@ -159,18 +154,18 @@ static void iMatrixExArrayAddCell(ImatExData* matex_data, Iarray* data, int lin,
       add_sep = 1;
 
     if (add_sep)
-      iMatrixExArrayAddChar(data, '\"');
+      iupMatrixExWriterChar(writer, '\"');
 
-    iMatrixExArrayAddStr(data, value);
+    iupMatrixExWriterStr(writer, value);
 
     if (add_sep)
-      iMatrixExArrayAddChar(data, '\"');
+      iupMatrixExWriterChar(writer, '\"');
   }
   else
-    iMatrixExArrayAddChar(data, ' ');
+    iupMatrixExWriterChar(writer, ' ');
 }
 
-static void iMatrixExCopyGetDataMarkedCol(ImatExData* matex_data, Iarray* data, const char* marked, int num_lin, int num_col, char sep)
+static int iMatrixExCopyGetDataMarkedCol(ImatExData* matex_data, ImatExWriter* writer, const char* vis_lin, const char* vis_col, const char* marked, int num_lin, int num_col, char sep)
 {
   int lin, col;
   int add_sep;
@@ -179,27 +174,36 @@ static void iMatrixExCopyGetDataMarkedCol(ImatExData* matex_data, Iarray* data,
   {
     add_sep = 0;
 
-    if (iupMatrixExIsLineVisible(matex_data->ih, lin))
+    if (vis_lin[lin])
     {
+      iupStrArenaBegin();  /* cell values of this line are released at once */
+
       for(col = 1; col <= num_col; ++col)
       {
         /* only marked columns */
-        if (marked[col-1] == '1' && iupMatrixExIsColumnVisible(matex_data->ih, col))
+        if (marked[col-1] == '1' && vis_col[col])
         {
           if (add_sep)
-            iMatrixExArrayAddChar(data, sep);
+            iupMatrixExWriterChar(writer, sep);
 
-          iMatrixExArrayAddCell(matex_data, data, lin, col, sep);
+          iMatrixExWriteCell(matex_data, writer, lin, col, sep);
           add_sep = 1;
         }
       }
 
-      iMatrixExArrayAddChar(data, '\n');
+      iupMatrixExWriterChar(writer, '\n');
+
+      iupStrArenaEnd();
     }
+
+    if (!iupMatrixExBusyInc(matex_data))
+      return 0;
   }
+
+  return 1;
 }
 
-static void iMatrixExCopyGetDataMarkedLin(ImatExData* matex_data, Iarray* data, const char* marked, int num_lin, int num_col, char sep)
+static int iMatrixExCopyGetDataMarkedLin(ImatExData* matex_data, ImatExWriter* writer, const char* vis_lin, const char* vis_col, const char* marked, int num_lin, int num_col, char sep)
 {
   int lin, col;
   int add_sep;
@@ -209,26 +213,35 @@ static void iMatrixExCopyGetDataMarkedLin(ImatExData* matex_data, Iarray* data,
     add_sep = 0;
 
     /* only marked lines */
-    if (marked[lin - 1] == '1' && iupMatrixExIsLineVisible(matex_data->ih, lin))
+    if (marked[lin - 1] == '1' && vis_lin[lin])
     {
+      iupStrArenaBegin();
+
       for(col = 1; col <= num_col; ++col)    /* all columns */
       {
-        if (iupMatrixExIsColumnVisible(matex_data->ih, col))
+        if (vis_col[col])
         {
           if (add_sep)
-            iMatrixExArrayAddChar(data, sep);
+            iupMatrixExWriterChar(writer, sep);
 
-          iMatrixExArrayAddCell(matex_data, data, lin, col, sep);
+          iMatrixExWriteCell(matex_data, writer, lin, col, sep);
           add_sep = 1;
         }
       }
 
-      iMatrixExArrayAddChar(data, '\n');
+      iupMatrixExWriterChar(writer, '\n');
+
+      iupStrArenaEnd();
     }
+
+    if (!iupMatrixExBusyInc(matex_data))
+      return 0;
   }
+
+  return 1;
 }
 
-static void iMatrixExCopyGetDataMarkedCell(ImatExData* matex_data, Iarray* data, const char* marked, int lin1, int col1, int lin2, int col2, int num_col, int keep_struct, char sep)
+static int iMatrixExCopyGetDataMarkedCell(ImatExData* matex_data, ImatExWriter* writer, const char* vis_lin, const char* vis_col, const char* marked, int lin1, int col1, int lin2, int col2, int num_col, int keep_struct, char sep)
 {
   int lin, col;
   int add_sep;
@@ -237,38 +250,47 @@ static void iMatrixExCopyGetDataMarkedCell(ImatExData* matex_data, Iarray* data,
   {
     add_sep = 0;
 
-    if (iupMatrixExIsLineVisible(matex_data->ih, lin))
+    if (vis_lin[lin])
     {
+      iupStrArenaBegin();
+
       for(col = col1; col <= col2; ++col)
       {
-        if (iupMatrixExIsColumnVisible(matex_data->ih, col))
+        if (vis_col[col])
         {
           int pos = (lin - 1) * num_col + (col - 1);  /* marked array does not include titles */
           if (marked[pos] == '1')
           {
             if (add_sep)
-              iMatrixExArrayAddChar(data, sep);
+              iupMatrixExWriterChar(writer, sep);
 
-            iMatrixExArrayAddCell(matex_data, data, lin, col, sep);
+            iMatrixExWriteCell(matex_data, writer, lin, col, sep);
             add_sep = 1;
           }
           else if (keep_struct)
           {
             if (add_sep)
-              iMatrixExArrayAddChar(data, sep);
+              iupMatrixExWriterChar(writer, sep);
 
-            iMatrixExArrayAddChar(data, ' ');
+            iupMatrixExWriterChar(writer, ' ');
             add_sep = 1;
           }
         }
       }
 
-      iMatrixExArrayAddChar(data, '\n');
+      iupMatrixExWriterChar(writer, '\n');
+
+      iupStrArenaEnd();
     }
+
+    if (!iupMatrixExBusyInc(matex_data))
+      return 0;
   }
+
+  return 1;
 }
 
-static void iMatrixExCopyGetData(ImatExData* matex_data, Iarray* data, int lin1, int col1, int lin2, int col2, char sep)
+static int iMatrixExCopyGetData(ImatExData* matex_data, ImatExWriter* writer, const char* vis_lin, const char* vis_col, int lin1, int col1, int lin2, int col2, char sep)
 {
   int lin, col;
   int add_sep;
@@ -277,33 +299,42 @@ static void iMatrixExCopyGetData(ImatExData* matex_data, Iarray* data, int lin1,
   {
     add_sep = 0;
 
-    if (iupMatrixExIsLineVisible(matex_data->ih, lin))
+    if (vis_lin[lin])
     {
+      iupStrArenaBegin();
+
       for(col = col1; col <= col2; ++col)
       {
-        if (iupMatrixExIsColumnVisible(matex_data->ih, col))
+        if (vis_col[col])
         {
           if (add_sep)
-            iMatrixExArrayAddChar(data, sep);
+            iupMatrixExWriterChar(writer, sep);
 
-          iMatrixExArrayAddCell(matex_data, data, lin, col, sep);
+          iMatrixExWriteCell(matex_data, writer, lin, col, sep);
 
           add_sep = 1;
         }
       }
 
-      iMatrixExArrayAddChar(data, '\n');
+      iupMatrixExWriterChar(writer, '\n');
+
+      iupStrArenaEnd();
     }
+
+    if (!iupMatrixExBusyInc(matex_data))
+      return 0;
   }
+
+  return 1;
 }
 
-static void iMatrixExCopyData(ImatExData* matex_data, Iarray* data, const char* value)
+static int iMatrixExCopyData(ImatExData* matex_data, ImatExWriter* writer, const char* value)
 {
-  int num_lin, num_col;
-  char sep;
+  int num_lin, num_col, ret = 0;
+  char sep, *vis_lin, *vis_col;
 
   if (!value)
-    return;
+    return 0;
 
   sep = *(iupAttribGetStr(matex_data->ih, "TEXTSEPARATOR"));
 
@@ -313,26 +344,33 @@ static void iMatrixExCopyData(ImatExData* matex_data, Iarray* data, const char*
   num_lin = IupGetInt(matex_data->ih, "NUMLIN");
   num_col = IupGetInt(matex_data->ih, "NUMCOL");
 
+  /* computed once, instead of for each cell */
+  vis_lin = iupMatrixExGetVisibleLines(matex_data->ih, num_lin);
+  vis_col = iupMatrixExGetVisibleColumns(matex_data->ih, num_col);
+  if (!vis_lin || !vis_col)
+  {
+    if (vis_lin) free(vis_lin);
+    if (vis_col) free(vis_col);
+    iupAttribSet(matex_data->ih, "LASTERROR", "IUP_ERRORMEMORY");
+    return 0;
+  }
+
   if (iupStrEqualNoCase(value, "MARKED"))
   {
     char *marked = IupGetAttribute(matex_data->ih,"MARKED");
     if (!marked)  /* no marked cells */
     {
       iupAttribSet(matex_data->ih, "LASTERROR", "IUP_ERRORNOSELECTION");
-      return;
     }
-
-    if (*marked == 'C')
+    else if (*marked == 'C')
     {
       marked++;
-
-      iMatrixExCopyGetDataMarkedCol(matex_data, data, marked, num_lin, num_col, sep);
+      ret = iMatrixExCopyGetDataMarkedCol(matex_data, writer, vis_lin, vis_col, marked, num_lin, num_col, sep);
     }
     else if (*marked == 'L')
     {
       marked++;
-
-      iMatrixExCopyGetDataMarkedLin(matex_data, data, marked, num_lin, num_col, sep);
+      ret = iMatrixExCopyGetDataMarkedLin(matex_data, writer, vis_lin, vis_col, marked, num_lin, num_col, sep);
     }
     else
     {
@@ -345,10 +383,11 @@ static void iMatrixExCopyData(ImatExData* matex_data, Iarray* data, const char*
       if (!keep_struct && !iMatrixExMarkedCellConsistent(marked, num_lin, num_col))
       {
         iupAttribSet(matex_data->ih, "LASTERROR", "IUP_ERRORINVALIDSELECTION");
-        return;
       }
-
-      iMatrixExCopyGetDataMarkedCell(matex_data, data, marked, lin1, col1, lin2, col2, num_col, keep_struct, sep);
+      else
+      {
+        ret = iMatrixExCopyGetDataMarkedCell(matex_data, writer, vis_lin, vis_col, marked, lin1, col1, lin2, col2, num_col, keep_struct, sep);
+      }
     }
   }
   else 
@@ -363,30 +402,33 @@ static void iMatrixExCopyData(ImatExData* matex_data, Iarray* data, const char*
       iupMatrixExCheckLimitsOrder(&col1, &col2, 1, num_col);
     }
 
-    iMatrixExCopyGetData(matex_data, data, lin1, col1, lin2, col2, sep);
+    ret = iMatrixExCopyGetData(matex_data, writer, vis_lin, vis_col, lin1, col1, lin2, col2, sep);
   }
+
+  free(vis_lin);
+  free(vis_col);
+  return ret;
 }
 
 static int iMatrixExSetCopyAttrib(Ihandle *ih, const char* value)
 {
   ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
-  Iarray* data =  iupArrayCreate(100, sizeof(char));
+  ImatExWriter writer;
 
-  iMatrixExCopyData(matex_data, data, value);
+  iupMatrixExWriterInit(&writer, NULL);
 
-  if (iupArrayCount(data)!=0)
+  if (iMatrixExCopyData(matex_data, &writer, value) && writer.len != 0 && !writer.error)
   {
-    Ihandle* clipboard;
-
-    iMatrixExArrayAddChar(data, '\0');
-
-    clipboard = IupClipboard();
+    Ihandle* clipboard = IupClipboard();
     IupSetAttribute(clipboard, "TEXT", NULL);  /* clear all data from clipboard */
-    IupSetAttribute(clipboard, "TEXT", (char*)iupArrayGetData(data));
+    IupSetAttribute(clipboard, "TEXT", iupMatrixExWriterGetString(&writer));
     IupDestroy(clipboard);
   }
 
-  iupArrayDestroy(data);
+  if (writer.error)
+    iupAttribSet(ih, "LASTERROR", "IUP_ERRORMEMORY");
+
+  iupMatrixExWriterRelease(&writer);
   return 0;
 }
 
@@ -397,18 +439,17 @@ static int iMatrixExSetCopyDataAttrib(Ihandle *ih, const char* value)
   else
   {
     ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
-    Iarray* data =  iupArrayCreate(100, sizeof(char));
+    ImatExWriter writer;
 
-    iMatrixExCopyData(matex_data, data, value);
+    iupMatrixExWriterInit(&writer, NULL);
 
-    if (iupArrayCount(data)!=0)
-    {
-      iMatrixExArrayAddChar(data, '\0');
+    if (iMatrixExCopyData(matex_data, &writer, value) && writer.len != 0 && !writer.error)
+      iupAttribSetStr(ih, "COPYDATA", iupMatrixExWriterGetString(&writer));
 
-      iupAttribSetStr(ih, "COPYDATA", (char*)iupArrayGetData(data));
-    }
+    if (writer.error)
+      iupAttribSet(ih, "LASTERROR", "IUP_ERRORMEMORY");
 
-    iupArrayDestroy(data);
+    iupMatrixExWriterRelease(&writer);
   }
   return 0;
 }
@@ -459,7 +500,7 @@ static int iMatrixExStrGetDataSize(const char* data, int *num_lin, int *num_col,
 
 static char* iMatrixExStrCopyData(char* value, int *value_max_size, const char* data, int value_len)
 {
-  if (*value_max_size < value_len)
+  if (*value_max_size < value_len + 1)  /* including the terminator */
   {
     *value_max_size = value_len+10;
     value = realloc(value, *value_max_size);
@@ -562,12 +603,37 @@ static int iMatrixExGetVisibleNumCol(Ihandle *ih, int start_col, int data_num_co
   return vis_num_col;
 }
 
+int iupMatrixExPasteCheckSize(Ihandle* ih, int lin, int col, int data_num_lin, int data_num_col)
+{
+  IFnii pastesize_cb = (IFnii)IupGetCallback(ih, "PASTESIZE_CB");
+  if (pastesize_cb)
+  {
+    int num_lin = IupGetInt(ih, "NUMLIN");
+    int num_col = IupGetInt(ih, "NUMCOL");
+    int vis_num_lin = iMatrixExGetVisibleNumLin(ih, lin, data_num_lin);
+    int vis_num_col = iMatrixExGetVisibleNumCol(ih, col, data_num_col);
+    if (lin+vis_num_lin>num_lin ||
+        col+vis_num_col>num_col)
+    {
+      int ret = pastesize_cb(ih, lin+vis_num_lin, col+vis_num_col);
+      if (ret == IUP_IGNORE)
+        return 0;
+      else if (ret == IUP_CONTINUE)
+      {
+        if (lin+vis_num_lin>num_lin) IupSetInt(ih, "NUMLIN", lin+vis_num_lin);
+        if (col+vis_num_col>num_col) IupSetInt(ih, "NUMCOL", col+vis_num_col);
+      }
+    }
+  }
+
+  return 1;
+}
+
 static void iMatrixExPasteData(Ihandle *ih, const char* data, int lin, int col, const char* busyname)
 {
   int num_lin, num_col, skip_lines,
       data_num_lin, data_num_col;
   char sep=0, *str_sep;
-  IFnii pastesize_cb;
 
   /* reset error state */
   iupAttribSet(ih, "LASTERROR", NULL);
@@ -606,28 +672,12 @@ static void iMatrixExPasteData(Ihandle *ih, const char* data, int lin, int col,
     return;
   }
 
+  if (!iupMatrixExPasteCheckSize(ih, lin, col, data_num_lin, data_num_col))
+    return;
+
   num_lin = IupGetInt(ih, "NUMLIN");
   num_col = IupGetInt(ih, "NUMCOL");
 
-  pastesize_cb = (IFnii)IupGetCallback(ih, "PASTESIZE_CB");
-  if (pastesize_cb)
-  {
-    int vis_num_lin = iMatrixExGetVisibleNumLin(ih, lin, data_num_lin);
-    int vis_num_col = iMatrixExGetVisibleNumCol(ih, col, data_num_col);
-    if (lin+vis_num_lin>num_lin ||
-        col+vis_num_col>num_col)
-    {
-      int ret = pastesize_cb(ih, lin+vis_num_lin, col+vis_num_col);
-      if (ret == IUP_IGNORE)
-        return;
-      else if (ret == IUP_CONTINUE)
-      {
-        if (lin+vis_num_lin>num_lin) IupSetInt(ih, "NUMLIN", lin+vis_num_lin);
-        if (col+vis_num_col>num_col) IupSetInt(ih, "NUMCOL", col+vis_num_col);
-      }
-    }
-  }
-
   iMatrixExPasteSetData(ih, data, data_num_lin, data_num_col, sep, lin, col, num_lin, num_col, busyname);
 }
 
@@ -669,23 +719,22 @@ static int iMatrixExSetPasteDataAttrib(Ihandle *ih, const char* data)
   return 0;
 }
 
-static char* iMatrixReadFile(const char* filename)
+static char* iMatrixReadFile(const char* filename, long *size)
 {
   char* data;
-  long size;
   FILE *file = fopen(filename, "rb");
   if (!file)
     return NULL;
 
   fseek(file, 0, SEEK_END);
-  size = ftell(file);
-  if (size <= 0)
+  *size = ftell(file);
+  if (*size <= 0)
   {
     fclose(file);
     return NULL;
   }
 
-  data = (char*)malloc(size + 1);
+  data = (char*)malloc(*size + 1);
   if (!data)
   {
     fclose(file);
@@ -693,17 +742,348 @@ static char* iMatrixReadFile(const char* filename)
   }
 
   fseek(file, 0, SEEK_SET);
-  fread(data, size, 1, file);
-  data[size] = 0;
+  fread(data, *size, 1, file);
+  data[*size] = 0;
   fclose(file);
 
   return data;
 }
 
+static const char* iMatrixExFileMap(const char* filename, size_t *size)
+{
+  /* the file is mapped read-only, so it is not loaded in memory all at once */
+  const char* data;
+#ifdef WIN32
+  HANDLE file, mapping;
+  LARGE_INTEGER file_size;
+
+  file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+    return NULL;
+
+  if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart <= 0 || (ULONGLONG)file_size.QuadPart > (ULONGLONG)((size_t)-1))
+  {
+    CloseHandle(file);
+    return NULL;
+  }
+  *size = (size_t)file_size.QuadPart;
+
+  mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  CloseHandle(file);
+  if (!mapping)
+    return NULL;
+
+  data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);  /* the view keeps the mapping */
+  return data;
+#else
+  struct stat st;
+  void* map;
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 || (unsigned long long)st.st_size > (unsigned long long)((size_t)-1))
+  {
+    close(fd);
+    return NULL;
+  }
+  *size = (size_t)st.st_size;
+
+  map = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);  /* the mapping keeps the file */
+  if (map == MAP_FAILED)
+    return NULL;
+
+#ifdef MADV_SEQUENTIAL
+  madvise(map, *size, MADV_SEQUENTIAL);
+#endif
+
+  data = (const char*)map;
+  return data;
+#endif
+}
+
+static void iMatrixExFileUnmap(const char* data, size_t size)
+{
+#ifdef WIN32
+  UnmapViewOfFile(data);
+  (void)size;
+#else
+  munmap((void*)data, size);
+#endif
+}
+
+/* The mapped data is not zero terminated,
+   so here the scanning is limited by "end", and is done with memchr,
+   that is usually vectorized by the C library. */
+
+static int iMatrixExMemCountChar(const char* data, const char* end, char c)
+{
+  int count = 0;
+  while (data < end)
+  {
+    data = (const char*)memchr(data, c, end - data);
+    if (!data)
+      break;
+
+    count++;
+    data++;
+  }
+  return count;
+}
+
+static const char* iMatrixExMemNextLine(const char* data, const char* end, char eol, int *len)
+{
+  const char* line_end = (const char*)memchr(data, eol, end - data);
+  if (!line_end)
+  {
+    *len = (int)(end - data);
+    return end;  /* no next line */
+  }
+
+  *len = (int)(line_end - data);
+  if (eol == '\n' && *len && line_end[-1] == '\r')  /* DOS line end */
+    (*len)--;
+
+  return line_end + 1;
+}
+
+static const char* iMatrixExMemNextValue(const char* data, const char* line_end, char sep, int has_quote, int *len)
+{
+  const char* value_end;
+
+  if (!has_quote)
+    value_end = (const char*)memchr(data, sep, line_end - data);
+  else
+  {
+    /* same as iupStrNextValue, separators inside quotes are ignored */
+    int ignore_sep = 0;
+    for (value_end = data; value_end < line_end; value_end++)
+    {
+      if (*value_end == sep && !ignore_sep)
+        break;
+
+      if (*value_end == '\"')
+        ignore_sep = !ignore_sep;
+    }
+
+    if (value_end == line_end)
+      value_end = NULL;
+  }
+
+  if (!value_end)
+  {
+    *len = (int)(line_end - data);
+    return line_end;  /* no next value */
+  }
+
+  *len = (int)(value_end - data);
+  return value_end + 1;
+}
+
+static int iMatrixExMemGetDataSize(const char* data, const char* end, char eol, int *num_lin, int *num_col, char *sep)
+{
+  const char* last = end - 1;
+
+  *num_lin = iMatrixExMemCountChar(data, end, eol) + 1;
+  if (*last == eol)
+  {
+    (*num_lin)--;  /* avoid an empty last line */
+    last--;
+  }
+
+  if (*num_lin == 0)
+    return 0;
+
+  if (*sep != 0)
+    *num_col = iMatrixExMemCountChar(data, end, *sep);
+  else
+  {
+    /* try to guess the separator */
+    *sep = '\t';
+    *num_col = iMatrixExMemCountChar(data, end, *sep);
+    if (*num_col == 0)
+    {
+      *sep = ';';
+      *num_col = iMatrixExMemCountChar(data, end, *sep);
+    }
+    if (*num_col == 0)
+    {
+      *sep = ' ';
+      *num_col = iMatrixExMemCountChar(data, end, *sep);
+    }
+  }
+
+  /* If there is no column separator for the last column, so add it */
+  if (last < data || *last != *sep)
+    *num_col += *num_lin;
+
+  if (*num_col == 0)
+    return 0;
+
+  if ((*num_col)%(*num_lin)!=0)
+    return 0;
+
+  *num_col = (*num_col)/(*num_lin);
+  return 1;
+}
+
+static void iMatrixExPasteMappedData(Ihandle *ih, const char* data, const char* end, int start_lin, int start_col)
+{
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  int num_lin, num_col, skip_lines, data_num_lin, data_num_col;
+  int lin, col, len, l, c, value_len;
+  int value_max_size = 0, error = 0;
+  char sep = 0, eol, *str_sep, *value = NULL, *vis_lin, *vis_col;
+  const char* zero;
+
+  /* reset error state */
+  iupAttribSet(ih, "LASTERROR", NULL);
+
+  /* same as a zero terminated string */
+  zero = (const char*)memchr(data, 0, end - data);
+  if (zero)
+    end = zero;
+
+  if (data == end)
+  {
+    iupAttribSet(ih, "LASTERROR", "IUP_ERRORNOTEXT");
+    return;
+  }
+
+  /* DOS and UNIX line ends, or MAC when there is no line feed */
+  eol = memchr(data, '\n', end - data)? '\n': '\r';
+
+  skip_lines = IupGetInt(ih, "TEXTSKIPLINES");
+  if (skip_lines)
+  {
+    int i;
+
+    for (i = 0; i < skip_lines && data < end; i++)
+      data = iMatrixExMemNextLine(data, end, eol, &len);
+
+    if (i != skip_lines || data == end)
+    {
+      iupAttribSet(ih, "LASTERROR", "IUP_ERRORNOTEXT");
+      return;
+    }
+  }
+
+  str_sep = iupAttribGet(ih, "TEXTSEPARATOR");  /* don't check for the default value */
+  if (str_sep) sep = *str_sep;
+
+  if (!iMatrixExMemGetDataSize(data, end, eol, &data_num_lin, &data_num_col, &sep))
+  {
+    iupAttribSet(ih, "LASTERROR", "IUP_ERRORINVALIDDATA");
+    return;
+  }
+
+  if (!iupMatrixExPasteCheckSize(ih, start_lin, start_col, data_num_lin, data_num_col))
+    return;
+
+  num_lin = IupGetInt(ih, "NUMLIN");
+  num_col = IupGetInt(ih, "NUMCOL");
+
+  vis_lin = iupMatrixExGetVisibleLines(ih, num_lin);
+  vis_col = iupMatrixExGetVisibleColumns(ih, num_col);
+  if (!vis_lin || !vis_col)
+  {
+    if (vis_lin) free(vis_lin);
+    if (vis_col) free(vis_col);
+    iupAttribSet(ih, "LASTERROR", "IUP_ERRORMEMORY");
+    return;
+  }
+
+  /* progress is reported for each line */
+  iupMatrixExBusyStart(matex_data, data_num_lin, "PASTEFILE");
+
+  lin = start_lin;
+  l = 0;
+  while (lin <= num_lin && l < data_num_lin && data < end && !error)
+  {
+    if (vis_lin[lin])
+    {
+      const char* line_start = data;
+      const char* next_line = iMatrixExMemNextLine(data, end, eol, &len);
+      const char* line_end = line_start + len;
+      int has_quote = memchr(line_start, '\"', len) != NULL;
+
+      l++;
+
+      col = start_col;
+      c = 0;
+      while (len && col <= num_col && c < data_num_col)
+      {
+        if (vis_col[col])
+        {
+          const char* next_value = iMatrixExMemNextValue(data, line_end, sep, has_quote, &value_len);
+          const char* value_start = data;
+          int copy_len = value_len;
+
+          c++;
+
+          if (copy_len >= 2 && value_start[0] == '\"' && value_start[copy_len - 1] == '\"')
+          {
+            value_start++;
+            copy_len -= 2;
+          }
+
+          if (copy_len || !value_len)  /* an empty quoted value is ignored, as in the text paste */
+          {
+            if (value_max_size < copy_len + 1)
+            {
+              char* new_value = (char*)realloc(value, copy_len + 10);
+              if (!new_value)
+              {
+                /* stop here, the cells already set are kept */
+                iupAttribSet(ih, "LASTERROR", "IUP_ERRORMEMORY");
+                error = 1;
+                break;
+              }
+              value = new_value;
+              value_max_size = copy_len + 10;
+            }
+            memcpy(value, value_start, copy_len);
+            value[copy_len] = 0;
+            iupMatrixExSetCellValue(matex_data->ih, lin, col, value);
+          }
+
+          data = next_value;
+          len -= value_len + 1;
+        }
+
+        col++;
+      }
+
+      data = next_line;
+
+      if (!iupMatrixExBusyInc(matex_data))
+        break;
+    }
+
+    lin++;
+  }
+
+  if (matex_data->busy)  /* not canceled */
+  {
+    iupMatrixExBusyEnd(matex_data);
+    iupBaseCallValueChangedCb(matex_data->ih);
+  }
+
+  free(vis_lin);
+  free(vis_col);
+  if (value)
+    free(value);
+}
+
 static int iMatrixExSetPasteFileAttrib(Ihandle *ih, const char* value)
 {
   char* data, *paste_at;
+  const char* map_data;
   int lin = 0, col = 0;
+  size_t map_size;
+  long size;
 
   paste_at = iupAttribGet(ih, "PASTEFILEAT");
   if (paste_at)
@@ -717,14 +1097,30 @@ static int iMatrixExSetPasteFileAttrib(Ihandle *ih, const char* value)
     }
   }
 
-  data = iMatrixReadFile(value);
+  map_data = iMatrixExFileMap(value, &map_size);
+  if (map_data)
+  {
+    if (iupMatrixExIsBinary(map_data, (long)map_size))  /* saved with COPYFILE and FILEFORMAT=BIN */
+      iupMatrixExPasteBinary(ih, map_data, (long)map_size, lin, col);
+    else
+      iMatrixExPasteMappedData(ih, map_data, map_data + map_size, lin, col);
+
+    iMatrixExFileUnmap(map_data, map_size);
+    return 0;
+  }
+
+  /* when the file can not be mapped, read it all */
+  data = iMatrixReadFile(value, &size);
   if (!data)
   {
     iupAttribSet(ih, "LASTERROR", "IUP_ERRORFILEOPEN");
     return 0;
   }
 
-  iMatrixExPasteData(ih, data, lin, col, "PASTEFILE");
+  if (iupMatrixExIsBinary(data, size))
+    iupMatrixExPasteBinary(ih, data, size, lin, col);
+  else
+    iMatrixExPasteMappedData(ih, data, data + size, lin, col);
 
   free(data);
   return 0;
@@ -22,8 +22,11 @@
 static void iMatrixExCopyColToSetDataSelected(ImatExData* matex_data, int lin, int col, int num_lin, const char* selection, int selection_count, const char* busyname)
 {
   int skip_lin = lin;
+  /* typed values are copied directly, without a string */
+  double number;
+  int has_number = iupMatrixExGetCellNumber(matex_data->ih, lin, col, &number);
   /* Must duplicate the memory to ensure it will be valid for all iterations */
-  char* value = iupStrDup(iupMatrixExGetCellValue(matex_data->ih, lin, col, 0));  /* get internal value */
+  char* value = has_number? NULL: iupStrDup(iupMatrixExGetCellValue(matex_data->ih, lin, col, 0));  /* get internal value */
 
   iupMatrixExBusyStart(matex_data, selection_count, busyname);
 
@@ -31,7 +34,10 @@ static void iMatrixExCopyColToSetDataSelected(ImatExData* matex_data, int lin, i
   {
     if (lin != skip_lin && selection[lin]=='1' && iupMatrixExIsLineVisible(matex_data->ih, lin))
     {
-      iupMatrixExSetCellValue(matex_data->ih, lin, col, value);
+      if (has_number)
+        iupMatrixExSetCellNumber(matex_data->ih, lin, col, number);
+      else
+        iupMatrixExSetCellValue(matex_data->ih, lin, col, value);
 
       if (!iupMatrixExBusyInc(matex_data))
       {
@@ -50,8 +56,11 @@ static void iMatrixExCopyColToSetDataSelected(ImatExData* matex_data, int lin, i
 static void iMatrixExCopyColToSetData(ImatExData* matex_data, int lin, int col, int lin1, int lin2, const char* busyname)
 {
   int skip_lin = lin;
+  /* typed values are copied directly, without a string */
+  double number;
+  int has_number = iupMatrixExGetCellNumber(matex_data->ih, lin, col, &number);
   /* Must duplicate the memory to ensure it will be valid for all iterations */
-  char* value = iupStrDup(iupMatrixExGetCellValue(matex_data->ih, lin, col, 0));  /* get internal value */
+  char* value = has_number? NULL: iupStrDup(iupMatrixExGetCellValue(matex_data->ih, lin, col, 0));  /* get internal value */
 
   iupMatrixExBusyStart(matex_data, lin2-lin1+1, busyname);
 
@@ -59,7 +68,10 @@ static void iMatrixExCopyColToSetData(ImatExData* matex_data, int lin, int col,
   {
     if (lin != skip_lin && iupMatrixExIsLineVisible(matex_data->ih, lin))
     {
-      iupMatrixExSetCellValue(matex_data->ih, lin, col, value);
+      if (has_number)
+        iupMatrixExSetCellNumber(matex_data->ih, lin, col, number);
+      else
+        iupMatrixExSetCellValue(matex_data->ih, lin, col, value);
 
       if (!iupMatrixExBusyInc(matex_data))
       {
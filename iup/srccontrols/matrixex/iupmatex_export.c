@@ -16,86 +16,276 @@
 #include "iup_object.h"
 #include "iup_attrib.h"
 #include "iup_str.h"
+#include "iup_classbase.h"
 #include "iup_matrixex.h"
 
 
-static void iMatrixExStrCopyNoSepHTML(char* buffer, const char* str)
+/**************************************************************************
+                              Buffered Writer
+***************************************************************************/
+
+#define IMATEX_WRITER_FILESIZE 65536  /* data is written to the file in large blocks */
+#define IMATEX_WRITER_MEMSIZE   1024  /* initial size, grows as needed */
+
+void iupMatrixExWriterInit(ImatExWriter* writer, FILE* file)
 {
-  while (*str)
+  writer->file = file;
+  writer->size = file? IMATEX_WRITER_FILESIZE: IMATEX_WRITER_MEMSIZE;
+  writer->buffer = (char*)malloc(writer->size);
+  writer->len = 0;
+  writer->error = 0;
+
+  if (!writer->buffer)
   {
-    if (*str=='\n')
+    writer->size = 0;
+    writer->error = 1;
+  }
+}
+
+static void iMatrixExWriterFlush(ImatExWriter* writer)
+{
+  if (writer->len && !writer->error)
+  {
+    if (fwrite(writer->buffer, 1, writer->len, writer->file) != (size_t)writer->len)
+      writer->error = 1;
+  }
+
+  writer->len = 0;
+}
+
+void iupMatrixExWriterData(ImatExWriter* writer, const char* data, int len)
+{
+  if (writer->error)
+    return;
+
+  if ((size_t)writer->len + (size_t)len > (size_t)writer->size)
+  {
+    if (writer->file)
     {
-      *buffer = '<'; buffer++;
-      *buffer = 'B'; buffer++;
-      *buffer = 'R'; buffer++;
-      *buffer = '>'; 
+      iMatrixExWriterFlush(writer);
+
+      if (len > writer->size)
+      {
+        /* larger than the buffer, write it directly */
+        if (!writer->error && fwrite(data, 1, len, writer->file) != (size_t)len)
+          writer->error = 1;
+        return;
+      }
     }
     else
-      *buffer = *str;
+    {
+      size_t size = (size_t)writer->size;
+      char* buffer;
+
+      while ((size_t)writer->len + (size_t)len > size)
+        size *= 2;
+
+      /* len and size are int */
+      if (size > INT_MAX)
+        size = INT_MAX;
+      if ((size_t)writer->len + (size_t)len > size)
+      {
+        writer->error = 1;
+        return;
+      }
+
+      /* keep the old buffer if failed */
+      buffer = (char*)realloc(writer->buffer, size);
+      if (!buffer)
+      {
+        writer->error = 1;
+        return;
+      }
 
-    buffer++;
-    str++;
+      writer->buffer = buffer;
+      writer->size = (int)size;
+    }
   }
-  *buffer = 0;
+
+  memcpy(writer->buffer + writer->len, data, len);
+  writer->len += len;
+}
+
+void iupMatrixExWriterStr(ImatExWriter* writer, const char* str)
+{
+  iupMatrixExWriterData(writer, str, (int)strlen(str));
 }
 
-static void iMatrixExStrCopyNoSepLaTeX(char* buffer, const char* str)
+void iupMatrixExWriterChar(ImatExWriter* writer, char c)
 {
-  while (*str)
+  if (writer->len < writer->size)
   {
-    if (*str=='\n' || *str=='_')
-      *buffer = ' ';
-    else if (*str=='%')
+    writer->buffer[writer->len] = c;
+    writer->len++;
+  }
+  else
+    iupMatrixExWriterData(writer, &c, 1);
+}
+
+char* iupMatrixExWriterGetString(ImatExWriter* writer)
+{
+  /* the terminator is not counted in len */
+  if (writer->error)
+    return NULL;
+  iupMatrixExWriterChar(writer, 0);
+  if (writer->error)
+    return NULL;
+  writer->len--;
+  return writer->buffer;
+}
+
+void iupMatrixExWriterRelease(ImatExWriter* writer)
+{
+  if (writer->file)
+    iMatrixExWriterFlush(writer);
+
+  free(writer->buffer);
+  writer->buffer = NULL;
+  writer->size = 0;
+}
+
+
+/**************************************************************************
+                              Text Formats
+***************************************************************************/
+
+static void iMatrixExWriteTXT(ImatExWriter* writer, const char* str, char sep)
+{
+  if (str)
+  {
+    if (strchr(str, sep))
     {
-      *buffer = '\\'; buffer++;
-      *buffer = '%'; 
+      iupMatrixExWriterChar(writer, '\"');
+      iupMatrixExWriterStr(writer, str);
+      iupMatrixExWriterChar(writer, '\"');
     }
     else
-      *buffer = *str;
+      iupMatrixExWriterStr(writer, str);
+  }
+  else
+    iupMatrixExWriterChar(writer, ' ');
+}
+
+static void iMatrixExWriteCSV(ImatExWriter* writer, const char* str, char sep)
+{
+  /* RFC 4180: fields with separators, quotes or line breaks are enclosed in quotes,
+     and quotes inside them are doubled */
+  const char* s;
+
+  if (!str)
+    return;
+
+  for (s = str; *s; s++)
+  {
+    if (*s == sep || *s == '\"' || *s == '\n' || *s == '\r')
+      break;
+  }
+
+  if (*s == 0)
+  {
+    iupMatrixExWriterData(writer, str, (int)(s - str));
+    return;
+  }
+
+  iupMatrixExWriterChar(writer, '\"');
+
+  for (s = str; *s; s++)
+  {
+    if (*s == '\"')
+    {
+      iupMatrixExWriterData(writer, str, (int)(s - str) + 1);  /* including the quote */
+      iupMatrixExWriterChar(writer, '\"');
+      str = s + 1;
+    }
+  }
+  iupMatrixExWriterData(writer, str, (int)(s - str));
 
-    buffer++;
-    str++;
+  iupMatrixExWriterChar(writer, '\"');
+}
+
+static void iMatrixExWriteHTML(ImatExWriter* writer, const char* str)
+{
+  const char* s;
+
+  for (s = str; *s; s++)
+  {
+    if (*s == '\n')
+    {
+      iupMatrixExWriterData(writer, str, (int)(s - str));
+      iupMatrixExWriterStr(writer, "<BR>");
+      str = s + 1;
+    }
   }
-  *buffer = 0;
+  iupMatrixExWriterData(writer, str, (int)(s - str));
 }
 
-static void iMatrixExCopyTXT(Ihandle *ih, FILE* file, int num_lin, int num_col, int skip_lin, int skip_col)
+static void iMatrixExWriteLaTeX(ImatExWriter* writer, const char* str)
+{
+  const char* s;
+
+  for (s = str; *s; s++)
+  {
+    if (*s == '\n' || *s == '_' || *s == '%')
+    {
+      iupMatrixExWriterData(writer, str, (int)(s - str));
+      if (*s == '%')
+        iupMatrixExWriterStr(writer, "\\%");
+      else
+        iupMatrixExWriterChar(writer, ' ');
+      str = s + 1;
+    }
+  }
+  iupMatrixExWriterData(writer, str, (int)(s - str));
+}
+
+static int iMatrixExCopyTXT(Ihandle *ih, ImatExWriter* writer, const char* vis_lin, const char* vis_col, int num_lin, int num_col, int skip_lin, int skip_col, int csv)
 {
   ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
   int lin, col;
   int add_sep;
   char* str, sep;
+  const char* eol;
 
-  sep = *(iupAttribGetStr(ih, "TEXTSEPARATOR"));
+  if (csv)
+  {
+    str = iupAttribGet(ih, "TEXTSEPARATOR");  /* don't check for the default value */
+    sep = str? *str: ',';
+    eol = "\r\n";
+  }
+  else
+  {
+    sep = *(iupAttribGetStr(ih, "TEXTSEPARATOR"));
+    eol = "\n";
+  }
 
   str = iupAttribGetStr(ih, "COPYCAPTION");
   if (str)
-    fprintf(file,"%s\n",str);
+  {
+    iupMatrixExWriterStr(writer, str);
+    iupMatrixExWriterStr(writer, eol);
+  }
 
   /* Here includes the title cells */
   for (lin = 0; lin <= num_lin; ++lin)
   {
     add_sep = 0;
 
-    if (iupMatrixExIsLineVisible(ih, lin))
+    if (vis_lin[lin])
     {
+      iupStrArenaBegin();  /* cell values of this line are released at once */
+
       for (col = 0; col <= num_col; ++col)
       {
-        if (iupMatrixExIsColumnVisible(ih, col))
+        if (vis_col[col])
         {
           if (add_sep)
-            fprintf(file, "%c", sep);
+            iupMatrixExWriterChar(writer, sep);
 
           str = iupMatrixExGetCellValue(matex_data->ih, lin, col, 1);  /* get displayed value */
-          if (str)
-          {
-            if (strchr(str, sep))
-              fprintf(file, "\"%s\"", str);
-            else
-              fprintf(file, "%s", str);
-          }
+          if (csv)
+            iMatrixExWriteCSV(writer, str, sep);
           else
-            fprintf(file, "%s", " ");
+            iMatrixExWriteTXT(writer, str, sep);
 
           add_sep = 1;
         }
@@ -103,11 +293,18 @@ static void iMatrixExCopyTXT(Ihandle *ih, FILE* file, int num_lin, int num_col,
         if (col == 0) col += skip_col;
       }
 
-      fprintf(file, "%s", "\n");
+      iupMatrixExWriterStr(writer, eol);
+
+      iupStrArenaEnd();
     }
 
-    if (lin == 0) lin += skip_lin;
+    if (lin == 0)
+      lin += skip_lin;
+    else if (!iupMatrixExBusyInc(matex_data))
+      return 0;
   }
+
+  return 1;
 }
 
 static char* iMatrixExGetCellAttrib(Ihandle* ih, const char* attrib, int lin, int col)
@@ -207,7 +404,7 @@ static char* iMatrixExGetCellFormat(Ihandle *ih, int lin, int col, char* format)
   return format;
 }
 
-static void iMatrixExCopyHTML(Ihandle *ih, FILE* file, int num_lin, int num_col, char* buffer, int skip_lin, int skip_col)
+static int iMatrixExCopyHTML(Ihandle *ih, ImatExWriter* writer, const char* vis_lin, const char* vis_col, int num_lin, int num_col, int skip_lin, int skip_col)
 {
   ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
   int lin, col;
@@ -226,54 +423,69 @@ static void iMatrixExCopyHTML(Ihandle *ih, FILE* file, int num_lin, int num_col,
   if (!td) td = "";
   if (!caption) caption = "";
 
-  fprintf(file,"<!-- File automatically generated by IUP -->\n");
-  fprintf(file,"<TABLE%s>\n", table);
+  iupMatrixExWriterStr(writer, "<!-- File automatically generated by IUP -->\n");
+  iupMatrixExWriterStr(writer, "<TABLE");
+  iupMatrixExWriterStr(writer, table);
+  iupMatrixExWriterStr(writer, ">\n");
 
   str = iupAttribGetStr(ih, "COPYCAPTION");
   if (str)
-    fprintf(file,"<CAPTION%s>%s</CAPTION>\n", caption, str);
+  {
+    iupMatrixExWriterStr(writer, "<CAPTION");
+    iupMatrixExWriterStr(writer, caption);
+    iupMatrixExWriterChar(writer, '>');
+    iupMatrixExWriterStr(writer, str);
+    iupMatrixExWriterStr(writer, "</CAPTION>\n");
+  }
 
   /* Here includes the title cells */
   for (lin = 0; lin <= num_lin; ++lin)
   {
-    if (iupMatrixExIsLineVisible(ih, lin))
+    if (vis_lin[lin])
     {
-      fprintf(file,"<TR%s> ", tr);
+      iupStrArenaBegin();  /* cell values and formats of this line are released at once */
+
+      iupMatrixExWriterStr(writer, "<TR");
+      iupMatrixExWriterStr(writer, tr);
+      iupMatrixExWriterStr(writer, "> ");
 
       for (col = 0; col <= num_col; ++col)
       {
-        if (iupMatrixExIsColumnVisible(ih, col))
-        {           
-          if (lin==0||col==0)
-            fprintf(file,"<TH%s%s>", th, add_format? iMatrixExGetCellFormat(ih, lin, col, f): "");
-          else
-            fprintf(file,"<TD%s%s>", td, add_format? iMatrixExGetCellFormat(ih, lin, col, f): "");
+        if (vis_col[col])
+        {
+          int is_title = (lin == 0 || col == 0);
+
+          iupMatrixExWriterStr(writer, is_title? "<TH": "<TD");
+          iupMatrixExWriterStr(writer, is_title? th: td);
+          if (add_format)
+            iupMatrixExWriterStr(writer, iMatrixExGetCellFormat(ih, lin, col, f));
+          iupMatrixExWriterChar(writer, '>');
 
           str = iupMatrixExGetCellValue(matex_data->ih, lin, col, 1);  /* get displayed value */
           if (str)
-          {
-            iMatrixExStrCopyNoSepHTML(buffer, str);
-            fprintf(file, "%s", buffer);
-          }
+            iMatrixExWriteHTML(writer, str);
           else
-            fprintf(file, "%s", " ");
+            iupMatrixExWriterChar(writer, ' ');
 
-          if (lin==0||col==0)
-            fprintf(file,"</TH> ");
-          else
-            fprintf(file,"</TD> ");
+          iupMatrixExWriterStr(writer, is_title? "</TH> ": "</TD> ");
         }
 
         if (col == 0) col += skip_col;
       }
 
-      fprintf(file,"</TR>\n");
+      iupMatrixExWriterStr(writer, "</TR>\n");
+
+      iupStrArenaEnd();
     }
 
-    if (lin == 0) lin += skip_lin;
+    if (lin == 0)
+      lin += skip_lin;
+    else if (!iupMatrixExBusyInc(matex_data))
+      return 0;
   }
 
-  fprintf(file,"</TABLE>\n");
+  iupMatrixExWriterStr(writer, "</TABLE>\n");
+  return 1;
 }
 
 static int iMatrixExIsBoldLine(Ihandle* ih, int lin)
@@ -293,58 +505,59 @@ static int iMatrixExIsBoldLine(Ihandle* ih, int lin)
   return 0;
 }
 
-static void iMatrixExCopyLaTeX(Ihandle *ih, FILE* file, int num_lin, int num_col, char* buffer, int skip_lin, int skip_col)
+static int iMatrixExCopyLaTeX(Ihandle *ih, ImatExWriter* writer, const char* vis_lin, const char* vis_col, int num_lin, int num_col, int skip_lin, int skip_col)
 {
   ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
   int lin, col;
   int add_sep;
   char* str;
 
-  fprintf(file,"%% File automatically generated by IUP\n");
+  iupMatrixExWriterStr(writer, "% File automatically generated by IUP\n");
 
-  fprintf(file,"\\begin{table}\n");
-  fprintf(file,"\\begin{center}\n");
-  fprintf(file,"\\begin{tabular}{");
+  iupMatrixExWriterStr(writer, "\\begin{table}\n");
+  iupMatrixExWriterStr(writer, "\\begin{center}\n");
+  iupMatrixExWriterStr(writer, "\\begin{tabular}{");
 
   for (col = 0; col <= num_col; ++col)
   {
-    if (iupMatrixExIsColumnVisible(ih, col))
-      fprintf(file,"|r");
+    if (vis_col[col])
+      iupMatrixExWriterStr(writer, "|r");
 
     if (col == 0) col += skip_col;
   }
-  fprintf(file,"|} \\hline\n");
+  iupMatrixExWriterStr(writer, "|} \\hline\n");
 
   /* Here includes the title cells */
   for (lin = 0; lin <= num_lin; ++lin)
   {
     add_sep = 0;
 
-    if (iupMatrixExIsLineVisible(ih, lin))
+    if (vis_lin[lin])
     {
-      int is_bold = iMatrixExIsBoldLine(ih, lin);
+      int is_bold;
+
+      iupStrArenaBegin();  /* cell values of this line are released at once */
+
+      is_bold = iMatrixExIsBoldLine(ih, lin);
 
       for (col = 0; col <= num_col; ++col)
       {
-        if (iupMatrixExIsColumnVisible(ih, col))
-        {    
+        if (vis_col[col])
+        {
           if (add_sep)
-            fprintf(file,"& ");
+            iupMatrixExWriterStr(writer, "& ");
 
           if (is_bold)
-            fprintf(file,"\\bf{");
+            iupMatrixExWriterStr(writer, "\\bf{");
 
           str = iupMatrixExGetCellValue(matex_data->ih, lin, col, 1);  /* get displayed value */
           if (str)
-          {
-            iMatrixExStrCopyNoSepLaTeX(buffer, str);
-            fprintf(file, "%s", buffer);
-          }
+            iMatrixExWriteLaTeX(writer, str);
           else
-            fprintf(file, "%s", " ");
+            iupMatrixExWriterChar(writer, ' ');
 
           if (is_bold)
-            fprintf(file,"}");
+            iupMatrixExWriterChar(writer, '}');
 
           add_sep = 1;
         }
@@ -352,29 +565,363 @@ static void iMatrixExCopyLaTeX(Ihandle *ih, FILE* file, int num_lin, int num_col
         if (col == 0) col += skip_col;
       }
 
-      fprintf(file,"\\\\ \\hline\n");
+      iupMatrixExWriterStr(writer, "\\\\ \\hline\n");
+
+      iupStrArenaEnd();
     }
 
-    if (lin == 0) lin += skip_lin;
+    if (lin == 0)
+      lin += skip_lin;
+    else if (!iupMatrixExBusyInc(matex_data))
+      return 0;
   }
 
-  fprintf(file,"\\end{tabular}\n");
+  iupMatrixExWriterStr(writer, "\\end{tabular}\n");
 
   str = iupAttribGetStr(ih, "COPYCAPTION");
-  if (str) fprintf(file,"\\caption{%s.}\n", str);
+  if (str)
+  {
+    iupMatrixExWriterStr(writer, "\\caption{");
+    iupMatrixExWriterStr(writer, str);
+    iupMatrixExWriterStr(writer, ".}\n");
+  }
 
   str = iupAttribGetStr(ih, "LATEXLABEL");
-  if (str) fprintf(file,"\\label{tab:%s}\n", str);
+  if (str)
+  {
+    iupMatrixExWriterStr(writer, "\\label{tab:");
+    iupMatrixExWriterStr(writer, str);
+    iupMatrixExWriterStr(writer, "}\n");
+  }
+
+  iupMatrixExWriterStr(writer, "\\end{center}\n");
+  iupMatrixExWriterStr(writer, "\\end{table}\n");
+  return 1;
+}
+
+
+/**************************************************************************
+                              Binary Format
+***************************************************************************/
+
+/* Header:  "IUPMATEX", byte order mark, version, number of lines, number of columns
+            (all integers are 32 bits unsigned in the byte order of the writer).
+   Then the cells column by column, each cell is a type byte followed by:
+     IMATEX_BIN_EMPTY  - nothing
+     IMATEX_BIN_TEXT   - the length and the characters, without the terminator
+     IMATEX_BIN_NUMBER - a double, the internal value of a numeric column with NUMERICSTORE.
+   Titles are not included. Values are the internal values, not the displayed values. */
+
+#define IMATEX_BIN_SIGNATURE "IUPMATEX"
+#define IMATEX_BIN_BOM     0x01020304
+#define IMATEX_BIN_VERSION 1
+#define IMATEX_BIN_HEADER  24
+
+enum { IMATEX_BIN_EMPTY, IMATEX_BIN_TEXT, IMATEX_BIN_NUMBER };
 
-  fprintf(file,"\\end{center}\n");
-  fprintf(file,"\\end{table}\n");
+static void iMatrixExWriteUInt(ImatExWriter* writer, unsigned int value)
+{
+  iupMatrixExWriterData(writer, (char*)&value, 4);
 }
 
+static unsigned int iMatrixExReadUInt(const char* data, int swap)
+{
+  unsigned char b[4];
+  unsigned int value;
+
+  if (swap)
+  {
+    b[0] = data[3]; b[1] = data[2]; b[2] = data[1]; b[3] = data[0];
+  }
+  else
+    memcpy(b, data, 4);
+
+  memcpy(&value, b, 4);
+  return value;
+}
+
+static double iMatrixExReadDouble(const char* data, int swap)
+{
+  unsigned char b[8];
+  double value;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    b[i] = data[swap? 7 - i: i];
+
+  memcpy(&value, b, 8);
+  return value;
+}
+
+static int iMatrixExCopyBinary(Ihandle *ih, ImatExWriter* writer, const char* vis_lin, const char* vis_col, int num_lin, int num_col, int skip_lin, int skip_col)
+{
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  int lin, col, count_lin = 0, count_col = 0;
+  unsigned char type;
+
+  for (lin = 1 + skip_lin; lin <= num_lin; ++lin)
+    if (vis_lin[lin]) count_lin++;
+  for (col = 1 + skip_col; col <= num_col; ++col)
+    if (vis_col[col]) count_col++;
+
+  iupMatrixExWriterStr(writer, IMATEX_BIN_SIGNATURE);
+  iMatrixExWriteUInt(writer, IMATEX_BIN_BOM);
+  iMatrixExWriteUInt(writer, IMATEX_BIN_VERSION);
+  iMatrixExWriteUInt(writer, (unsigned int)count_lin);
+  iMatrixExWriteUInt(writer, (unsigned int)count_col);
+
+  /* column by column, so each column is contiguous in the file */
+  for (col = 1 + skip_col; col <= num_col; ++col)
+  {
+    if (!vis_col[col])
+      continue;
+
+    iupStrArenaBegin();
+
+    for (lin = 1 + skip_lin; lin <= num_lin; ++lin)
+    {
+      double number;
+
+      if (!vis_lin[lin])
+        continue;
+
+      if (iupMatrixExGetCellNumber(matex_data->ih, lin, col, &number))
+      {
+        type = IMATEX_BIN_NUMBER;
+        iupMatrixExWriterChar(writer, (char)type);
+        iupMatrixExWriterData(writer, (char*)&number, 8);
+      }
+      else
+      {
+        char* str = iupMatrixExGetCellValue(matex_data->ih, lin, col, 0);  /* get internal value */
+        if (str)
+        {
+          unsigned int len = (unsigned int)strlen(str);
+          type = IMATEX_BIN_TEXT;
+          iupMatrixExWriterChar(writer, (char)type);
+          iMatrixExWriteUInt(writer, len);
+          iupMatrixExWriterData(writer, str, (int)len);
+        }
+        else
+        {
+          type = IMATEX_BIN_EMPTY;
+          iupMatrixExWriterChar(writer, (char)type);
+        }
+      }
+    }
+
+    iupStrArenaEnd();
+
+    if (!iupMatrixExBusyInc(matex_data))
+      return 0;
+  }
+
+  return 1;
+}
+
+int iupMatrixExIsBinary(const char* data, long size)
+{
+  return size >= IMATEX_BIN_HEADER && memcmp(data, IMATEX_BIN_SIGNATURE, 8) == 0;
+}
+
+static int iMatrixExBinaryCheck(const char* data, long size, int *swap, int *num_lin, int *num_col)
+{
+  const char* end = data + size;
+  unsigned int count, i, len;
+
+  if (iMatrixExReadUInt(data + 8, 0) == IMATEX_BIN_BOM)
+    *swap = 0;
+  else if (iMatrixExReadUInt(data + 8, 1) == IMATEX_BIN_BOM)
+    *swap = 1;
+  else
+    return 0;
+
+  if (iMatrixExReadUInt(data + 12, *swap) != IMATEX_BIN_VERSION)
+    return 0;
+
+  *num_lin = (int)iMatrixExReadUInt(data + 16, *swap);
+  *num_col = (int)iMatrixExReadUInt(data + 20, *swap);
+  if (*num_lin <= 0 || *num_col <= 0 || *num_lin > INT_MAX / *num_col)
+    return 0;
+
+  /* validate all the cells before changing the matrix */
+  count = (unsigned int)(*num_lin) * (unsigned int)(*num_col);
+  data += IMATEX_BIN_HEADER;
+
+  for (i = 0; i < count; i++)
+  {
+    if (data >= end)
+      return 0;
+
+    switch (*data)
+    {
+    case IMATEX_BIN_EMPTY:
+      data++;
+      break;
+    case IMATEX_BIN_TEXT:
+      if (end - data < 5)
+        return 0;
+      len = iMatrixExReadUInt(data + 1, *swap);
+      if ((unsigned long)(end - data - 5) < (unsigned long)len)
+        return 0;
+      data += 5 + len;
+      break;
+    case IMATEX_BIN_NUMBER:
+      if (end - data < 9)
+        return 0;
+      data += 9;
+      break;
+    default:
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+void iupMatrixExPasteBinary(Ihandle* ih, const char* data, long size, int lin, int col)
+{
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  int swap, data_num_lin, data_num_col, num_lin, num_col, l, c;
+  int value_max_size = 0, *lin_map, error = 0;
+  char* value = NULL, *visible;
+
+  /* reset error state */
+  iupAttribSet(ih, "LASTERROR", NULL);
+
+  if (!iMatrixExBinaryCheck(data, size, &swap, &data_num_lin, &data_num_col))
+  {
+    iupAttribSet(ih, "LASTERROR", "IUP_ERRORINVALIDDATA");
+    return;
+  }
+
+  if (!iupMatrixExPasteCheckSize(ih, lin, col, data_num_lin, data_num_col))
+    return;
+
+  num_lin = IupGetInt(ih, "NUMLIN");
+  num_col = IupGetInt(ih, "NUMCOL");
+
+  /* hidden lines are skipped, as in the text paste */
+  lin_map = (int*)malloc(data_num_lin * sizeof(int));
+  visible = iupMatrixExGetVisibleLines(ih, num_lin);
+  if (!lin_map || !visible)
+  {
+    if (lin_map) free(lin_map);
+    if (visible) free(visible);
+    iupAttribSet(ih, "LASTERROR", "IUP_ERRORMEMORY");
+    return;
+  }
+
+  for (l = 0; l < data_num_lin; l++)
+  {
+    while (lin <= num_lin && !visible[lin])
+      lin++;
+
+    if (lin <= num_lin)
+    {
+      lin_map[l] = lin;
+      lin++;
+    }
+    else
+      lin_map[l] = -1;
+  }
+  free(visible);
+
+  visible = iupMatrixExGetVisibleColumns(ih, num_col);
+  if (!visible)
+  {
+    free(lin_map);
+    iupAttribSet(ih, "LASTERROR", "IUP_ERRORMEMORY");
+    return;
+  }
+
+  iupMatrixExBusyStart(matex_data, data_num_col, "PASTEFILE");
+
+  data += IMATEX_BIN_HEADER;
+
+  for (c = 0; c < data_num_col; c++)
+  {
+    while (col <= num_col && !visible[col])
+      col++;
+
+    for (l = 0; l < data_num_lin && !error; l++)
+    {
+      int set = (col <= num_col && lin_map[l] != -1);
+
+      if (*data == IMATEX_BIN_TEXT)
+      {
+        unsigned int len = iMatrixExReadUInt(data + 1, swap);
+
+        if (set)
+        {
+          if (value_max_size < (int)len + 1)
+          {
+            char* new_value = (char*)realloc(value, (int)len + 1);
+            if (!new_value)
+            {
+              iupAttribSet(ih, "LASTERROR", "IUP_ERRORMEMORY");
+              error = 1;
+              break;
+            }
+            value = new_value;
+            value_max_size = (int)len + 1;
+          }
+          memcpy(value, data + 5, len);
+          value[len] = 0;
+          iupMatrixExSetCellValue(matex_data->ih, lin_map[l], col, value);
+        }
+
+        data += 5 + len;
+      }
+      else if (*data == IMATEX_BIN_NUMBER)
+      {
+        if (set)
+          iupMatrixExSetCellNumber(matex_data->ih, lin_map[l], col, iMatrixExReadDouble(data + 1, swap));
+
+        data += 9;
+      }
+      else
+      {
+        if (set)
+          iupMatrixExSetCellValue(matex_data->ih, lin_map[l], col, NULL);
+
+        data++;
+      }
+    }
+
+    if (error)
+      break;
+
+    col++;
+
+    if (!iupMatrixExBusyInc(matex_data))
+      break;
+  }
+
+  /* when out of memory the cells already set are kept */
+  if (c == data_num_col || error)
+  {
+    iupMatrixExBusyEnd(matex_data);
+    iupBaseCallValueChangedCb(matex_data->ih);
+  }
+
+  free(visible);
+  free(lin_map);
+  if (value)
+    free(value);
+}
+
+
+/**************************************************************************
+                              Export
+***************************************************************************/
+
 static int iMatrixExSetCopyFileAttrib(Ihandle *ih, const char* value)
 {
-  int num_lin, num_col, skip_lin, skip_col;
-  char buffer[1024];
-  char* format;
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  int num_lin, num_col, skip_lin, skip_col, ret;
+  char *format, *vis_lin, *vis_col;
+  ImatExWriter writer;
 
   FILE *file = fopen(value, "wb");
   if (!file)
@@ -392,15 +939,56 @@ static int iMatrixExSetCopyFileAttrib(Ihandle *ih, const char* value)
   skip_lin = iupAttribGetInt(ih, "SKIPLINES");
   skip_col = iupAttribGetInt(ih, "SKIPCOLUMNS");
 
+  vis_lin = iupMatrixExGetVisibleLines(ih, num_lin);
+  vis_col = iupMatrixExGetVisibleColumns(ih, num_col);
+  if (!vis_lin || !vis_col)
+  {
+    if (vis_lin) free(vis_lin);
+    if (vis_col) free(vis_col);
+    fclose(file);
+    remove(value);
+    iupAttribSet(ih, "LASTERROR", "IUP_ERRORMEMORY");
+    return 0;
+  }
+
+  iupMatrixExWriterInit(&writer, file);
+
   format = iupAttribGetStr(ih, "FILEFORMAT");
+
+  if (iupStrEqualNoCase(format, "BIN"))
+    iupMatrixExBusyStartReadOnly(matex_data, num_col - skip_col, "COPYFILE");
+  else
+    iupMatrixExBusyStartReadOnly(matex_data, num_lin - skip_lin, "COPYFILE");
+
   if (iupStrEqualNoCase(format, "HTML"))
-    iMatrixExCopyHTML(ih, file, num_lin, num_col, buffer, skip_lin, skip_col);
+    ret = iMatrixExCopyHTML(ih, &writer, vis_lin, vis_col, num_lin, num_col, skip_lin, skip_col);
   else if (iupStrEqualNoCase(format, "LaTeX"))
-    iMatrixExCopyLaTeX(ih, file, num_lin, num_col, buffer, skip_lin, skip_col);
+    ret = iMatrixExCopyLaTeX(ih, &writer, vis_lin, vis_col, num_lin, num_col, skip_lin, skip_col);
+  else if (iupStrEqualNoCase(format, "BIN"))
+    ret = iMatrixExCopyBinary(ih, &writer, vis_lin, vis_col, num_lin, num_col, skip_lin, skip_col);
   else
-    iMatrixExCopyTXT(ih, file, num_lin, num_col, skip_lin, skip_col);
+    ret = iMatrixExCopyTXT(ih, &writer, vis_lin, vis_col, num_lin, num_col, skip_lin, skip_col, iupStrEqualNoCase(format, "CSV"));
+
+  if (ret)
+    iupMatrixExBusyEnd(matex_data);
+
+  iupMatrixExWriterRelease(&writer);
+
+  free(vis_lin);
+  free(vis_col);
+
+  if (fclose(file) != 0)
+    writer.error = 1;
+
+  if (!ret || writer.error)
+  {
+    /* canceled or failed, do not leave a partial file */
+    remove(value);
+
+    if (writer.error)
+      iupAttribSet(ih, "LASTERROR", "IUP_ERRORFILESAVE");
+  }
 
-  fclose(file);
   return 0;
 }
 
@@ -16,6 +16,7 @@
 #include "iup_object.h"
 #include "iup_attrib.h"
 #include "iup_str.h"
+#include "iup_mask.h"
 #include "iup_matrixex.h"
 
 
@@ -210,37 +211,161 @@ void iupMatrixExFindShowDialog(ImatExData* matex_data)
     IupShow(matex_data->find_dlg);
 }
 
-static int iMatrixMatch(Ihandle *ih, const char* findvalue, int lin, int col, int matchcase, int matchwholecell, int utf8)
+/**************************************************************************/
+/*  Match                                                                 */
+/**************************************************************************/
+
+enum { IMATEX_FIND_TEXT, IMATEX_FIND_WILDCARD, IMATEX_FIND_MASK };
+
+typedef struct _ImatExFindMatch
+{
+  char* find_value;
+  char* pattern;   /* WILDCARD pattern, with "*" around when not matching the whole cell */
+  Imask* mask;
+  int matchcase, matchwholecell, utf8, mode;
+} ImatExFindMatch;
+
+static int iMatrixExFindMatchInit(Ihandle* ih, ImatExFindMatch* match, const char* value)
+{
+  char* mode = iupAttribGetStr(ih, "FINDMATCHMODE");
+
+  memset(match, 0, sizeof(ImatExFindMatch));
+  match->utf8 = IupGetInt(NULL, "UTF8MODE");
+  match->matchcase = iupAttribGetInt(ih, "FINDMATCHCASE");
+  match->matchwholecell = iupAttribGetInt(ih, "FINDMATCHWHOLECELL");
+  match->find_value = iupStrDup(value);
+
+  if (iupStrEqualNoCase(mode, "WILDCARD"))
+  {
+    int len = (int)strlen(value);
+    match->mode = IMATEX_FIND_WILDCARD;
+    match->pattern = (char*)malloc(len + 3);
+    if (match->matchwholecell)
+      strcpy(match->pattern, value);
+    else
+    {
+      match->pattern[0] = '*';
+      memcpy(match->pattern + 1, value, len);
+      match->pattern[len + 1] = '*';
+      match->pattern[len + 2] = 0;
+    }
+  }
+  else if (iupStrEqualNoCase(mode, "MASK"))
+  {
+    match->mode = IMATEX_FIND_MASK;
+    match->mask = iupMaskCreate(value);
+    if (!match->mask)
+    {
+      free(match->find_value);
+      return 0;
+    }
+    iupMaskSetCaseI(match->mask, !match->matchcase);
+  }
+  else
+    match->mode = IMATEX_FIND_TEXT;
+
+  return 1;
+}
+
+static void iMatrixExFindMatchRelease(ImatExFindMatch* match)
+{
+  free(match->find_value);
+  if (match->pattern) free(match->pattern);
+  if (match->mask) iupMaskDestroy(match->mask);
+}
+
+static const char* iMatrixExFindNextChar(const char* str, int utf8)
+{
+  str++;
+  if (utf8)
+  {
+    /* skip the continuation bytes */
+    while ((*str & 0xC0) == 0x80)
+      str++;
+  }
+  return str;
+}
+
+static int iMatrixExFindCharEqual(char c1, char c2, int matchcase)
+{
+  if (matchcase)
+    return c1 == c2;
+  else
+    return iup_tolower(c1) == iup_tolower(c2);
+}
+
+static int iMatrixExFindWildcard(const char* str, const char* pattern, int matchcase, int utf8)
+{
+  /* "*" matches any sequence and "?" matches a single character */
+  const char *star_pattern = NULL, *star_str = NULL;
+
+  while (*str)
+  {
+    if (*pattern == '*')
+    {
+      star_pattern = ++pattern;
+      star_str = str;
+    }
+    else if (*pattern == '?')
+    {
+      pattern++;
+      str = iMatrixExFindNextChar(str, utf8);
+    }
+    else if (*pattern && iMatrixExFindCharEqual(*pattern, *str, matchcase))
+    {
+      pattern++;
+      str++;
+    }
+    else if (star_pattern)
+    {
+      /* let the last "*" consume one more character */
+      pattern = star_pattern;
+      star_str = iMatrixExFindNextChar(star_str, utf8);
+      str = star_str;
+    }
+    else
+      return 0;
+  }
+
+  while (*pattern == '*')
+    pattern++;
+
+  return *pattern == 0;
+}
+
+static int iMatrixExFindMatchValue(ImatExFindMatch* match, const char* value)
 {
-  char* value = iupMatrixExGetCellValue(ih, lin, col, 1);  /* get displayed value */
   if (!value || value[0] == 0)
     return 0;
 
-  if (matchwholecell)
-    return iupStrCompareEqual(value, findvalue, matchcase, utf8, 0);
+  if (match->mode == IMATEX_FIND_WILDCARD)
+    return iMatrixExFindWildcard(value, match->pattern, match->matchcase, match->utf8);
+  else if (match->mode == IMATEX_FIND_MASK)
+    return iupMaskCheck(match->mask, value) == 1;  /* always the whole cell */
+  else if (match->matchwholecell)
+    return iupStrCompareEqual(value, match->find_value, match->matchcase, match->utf8, 0);
   else
-    return iupStrCompareFind(value, findvalue, matchcase, utf8);  /* search only for the first occurrence */
+    return iupStrCompareFind(value, match->find_value, match->matchcase, match->utf8);  /* search only for the first occurrence */
+}
+
+static int iMatrixMatch(Ihandle *ih, ImatExFindMatch* match, int lin, int col)
+{
+  char* value = iupMatrixExGetCellValue(ih, lin, col, 1);  /* get displayed value */
+  return iMatrixExFindMatchValue(match, value);
 }
 
-static int iMatrixExSetFind(Ihandle *ih, const char* value, int inc, int flip, int matchcase, int matchwholecell, int *lin, int *col, int search_cur_cell)
+static int iMatrixExSetFind(Ihandle *ih, ImatExFindMatch* match, int inc, int flip, int *lin, int *col, int search_cur_cell)
 {
-  int utf8 = IupGetInt(NULL, "UTF8MODE");
   int num_lin = IupGetInt(ih, "NUMLIN");
   int num_col = IupGetInt(ih, "NUMCOL");
   int count = (num_lin+1)*(num_col+1);
   int pos, start_pos;
-  char* find_value;
-
-  find_value = iupStrDup(value);
 
   if (search_cur_cell)  /* search the current cell */
   {
     /* the FOCUSCELL is always visible and not a title */
-    if (iMatrixMatch(ih, find_value, *lin, *col, matchcase, matchwholecell, utf8))
-    {
-      free(find_value);
+    if (iMatrixMatch(ih, match, *lin, *col))
       return 1;
-    }
   }
 
   if (flip)
@@ -274,31 +399,27 @@ static int iMatrixExSetFind(Ihandle *ih, const char* value, int inc, int flip, i
     {
       if (!search_cur_cell)
       {
-        if (iMatrixMatch(ih, find_value, *lin, *col, matchcase, matchwholecell, utf8))
-        {
-          free(find_value);
+        if (iMatrixMatch(ih, match, *lin, *col))
           return 1;
-        }
       }
 
-      free(find_value);
       return 0;
     }
 
     if (!iupMatrixExIsLineVisible(ih, *lin) || !iupMatrixExIsColumnVisible(ih, *col))
       continue;
 
-  } while (!iMatrixMatch(ih, find_value, *lin, *col, matchcase, matchwholecell, utf8));
+  } while (!iMatrixMatch(ih, match, *lin, *col));
 
-  free(find_value);
   return 1;
 }
 
 static int iMatrixExSetFindAttrib(Ihandle *ih, const char* value)
 {
   int lin=1, col=1, search_cur_cell = 0;
-  int inc, flip, matchcase, matchwholecell;
+  int inc, flip, found;
   char* direction;
+  ImatExFindMatch match;
 
   if (!value || value[0]==0)
     return 0;
@@ -326,8 +447,6 @@ static int iMatrixExSetFindAttrib(Ihandle *ih, const char* value)
     flip = 0;
     inc = +1;
   }
-  matchcase = iupAttribGetInt(ih, "FINDMATCHCASE");
-  matchwholecell = iupAttribGetInt(ih, "FINDMATCHWHOLECELL");
 
   {
     int last_lin=0, last_col=0;
@@ -336,7 +455,14 @@ static int iMatrixExSetFindAttrib(Ihandle *ih, const char* value)
       search_cur_cell = 1;  /* search in the current cell */
   }
 
-  if (iMatrixExSetFind(ih, value, inc, flip, matchcase, matchwholecell, &lin, &col, search_cur_cell))
+  found = 0;
+  if (iMatrixExFindMatchInit(ih, &match, value))
+  {
+    found = iMatrixExSetFind(ih, &match, inc, flip, &lin, &col, search_cur_cell);
+    iMatrixExFindMatchRelease(&match);
+  }
+
+  if (found)
   {
     IupSetfAttribute(ih,"FOCUSCELL", "%d:%d", lin, col);
     IupSetfAttribute(ih,"SHOW", "%d:%d", lin, col);
@@ -352,6 +478,477 @@ static int iMatrixExSetFindAttrib(Ihandle *ih, const char* value)
   return 1;
 }
 
+
+/**************************************************************************/
+/*  Index                                                                 */
+/**************************************************************************/
+
+/* Each indexed column has an inverted index of the sequences of 3 bytes
+   (trigrams) of the displayed values. Letters are folded to lower case 
+   and all non ASCII bytes are folded to a single code, so the index 
+   returns a superset of the lines that can match, that are then checked
+   with the actual comparison. Changed lines are just recorded and checked
+   in all searches, until there are too many and the index is rebuilt. */
+
+#define IMATEX_FIND_HASH 4096   /* must be a power of 2 */
+
+typedef struct _ImatExFindPostings
+{
+  int* lines;   /* displayed lines, in ascending order */
+  int count, max;
+} ImatExFindPostings;
+
+struct _ImatExFindIndex
+{
+  int enabled;
+  int built;
+  int num_lin;                    /* number of lines when built */
+  ImatExFindPostings* postings;   /* IMATEX_FIND_HASH lists */
+  int* changed_lines;             /* lines changed after built */
+  int changed_count, changed_max;
+};
+
+static unsigned char iMatrixExFindFold(char c)
+{
+  if ((unsigned char)c >= 0x80)
+    return 0x80;
+  return (unsigned char)iup_tolower(c);
+}
+
+static int iMatrixExFindHash(const char* s)
+{
+  return ((iMatrixExFindFold(s[0]) * 31 + iMatrixExFindFold(s[1])) * 31 + iMatrixExFindFold(s[2])) & (IMATEX_FIND_HASH - 1);
+}
+
+static int iMatrixExFindAddLine(int* *lines, int *count, int *max, int lin)
+{
+  if (*count == *max)
+  {
+    int new_max = *max ? 2 * (*max) : 8;
+    int* new_lines = (int*)realloc(*lines, new_max * sizeof(int));
+    if (!new_lines)
+      return 0;
+    *lines = new_lines;
+    *max = new_max;
+  }
+  (*lines)[*count] = lin;
+  (*count)++;
+  return 1;
+}
+
+static void iMatrixExFindIndexClear(ImatExFindIndex* index)
+{
+  if (index->postings)
+  {
+    int h;
+    for (h = 0; h < IMATEX_FIND_HASH; h++)
+    {
+      if (index->postings[h].lines)
+        free(index->postings[h].lines);
+    }
+    free(index->postings);
+    index->postings = NULL;
+  }
+
+  if (index->changed_lines)
+  {
+    free(index->changed_lines);
+    index->changed_lines = NULL;
+  }
+  index->changed_count = 0;
+  index->changed_max = 0;
+  index->built = 0;
+}
+
+static int iMatrixExFindIndexBuild(Ihandle* ih, ImatExFindIndex* index, int col, int num_lin)
+{
+  int lin;
+
+  iMatrixExFindIndexClear(index);
+  index->postings = (ImatExFindPostings*)calloc(IMATEX_FIND_HASH, sizeof(ImatExFindPostings));
+  if (!index->postings)
+    return 0;
+  index->num_lin = num_lin;
+
+  for (lin = 1; lin <= num_lin; lin++)
+  {
+    char* value = iupMatrixExGetCellValue(ih, lin, col, 1);
+    int i, len;
+
+    if (!value)
+      continue;
+
+    len = (int)strlen(value);
+    for (i = 0; i + 3 <= len; i++)
+    {
+      ImatExFindPostings* postings = index->postings + iMatrixExFindHash(value + i);
+      if (postings->count == 0 || postings->lines[postings->count - 1] != lin)
+      {
+        if (!iMatrixExFindAddLine(&(postings->lines), &(postings->count), &(postings->max), lin))
+        {
+          iMatrixExFindIndexClear(index);
+          return 0;
+        }
+      }
+    }
+  }
+
+  index->built = 1;
+  return 1;
+}
+
+static int iMatrixExFindCompareInt(const void* elem1, const void* elem2)
+{
+  int i1 = *((const int*)elem1);
+  int i2 = *((const int*)elem2);
+  return (i1 > i2) - (i1 < i2);
+}
+
+static int iMatrixExFindQueryHashes(ImatExFindMatch* match, int* hashes)
+{
+  /* the trigrams that all the matching values must contain, 
+     only sequences of ASCII characters to avoid multibyte differences */
+  const char* s = match->find_value;
+  int count = 0;
+
+  if (match->mode == IMATEX_FIND_MASK)
+    return 0;
+
+  for (; s[0] && s[1] && s[2]; s++)
+  {
+    int h, i, found = 0;
+
+    if ((unsigned char)s[0] >= 0x80 || (unsigned char)s[1] >= 0x80 || (unsigned char)s[2] >= 0x80)
+      continue;
+    if (match->mode == IMATEX_FIND_WILDCARD &&
+        (s[0] == '*' || s[0] == '?' || s[1] == '*' || s[1] == '?' || s[2] == '*' || s[2] == '?'))
+      continue;
+
+    h = iMatrixExFindHash(s);
+    for (i = 0; i < count; i++)
+    {
+      if (hashes[i] == h)
+        found = 1;
+    }
+    if (!found && count < 16)
+      hashes[count++] = h;
+  }
+
+  return count;
+}
+
+static int* iMatrixExFindIndexCandidates(ImatExFindIndex* index, int* hashes, int hash_count, int *candidate_count)
+{
+  /* intersection of the postings of all the trigrams, plus the changed lines */
+  ImatExFindPostings* postings = index->postings;
+  int i, h, shortest = 0, count;
+  int* candidates;
+
+  for (h = 1; h < hash_count; h++)
+  {
+    if (postings[hashes[h]].count < postings[hashes[shortest]].count)
+      shortest = h;
+  }
+
+  count = postings[hashes[shortest]].count;
+  candidates = (int*)malloc((count + index->changed_count + 1) * sizeof(int));
+  if (!candidates)
+    return NULL;
+  if (count)
+    memcpy(candidates, postings[hashes[shortest]].lines, count * sizeof(int));
+
+  for (h = 0; h < hash_count && count > 0; h++)
+  {
+    ImatExFindPostings* other = postings + hashes[h];
+    int j = 0, new_count = 0;
+
+    if (h == shortest)
+      continue;
+
+    for (i = 0; i < count; i++)
+    {
+      while (j < other->count && other->lines[j] < candidates[i])
+        j++;
+      if (j == other->count)
+        break;
+      if (other->lines[j] == candidates[i])
+        candidates[new_count++] = candidates[i];
+    }
+    count = new_count;
+  }
+
+  if (index->changed_count)
+  {
+    /* merge the changed lines, keeping the ascending order without duplicates */
+    int k, n;
+    qsort(index->changed_lines, index->changed_count, sizeof(int), iMatrixExFindCompareInt);
+    for (k = 0, n = 0; k < index->changed_count; k++)
+    {
+      if (n == 0 || index->changed_lines[n - 1] != index->changed_lines[k])
+        index->changed_lines[n++] = index->changed_lines[k];
+    }
+    index->changed_count = n;
+
+    memcpy(candidates + count, index->changed_lines, n * sizeof(int));
+    count += n;
+    qsort(candidates, count, sizeof(int), iMatrixExFindCompareInt);
+
+    for (k = 0, n = 0; k < count; k++)
+    {
+      if (n == 0 || candidates[n - 1] != candidates[k])
+        candidates[n++] = candidates[k];
+    }
+    count = n;
+  }
+
+  *candidate_count = count;
+  return candidates;
+}
+
+static ImatExFindIndex* iMatrixExFindGetIndex(ImatExData* matex_data, int col)
+{
+  if (col < 1 || col >= matex_data->find_index_count || !matex_data->find_index[col].enabled)
+    return NULL;
+  return matex_data->find_index + col;
+}
+
+static int iMatrixExSetFindIndexAttrib(Ihandle* ih, int col, const char* value)
+{
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  int enabled = iupStrBoolean(value);
+  int c, any = 0;
+
+  if (col < 1)
+    return 0;
+
+  if (col >= matex_data->find_index_count)
+  {
+    ImatExFindIndex* find_index;
+
+    if (!enabled)
+      return 0;
+
+    find_index = (ImatExFindIndex*)realloc(matex_data->find_index, (col + 1) * sizeof(ImatExFindIndex));
+    if (!find_index)
+      return 0;
+
+    matex_data->find_index = find_index;
+    memset(matex_data->find_index + matex_data->find_index_count, 0, (col + 1 - matex_data->find_index_count) * sizeof(ImatExFindIndex));
+    matex_data->find_index_count = col + 1;
+  }
+
+  /* built only at the next FINDALL */
+  iMatrixExFindIndexClear(matex_data->find_index + col);
+  matex_data->find_index[col].enabled = enabled;
+
+  for (c = 1; c < matex_data->find_index_count; c++)
+  {
+    if (matex_data->find_index[c].enabled)
+      any = 1;
+  }
+  iupAttribSetClassObject(ih, "FINDINDEXNOTIFY", any ? "Yes" : "No");
+
+  return 0;
+}
+
+static char* iMatrixExGetFindIndexAttrib(Ihandle* ih, int col)
+{
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  return iupStrReturnBoolean(iMatrixExFindGetIndex(matex_data, col) != NULL);
+}
+
+static int iMatrixExSetFindIndexCellAttrib(Ihandle* ih, int lin, int col, const char* value)
+{
+  /* called by the matrix when a cell value changes, lin is the displayed line */
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  ImatExFindIndex* index = iMatrixExFindGetIndex(matex_data, col);
+
+  if (index && index->built && lin > 0)
+  {
+    /* after that a rebuild is faster */
+    if (index->changed_count > index->num_lin / 8 + 16 ||
+        !iMatrixExFindAddLine(&(index->changed_lines), &(index->changed_count), &(index->changed_max), lin))
+      iMatrixExFindIndexClear(index);
+  }
+
+  (void)value;
+  return 0;
+}
+
+static int iMatrixExSetFindIndexClearAttrib(Ihandle* ih, const char* value)
+{
+  /* called by the matrix when lines or columns are added or removed, or when the lines are sorted */
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  int col;
+
+  for (col = 1; col < matex_data->find_index_count; col++)
+    iMatrixExFindIndexClear(matex_data->find_index + col);
+
+  (void)value;
+  return 0;
+}
+
+void iupMatrixExFindRelease(ImatExData* matex_data)
+{
+  int col;
+
+  for (col = 1; col < matex_data->find_index_count; col++)
+    iMatrixExFindIndexClear(matex_data->find_index + col);
+
+  if (matex_data->find_index)
+  {
+    free(matex_data->find_index);
+    matex_data->find_index = NULL;
+    matex_data->find_index_count = 0;
+  }
+
+  if (matex_data->find_results)
+  {
+    iupArrayDestroy(matex_data->find_results);
+    matex_data->find_results = NULL;
+  }
+}
+
+
+/**************************************************************************/
+/*  Find All                                                              */
+/**************************************************************************/
+
+typedef struct _ImatExFindResult
+{
+  int lin, col;
+} ImatExFindResult;
+
+static int iMatrixExFindCompareResult(const void* elem1, const void* elem2)
+{
+  const ImatExFindResult* r1 = (const ImatExFindResult*)elem1;
+  const ImatExFindResult* r2 = (const ImatExFindResult*)elem2;
+  if (r1->lin != r2->lin)
+    return (r1->lin > r2->lin) - (r1->lin < r2->lin);
+  return (r1->col > r2->col) - (r1->col < r2->col);
+}
+
+static void iMatrixExFindReverseResults(ImatExData* matex_data)
+{
+  ImatExFindResult* results = (ImatExFindResult*)iupArrayGetData(matex_data->find_results);
+  int i, count = iupArrayCount(matex_data->find_results);
+
+  for (i = 0; i < count / 2; i++)
+  {
+    ImatExFindResult tmp = results[i];
+    results[i] = results[count - 1 - i];
+    results[count - 1 - i] = tmp;
+  }
+}
+
+static void iMatrixExFindAddResult(ImatExData* matex_data, int lin, int col)
+{
+  ImatExFindResult* results = (ImatExFindResult*)iupArrayInc(matex_data->find_results);
+  int count = iupArrayCount(matex_data->find_results);
+  if (!results)
+    return;
+  results[count - 1].lin = lin;
+  results[count - 1].col = col;
+}
+
+static int iMatrixExSetFindAllAttrib(Ihandle* ih, const char* value)
+{
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  int num_lin = IupGetInt(ih, "NUMLIN");
+  int num_col = IupGetInt(ih, "NUMCOL");
+  /* in callback mode the values can change without notice, 
+     and the translated values are not notified */
+  int use_index = !IupGetCallback(ih, "VALUE_CB") && !IupGetCallback(ih, "VALUES_RANGE_CB") && 
+                  !IupGetCallback(ih, "TRANSLATEVALUE_CB");
+  char* direction = iupAttribGetStr(ih, "FINDDIRECTION");
+  ImatExFindMatch match;
+  int hashes[16], hash_count;
+  int lin, col;
+
+  if (!matex_data->find_results)
+    matex_data->find_results = iupArrayCreate(64, sizeof(ImatExFindResult));
+  else
+    iupArrayRemove(matex_data->find_results, 0, iupArrayCount(matex_data->find_results));
+
+  if (!matex_data->find_results || !value || value[0] == 0 || !iMatrixExFindMatchInit(ih, &match, value))
+    return 0;
+
+  hash_count = iMatrixExFindQueryHashes(&match, hashes);
+
+  /* search column by column */
+  for (col = 1; col <= num_col; col++)
+  {
+    ImatExFindIndex* index = iMatrixExFindGetIndex(matex_data, col);
+    int* candidates = NULL;
+    int candidate_count = 0;
+
+    if (!iupMatrixExIsColumnVisible(ih, col))
+      continue;
+
+    if (index && use_index && hash_count > 0)
+    {
+      if (index->built && index->num_lin == num_lin)
+        candidates = iMatrixExFindIndexCandidates(index, hashes, hash_count, &candidate_count);
+      else if (iMatrixExFindIndexBuild(ih, index, col, num_lin))
+        candidates = iMatrixExFindIndexCandidates(index, hashes, hash_count, &candidate_count);
+    }
+
+    /* if the index could not be allocated, search all the lines */
+    if (candidates)
+    {
+      int i;
+
+      for (i = 0; i < candidate_count; i++)
+      {
+        lin = candidates[i];
+        if (lin <= num_lin && iupMatrixExIsLineVisible(ih, lin) && iMatrixMatch(ih, &match, lin, col))
+          iMatrixExFindAddResult(matex_data, lin, col);
+      }
+
+      free(candidates);
+    }
+    else
+    {
+      for (lin = 1; lin <= num_lin; lin++)
+      {
+        if (iupMatrixExIsLineVisible(ih, lin) && iMatrixMatch(ih, &match, lin, col))
+          iMatrixExFindAddResult(matex_data, lin, col);
+      }
+    }
+  }
+
+  iMatrixExFindMatchRelease(&match);
+
+  /* the same order FIND visits the cells starting at 1:1,
+     the results were found by column from left to right and top to bottom */
+  if (iupStrEqualNoCase(direction, "LEFTTOP") || iupStrEqualNoCase(direction, "RIGHTBOTTOM"))
+    qsort(iupArrayGetData(matex_data->find_results), iupArrayCount(matex_data->find_results), sizeof(ImatExFindResult), iMatrixExFindCompareResult);
+
+  if (iupStrEqualNoCase(direction, "LEFTTOP") || iupStrEqualNoCase(direction, "TOPLEFT"))
+    iMatrixExFindReverseResults(matex_data);
+
+  return 0;
+}
+
+static char* iMatrixExGetFindResultCountAttrib(Ihandle* ih)
+{
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  int count = matex_data->find_results ? iupArrayCount(matex_data->find_results) : 0;
+  return iupStrReturnInt(count);
+}
+
+static char* iMatrixExGetFindResultAttrib(Ihandle* ih, int id)
+{
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  ImatExFindResult* results;
+
+  if (!matex_data->find_results || id < 1 || id > iupArrayCount(matex_data->find_results))
+    return NULL;
+
+  results = (ImatExFindResult*)iupArrayGetData(matex_data->find_results);
+  return iupStrReturnIntInt(results[id - 1].lin, results[id - 1].col, ':');
+}
+
 void iupMatrixExRegisterFind(Iclass* ic)
 {
   iupClassRegisterAttribute(ic, "FIND", NULL, iMatrixExSetFindAttrib, NULL, NULL, IUPAF_NO_INHERIT);
@@ -359,4 +956,13 @@ void iupMatrixExRegisterFind(Iclass* ic)
   iupClassRegisterAttribute(ic, "FINDDIRECTION", NULL, NULL, IUPAF_SAMEASSYSTEM, "RIGHTBOTTOM", IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "FINDMATCHCASE", NULL, NULL, IUPAF_SAMEASSYSTEM, "Yes", IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "FINDMATCHWHOLECELL", NULL, NULL, IUPAF_SAMEASSYSTEM, "Yes", IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "FINDMATCHMODE", NULL, NULL, IUPAF_SAMEASSYSTEM, "TEXT", IUPAF_NO_INHERIT);
+
+  iupClassRegisterAttribute(ic, "FINDALL", NULL, iMatrixExSetFindAllAttrib, NULL, NULL, IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "FINDRESULTCOUNT", iMatrixExGetFindResultCountAttrib, NULL, NULL, NULL, IUPAF_READONLY | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId(ic, "FINDRESULT", iMatrixExGetFindResultAttrib, NULL, IUPAF_READONLY | IUPAF_NO_INHERIT);
+
+  iupClassRegisterAttributeId(ic, "FINDINDEX", iMatrixExGetFindIndexAttrib, iMatrixExSetFindIndexAttrib, IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId2(ic, "FINDINDEXCELL", NULL, iMatrixExSetFindIndexCellAttrib, IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "FINDINDEXCLEAR", NULL, iMatrixExSetFindIndexClearAttrib, NULL, NULL, IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
 }
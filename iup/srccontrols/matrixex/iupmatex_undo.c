@@ -24,17 +24,30 @@
 
 static IattribSetFunc iMatrixSetUndoRedoAttrib = NULL;
 
+/* Each step is a log of the changed cells, in the order they were changed.
+   The old values are packed in a single buffer per step. */
+
+enum { IUNDO_NULL, IUNDO_TEXT, IUNDO_NUMBER };
+
+typedef struct _IundoCell {
+  int lin, col;
+  int type;     /* IUNDO_NULL, IUNDO_TEXT or IUNDO_NUMBER */
+  int offset;   /* position of the value in the values buffer */
+} IundoCell;
+
 typedef struct _IundoData {
   int cell_count;
   const char* name;
-  Itable* data_table;
+  Iarray* cells;    /* IundoCell */
+  Iarray* values;   /* zero terminated strings and doubles (not aligned) */
 } IundoData;
 
 static void iMatrixExUndoDataInit(IundoData* undo_data, const char* name)
 {
   undo_data->cell_count = 0;
   undo_data->name = name;
-  undo_data->data_table = iupTableCreate(IUPTABLE_STRINGINDEXED);
+  undo_data->cells = iupArrayCreate(10, sizeof(IundoCell));
+  undo_data->values = iupArrayCreate(100, sizeof(char));
 
   if (name)
   {
@@ -48,51 +61,133 @@ static void iMatrixExUndoDataInit(IundoData* undo_data, const char* name)
 
 static void iMatrixExUndoDataClear(IundoData* undo_data)
 {
-  iupTableDestroy(undo_data->data_table);
+  iupArrayDestroy(undo_data->cells);
+  iupArrayDestroy(undo_data->values);
   memset(undo_data, 0, sizeof(IundoData));
 }
 
-static void iMatrixExUndoDataAddCell(IundoData* undo_data, int lin, int col, const char* value)
+static double iMatrixExUndoDataMemory(IundoData* undo_data)
 {
-  char id[40];
-  sprintf(id, "%d:%d", lin, col);
-  if (!value)
-    iupTableSet(undo_data->data_table, id, (void*)"", IUPTABLE_POINTER);  /* store NULL pointers so they can be restored later */
-  else
-    iupTableSet(undo_data->data_table, id, (void*)value, IUPTABLE_STRING);
+  return (double)iupArrayCount(undo_data->cells) * sizeof(IundoCell) + (double)iupArrayCount(undo_data->values);
+}
+
+static int iMatrixExUndoValuesAdd(Iarray* values, const void* value, int size)
+{
+  int offset = iupArrayCount(values);
+  char* data = (char*)iupArrayAddUninit(values, size);
+  memcpy(data + offset, value, size);
+  return offset;
+}
+
+static void iMatrixExUndoDataAddCell(IundoData* undo_data, int lin, int col, int type, const void* value)
+{
+  IundoCell* cell;
+  int offset = 0;
+
+  if (type == IUNDO_TEXT)
+    offset = iMatrixExUndoValuesAdd(undo_data->values, value, (int)strlen((const char*)value) + 1);
+  else if (type == IUNDO_NUMBER)
+    offset = iMatrixExUndoValuesAdd(undo_data->values, value, sizeof(double));
+
+  cell = (IundoCell*)iupArrayInc(undo_data->cells);
+  cell += undo_data->cell_count;
+  cell->lin = lin;
+  cell->col = col;
+  cell->type = type;
+  cell->offset = offset;
+
   undo_data->cell_count++;
 }
 
-static int iMatrixExUndoDataSwap(ImatExData* matex_data, IundoData* undo_data)
+static int iMatrixExUndoSaveCell(ImatExData* matex_data, Iarray* values, int lin, int col, int *offset)
 {
-  char* id = iupTableFirst(undo_data->data_table);
-  while (id)
+  double number;
+  char* value;
+
+  *offset = 0;
+
+  if (iupMatrixExGetCellNumber(matex_data->ih, lin, col, &number))
   {
-    char *value, *old_value;
-    int lin=1, col=1;
-    iupStrToIntInt(id, &lin, &col, ':');
+    *offset = iMatrixExUndoValuesAdd(values, &number, sizeof(double));
+    return IUNDO_NUMBER;
+  }
 
-    value = (char*)iupTableGetCurr(undo_data->data_table);
+  value = iupMatrixExGetCellValue(matex_data->ih, lin, col, 0);  /* get internal value */
+  if (!value)
+    return IUNDO_NULL;
+
+  *offset = iMatrixExUndoValuesAdd(values, value, (int)strlen(value) + 1);
+  return IUNDO_TEXT;
+}
 
-    old_value = iupStrDup(iupMatrixExGetCellValue(matex_data->ih, lin, col, 0));  /* get internal value */
+static void iMatrixExUndoRestoreCell(ImatExData* matex_data, IundoCell* cell, const char* values, int callbacks)
+{
+  if (cell->type == IUNDO_NUMBER)
+  {
+    double number;
+    memcpy(&number, values + cell->offset, sizeof(double));
 
-    iupMatrixExSetCellValue(matex_data->ih, lin, col, value);
+    if (callbacks)
+      iupMatrixExSetCellNumber(matex_data->ih, cell->lin, cell->col, number);
+    else
+      iupMatrixExRestoreCellNumber(matex_data->ih, cell->lin, cell->col, number);
+  }
+  else
+  {
+    const char* value = (cell->type == IUNDO_TEXT)? values + cell->offset: NULL;
 
-    if (!old_value)
-      iupTableSetCurr(undo_data->data_table, (void*)"", IUPTABLE_POINTER);
+    if (callbacks)
+      iupMatrixExSetCellValue(matex_data->ih, cell->lin, cell->col, value);
     else
-    {
-      iupTableSetCurr(undo_data->data_table, (void*)old_value, IUPTABLE_STRING);
-      free(old_value);
-    }
+      iupMatrixExRestoreCellValue(matex_data->ih, cell->lin, cell->col, value);
+  }
+}
+
+static int iMatrixExUndoDataSwap(ImatExData* matex_data, IundoData* undo_data, int reverse, int callbacks)
+{
+  /* Undo restores from the last cell to the first, and Redo from the first to the last,
+     so a cell changed more than once in the same step ends with the right value.
+     The current values are saved in a new buffer that replaces the old one. */
+  IundoCell* cells = (IundoCell*)iupArrayGetData(undo_data->cells);
+  const char* values = (const char*)iupArrayGetData(undo_data->values);
+  Iarray* new_values = iupArrayCreate(iupArrayCount(undo_data->values) + 1, sizeof(char));
+  int i, ret = 1;
+
+  for (i = 0; i < undo_data->cell_count; i++)
+  {
+    IundoCell* cell = &(cells[reverse? undo_data->cell_count-1 - i: i]);
+    int type, offset;
+
+    type = iMatrixExUndoSaveCell(matex_data, new_values, cell->lin, cell->col, &offset);
+
+    iMatrixExUndoRestoreCell(matex_data, cell, values, callbacks);
+
+    cell->type = type;
+    cell->offset = offset;
 
     if (!iupMatrixExBusyInc(matex_data))
-      return 0;
+    {
+      ret = 0;
+      break;
+    }
+  }
 
-    id = iupTableNext(undo_data->data_table);
+  if (!ret)
+  {
+    /* canceled, move the values of the remaining cells to the new buffer */
+    for (i++; i < undo_data->cell_count; i++)
+    {
+      IundoCell* cell = &(cells[reverse? undo_data->cell_count-1 - i: i]);
+      if (cell->type == IUNDO_TEXT)
+        cell->offset = iMatrixExUndoValuesAdd(new_values, values + cell->offset, (int)strlen(values + cell->offset) + 1);
+      else if (cell->type == IUNDO_NUMBER)
+        cell->offset = iMatrixExUndoValuesAdd(new_values, values + cell->offset, sizeof(double));
+    }
   }
 
-  return 1;
+  iupArrayDestroy(undo_data->values);
+  undo_data->values = new_values;
+  return ret;
 }
 
 static void iMatrixExUndoStackInit(ImatExData* matex_data)
@@ -124,33 +219,91 @@ void iupMatrixExUndoPushBegin(ImatExData* matex_data, const char* name)
   }
 }
 
+static double iMatrixExUndoStackMemory(ImatExData* matex_data)
+{
+  int i, undo_stack_count = iupArrayCount(matex_data->undo_stack);
+  IundoData* undo_stack_data = (IundoData*)iupArrayGetData(matex_data->undo_stack);
+  double memory = 0;
+
+  for (i=0; i<undo_stack_count; i++)
+    memory += iMatrixExUndoDataMemory(&(undo_stack_data[i]));
+
+  return memory;
+}
+
+static void iMatrixExUndoStackEnd(ImatExData* matex_data)
+{
+  IundoData* undo_stack_data = (IundoData*)iupArrayGetData(matex_data->undo_stack);
+  IundoData* undo_data = &(undo_stack_data[matex_data->undo_stack_pos]);
+  double limit;
+
+  iupArrayShrink(undo_data->cells);
+  iupArrayShrink(undo_data->values);
+
+  matex_data->undo_stack_pos++;
+
+  /* Drop the oldest steps while the log uses more memory than the limit,
+     but always keep the step just done */
+  limit = iupAttribGetDouble(matex_data->ih, "UNDOMEMORYLIMIT");
+  if (limit > 0)
+  {
+    double memory = iMatrixExUndoStackMemory(matex_data);
+    int drop = 0;
+
+    while (memory > limit && drop < matex_data->undo_stack_pos-1)
+    {
+      memory -= iMatrixExUndoDataMemory(&(undo_stack_data[drop]));
+      iMatrixExUndoDataClear(&(undo_stack_data[drop]));
+      drop++;
+    }
+
+    if (drop)
+    {
+      iupArrayRemove(matex_data->undo_stack, 0, drop);
+      matex_data->undo_stack_pos -= drop;
+    }
+  }
+}
+
 void iupMatrixExUndoPushEnd(ImatExData* matex_data)
 {
   if (matex_data->undo_stack_hold)
   {
-    matex_data->undo_stack_pos++;
+    iMatrixExUndoStackEnd(matex_data);
     matex_data->undo_stack_hold = 0;
   }
 }
 
-static int iMatrixSetUndoPushCellAttrib(Ihandle* ih, int lin, int col, const char* value)
+static void iMatrixExUndoPushCell(ImatExData* matex_data, int lin, int col, int type, const void* value)
 {
-  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
   IundoData* undo_stack_data;
 
   if (matex_data->undo_stack_hold)
   {
     undo_stack_data = (IundoData*)iupArrayGetData(matex_data->undo_stack);
-    iMatrixExUndoDataAddCell(&(undo_stack_data[matex_data->undo_stack_pos]), lin, col, value);
+    iMatrixExUndoDataAddCell(&(undo_stack_data[matex_data->undo_stack_pos]), lin, col, type, value);
   }
   else
   {
     iMatrixUndoStackAdd(matex_data, "SETCELL");
     undo_stack_data = (IundoData*)iupArrayGetData(matex_data->undo_stack);
-    iMatrixExUndoDataAddCell(&(undo_stack_data[matex_data->undo_stack_pos]), lin, col, value);
-    matex_data->undo_stack_pos++;
+    iMatrixExUndoDataAddCell(&(undo_stack_data[matex_data->undo_stack_pos]), lin, col, type, value);
+    iMatrixExUndoStackEnd(matex_data);
   }
+}
+
+static int iMatrixSetUndoPushCellAttrib(Ihandle* ih, int lin, int col, const char* value)
+{
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  iMatrixExUndoPushCell(matex_data, lin, col, value? IUNDO_TEXT: IUNDO_NULL, value);
+  return 0;
+}
 
+static int iMatrixSetUndoPushNumberAttrib(Ihandle* ih, int lin, int col, const char* value)
+{
+  /* value is a pointer to a double */
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  iMatrixExUndoPushCell(matex_data, lin, col, IUNDO_NUMBER, value);
   return 0;
 }
 
@@ -180,6 +333,14 @@ static char* iMatrixGetUndoCountAttrib(Ihandle* ih)
   return NULL; 
 }
 
+static char* iMatrixGetUndoMemoryAttrib(Ihandle* ih)
+{
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  if (matex_data->undo_stack)
+    return iupStrReturnStrf("%.0f", iMatrixExUndoStackMemory(matex_data));
+  return NULL; 
+}
+
 static char* iMatrixGetUndoNameAttrib(Ihandle* ih, int id)
 {
   ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
@@ -203,6 +364,7 @@ static int iMatrixSetUndoAttrib(Ihandle* ih, const char* value)
   if (undo_stack_count && matex_data->undo_stack_pos>0)
   {
     int i, count = 1, total_cell_count = 0;
+    int callbacks = iupAttribGetBoolean(ih, "UNDOCALLBACKS");
     IundoData* undo_stack_data = (IundoData*)iupArrayGetData(matex_data->undo_stack);
 
     iupStrToInt(value, &count);
@@ -217,7 +379,7 @@ static int iMatrixSetUndoAttrib(Ihandle* ih, const char* value)
 
     for (i=0; i<count; i++)
     {
-      if (!iMatrixExUndoDataSwap(matex_data, &(undo_stack_data[matex_data->undo_stack_pos-1 - i])))
+      if (!iMatrixExUndoDataSwap(matex_data, &(undo_stack_data[matex_data->undo_stack_pos-1 - i]), 1, callbacks))
       {
         matex_data->undo_stack_pos -= i;
         iMatrixSetUndoRedoAttrib(ih, "Yes");
@@ -259,6 +421,7 @@ static int iMatrixSetRedoAttrib(Ihandle* ih, const char* value)
   if (undo_stack_count && matex_data->undo_stack_pos<undo_stack_count)
   {
     int i, count = 1, total_cell_count = 0;
+    int callbacks = iupAttribGetBoolean(ih, "UNDOCALLBACKS");
     IundoData* undo_stack_data = (IundoData*)iupArrayGetData(matex_data->undo_stack);
 
     iupStrToInt(value, &count);
@@ -273,7 +436,7 @@ static int iMatrixSetRedoAttrib(Ihandle* ih, const char* value)
 
     for (i=0; i<count; i++)
     {
-      if (!iMatrixExUndoDataSwap(matex_data, &(undo_stack_data[matex_data->undo_stack_pos + i])))
+      if (!iMatrixExUndoDataSwap(matex_data, &(undo_stack_data[matex_data->undo_stack_pos + i]), 0, callbacks))
       {
         matex_data->undo_stack_pos += i;
         iMatrixSetUndoRedoAttrib(ih, "Yes");
@@ -418,9 +581,13 @@ void iupMatrixExRegisterUndo(Iclass* ic)
   iupClassRegisterAttribute(ic, "UNDOCLEAR", NULL, iMatrixSetUndoClearAttrib, NULL, NULL, IUPAF_WRITEONLY|IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId(ic, "UNDONAME", iMatrixGetUndoNameAttrib, NULL, IUPAF_READONLY|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "UNDOCOUNT", iMatrixGetUndoCountAttrib, NULL, NULL, NULL, IUPAF_READONLY|IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "UNDOMEMORY", iMatrixGetUndoMemoryAttrib, NULL, NULL, NULL, IUPAF_READONLY|IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "UNDOMEMORYLIMIT", NULL, NULL, NULL, NULL, IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "UNDOCALLBACKS", NULL, NULL, NULL, NULL, IUPAF_NO_INHERIT);
 
   /* Internal attributes */
   iupClassRegisterAttributeId2(ic, "UNDOPUSHCELL", NULL, iMatrixSetUndoPushCellAttrib, IUPAF_WRITEONLY|IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId2(ic, "UNDOPUSHNUMBER", NULL, iMatrixSetUndoPushNumberAttrib, IUPAF_WRITEONLY|IUPAF_NO_STRING|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "UNDOPUSHBEGIN", NULL, iMatrixSetUndoPushBeginAttrib, NULL, NULL, IUPAF_WRITEONLY|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "UNDOPUSHEND", NULL, iMatrixSetUndoPushEndAttrib, NULL, NULL, IUPAF_WRITEONLY|IUPAF_NO_INHERIT);
 }
@@ -75,6 +75,29 @@ int iupMatrixExIsLineVisible(Ihandle* ih, int lin)
   return 1;
 }
 
+char* iupMatrixExGetVisibleLines(Ihandle* ih, int num_lin)
+{
+  /* computed once, instead of an attribute lookup for each cell */
+  char* visible = (char*)malloc(num_lin + 1);
+  int lin;
+  if (!visible)
+    return NULL;
+  for (lin = 0; lin <= num_lin; lin++)
+    visible[lin] = (char)iupMatrixExIsLineVisible(ih, lin);
+  return visible;
+}
+
+char* iupMatrixExGetVisibleColumns(Ihandle* ih, int num_col)
+{
+  char* visible = (char*)malloc(num_col + 1);
+  int col;
+  if (!visible)
+    return NULL;
+  for (col = 0; col <= num_col; col++)
+    visible[col] = (char)iupMatrixExIsColumnVisible(ih, col);
+  return visible;
+}
+
 static char* iMatrixGetVisibleColAttribId(Ihandle *ih, int col)
 {
   return iupStrReturnBoolean (iupMatrixExIsColumnVisible(ih, col)); 
@@ -23,6 +23,7 @@
 
 #include "iup_assert.h"
 #include "iup_object.h"
+#include "iup_childtree.h"
 #include "iup_attrib.h"
 #include "iup_str.h"
 #include "iup_layout.h"
@@ -411,6 +412,7 @@ static int iGLSubCanvasSetZorder(Ihandle* parent, Ihandle* child, int top)
     parent->firstchild = child;
   }
 
+  iupChildTreeUpdate(parent);
   return 1;
 }
 
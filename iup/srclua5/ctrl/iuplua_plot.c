@@ -363,6 +363,18 @@ static int PlotAddStrSamples(lua_State *L)
   return 0;
 }
 
+static int PlotAppendRolling(lua_State *L)
+{
+  double *px, *py;
+  int count = luaL_checkinteger(L, 5);
+  px = iuplua_checkdouble_array(L, 3, count);
+  py = iuplua_checkdouble_array(L, 4, count);
+  IupPlotAppendRolling(iuplua_checkihandle(L,1), luaL_checkinteger(L,2), px, py, count);
+  free(px);
+  free(py);
+  return 0;
+}
+
 static int PlotGetSample(lua_State *L)
 {
   Ihandle *ih = iuplua_checkihandle(L, 1);
@@ -478,6 +490,7 @@ void iuplua_plotfuncs_open (lua_State *L)
   iuplua_register(L, PlotInsertStrSamples ,"PlotInsertStrSamples");
   iuplua_register(L, PlotAddSamples       ,"PlotAddSamples");
   iuplua_register(L, PlotAddStrSamples    ,"PlotAddStrSamples");
+  iuplua_register(L, PlotAppendRolling    ,"PlotAppendRolling");
   iuplua_register(L, PlotGetSample, "PlotGetSample");
   iuplua_register(L, PlotGetSampleStr, "PlotGetSampleStr");
   iuplua_register(L, PlotGetSampleSelection, "PlotGetSampleSelection");
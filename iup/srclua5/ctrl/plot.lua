@@ -49,6 +49,7 @@ ctrl.InsertSamples = iup.PlotInsertSamples
 ctrl.InsertStrSamples = iup.PlotInsertStrSamples 
 ctrl.AddSamples = iup.PlotAddSamples 
 ctrl.AddStrSamples = iup.PlotAddStrSamples 
+ctrl.AppendRolling = iup.PlotAppendRolling
 ctrl.GetSample = iup.PlotGetSample
 ctrl.GetSampleStr = iup.PlotGetSampleStr
 ctrl.GetSampleSelection = iup.PlotGetSampleSelection
@@ -23,6 +23,7 @@ enum iupPlotSliceLabel { IUP_PLOT_NONE, IUP_PLOT_X, IUP_PLOT_Y, IUP_PLOT_PERCENT
 enum iupPlotHighlight { IUP_PLOT_HIGHLIGHT_NONE, IUP_PLOT_HIGHLIGHT_SAMPLE, IUP_PLOT_HIGHLIGHT_CURVE, IUP_PLOT_HIGHLIGHT_BOTH };
 enum iupPlotClipping { IUP_PLOT_CLIPNONE, IUP_PLOT_CLIPAREA, IUP_PLOT_CLIPAREAOFFSET };
 enum iupPlotAxisPosition { IUP_PLOT_START, IUP_PLOT_CROSSORIGIN, IUP_PLOT_END };
+enum iupPlotBufferType { IUP_PLOT_BUFFER_DOUBLE, IUP_PLOT_BUFFER_FLOAT, IUP_PLOT_BUFFER_SHORT, IUP_PLOT_BUFFER_INDEX };
 
 #define IUP_PLOT_DEF_NUMBERFORMAT "%.0f"
 #define IUP_PLOT_DEF_NUMBERFORMATSIGNED "% .0f"
@@ -154,44 +155,71 @@ public:
 class iupPlotData
 {
 public:
-  iupPlotData(int inSize) : mCount(0), mIsString(false) { mArray = iupArrayCreate(20, inSize); }
+  iupPlotData(int inSize) : mCount(0), mIsString(false), mIsBuffer(false), mSize(inSize), mStart(0), mCapacity(0) { mArray = iupArrayCreate(20, inSize); }
   virtual ~iupPlotData() { iupArrayDestroy(mArray); }
 
   bool IsString() const { return mIsString; }
+  bool IsBuffer() const { return mIsBuffer; }
   int GetCount() const { return mCount; }
+  int GetCapacity() const { return mCapacity; }
+  bool IsFull() const { return mCapacity && mCount == mCapacity; }
 
   virtual bool CalculateRange(double &outMin, double &outMax) const = 0;
   virtual double GetSample(int inSampleIndex) const = 0;
+  virtual void Reserve(int inCount) = 0;
+  virtual void SetCapacity(int inCapacity);
 
-  void RemoveSample(int inSampleIndex) {
-    if (inSampleIndex < 0) inSampleIndex = 0; if (inSampleIndex > mCount) inSampleIndex = mCount;
-    iupArrayRemove(mArray, inSampleIndex, 1); mCount--;
-  }
+  virtual void RemoveSample(int inSampleIndex);
 
 protected:
   int mCount;
   Iarray* mArray;
   bool mIsString;
+  bool mIsBuffer;
+  int mSize;      // size of each sample in the array
+  int mStart;     // position of the first sample, when used as a ring buffer
+  int mCapacity;  // number of samples of the ring buffer, 0 if the array can grow
+
+  int GetPos(int inSampleIndex) const { int thePos = inSampleIndex + mStart; return (mCapacity && thePos >= mCapacity) ? thePos - mCapacity : thePos; }
+  int InsertPos(int inSampleIndex);
 };
 
 class iupPlotDataReal : public iupPlotData
 {
 public:
-  iupPlotDataReal() :iupPlotData(sizeof(double)) { mData = (double*)iupArrayGetData(mArray); }
+  iupPlotDataReal() :iupPlotData(sizeof(double)), mRangeValid(false), mRangeMin(0), mRangeMax(0) { mData = (double*)iupArrayGetData(mArray); }
 
-  double GetSample(int inSampleIndex) const { return mData[inSampleIndex]; }
-  void SetSample(int inSampleIndex, double inReal) const { mData[inSampleIndex] = inReal; }
+  double GetSample(int inSampleIndex) const { return mData[GetPos(inSampleIndex)]; }
+  void SetSample(int inSampleIndex, double inReal) const { int thePos = GetPos(inSampleIndex); RemoveRange(mData[thePos]); mData[thePos] = inReal; AddRange(inReal); }
 
-  void AddSample(double inReal) { mData = (double*)iupArrayInc(mArray); mData[mCount] = inReal; mCount++; }
+  void Reserve(int inCount) { if (!mCapacity) mData = (double*)iupArrayReserve(mArray, inCount); }
+  void SetCapacity(int inCapacity) { iupPlotData::SetCapacity(inCapacity); mData = (double*)iupArrayGetData(mArray); mRangeValid = false; }
+  void AddSample(double inReal) { InsertSample(mCount, inReal); }
   void InsertSample(int inSampleIndex, double inReal) {
-    if (inSampleIndex < 0) inSampleIndex = 0; if (inSampleIndex > mCount) inSampleIndex = mCount;
-    mData = (double*)iupArrayInsert(mArray, inSampleIndex, 1); mData[inSampleIndex] = inReal; mCount++;
+    int thePos = InsertPos(inSampleIndex);
+    mData = (double*)iupArrayGetData(mArray); mData[thePos] = inReal; AddRange(inReal);
+  }
+  void RemoveSample(int inSampleIndex) {
+    if (inSampleIndex >= 0 && inSampleIndex < mCount) RemoveRange(mData[GetPos(inSampleIndex)]);
+    iupPlotData::RemoveSample(inSampleIndex);
   }
 
   bool CalculateRange(double &outMin, double &outMax) const;
 
 protected:
   double* mData;
+
+  // running minimum and maximum, computed again only when one of them is removed
+  mutable bool mRangeValid;
+  mutable double mRangeMin;
+  mutable double mRangeMax;
+
+  void AddRange(double inReal) const {
+    if (!mRangeValid) return;
+    if (inReal < mRangeMin) mRangeMin = inReal;
+    if (inReal > mRangeMax) mRangeMax = inReal;
+  }
+  void RemoveRange(double inReal) const { if (inReal == mRangeMin || inReal == mRangeMax) mRangeValid = false; }
 };
 
 class iupPlotDataString : public iupPlotData
@@ -202,17 +230,24 @@ public:
 
   double GetSample(int inSampleIndex) const { return inSampleIndex; }
 
-  const char* GetSampleString(int inSampleIndex) const { return mData[inSampleIndex]; }
+  const char* GetSampleString(int inSampleIndex) const { return mData[GetPos(inSampleIndex)]; }
   void SetSampleString(int inSampleIndex, const char *inString) const { 
-    if (inString == mData[inSampleIndex]) return; // set for the same pointer does nothing
-    free(mData[inSampleIndex]); 
-    mData[inSampleIndex] = iupStrDup(inString); 
+    int thePos = GetPos(inSampleIndex);
+    if (inString == mData[thePos]) return; // set for the same pointer does nothing
+    free(mData[thePos]); 
+    mData[thePos] = iupStrDup(inString); 
   }
 
-  void AddSample(const char *inString) { mData = (char**)iupArrayInc(mArray); mData[mCount] = iupStrDup(inString); mCount++; }
+  void Reserve(int inCount) { if (!mCapacity) mData = (char**)iupArrayReserve(mArray, inCount); }
+  void SetCapacity(int inCapacity);
+  void AddSample(const char *inString) { InsertSample(mCount, inString); }
   void InsertSample(int inSampleIndex, const char *inString) {
-    if (inSampleIndex < 0) inSampleIndex = 0; if (inSampleIndex > mCount) inSampleIndex = mCount;
-    mData = (char**)iupArrayInsert(mArray, inSampleIndex, 1); mData[inSampleIndex] = iupStrDup(inString); mCount++;
+    int thePos = InsertPos(inSampleIndex);
+    mData = (char**)iupArrayGetData(mArray); mData[thePos] = iupStrDup(inString);
+  }
+  void RemoveSample(int inSampleIndex) {
+    if (inSampleIndex >= 0 && inSampleIndex < mCount) free(mData[GetPos(inSampleIndex)]);
+    iupPlotData::RemoveSample(inSampleIndex);
   }
 
   bool CalculateRange(double &outMin, double &outMax) const;
@@ -226,15 +261,17 @@ class iupPlotDataBool : public iupPlotData
 public:
   iupPlotDataBool() :iupPlotData(sizeof(bool)) { mData = (bool*)iupArrayGetData(mArray); }
 
-  double GetSample(int inSampleIndex) const { return (int)mData[inSampleIndex]; }
+  double GetSample(int inSampleIndex) const { return (int)mData[GetPos(inSampleIndex)]; }
 
-  bool GetSampleBool(int inSampleIndex) const { return mData[inSampleIndex]; }
-  void SetSampleBool(int inSampleIndex, bool inBool) { mData[inSampleIndex] = inBool; }
+  bool GetSampleBool(int inSampleIndex) const { return mData[GetPos(inSampleIndex)]; }
+  void SetSampleBool(int inSampleIndex, bool inBool) { mData[GetPos(inSampleIndex)] = inBool; }
 
-  void AddSample(bool inBool) { mData = (bool*)iupArrayInc(mArray); mData[mCount] = inBool; mCount++; }
+  void Reserve(int inCount) { if (!mCapacity) mData = (bool*)iupArrayReserve(mArray, inCount); }
+  void SetCapacity(int inCapacity) { iupPlotData::SetCapacity(inCapacity); mData = (bool*)iupArrayGetData(mArray); }
+  void AddSample(bool inBool) { InsertSample(mCount, inBool); }
   void InsertSample(int inSampleIndex, bool inBool) {
-    if (inSampleIndex < 0) inSampleIndex = 0; if (inSampleIndex > mCount) inSampleIndex = mCount;
-    mData = (bool*)iupArrayInsert(mArray, inSampleIndex, 1); mData[inSampleIndex] = inBool; mCount++;
+    int thePos = InsertPos(inSampleIndex);
+    mData = (bool*)iupArrayGetData(mArray); mData[thePos] = inBool;
   }
 
   bool CalculateRange(double &outMin, double &outMax) const;
@@ -243,6 +280,119 @@ protected:
   bool* mData;
 };
 
+// Samples stored in a buffer owned by the application, they are never copied.
+// The buffer can not be modified by the plot, and it can not be a ring buffer.
+class iupPlotDataBuffer : public iupPlotData
+{
+public:
+  iupPlotDataBuffer(const void* inBuffer, iupPlotBufferType inType, int inStride, int inCount);
+
+  // non virtual accessor, used also by GetSample
+  double GetValue(int inSampleIndex) const {
+    const unsigned char* theSample = mBuffer + (size_t)inSampleIndex * mStride;
+    switch (mType)
+    {
+    case IUP_PLOT_BUFFER_DOUBLE: return *(const double*)theSample;
+    case IUP_PLOT_BUFFER_FLOAT: return *(const float*)theSample;
+    case IUP_PLOT_BUFFER_SHORT: return *(const short*)theSample;
+    default: return inSampleIndex;
+    }
+  }
+
+  double GetSample(int inSampleIndex) const { return GetValue(inSampleIndex); }
+  void Reserve(int) {}
+  void SetCapacity(int) {}
+  void RemoveSample(int) {}
+
+  void SetChanged(int inStart, int inEnd);
+
+  bool CalculateRange(double &outMin, double &outMax) const;
+
+protected:
+  const unsigned char* mBuffer;
+  iupPlotBufferType mType;
+  int mStride;  // in bytes
+
+  // running minimum and maximum, computed again when old samples are changed
+  mutable bool mRangeValid;
+  mutable double mRangeMin;
+  mutable double mRangeMax;
+};
+
+struct iupPlotPyramidNode
+{
+  int mMinIndex;
+  int mMaxIndex;
+  int mSegmentIndex;  // first sample that starts a segment, -1 if none
+};
+
+// Min/max of the Y values at several resolutions, used to decimate large datasets.
+// The first level has one node for each block of samples,
+// each next level has one node for each 2 nodes of the previous level.
+// It is updated incrementally, only from the first modified sample.
+// Samples removed from the beginning are only skipped, nodes store indices counted from the last rebuild.
+class iupPlotSamplePyramid
+{
+public:
+  iupPlotSamplePyramid();
+  ~iupPlotSamplePyramid();
+
+  void Invalidate(int inSampleIndex) { if (inSampleIndex + mOffset < mValidCount) mValidCount = inSampleIndex + mOffset; }
+  void RemoveFirst() { mOffset++; }
+  void Update(const iupPlotData* inDataX, const iupPlotData* inDataY, const iupPlotDataBool* inSegment);
+
+  bool IsOrderedX() const { return mUnorderedIndex == -1; }
+  void FindMinMax(const iupPlotData* inDataY, int inStart, int inEnd, int &outMinIndex, int &outMaxIndex) const;
+  int FindSegment(const iupPlotDataBool* inSegment, int inStart, int inEnd) const;
+  int FindInside(const iupPlotData* inDataY, int inStart, int inEnd, double inMinY, double inMaxY) const;
+
+protected:
+  int mCount;           // samples in the pyramid, including the removed ones
+  int mValidCount;      // samples that did not change since the last update
+  int mOffset;          // samples removed from the beginning
+  int mUnorderedIndex;  // first sample with X smaller than the previous one, -1 if none
+  int mLevelCount;
+  Iarray* mLevels[32];
+
+  const iupPlotPyramidNode* GetLevel(int inLevel) const { return (const iupPlotPyramidNode*)iupArrayGetData(mLevels[inLevel]); }
+  double GetY(const iupPlotData* inDataY, int inIndex) const { return inDataY->GetSample(inIndex - mOffset); }
+  void FindMinMaxIndex(const iupPlotData* inDataY, int inStart, int inEnd, int &outMinIndex, int &outMaxIndex) const;
+  int FindSegmentIndex(const iupPlotDataBool* inSegment, int inStart, int inEnd) const;
+  int FindInsideIndex(const iupPlotData* inDataY, int inStart, int inEnd, double inMinY, double inMaxY) const;
+  int FindInsideNode(const iupPlotData* inDataY, int inLevel, int inNode, double inMinY, double inMaxY) const;
+};
+
+// Uniform grid of the samples in data space, used to find samples inside a box when X is not ordered.
+// New samples are added to their cells while inside the grid limits, other changes rebuild the grid.
+// Samples removed from the beginning are only skipped until the next rebuild.
+class iupPlotSampleGrid
+{
+public:
+  iupPlotSampleGrid();
+  ~iupPlotSampleGrid();
+
+  void Invalidate(int inSampleIndex) { if (inSampleIndex + mOffset < mValidCount) mValidCount = inSampleIndex + mOffset; }
+  void RemoveFirst() { mOffset++; }
+  void Update(const iupPlotData* inDataX, const iupPlotData* inDataY);
+
+  void FindInside(const iupPlotData* inDataX, const iupPlotData* inDataY, double inMinX, double inMaxX, double inMinY, double inMaxY, Iarray* outIndex) const;
+
+protected:
+  int mCount;        // samples in the grid, including the removed ones
+  int mValidCount;   // samples that did not change since the last update
+  int mOffset;       // samples removed from the beginning
+  int mBuildCount;   // samples when the grid was built
+  int mSize;         // number of cells in each direction
+  double mMinX, mMaxX, mMinY, mMaxY;
+  double mCellWidth, mCellHeight;
+  int* mFirst;       // first sample of each cell, -1 if empty
+  int* mLast;        // last sample of each cell
+  Iarray* mNext;     // next sample in the same cell, -1 if none
+
+  void Build(const iupPlotData* inDataX, const iupPlotData* inDataY);
+  bool AddSample(int inSampleIndex, double inX, double inY);
+};
+
 struct iupPlotSampleNotify
 {
   Ihandle* ih;
@@ -271,6 +421,11 @@ public:
   void DrawDataPie(const iupPlotTrafo *inTrafoX, const iupPlotTrafo *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify, const iupPlotAxis& inAxisY, long inBackColor) const;
 
   int GetCount();
+  void ReserveSamples(int inCount);
+  int GetCapacity();
+  void SetCapacity(int inCapacity);
+  bool AttachBuffers(const void* inX, iupPlotBufferType inTypeX, int inStrideX, const void* inY, iupPlotBufferType inTypeY, int inStrideY, int inCount);
+  void BuffersChanged(int inStart, int inEnd);
   void AddSample(double inX, double inY);
   void InsertSample(int inSampleIndex, double inX, double inY);
   void AddSampleSegment(double inX, double inY, bool inSegment);
@@ -293,6 +448,12 @@ public:
   const iupPlotDataBool* GetSegment() const { return mSegment; }
   const iupPlotDataReal* GetExtra() const { return mExtra; }
 
+  int FindSampleX(double inX) const;
+  bool CalculateXRange(double &outXMin, double &outXMax) const;
+  bool CalculateYRange(double &outYMin, double &outYMax) const;
+  bool CalculateYRange(double inXMin, double inXMax, double &outYMin, double &outYMax) const;
+  int FindCrossingY(int inStart, double inY, bool inLess) const;
+
   bool SelectSamples(double inMinX, double inMaxX, double inMinY, double inMaxY, const iupPlotSampleNotify* inNotify);
   bool ClearSelection(const iupPlotSampleNotify* inNotify);
   bool DeleteSelectedSamples(const iupPlotSampleNotify* inNotify);
@@ -319,6 +480,7 @@ public:
   void* mUserData;
   bool mOrderedX;
   bool mSelectedCurve;
+  bool mDecimate;
 
   // Aux
   int mHighlightedSample;
@@ -333,9 +495,17 @@ protected:
   iupPlotDataReal* mExtra;
   iupPlotDataBool* mSegment;
   bool mHasSelected;
+  mutable iupPlotSamplePyramid* mPyramid;  // created when needed
+  mutable iupPlotSampleGrid* mGrid;
 
   void InitSegment();
   void InitExtra();
+  void InvalidateIndex(int inSampleIndex) { if (mPyramid) mPyramid->Invalidate(inSampleIndex); if (mGrid) mGrid->Invalidate(inSampleIndex); }
+  void RemoveFirstIndex() { if (mPyramid) mPyramid->RemoveFirst(); if (mGrid) mGrid->RemoveFirst(); }
+  const iupPlotSamplePyramid* GetPyramid() const;
+  void FindSamplesInside(double inMinX, double inMaxX, double inMinY, double inMaxY, Iarray* outIndex) const;
+
+  Iarray* DecimateSamples(const iupPlotTrafo *inTrafoX, cdCanvas* canvas, const iupPlotSampleNotify* inNotify) const;
 
   void DrawDataLine(const iupPlotTrafo *inTrafoX, const iupPlotTrafo *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify, bool inShowMark, bool inErrorBar) const;
   void DrawDataMark(const iupPlotTrafo *inTrafoX, const iupPlotTrafo *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify) const;
@@ -684,6 +854,7 @@ public:
   int mDefaultFontSize;
   int mDefaultFontStyle;
   bool mScaleEqual;
+  bool mAutoScaleVisibleY;
   iupPlotClipping mDataSetClipping;
 
   bool mCrossHairH, mCrossHairV;
@@ -763,9 +934,9 @@ protected:
   bool DrawLegend(const iupPlotRect &inRect, cdCanvas* canvas, iupPlotRect &ioPos) const;
   bool DrawSampleColorLegend(iupPlotDataSet *inData, const iupPlotRect &inRect, cdCanvas* canvas, iupPlotRect &ioPos) const;
   void DrawCrossHairH(const iupPlotRect &inRect, cdCanvas* canvas) const;
-  void DrawCrossSamplesH(const iupPlotRect &inRect, const iupPlotData *inXData, const iupPlotData *inYData, cdCanvas* canvas) const;
+  void DrawCrossSamplesH(const iupPlotRect &inRect, const iupPlotDataSet *inDataSet, cdCanvas* canvas) const;
   void DrawCrossHairV(const iupPlotRect &inRect, cdCanvas* canvas) const;
-  void DrawCrossSamplesV(const iupPlotRect &inRect, const iupPlotData *inXData, const iupPlotData *inYData, cdCanvas* canvas) const;
+  void DrawCrossSamplesV(const iupPlotRect &inRect, const iupPlotDataSet *inDataSet, cdCanvas* canvas) const;
   void DrawInactive(cdCanvas* canvas) const;
 
   /*********************************/
@@ -216,7 +216,7 @@ void iupPlot::CalculateXRange(double &outXMin, double &outXMax) const
       theXMin = -1;
       theXMax = 1;
     }
-    else if (!theXData->CalculateRange(theXMin, theXMax))
+    else if (!mDataSetList[ds]->CalculateXRange(theXMin, theXMax))
       return;
     
     if (theFirst) 
@@ -240,8 +240,6 @@ void iupPlot::CalculateYRange(double &outYMin, double &outYMax) const
 
   for (int ds = 0; ds < mDataSetListCount; ds++)
   {
-    const iupPlotData *theYData = mDataSetList[ds]->GetDataY();
-
     double theYMin;
     double theYMax;
     if (mDataSetList[ds]->mMode == IUP_PLOT_PIE)
@@ -249,7 +247,13 @@ void iupPlot::CalculateYRange(double &outYMin, double &outYMax) const
       theYMin = -1;
       theYMax = 1;
     }
-    else if (!theYData->CalculateRange(theYMin, theYMax))
+    else if (mAutoScaleVisibleY)
+    {
+      // only the samples inside the X axis range, it was already calculated
+      if (!mDataSetList[ds]->CalculateYRange(mAxisX.mMin, mAxisX.mMax, theYMin, theYMax))
+        continue;
+    }
+    else if (!mDataSetList[ds]->CalculateYRange(theYMin, theYMax))
       return;
     
     if (theFirst) 
@@ -19,20 +19,103 @@ static inline bool iPlotCheckInsideBox(double x, double y, double boxMinX, doubl
 /************************************************************************************************/
 
 
+int iupPlotData::InsertPos(int inSampleIndex)
+{
+  // makes room for a new sample, returns its position in the array
+  if (inSampleIndex < 0) inSampleIndex = 0; if (inSampleIndex > mCount) inSampleIndex = mCount;
+
+  if (!mCapacity)
+  {
+    if (inSampleIndex == mCount)
+      iupArrayInc(mArray);
+    else
+      iupArrayInsert(mArray, inSampleIndex, 1);
+    mCount++;
+    return inSampleIndex;
+  }
+
+  if (mCount == mCapacity)
+  {
+    // the oldest sample is discarded
+    RemoveSample(0);
+    if (inSampleIndex > 0) inSampleIndex--;
+  }
+
+  // the next samples are moved one position forward
+  char* theData = (char*)iupArrayGetData(mArray);
+  for (int i = mCount; i > inSampleIndex; i--)
+    memcpy(theData + GetPos(i) * mSize, theData + GetPos(i - 1) * mSize, mSize);
+
+  mCount++;
+  return GetPos(inSampleIndex);
+}
+
+void iupPlotData::RemoveSample(int inSampleIndex)
+{
+  if (!mCapacity)
+  {
+    if (inSampleIndex < 0) inSampleIndex = 0; if (inSampleIndex > mCount) inSampleIndex = mCount;
+    iupArrayRemove(mArray, inSampleIndex, 1); mCount--;
+    return;
+  }
+
+  if (inSampleIndex < 0 || inSampleIndex >= mCount)
+    return;
+
+  if (inSampleIndex == 0)
+    mStart = GetPos(1);  // the first sample is only skipped
+  else
+  {
+    // the next samples are moved one position back
+    char* theData = (char*)iupArrayGetData(mArray);
+    for (int i = inSampleIndex; i < mCount - 1; i++)
+      memcpy(theData + GetPos(i) * mSize, theData + GetPos(i + 1) * mSize, mSize);
+  }
+
+  mCount--;
+}
+
+void iupPlotData::SetCapacity(int inCapacity)
+{
+  // the samples are copied in order to a new array,
+  // when they do not fit the first samples are discarded
+  if (inCapacity < 0) inCapacity = 0;
+  int theFirst = (inCapacity && mCount > inCapacity) ? mCount - inCapacity : 0;
+  int theCount = mCount - theFirst;
+
+  Iarray* theArray = iupArrayCreate(inCapacity ? inCapacity : theCount + 20, mSize);
+  char* theData = (char*)iupArrayAdd(theArray, inCapacity ? inCapacity : theCount);
+  const char* theOldData = (const char*)iupArrayGetData(mArray);
+  for (int i = 0; i < theCount; i++)
+    memcpy(theData + i * mSize, theOldData + GetPos(theFirst + i) * mSize, mSize);
+
+  iupArrayDestroy(mArray);
+  mArray = theArray;
+  mCount = theCount;
+  mStart = 0;
+  mCapacity = inCapacity;
+}
+
 bool iupPlotDataReal::CalculateRange(double &outMin, double &outMax) const
 {
-  int theCount = iupArrayCount(mArray);
-  if (theCount > 0)
+  if (mCount > 0)
   {
-    double* theData = (double*)iupArrayGetData(mArray);
-    outMax = outMin = theData[0];
-    for (int i = 1; i < theCount; i++)
+    if (!mRangeValid)
     {
-      if (theData[i] > outMax)
-        outMax = theData[i];
-      if (theData[i] < outMin)
-        outMin = theData[i];
+      mRangeMax = mRangeMin = mData[GetPos(0)];
+      for (int i = 1; i < mCount; i++)
+      {
+        double theValue = mData[GetPos(i)];
+        if (theValue > mRangeMax)
+          mRangeMax = theValue;
+        if (theValue < mRangeMin)
+          mRangeMin = theValue;
+      }
+      mRangeValid = true;
     }
+
+    outMin = mRangeMin;
+    outMax = mRangeMax;
     return true;
   }
 
@@ -42,7 +125,17 @@ bool iupPlotDataReal::CalculateRange(double &outMin, double &outMax) const
 iupPlotDataString::~iupPlotDataString()
 {
   for (int i = 0; i < mCount; i++)
-    free(mData[i]);
+    free(mData[GetPos(i)]);
+}
+
+void iupPlotDataString::SetCapacity(int inCapacity)
+{
+  // strings of the samples that will be discarded
+  for (int i = 0; inCapacity > 0 && i < mCount - inCapacity; i++)
+    free(mData[GetPos(i)]);
+
+  iupPlotData::SetCapacity(inCapacity);
+  mData = (char**)iupArrayGetData(mArray);
 }
 
 bool iupPlotDataString::CalculateRange(double &outMin, double &outMax) const
@@ -69,6 +162,660 @@ bool iupPlotDataBool::CalculateRange(double &outMin, double &outMax) const
   return false;
 }
 
+iupPlotDataBuffer::iupPlotDataBuffer(const void* inBuffer, iupPlotBufferType inType, int inStride, int inCount)
+  :iupPlotData(sizeof(double)), mBuffer((const unsigned char*)inBuffer), mType(inType), mStride(inStride),
+   mRangeValid(false), mRangeMin(0), mRangeMax(0)
+{
+  mIsBuffer = true;
+  mCount = inCount;
+
+  if (!mBuffer)
+    mType = IUP_PLOT_BUFFER_INDEX;  // the sample index is the value
+
+  if (mStride <= 0)
+  {
+    // contiguous samples
+    switch (mType)
+    {
+    case IUP_PLOT_BUFFER_DOUBLE: mStride = sizeof(double); break;
+    case IUP_PLOT_BUFFER_FLOAT: mStride = sizeof(float); break;
+    case IUP_PLOT_BUFFER_SHORT: mStride = sizeof(short); break;
+    default: mStride = 0; break;
+    }
+  }
+}
+
+void iupPlotDataBuffer::SetChanged(int inStart, int inEnd)
+{
+  // samples in [inStart, inEnd) were changed by the application, the ones after the end are new
+  int theOldCount = mCount;
+  if (inEnd > mCount)
+    mCount = inEnd;
+
+  if (!mRangeValid)
+    return;
+
+  if (inStart < theOldCount)
+  {
+    mRangeValid = false;  // the old values are unknown
+    return;
+  }
+
+  for (int i = theOldCount; i < mCount; i++)
+  {
+    double theValue = GetValue(i);
+    if (theValue < mRangeMin) mRangeMin = theValue;
+    if (theValue > mRangeMax) mRangeMax = theValue;
+  }
+}
+
+bool iupPlotDataBuffer::CalculateRange(double &outMin, double &outMax) const
+{
+  if (mCount > 0)
+  {
+    if (!mRangeValid)
+    {
+      mRangeMax = mRangeMin = GetValue(0);
+      for (int i = 1; i < mCount; i++)
+      {
+        double theValue = GetValue(i);
+        if (theValue > mRangeMax)
+          mRangeMax = theValue;
+        if (theValue < mRangeMin)
+          mRangeMin = theValue;
+      }
+      mRangeValid = true;
+    }
+
+    outMin = mRangeMin;
+    outMax = mRangeMax;
+    return true;
+  }
+
+  return false;
+}
+
+
+/************************************************************************************************/
+
+
+static const int kPyramidBlockSize = 16;  // samples in each node of the first level
+
+iupPlotSamplePyramid::iupPlotSamplePyramid()
+  :mCount(0), mValidCount(0), mOffset(0), mUnorderedIndex(-1), mLevelCount(0)
+{
+}
+
+iupPlotSamplePyramid::~iupPlotSamplePyramid()
+{
+  for (int l = 0; l < mLevelCount; l++)
+    iupArrayDestroy(mLevels[l]);
+}
+
+static inline void iPlotPyramidCheckMinMax(double inY, int inSampleIndex, double &ioMin, double &ioMax, int &ioMinIndex, int &ioMaxIndex)
+{
+  if (inY < ioMin)
+  {
+    ioMin = inY;
+    ioMinIndex = inSampleIndex;
+  }
+  if (inY > ioMax)
+  {
+    ioMax = inY;
+    ioMaxIndex = inSampleIndex;
+  }
+}
+
+void iupPlotSamplePyramid::Update(const iupPlotData* inDataX, const iupPlotData* inDataY, const iupPlotDataBool* inSegment)
+{
+  if (mOffset > 0 && mOffset >= inDataX->GetCount())
+  {
+    // more samples were removed than remained, build again from the beginning
+    mOffset = 0;
+    mValidCount = 0;
+    mUnorderedIndex = -1;
+  }
+
+  int theCount = inDataX->GetCount() + mOffset;
+  int theStart = mValidCount;
+  if (theStart < mOffset) theStart = mOffset;
+  if (theStart > theCount) theStart = theCount;
+
+  // only the pairs after the first modified sample must be checked again,
+  // or after the first sample when the unordered sample was removed
+  int theCheck = -1;
+  if (mUnorderedIndex == -1 || mUnorderedIndex >= theStart)
+    theCheck = theStart;
+  else if (mUnorderedIndex <= mOffset)
+    theCheck = mOffset;
+
+  if (theCheck != -1)
+  {
+    mUnorderedIndex = -1;
+
+    for (int i = iupPlotMax(theCheck, mOffset + 1); i < theCount; i++)
+    {
+      if (!(inDataX->GetSample(i - mOffset) >= inDataX->GetSample(i - 1 - mOffset)))  // also false for NAN
+      {
+        mUnorderedIndex = i;
+        break;
+      }
+    }
+  }
+
+  if (theStart == theCount && mCount == theCount)
+    return;
+
+  int theNodeCount = (theCount + kPyramidBlockSize - 1) / kPyramidBlockSize;
+  int theFirstNode = theStart / kPyramidBlockSize;
+  int theLevel = 0;
+
+  while (theNodeCount > 0)
+  {
+    if (theLevel == mLevelCount)
+    {
+      mLevels[theLevel] = iupArrayCreate(theNodeCount, sizeof(iupPlotPyramidNode));
+      mLevelCount++;
+    }
+
+    Iarray* theArray = mLevels[theLevel];
+    int theArrayCount = iupArrayCount(theArray);
+    if (theArrayCount < theNodeCount)
+      iupArrayAdd(theArray, theNodeCount - theArrayCount);
+    else if (theArrayCount > theNodeCount)
+      iupArrayRemove(theArray, theNodeCount, theArrayCount - theNodeCount);
+
+    iupPlotPyramidNode* theNodes = (iupPlotPyramidNode*)iupArrayGetData(theArray);
+
+    // nodes with removed samples are never used, they are not inside any interval
+    int theNodeSize = kPyramidBlockSize << theLevel;
+    if (theFirstNode * theNodeSize < mOffset)
+      theFirstNode = (mOffset + theNodeSize - 1) / theNodeSize;
+
+    if (theLevel == 0)
+    {
+      for (int n = theFirstNode; n < theNodeCount; n++)
+      {
+        int theBegin = n * kPyramidBlockSize;
+        int theEnd = theBegin + kPyramidBlockSize;
+        if (theEnd > theCount) theEnd = theCount;
+
+        double theMin = GetY(inDataY, theBegin);
+        double theMax = theMin;
+        theNodes[n].mMinIndex = theBegin;
+        theNodes[n].mMaxIndex = theBegin;
+        theNodes[n].mSegmentIndex = -1;
+
+        for (int i = theBegin; i < theEnd; i++)
+        {
+          iPlotPyramidCheckMinMax(GetY(inDataY, i), i, theMin, theMax, theNodes[n].mMinIndex, theNodes[n].mMaxIndex);
+
+          if (inSegment && theNodes[n].mSegmentIndex == -1 && inSegment->GetSampleBool(i - mOffset))
+            theNodes[n].mSegmentIndex = i;
+        }
+      }
+    }
+    else
+    {
+      const iupPlotPyramidNode* theChildren = GetLevel(theLevel - 1);
+      int theChildCount = iupArrayCount(mLevels[theLevel - 1]);
+
+      for (int n = theFirstNode; n < theNodeCount; n++)
+      {
+        theNodes[n] = theChildren[2 * n];
+
+        if (2 * n + 1 < theChildCount)
+        {
+          const iupPlotPyramidNode* theRight = theChildren + 2 * n + 1;
+          double theMin = GetY(inDataY, theNodes[n].mMinIndex);
+          double theMax = GetY(inDataY, theNodes[n].mMaxIndex);
+
+          if (GetY(inDataY, theRight->mMinIndex) < theMin)
+            theNodes[n].mMinIndex = theRight->mMinIndex;
+          if (GetY(inDataY, theRight->mMaxIndex) > theMax)
+            theNodes[n].mMaxIndex = theRight->mMaxIndex;
+          if (theNodes[n].mSegmentIndex == -1)
+            theNodes[n].mSegmentIndex = theRight->mSegmentIndex;
+        }
+      }
+    }
+
+    theLevel++;
+
+    if (theNodeCount == 1)
+      break;
+
+    theNodeCount = (theNodeCount + 1) / 2;
+    theFirstNode /= 2;
+  }
+
+  // levels not necessary anymore
+  for (int l = theLevel; l < mLevelCount; l++)
+    iupArrayDestroy(mLevels[l]);
+  mLevelCount = theLevel;
+
+  mCount = theCount;
+  mValidCount = theCount;
+}
+
+void iupPlotSamplePyramid::FindMinMaxIndex(const iupPlotData* inDataY, int inStart, int inEnd, int &outMinIndex, int &outMaxIndex) const
+{
+  double theMin = GetY(inDataY, inStart);
+  double theMax = theMin;
+  outMinIndex = inStart;
+  outMaxIndex = inStart;
+
+  // nodes completely inside the interval
+  int theFirstNode = (inStart + kPyramidBlockSize - 1) / kPyramidBlockSize;
+  int theLastNode = (inEnd + 1) / kPyramidBlockSize;  // not included
+
+  if (theFirstNode >= theLastNode)
+  {
+    for (int i = inStart + 1; i <= inEnd; i++)
+      iPlotPyramidCheckMinMax(GetY(inDataY, i), i, theMin, theMax, outMinIndex, outMaxIndex);
+    return;
+  }
+
+  for (int i = inStart + 1; i < theFirstNode * kPyramidBlockSize; i++)
+    iPlotPyramidCheckMinMax(GetY(inDataY, i), i, theMin, theMax, outMinIndex, outMaxIndex);
+  for (int i = theLastNode * kPyramidBlockSize; i <= inEnd; i++)
+    iPlotPyramidCheckMinMax(GetY(inDataY, i), i, theMin, theMax, outMinIndex, outMaxIndex);
+
+  // climb the levels using the largest nodes that fit in the interval
+  for (int l = 0; theFirstNode < theLastNode; l++)
+  {
+    const iupPlotPyramidNode* theNodes = GetLevel(l);
+
+    if (theFirstNode & 1)
+    {
+      iPlotPyramidCheckMinMax(GetY(inDataY, theNodes[theFirstNode].mMinIndex), theNodes[theFirstNode].mMinIndex, theMin, theMax, outMinIndex, outMaxIndex);
+      iPlotPyramidCheckMinMax(GetY(inDataY, theNodes[theFirstNode].mMaxIndex), theNodes[theFirstNode].mMaxIndex, theMin, theMax, outMinIndex, outMaxIndex);
+      theFirstNode++;
+    }
+    if (theLastNode & 1)
+    {
+      theLastNode--;
+      iPlotPyramidCheckMinMax(GetY(inDataY, theNodes[theLastNode].mMinIndex), theNodes[theLastNode].mMinIndex, theMin, theMax, outMinIndex, outMaxIndex);
+      iPlotPyramidCheckMinMax(GetY(inDataY, theNodes[theLastNode].mMaxIndex), theNodes[theLastNode].mMaxIndex, theMin, theMax, outMinIndex, outMaxIndex);
+    }
+
+    theFirstNode /= 2;
+    theLastNode /= 2;
+  }
+}
+
+int iupPlotSamplePyramid::FindSegmentIndex(const iupPlotDataBool* inSegment, int inStart, int inEnd) const
+{
+  if (!inSegment || inStart > inEnd)
+    return -1;
+
+  int theFirstNode = (inStart + kPyramidBlockSize - 1) / kPyramidBlockSize;
+  int theLastNode = (inEnd + 1) / kPyramidBlockSize;  // not included
+
+  if (theFirstNode >= theLastNode)
+  {
+    for (int i = inStart; i <= inEnd; i++)
+    {
+      if (inSegment->GetSampleBool(i - mOffset))
+        return i;
+    }
+    return -1;
+  }
+
+  for (int i = inStart; i < theFirstNode * kPyramidBlockSize; i++)
+  {
+    if (inSegment->GetSampleBool(i - mOffset))
+      return i;
+  }
+
+  int theSegmentIndex = -1;
+
+  for (int l = 0; theFirstNode < theLastNode; l++)
+  {
+    const iupPlotPyramidNode* theNodes = GetLevel(l);
+
+    if (theFirstNode & 1)
+    {
+      int theIndex = theNodes[theFirstNode].mSegmentIndex;
+      if (theIndex != -1 && (theSegmentIndex == -1 || theIndex < theSegmentIndex))
+        theSegmentIndex = theIndex;
+      theFirstNode++;
+    }
+    if (theLastNode & 1)
+    {
+      theLastNode--;
+      int theIndex = theNodes[theLastNode].mSegmentIndex;
+      if (theIndex != -1 && (theSegmentIndex == -1 || theIndex < theSegmentIndex))
+        theSegmentIndex = theIndex;
+    }
+
+    theFirstNode /= 2;
+    theLastNode /= 2;
+  }
+
+  if (theSegmentIndex != -1)
+    return theSegmentIndex;
+
+  for (int i = ((inEnd + 1) / kPyramidBlockSize) * kPyramidBlockSize; i <= inEnd; i++)
+  {
+    if (inSegment->GetSampleBool(i - mOffset))
+      return i;
+  }
+
+  return -1;
+}
+
+static inline bool iPlotCheckInside(double inY, double inMinY, double inMaxY)
+{
+  return inY >= inMinY && inY <= inMaxY;
+}
+
+int iupPlotSamplePyramid::FindInsideNode(const iupPlotData* inDataY, int inLevel, int inNode, double inMinY, double inMaxY) const
+{
+  const iupPlotPyramidNode* theNode = GetLevel(inLevel) + inNode;
+
+  // no sample of the node can be inside
+  if (GetY(inDataY, theNode->mMaxIndex) < inMinY || GetY(inDataY, theNode->mMinIndex) > inMaxY)
+    return -1;
+
+  if (inLevel == 0)
+  {
+    int theBegin = inNode * kPyramidBlockSize;
+    int theEnd = theBegin + kPyramidBlockSize;
+    if (theEnd > mCount) theEnd = mCount;
+
+    for (int i = theBegin; i < theEnd; i++)
+    {
+      if (iPlotCheckInside(GetY(inDataY, i), inMinY, inMaxY))
+        return i;
+    }
+    return -1;
+  }
+
+  int theIndex = FindInsideNode(inDataY, inLevel - 1, 2 * inNode, inMinY, inMaxY);
+  if (theIndex == -1 && 2 * inNode + 1 < iupArrayCount(mLevels[inLevel - 1]))
+    theIndex = FindInsideNode(inDataY, inLevel - 1, 2 * inNode + 1, inMinY, inMaxY);
+  return theIndex;
+}
+
+int iupPlotSamplePyramid::FindInsideIndex(const iupPlotData* inDataY, int inStart, int inEnd, double inMinY, double inMaxY) const
+{
+  // first sample in [inStart, inEnd] with Y inside [inMinY, inMaxY], -1 if none
+  if (inStart > inEnd)
+    return -1;
+
+  int theFirstNode = (inStart + kPyramidBlockSize - 1) / kPyramidBlockSize;
+  int theLastNode = (inEnd + 1) / kPyramidBlockSize;  // not included
+
+  if (theFirstNode >= theLastNode)
+  {
+    for (int i = inStart; i <= inEnd; i++)
+    {
+      if (iPlotCheckInside(GetY(inDataY, i), inMinY, inMaxY))
+        return i;
+    }
+    return -1;
+  }
+
+  for (int i = inStart; i < theFirstNode * kPyramidBlockSize; i++)
+  {
+    if (iPlotCheckInside(GetY(inDataY, i), inMinY, inMaxY))
+      return i;
+  }
+
+  // the nodes at the left are visited in order while climbing,
+  // the nodes at the right are visited later in the reverse order they were found
+  int theRightLevel[32], theRightNode[32], theRightCount = 0;
+  int theIndex;
+
+  for (int l = 0; theFirstNode < theLastNode; l++)
+  {
+    if (theFirstNode & 1)
+    {
+      theIndex = FindInsideNode(inDataY, l, theFirstNode, inMinY, inMaxY);
+      if (theIndex != -1)
+        return theIndex;
+      theFirstNode++;
+    }
+    if (theLastNode & 1)
+    {
+      theLastNode--;
+      theRightLevel[theRightCount] = l;
+      theRightNode[theRightCount] = theLastNode;
+      theRightCount++;
+    }
+
+    theFirstNode /= 2;
+    theLastNode /= 2;
+  }
+
+  while (theRightCount > 0)
+  {
+    theRightCount--;
+    theIndex = FindInsideNode(inDataY, theRightLevel[theRightCount], theRightNode[theRightCount], inMinY, inMaxY);
+    if (theIndex != -1)
+      return theIndex;
+  }
+
+  for (int i = ((inEnd + 1) / kPyramidBlockSize) * kPyramidBlockSize; i <= inEnd; i++)
+  {
+    if (iPlotCheckInside(GetY(inDataY, i), inMinY, inMaxY))
+      return i;
+  }
+
+  return -1;
+}
+
+// the public queries use the indices of the current samples
+
+void iupPlotSamplePyramid::FindMinMax(const iupPlotData* inDataY, int inStart, int inEnd, int &outMinIndex, int &outMaxIndex) const
+{
+  FindMinMaxIndex(inDataY, inStart + mOffset, inEnd + mOffset, outMinIndex, outMaxIndex);
+  outMinIndex -= mOffset;
+  outMaxIndex -= mOffset;
+}
+
+int iupPlotSamplePyramid::FindSegment(const iupPlotDataBool* inSegment, int inStart, int inEnd) const
+{
+  int theIndex = FindSegmentIndex(inSegment, inStart + mOffset, inEnd + mOffset);
+  return (theIndex == -1) ? -1 : theIndex - mOffset;
+}
+
+int iupPlotSamplePyramid::FindInside(const iupPlotData* inDataY, int inStart, int inEnd, double inMinY, double inMaxY) const
+{
+  int theIndex = FindInsideIndex(inDataY, inStart + mOffset, inEnd + mOffset, inMinY, inMaxY);
+  return (theIndex == -1) ? -1 : theIndex - mOffset;
+}
+
+
+/************************************************************************************************/
+
+
+static inline bool iPlotIsFinite(double inValue)
+{
+  return inValue - inValue == 0;  // false for NAN and INF
+}
+
+iupPlotSampleGrid::iupPlotSampleGrid()
+  :mCount(0), mValidCount(0), mOffset(0), mBuildCount(0), mSize(0), mMinX(0), mMaxX(0), mMinY(0), mMaxY(0),
+   mCellWidth(1), mCellHeight(1), mFirst(NULL), mLast(NULL), mNext(NULL)
+{
+}
+
+iupPlotSampleGrid::~iupPlotSampleGrid()
+{
+  if (mFirst) free(mFirst);
+  if (mLast) free(mLast);
+  if (mNext) iupArrayDestroy(mNext);
+}
+
+bool iupPlotSampleGrid::AddSample(int inSampleIndex, double inX, double inY)
+{
+  int* theNext;
+
+  if (!iPlotIsFinite(inX) || !iPlotIsFinite(inY))
+  {
+    // can not be found, it is not in any cell
+    theNext = (int*)iupArrayInc(mNext);
+    theNext[inSampleIndex] = -1;
+    return true;
+  }
+
+  if (inX < mMinX || inX > mMaxX || inY < mMinY || inY > mMaxY)
+    return false;
+
+  int theCellX = (int)((inX - mMinX) / mCellWidth);
+  int theCellY = (int)((inY - mMinY) / mCellHeight);
+  if (theCellX >= mSize) theCellX = mSize - 1;
+  if (theCellY >= mSize) theCellY = mSize - 1;
+  int theCell = theCellY * mSize + theCellX;
+
+  theNext = (int*)iupArrayInc(mNext);
+  theNext[inSampleIndex] = -1;
+
+  // samples are always added at the end of the cell, so they are kept in order
+  if (mFirst[theCell] == -1)
+    mFirst[theCell] = inSampleIndex;
+  else
+    theNext[mLast[theCell]] = inSampleIndex;
+  mLast[theCell] = inSampleIndex;
+
+  return true;
+}
+
+void iupPlotSampleGrid::Build(const iupPlotData* inDataX, const iupPlotData* inDataY)
+{
+  int theCount = inDataX->GetCount();
+  bool theFirst = true;
+
+  for (int i = 0; i < theCount; i++)
+  {
+    double theX = inDataX->GetSample(i);
+    double theY = inDataY->GetSample(i);
+    if (!iPlotIsFinite(theX) || !iPlotIsFinite(theY))
+      continue;
+
+    if (theFirst)
+    {
+      mMinX = mMaxX = theX;
+      mMinY = mMaxY = theY;
+      theFirst = false;
+    }
+    else
+    {
+      if (theX < mMinX) mMinX = theX;
+      if (theX > mMaxX) mMaxX = theX;
+      if (theY < mMinY) mMinY = theY;
+      if (theY > mMaxY) mMaxY = theY;
+    }
+  }
+
+  // a few samples in each cell
+  mSize = (int)sqrt(theCount / 4.0);
+  if (mSize < 1) mSize = 1;
+  if (mSize > 1024) mSize = 1024;
+
+  mCellWidth = (mMaxX - mMinX) / mSize;
+  mCellHeight = (mMaxY - mMinY) / mSize;
+  if (mCellWidth <= 0) mCellWidth = 1;
+  if (mCellHeight <= 0) mCellHeight = 1;
+
+  mOffset = 0;
+
+  mFirst = (int*)realloc(mFirst, mSize * mSize * sizeof(int));
+  mLast = (int*)realloc(mLast, mSize * mSize * sizeof(int));
+  memset(mFirst, 0xFF, mSize * mSize * sizeof(int));  // all -1
+
+  if (mNext) iupArrayDestroy(mNext);
+  mNext = iupArrayCreate(theCount + 1, sizeof(int));
+
+  for (int i = 0; i < theCount; i++)
+    AddSample(i, inDataX->GetSample(i), inDataY->GetSample(i));
+
+  mBuildCount = theCount;
+}
+
+void iupPlotSampleGrid::Update(const iupPlotData* inDataX, const iupPlotData* inDataY)
+{
+  int theCount = inDataX->GetCount() + mOffset;
+
+  if (mValidCount == theCount && mCount == theCount && mFirst)
+    return;
+
+  // only new samples can be added, and while the cells are not too crowded,
+  // also removed samples are skipped only while they are not more than the current samples
+  if (!mFirst || mValidCount < mCount || theCount < mCount ||
+      inDataX->GetCount() > 4 * mBuildCount + 64 || mOffset > inDataX->GetCount())
+    Build(inDataX, inDataY);
+  else
+  {
+    for (int i = mCount; i < theCount; i++)
+    {
+      if (!AddSample(i, inDataX->GetSample(i - mOffset), inDataY->GetSample(i - mOffset)))
+      {
+        Build(inDataX, inDataY);
+        break;
+      }
+    }
+  }
+
+  mCount = inDataX->GetCount() + mOffset;
+  mValidCount = mCount;
+}
+
+static int iPlotCompareIndex(const void* inA, const void* inB)
+{
+  return *(const int*)inA - *(const int*)inB;
+}
+
+void iupPlotSampleGrid::FindInside(const iupPlotData* inDataX, const iupPlotData* inDataY, double inMinX, double inMaxX, double inMinY, double inMaxY, Iarray* outIndex) const
+{
+  if (inMaxX < mMinX || inMinX > mMaxX || inMaxY < mMinY || inMinY > mMaxY)
+    return;
+
+  int theCellX1 = (inMinX <= mMinX) ? 0 : (int)((inMinX - mMinX) / mCellWidth);
+  int theCellX2 = (inMaxX >= mMaxX) ? mSize - 1 : (int)((inMaxX - mMinX) / mCellWidth);
+  int theCellY1 = (inMinY <= mMinY) ? 0 : (int)((inMinY - mMinY) / mCellHeight);
+  int theCellY2 = (inMaxY >= mMaxY) ? mSize - 1 : (int)((inMaxY - mMinY) / mCellHeight);
+  if (theCellX1 >= mSize) theCellX1 = mSize - 1;
+  if (theCellX2 >= mSize) theCellX2 = mSize - 1;
+  if (theCellY1 >= mSize) theCellY1 = mSize - 1;
+  if (theCellY2 >= mSize) theCellY2 = mSize - 1;
+
+  const int* theNext = (const int*)iupArrayGetData(mNext);
+  int theCellCount = 0;
+
+  for (int cy = theCellY1; cy <= theCellY2; cy++)
+  {
+    for (int cx = theCellX1; cx <= theCellX2; cx++)
+    {
+      int theCount = iupArrayCount(outIndex);
+
+      for (int i = mFirst[cy * mSize + cx]; i != -1; i = theNext[i])
+      {
+        if (i < mOffset)  // removed
+          continue;
+
+        double theX = inDataX->GetSample(i - mOffset);
+        double theY = inDataY->GetSample(i - mOffset);
+
+        if (theX >= inMinX && theX <= inMaxX && theY >= inMinY && theY <= inMaxY)
+        {
+          int* theIndex = (int*)iupArrayInc(outIndex);
+          theIndex[iupArrayCount(outIndex) - 1] = i - mOffset;
+        }
+      }
+
+      if (iupArrayCount(outIndex) > theCount)
+        theCellCount++;
+    }
+  }
+
+  // each cell is in order, but not the cells together
+  if (theCellCount > 1)
+    qsort(iupArrayGetData(outIndex), iupArrayCount(outIndex), sizeof(int), iPlotCompareIndex);
+}
+
 
 /************************************************************************************************/
 
@@ -77,7 +824,7 @@ iupPlotDataSet::iupPlotDataSet(bool strXdata)
 : mColor(CD_BLACK), mLineStyle(CD_CONTINUOUS), mLineWidth(1), mAreaTransparency(255), mMarkStyle(CD_X), mMarkSize(7),
   mMultibarIndex(-1), mMultibarCount(0), mBarOutlineColor(0), mBarShowOutline(false), mBarSpacingPercent(10),
   mPieStartAngle(0), mPieRadius(0.95), mPieContour(false), mPieHole(0), mPieSliceLabelPos(0.95),
-  mHighlightedSample(-1), mHighlightedCurve(false), mBarMulticolor(false), mOrderedX(false), mSelectedCurve(false),
+  mHighlightedSample(-1), mHighlightedCurve(false), mBarMulticolor(false), mOrderedX(false), mSelectedCurve(false), mDecimate(true), mPyramid(NULL), mGrid(NULL),
   mPieSliceLabel(IUP_PLOT_NONE), mMode(IUP_PLOT_LINE), mName(NULL), mHasSelected(false), mUserData(0)
 {
   if (strXdata)
@@ -103,6 +850,166 @@ iupPlotDataSet::~iupPlotDataSet()
     delete mSegment;
   if (mExtra)
     delete mExtra;
+  if (mPyramid)
+    delete mPyramid;
+  if (mGrid)
+    delete mGrid;
+}
+
+const iupPlotSamplePyramid* iupPlotDataSet::GetPyramid() const
+{
+  if (!mPyramid)
+    mPyramid = new iupPlotSamplePyramid();
+  mPyramid->Update(mDataX, mDataY, mSegment);
+  return mPyramid;
+}
+
+static int iPlotFindFirstX(const iupPlotData* inDataX, int inStart, int inEnd, double inX, bool inAfter)
+{
+  // first sample in [inStart, inEnd] with X >= inX (or X > inX), or inEnd+1, X must be ordered
+  while (inStart <= inEnd)
+  {
+    int theMiddle = inStart + (inEnd - inStart) / 2;
+    double theX = inDataX->GetSample(theMiddle);
+    if (inAfter ? theX > inX : theX >= inX)
+      inEnd = theMiddle - 1;
+    else
+      inStart = theMiddle + 1;
+  }
+
+  return inStart;
+}
+
+void iupPlotDataSet::FindSamplesInside(double inMinX, double inMaxX, double inMinY, double inMaxY, Iarray* outIndex) const
+{
+  // samples inside the box in data coordinates, in order
+  int theCount = mDataX->GetCount();
+  const iupPlotSamplePyramid* thePyramid = GetPyramid();
+
+  if (thePyramid->IsOrderedX())
+  {
+    int theStart = iPlotFindFirstX(mDataX, 0, theCount - 1, inMinX, false);
+    int theEnd = iPlotFindFirstX(mDataX, theStart, theCount - 1, inMaxX, true) - 1;
+
+    int i = thePyramid->FindInside(mDataY, theStart, theEnd, inMinY, inMaxY);
+    while (i != -1)
+    {
+      int* theIndex = (int*)iupArrayInc(outIndex);
+      theIndex[iupArrayCount(outIndex) - 1] = i;
+
+      i = thePyramid->FindInside(mDataY, i + 1, theEnd, inMinY, inMaxY);
+    }
+  }
+  else
+  {
+    if (!mGrid)
+      mGrid = new iupPlotSampleGrid();
+    mGrid->Update(mDataX, mDataY);
+
+    mGrid->FindInside(mDataX, mDataY, inMinX, inMaxX, inMinY, inMaxY, outIndex);
+  }
+}
+
+int iupPlotDataSet::FindSampleX(double inX) const
+{
+  // first sample with X >= inX, -1 if X is not ordered
+  int theCount = mDataX->GetCount();
+  if (theCount == 0 || !GetPyramid()->IsOrderedX())
+    return -1;
+
+  return iPlotFindFirstX(mDataX, 0, theCount - 1, inX, false);
+}
+
+bool iupPlotDataSet::CalculateXRange(double &outXMin, double &outXMax) const
+{
+  // in a ring buffer the running range is lost each time the oldest sample is discarded,
+  // but when X is ordered the first and last samples are the limits
+  int theCount = mDataX->GetCount();
+  if (theCount > 0 && mDataX->GetCapacity() && !mDataX->IsString() && GetPyramid()->IsOrderedX())
+  {
+    outXMin = mDataX->GetSample(0);
+    outXMax = mDataX->GetSample(theCount - 1);
+    return true;
+  }
+
+  return mDataX->CalculateRange(outXMin, outXMax);
+}
+
+bool iupPlotDataSet::CalculateYRange(double &outYMin, double &outYMax) const
+{
+  // in a ring buffer the running range is lost each time the oldest sample is discarded,
+  // so the pyramid is used instead
+  int theCount = mDataY->GetCount();
+  if (theCount > 0 && mDataY->GetCapacity())
+  {
+    int theMinIndex, theMaxIndex;
+    GetPyramid()->FindMinMax(mDataY, 0, theCount - 1, theMinIndex, theMaxIndex);
+    outYMin = mDataY->GetSample(theMinIndex);
+    outYMax = mDataY->GetSample(theMaxIndex);
+    return true;
+  }
+
+  return mDataY->CalculateRange(outYMin, outYMax);
+}
+
+bool iupPlotDataSet::CalculateYRange(double inXMin, double inXMax, double &outYMin, double &outYMax) const
+{
+  // range of the samples with X inside [inXMin, inXMax]
+  int theCount = mDataX->GetCount();
+  if (theCount == 0)
+    return false;
+
+  const iupPlotSamplePyramid* thePyramid = GetPyramid();
+  if (thePyramid->IsOrderedX())
+  {
+    int theStart = iPlotFindFirstX(mDataX, 0, theCount - 1, inXMin, false);
+    int theEnd = iPlotFindFirstX(mDataX, theStart, theCount - 1, inXMax, true) - 1;
+    if (theStart > theEnd)
+      return false;
+
+    int theMinIndex, theMaxIndex;
+    thePyramid->FindMinMax(mDataY, theStart, theEnd, theMinIndex, theMaxIndex);
+    outYMin = mDataY->GetSample(theMinIndex);
+    outYMax = mDataY->GetSample(theMaxIndex);
+    return true;
+  }
+
+  bool theFound = false;
+  for (int i = 0; i < theCount; i++)
+  {
+    double theX = mDataX->GetSample(i);
+    if (theX < inXMin || theX > inXMax)
+      continue;
+
+    double theY = mDataY->GetSample(i);
+    if (!theFound)
+    {
+      outYMin = outYMax = theY;
+      theFound = true;
+    }
+    else
+    {
+      if (theY < outYMin) outYMin = theY;
+      if (theY > outYMax) outYMax = theY;
+    }
+  }
+
+  return theFound;
+}
+
+int iupPlotDataSet::FindCrossingY(int inStart, double inY, bool inLess) const
+{
+  // first sample from inStart where (Y < inY) is different from inLess, -1 if none
+  int theCount = mDataX->GetCount();
+  const iupPlotSamplePyramid* thePyramid = GetPyramid();
+
+  if (inLess)
+    return thePyramid->FindInside(mDataY, inStart, theCount - 1, inY, HUGE_VAL);
+
+  int i = thePyramid->FindInside(mDataY, inStart, theCount - 1, -HUGE_VAL, inY);
+  while (i != -1 && !(mDataY->GetSample(i) < inY))
+    i = thePyramid->FindInside(mDataY, i + 1, theCount - 1, -HUGE_VAL, inY);
+  return i;
 }
 
 bool iupPlotDataSet::FindSample(iupPlotTrafo *inTrafoX, iupPlotTrafo *inTrafoY, double inScreenX, double inScreenY, double inScreenTolerance,
@@ -126,27 +1033,31 @@ bool iupPlotDataSet::FindSample(iupPlotTrafo *inTrafoX, iupPlotTrafo *inTrafoY,
 bool iupPlotDataSet::FindPointSample(iupPlotTrafo *inTrafoX, iupPlotTrafo *inTrafoY, double inScreenX, double inScreenY, double inScreenTolerance,
                                      int &outSampleIndex, double &outX, double &outY) const
 {
-  double theX, theY, theScreenX, theScreenY;
-  double thePrevScreenX = 0;
+  if (mDataX->GetCount() == 0)
+    return false;
 
-  int theCount = mDataX->GetCount();
+  // candidates inside the tolerance box in data coordinates, a little larger to avoid rounding errors
+  double theMinX = inTrafoX->TransformBack(inScreenX - inScreenTolerance - 1);
+  double theMaxX = inTrafoX->TransformBack(inScreenX + inScreenTolerance + 1);
+  double theMinY = inTrafoY->TransformBack(inScreenY - inScreenTolerance - 1);
+  double theMaxY = inTrafoY->TransformBack(inScreenY + inScreenTolerance + 1);
+  if (theMinX > theMaxX) { double theTmp = theMinX; theMinX = theMaxX; theMaxX = theTmp; }
+  if (theMinY > theMaxY) { double theTmp = theMinY; theMinY = theMaxY; theMaxY = theTmp; }
 
-  for (int i = 0; i < theCount; i++)
-  {
-    theX = mDataX->GetSample(i);
-    theY = mDataY->GetSample(i);
-    theScreenX = inTrafoX->Transform(theX);
-    theScreenY = inTrafoY->Transform(theY);
+  Iarray* theInside = iupArrayCreate(20, sizeof(int));
+  FindSamplesInside(theMinX, theMaxX, theMinY, theMaxY, theInside);
 
-    // optimization when X values are ordered
-    if (mOrderedX && i > 0 && (inScreenX < thePrevScreenX - inScreenTolerance || inScreenX > theScreenX + inScreenTolerance))
-    {
-      if (inScreenX < thePrevScreenX - inScreenTolerance)
-        break;
+  const int* theIndex = (const int*)iupArrayGetData(theInside);
+  int theCount = iupArrayCount(theInside);
+  bool theFound = false;
 
-      thePrevScreenX = theScreenX;
-      continue;
-    }
+  for (int k = 0; k < theCount; k++)
+  {
+    int i = theIndex[k];
+    double theX = mDataX->GetSample(i);
+    double theY = mDataY->GetSample(i);
+    double theScreenX = inTrafoX->Transform(theX);
+    double theScreenY = inTrafoY->Transform(theY);
 
     if (fabs(theScreenX - inScreenX) < inScreenTolerance &&
         fabs(theScreenY - inScreenY) < inScreenTolerance)
@@ -154,13 +1065,13 @@ bool iupPlotDataSet::FindPointSample(iupPlotTrafo *inTrafoX, iupPlotTrafo *inTra
       outX = theX;
       outY = theY;
       outSampleIndex = i;
-      return true;
+      theFound = true;
+      break;
     }
-
-    thePrevScreenX = theScreenX;
   }
 
-  return false;
+  iupArrayDestroy(theInside);
+  return theFound;
 }
 
 bool iupPlotDataSet::FindMultipleBarSample(iupPlotTrafo *inTrafoX, iupPlotTrafo *inTrafoY, double inScreenX, double inScreenY,
@@ -384,32 +1295,43 @@ bool iupPlotDataSet::FindSegment(iupPlotTrafo *mTrafoX, iupPlotTrafo *mTrafoY, d
   double found_x1 = 0, found_y1 = 0, found_x2 = 0, found_y2 = 0;
   bool found = false;
 
-  double theX1 = mDataX->GetSample(0);
-  double theY1 = mDataY->GetSample(0);
+  int theCount = mDataX->GetCount();
+  if (theCount == 0)
+    return false;
+
+  int theStart = 0;
+  int theEnd = theCount - 2;
+
+  // when X values are ordered, only the segments that are near the X coordinate are checked
+  if (GetPyramid()->IsOrderedX())
+  {
+    double theMinX = mTrafoX->TransformBack(inScreenX - inScreenTolerance - 1);
+    double theMaxX = mTrafoX->TransformBack(inScreenX + inScreenTolerance + 1);
+    if (theMinX > theMaxX) { double theTmp = theMinX; theMinX = theMaxX; theMaxX = theTmp; }
+
+    int theFirst = iPlotFindFirstX(mDataX, 0, theCount - 1, theMinX, false);
+    int theLast = iPlotFindFirstX(mDataX, theFirst, theCount - 1, theMaxX, true);
+
+    theStart = iupPlotMax(theFirst - 1, 0);
+    if (theLast - 1 < theEnd)
+      theEnd = theLast - 1;
+  }
+
+  if (theStart > theEnd)
+    return false;
+
+  double theX1 = mDataX->GetSample(theStart);
+  double theY1 = mDataY->GetSample(theStart);
   double theScreenX1 = mTrafoX->Transform(theX1);
   double theScreenY1 = mTrafoY->Transform(theY1);
 
-  int theCount = mDataX->GetCount();
-  for (int i = 0; i < theCount - 1; i++)
+  for (int i = theStart; i <= theEnd; i++)
   {
     double theX2 = mDataX->GetSample(i + 1);
     double theY2 = mDataY->GetSample(i + 1);
     double theScreenX2 = mTrafoX->Transform(theX2);
     double theScreenY2 = mTrafoY->Transform(theY2);
 
-    // optimization when X values are ordered
-    if (mOrderedX && (inScreenX < theScreenX1 || inScreenX > theScreenX2))
-    {
-      if (inScreenX < theScreenX1)
-        break;
-
-      theX1 = theX2;
-      theY1 = theY2;
-      theScreenX1 = theScreenX2;
-      theScreenY1 = theScreenY2;
-      continue;
-    }
-
     // inX,inY must be inside box theScreenX1,theScreenY1 - theScreenX2,theScreenY2
     if (!iPlotCheckInsideBoxTolerance(theScreenX1, theScreenY1, theScreenX2, theScreenY2, inScreenX, inScreenY, inScreenTolerance))
     {
@@ -489,50 +1411,72 @@ bool iupPlotDataSet::FindSegment(iupPlotTrafo *mTrafoX, iupPlotTrafo *mTrafoY, d
 bool iupPlotDataSet::SelectSamples(double inMinX, double inMaxX, double inMinY, double inMaxY, const iupPlotSampleNotify* inNotify)
 {
   bool theChanged = false;
+  bool theHadSelected = mHasSelected;
   mHasSelected = false;
 
   int theCount = mDataX->GetCount();
-  for (int i = 0; i < theCount; i++)
-  {
-    double theX = mDataX->GetSample(i);
-    double theY = mDataY->GetSample(i);
-    bool theSelected = mSelection->GetSampleBool(i);
 
-    if (theX >= inMinX && theX <= inMaxX &&
-        theY >= inMinY && theY <= inMaxY)
+  // only the selected samples can be unselected
+  if (theHadSelected)
+  {
+    for (int i = 0; i < theCount; i++)
     {
-      mHasSelected = true;
-
+      bool theSelected = mSelection->GetSampleBool(i);
       if (!theSelected)
+        continue;
+
+      double theX = mDataX->GetSample(i);
+      double theY = mDataY->GetSample(i);
+
+      if (theX >= inMinX && theX <= inMaxX &&
+          theY >= inMinY && theY <= inMaxY)
       {
-        if (inNotify->cb)
-        {
-          int ret = inNotify->cb(inNotify->ih, inNotify->ds, i, theX, theY, (int)theSelected);
-          if (ret == IUP_IGNORE)
-            continue;
-        }
+        mHasSelected = true;
+        continue;
+      }
 
-        theChanged = true;
-        mSelection->SetSampleBool(i, true);
+      if (inNotify->cb)
+      {
+        int ret = inNotify->cb(inNotify->ih, inNotify->ds, i, theX, theY, (int)theSelected);
+        if (ret == IUP_IGNORE)
+          continue;
       }
+
+      theChanged = true;
+      mSelection->SetSampleBool(i, false);
     }
-    else
+  }
+
+  Iarray* theInside = iupArrayCreate(20, sizeof(int));
+  FindSamplesInside(inMinX, inMaxX, inMinY, inMaxY, theInside);
+
+  const int* theIndex = (const int*)iupArrayGetData(theInside);
+  int theInsideCount = iupArrayCount(theInside);
+
+  for (int k = 0; k < theInsideCount; k++)
+  {
+    int i = theIndex[k];
+    bool theSelected = mSelection->GetSampleBool(i);
+
+    mHasSelected = true;
+
+    if (!theSelected)
     {
-      if (theSelected)
+      if (inNotify->cb)
       {
-        if (inNotify->cb)
-        {
-          int ret = inNotify->cb(inNotify->ih, inNotify->ds, i, theX, theY, (int)theSelected);
-          if (ret == IUP_IGNORE)
-            continue;
-        }
-
-        theChanged = true;
-        mSelection->SetSampleBool(i, false);
+        double theX = mDataX->GetSample(i);
+        double theY = mDataY->GetSample(i);
+        int ret = inNotify->cb(inNotify->ih, inNotify->ds, i, theX, theY, (int)theSelected);
+        if (ret == IUP_IGNORE)
+          continue;
       }
+
+      theChanged = true;
+      mSelection->SetSampleBool(i, true);
     }
   }
 
+  iupArrayDestroy(theInside);
   return theChanged;
 }
 
@@ -605,13 +1549,131 @@ int iupPlotDataSet::GetCount()
   return mDataX->GetCount();
 }
 
+void iupPlotDataSet::ReserveSamples(int inCount)
+{
+  // room for more inCount samples, avoid several reallocations when adding many samples
+  int theCount = mDataX->GetCount() + inCount;
+
+  mDataX->Reserve(theCount);
+  mDataY->Reserve(theCount);
+  mSelection->Reserve(theCount);
+  if (mSegment)
+    mSegment->Reserve(theCount);
+  if (mExtra)
+    mExtra->Reserve(theCount);
+}
+
+int iupPlotDataSet::GetCapacity()
+{
+  return mDataX->GetCapacity();
+}
+
+void iupPlotDataSet::SetCapacity(int inCapacity)
+{
+  // when not zero, the samples are stored in a ring buffer,
+  // and when it is full the oldest sample is discarded for each new sample
+  if (inCapacity < 0) inCapacity = 0;
+  if (inCapacity == mDataX->GetCapacity() || mDataY->IsBuffer())
+    return;
+
+  InvalidateIndex(0);
+
+  mDataX->SetCapacity(inCapacity);
+  mDataY->SetCapacity(inCapacity);
+  mSelection->SetCapacity(inCapacity);
+  if (mSegment)
+    mSegment->SetCapacity(inCapacity);
+  if (mExtra)
+    mExtra->SetCapacity(inCapacity);
+}
+
+bool iupPlotDataSet::AttachBuffers(const void* inX, iupPlotBufferType inTypeX, int inStrideX, const void* inY, iupPlotBufferType inTypeY, int inStrideY, int inCount)
+{
+  // the samples are replaced by the application buffers, which are not copied,
+  // or by empty arrays when inY is NULL
+  if (mDataX->IsString())
+    return false;
+
+  if (!inY || inCount < 0)
+    inCount = 0;
+
+  delete mDataX;
+  delete mDataY;
+  delete mSelection;
+  if (mSegment)
+  {
+    delete mSegment;
+    mSegment = NULL;
+  }
+  if (mExtra)
+  {
+    delete mExtra;
+    mExtra = NULL;
+  }
+
+  if (inY)
+  {
+    mDataX = new iupPlotDataBuffer(inX, inTypeX, inStrideX, inCount);
+    mDataY = new iupPlotDataBuffer(inY, inTypeY, inStrideY, inCount);
+  }
+  else
+  {
+    mDataX = new iupPlotDataReal();
+    mDataY = new iupPlotDataReal();
+  }
+
+  mSelection = new iupPlotDataBool();
+  mSelection->Reserve(inCount);
+  for (int i = 0; i < inCount; i++)
+    mSelection->AddSample(false);
+
+  mHasSelected = false;
+  mHighlightedSample = -1;
+  InvalidateIndex(0);
+  return true;
+}
+
+void iupPlotDataSet::BuffersChanged(int inStart, int inEnd)
+{
+  // the application changed the samples in [inStart, inEnd),
+  // samples after the current count are added
+  if (!mDataY->IsBuffer())
+    return;
+
+  int theCount = mDataX->GetCount();
+  if (inStart < 0) inStart = 0;
+  if (inEnd > theCount)
+  {
+    for (int i = theCount; i < inEnd; i++)
+    {
+      mSelection->AddSample(false);
+      if (mSegment)
+        mSegment->AddSample(false);
+      if (mExtra)
+        mExtra->AddSample(0);
+    }
+  }
+  else if (inEnd <= inStart)
+    return;
+
+  ((iupPlotDataBuffer*)mDataX)->SetChanged(inStart, inEnd);
+  ((iupPlotDataBuffer*)mDataY)->SetChanged(inStart, inEnd);
+
+  InvalidateIndex(inStart);
+}
+
 void iupPlotDataSet::AddSample(double inX, double inY)
 {
+  if (mDataX->IsString() || mDataX->IsBuffer())
+    return;
+
   iupPlotDataReal *theXData = (iupPlotDataReal*)mDataX;
   iupPlotDataReal *theYData = (iupPlotDataReal*)mDataY;
 
-  if (theXData->IsString())
-    return;
+  if (theXData->IsFull())
+    RemoveSample(0);
+
+  InvalidateIndex(theXData->GetCount());
 
   theXData->AddSample(inX);
   theYData->AddSample(inY);
@@ -624,11 +1686,19 @@ void iupPlotDataSet::AddSample(double inX, double inY)
 
 void iupPlotDataSet::InsertSample(int inSampleIndex, double inX, double inY)
 {
+  if (mDataX->IsString() || mDataX->IsBuffer())
+    return;
+
   iupPlotDataReal *theXData = (iupPlotDataReal*)mDataX;
   iupPlotDataReal *theYData = (iupPlotDataReal*)mDataY;
 
-  if (theXData->IsString())
-    return;
+  if (theXData->IsFull())
+  {
+    RemoveSample(0);  // the oldest sample is discarded
+    if (inSampleIndex > 0) inSampleIndex--;
+  }
+
+  InvalidateIndex(inSampleIndex);
 
   theXData->InsertSample(inSampleIndex, inX);
   theYData->InsertSample(inSampleIndex, inY);
@@ -642,6 +1712,8 @@ void iupPlotDataSet::InsertSample(int inSampleIndex, double inX, double inY)
 void iupPlotDataSet::InitSegment()
 {
   mSegment = new iupPlotDataBool();
+  if (mDataX->GetCapacity())
+    mSegment->SetCapacity(mDataX->GetCapacity());
 
   int theCount = mDataX->GetCount();
   for (int i = 0; i < theCount; i++)
@@ -651,6 +1723,8 @@ void iupPlotDataSet::InitSegment()
 void iupPlotDataSet::InitExtra()
 {
   mExtra = new iupPlotDataReal();
+  if (mDataX->GetCapacity())
+    mExtra->SetCapacity(mDataX->GetCapacity());
 
   int theCount = mDataX->GetCount();
   for (int i = 0; i < theCount; i++)
@@ -659,15 +1733,20 @@ void iupPlotDataSet::InitExtra()
 
 void iupPlotDataSet::AddSampleSegment(double inX, double inY, bool inSegment)
 {
+  if (mDataX->IsString() || mDataX->IsBuffer())
+    return;
+
   iupPlotDataReal *theXData = (iupPlotDataReal*)mDataX;
   iupPlotDataReal *theYData = (iupPlotDataReal*)mDataY;
 
-  if (theXData->IsString())
-    return;
-
   if (!mSegment)
     InitSegment();
 
+  if (theXData->IsFull())
+    RemoveSample(0);
+
+  InvalidateIndex(theXData->GetCount());
+
   theXData->AddSample(inX);
   theYData->AddSample(inY);
   mSelection->AddSample(false);
@@ -678,15 +1757,23 @@ void iupPlotDataSet::AddSampleSegment(double inX, double inY, bool inSegment)
 
 void iupPlotDataSet::InsertSampleSegment(int inSampleIndex, double inX, double inY, bool inSegment)
 {
+  if (mDataX->IsString() || mDataX->IsBuffer())
+    return;
+
   iupPlotDataReal *theXData = (iupPlotDataReal*)mDataX;
   iupPlotDataReal *theYData = (iupPlotDataReal*)mDataY;
 
-  if (theXData->IsString())
-    return;
-
   if (!mSegment)
     InitSegment();
 
+  if (theXData->IsFull())
+  {
+    RemoveSample(0);  // the oldest sample is discarded
+    if (inSampleIndex > 0) inSampleIndex--;
+  }
+
+  InvalidateIndex(inSampleIndex);
+
   theXData->InsertSample(inSampleIndex, inX);
   theYData->InsertSample(inSampleIndex, inY);
   mSelection->InsertSample(inSampleIndex, false);
@@ -703,6 +1790,11 @@ void iupPlotDataSet::AddSample(const char* inX, double inY)
   if (!theXData->IsString())
     return;
 
+  if (theXData->IsFull())
+    RemoveSample(0);
+
+  InvalidateIndex(theXData->GetCount());
+
   theXData->AddSample(inX);
   theYData->AddSample(inY);
   mSelection->AddSample(false);
@@ -720,6 +1812,14 @@ void iupPlotDataSet::InsertSample(int inSampleIndex, const char* inX, double inY
   if (!theXData->IsString())
     return;
 
+  if (theXData->IsFull())
+  {
+    RemoveSample(0);  // the oldest sample is discarded
+    if (inSampleIndex > 0) inSampleIndex--;
+  }
+
+  InvalidateIndex(inSampleIndex);
+
   theXData->InsertSample(inSampleIndex, inX);
   theYData->InsertSample(inSampleIndex, inY);
   mSelection->InsertSample(inSampleIndex, false);
@@ -731,6 +1831,14 @@ void iupPlotDataSet::InsertSample(int inSampleIndex, const char* inX, double inY
 
 void iupPlotDataSet::RemoveSample(int inSampleIndex)
 {
+  if (mDataY->IsBuffer())
+    return;
+
+  if (inSampleIndex == 0 && mDataX->GetCount() > 0)
+    RemoveFirstIndex();  // the other samples are only shifted
+  else
+    InvalidateIndex(inSampleIndex);
+
   mDataX->RemoveSample(inSampleIndex);
   mDataY->RemoveSample(inSampleIndex);
   mSelection->RemoveSample(inSampleIndex);
@@ -742,18 +1850,15 @@ void iupPlotDataSet::RemoveSample(int inSampleIndex)
 
 void iupPlotDataSet::GetSample(int inSampleIndex, double *inX, double *inY)
 {
-  iupPlotDataReal *theXData = (iupPlotDataReal*)mDataX;
-  iupPlotDataReal *theYData = (iupPlotDataReal*)mDataY;
-
-  if (theXData->IsString())
+  if (mDataX->IsString())
     return;
 
-  int theCount = theXData->GetCount();
+  int theCount = mDataX->GetCount();
   if (inSampleIndex < 0 || inSampleIndex >= theCount)
     return;
 
-  if (inX) *inX = theXData->GetSample(inSampleIndex);
-  if (inY) *inY = theYData->GetSample(inSampleIndex);
+  if (inX) *inX = mDataX->GetSample(inSampleIndex);
+  if (inY) *inY = mDataY->GetSample(inSampleIndex);
 }
 
 void iupPlotDataSet::GetSample(int inSampleIndex, const char* *inX, double *inY)
@@ -792,16 +1897,18 @@ double iupPlotDataSet::GetSampleExtra(int inSampleIndex)
 
 void iupPlotDataSet::SetSample(int inSampleIndex, double inX, double inY)
 {
+  if (mDataX->IsString() || mDataX->IsBuffer())
+    return;
+
   iupPlotDataReal *theXData = (iupPlotDataReal*)mDataX;
   iupPlotDataReal *theYData = (iupPlotDataReal*)mDataY;
 
-  if (theXData->IsString())
-    return;
-
   int theCount = theXData->GetCount();
   if (inSampleIndex < 0 || inSampleIndex >= theCount)
     return;
 
+  InvalidateIndex(inSampleIndex);
+
   theXData->SetSample(inSampleIndex, inX);
   theYData->SetSample(inSampleIndex, inY);
 }
@@ -818,6 +1925,8 @@ void iupPlotDataSet::SetSample(int inSampleIndex, const char* inX, double inY)
   if (inSampleIndex < 0 || inSampleIndex >= theCount)
     return;
 
+  InvalidateIndex(inSampleIndex);
+
   theXData->SetSampleString(inSampleIndex, inX);
   theYData->SetSample(inSampleIndex, inY);
 }
@@ -932,7 +2041,7 @@ static void iPlotDrawHighlightedArc(cdCanvas *canvas, double xc, double yc, doub
   cdCanvasSetForeground(canvas, foreground);
 }
 
-static void iPlotDrawHighlightedCurve(cdCanvas *canvas, int inCount, const iupPlotData* inDataX, const iupPlotData* inDataY, const iupPlotDataBool* inSegment, 
+static void iPlotDrawHighlightedCurve(cdCanvas *canvas, int inCount, const int* inIndex, const iupPlotData* inDataX, const iupPlotData* inDataY, const iupPlotDataBool* inSegment, 
                                       const iupPlotTrafo *inTrafoX, const iupPlotTrafo *inTrafoY, bool inConnectPreviousX, bool inSelected = false)
 {
   int foreground = cdCanvasForeground(canvas, CD_QUERY);
@@ -947,20 +2056,21 @@ static void iPlotDrawHighlightedCurve(cdCanvas *canvas, int inCount, const iupPl
 
   cdCanvasBegin(canvas, CD_OPEN_LINES);
 
-  for (int i = 0; i < inCount; i++)
+  for (int k = 0; k < inCount; k++)
   {
+    int i = inIndex ? inIndex[k] : k;
     double theX = inDataX->GetSample(i);
     double theY = inDataY->GetSample(i);
     double theScreenX = inTrafoX->Transform(theX);
     double theScreenY = inTrafoY->Transform(theY);
 
-    if (i > 0 && inSegment && inSegment->GetSampleBool(i))
+    if (k > 0 && inSegment && inSegment->GetSampleBool(i))
     {
       cdCanvasEnd(canvas);
       cdCanvasBegin(canvas, CD_OPEN_LINES);
     }
 
-    if (inConnectPreviousX && i > 0)
+    if (inConnectPreviousX && k > 0)
       cdfCanvasVertex(canvas, thePreviousScreenX, theScreenY);
 
     cdfCanvasVertex(canvas, theScreenX, theScreenY);
@@ -975,13 +2085,138 @@ static void iPlotDrawHighlightedCurve(cdCanvas *canvas, int inCount, const iupPl
   cdCanvasLineWidth(canvas, width);
 }
 
-void iupPlotDataSet::DrawDataLine(const iupPlotTrafo *inTrafoX, const iupPlotTrafo *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify, bool inShowMark, bool inErrorBar) const
+static inline double iPlotGetSampleColumn(const iupPlotTrafo *inTrafoX, const iupPlotData* inDataX, int inSampleIndex, double inDir)
+{
+  // pixel column, inDir makes it increase with the sample index
+  return inDir * floor(inTrafoX->Transform(inDataX->GetSample(inSampleIndex)));
+}
+
+static int iPlotFindColumnEnd(const iupPlotTrafo *inTrafoX, const iupPlotData* inDataX, double inDir, int inStart, int inEnd, double inColumn)
+{
+  // first sample in [inStart, inEnd] after the given column, or inEnd+1
+  while (inStart <= inEnd)
+  {
+    int theMiddle = inStart + (inEnd - inStart) / 2;
+    if (iPlotGetSampleColumn(inTrafoX, inDataX, theMiddle, inDir) > inColumn)
+      inEnd = theMiddle - 1;
+    else
+      inStart = theMiddle + 1;
+  }
+
+  return inStart;
+}
+
+static inline void iPlotAddIndex(Iarray* inArray, int inSampleIndex)
+{
+  int* theIndex = (int*)iupArrayInc(inArray);
+  theIndex[iupArrayCount(inArray) - 1] = inSampleIndex;
+}
+
+Iarray* iupPlotDataSet::DecimateSamples(const iupPlotTrafo *inTrafoX, cdCanvas* canvas, const iupPlotSampleNotify* inNotify) const
 {
+  // For each pixel column only the first, the last, the minimum and the maximum samples are drawn,
+  // the other samples would be drawn inside the vertical line between the minimum and the maximum.
+  // Returns NULL when all the samples must be drawn.
   int theCount = mDataX->GetCount();
+  int theClipMinX, theClipMaxX, theClipMinY, theClipMaxY;
+
+  if (!mDecimate || inNotify->cb)  // the callback must be called for all samples
+    return NULL;
+
+  if (cdCanvasGetClipArea(canvas, &theClipMinX, &theClipMaxX, &theClipMinY, &theClipMaxY) == CD_CLIPOFF)
+    return NULL;
+
+  int theWidth = theClipMaxX - theClipMinX + 1;
+  if (theCount <= 4 * theWidth)
+    return NULL;
+
+  const iupPlotSamplePyramid* thePyramid = GetPyramid();
+  if (!thePyramid->IsOrderedX())
+    return NULL;
+
+  double theDir = (inTrafoX->Transform(mDataX->GetSample(theCount - 1)) < inTrafoX->Transform(mDataX->GetSample(0))) ? -1 : 1;
+  double theMinColumn = (theDir > 0) ? theClipMinX : -theClipMaxX;
+  double theMaxColumn = (theDir > 0) ? theClipMaxX : -theClipMinX;
+
+  // visible samples, plus one at each side for the lines that cross the clipping area
+  int theStart = iPlotFindColumnEnd(inTrafoX, mDataX, theDir, 0, theCount - 1, theMinColumn - 1) - 1;
+  int theEnd = iPlotFindColumnEnd(inTrafoX, mDataX, theDir, 0, theCount - 1, theMaxColumn);
+  if (theStart < 0) theStart = 0;
+  if (theEnd > theCount - 1) theEnd = theCount - 1;
+
+  Iarray* theArray = iupArrayCreate(4 * theWidth, sizeof(int));
+
+  int i = theStart;
+  while (i <= theEnd)
+  {
+    double theColumn = iPlotGetSampleColumn(inTrafoX, mDataX, i, theDir);
+
+    // last sample in the same column, the step grows to skip many samples at once
+    int theLast = i, theStep = 1;
+    while (theLast + theStep <= theEnd && iPlotGetSampleColumn(inTrafoX, mDataX, theLast + theStep, theDir) <= theColumn)
+    {
+      theLast += theStep;
+      theStep *= 2;
+    }
+    int theUpper = theLast + theStep - 1;
+    if (theUpper > theEnd) theUpper = theEnd;
+    int j = iPlotFindColumnEnd(inTrafoX, mDataX, theDir, theLast + 1, theUpper, theColumn) - 1;
+
+    // a segment can not be connected to the previous one
+    int theSegmentIndex = thePyramid->FindSegment(mSegment, i + 1, j);
+    if (theSegmentIndex != -1)
+      j = theSegmentIndex - 1;
+
+    iPlotAddIndex(theArray, i);
+
+    if (j > i)
+    {
+      int theInner[3], theInnerCount = 0;
+      int theMinIndex, theMaxIndex;
+      thePyramid->FindMinMax(mDataY, i, j, theMinIndex, theMaxIndex);
+
+      theInner[theInnerCount++] = theMinIndex;
+      theInner[theInnerCount++] = theMaxIndex;
+      if (mHighlightedSample > i && mHighlightedSample < j)
+        theInner[theInnerCount++] = mHighlightedSample;
+
+      // keep the sample order
+      for (int a = 1; a < theInnerCount; a++)
+      {
+        for (int b = a; b > 0 && theInner[b] < theInner[b - 1]; b--)
+        {
+          int theTmp = theInner[b];
+          theInner[b] = theInner[b - 1];
+          theInner[b - 1] = theTmp;
+        }
+      }
+
+      for (int a = 0; a < theInnerCount; a++)
+      {
+        if (theInner[a] > i && theInner[a] < j && (a == 0 || theInner[a] != theInner[a - 1]))
+          iPlotAddIndex(theArray, theInner[a]);
+      }
+
+      iPlotAddIndex(theArray, j);
+    }
+
+    i = j + 1;
+  }
+
+  return theArray;
+}
+
+void iupPlotDataSet::DrawDataLine(const iupPlotTrafo *inTrafoX, const iupPlotTrafo *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify, bool inShowMark, bool inErrorBar) const
+{
+  // marks are drawn for all samples
+  Iarray* theDecimated = inShowMark ? NULL : DecimateSamples(inTrafoX, canvas, inNotify);
+  const int* theIndex = theDecimated ? (const int*)iupArrayGetData(theDecimated) : NULL;
+  int theCount = theDecimated ? iupArrayCount(theDecimated) : mDataX->GetCount();
   cdCanvasBegin(canvas, CD_OPEN_LINES);
 
-  for (int i = 0; i < theCount; i++)
+  for (int k = 0; k < theCount; k++)
   {
+    int i = theIndex ? theIndex[k] : k;
     double theX = mDataX->GetSample(i);
     double theY = mDataY->GetSample(i);
     double theScreenX = inTrafoX->Transform(theX);
@@ -1007,7 +2242,7 @@ void iupPlotDataSet::DrawDataLine(const iupPlotTrafo *inTrafoX, const iupPlotTra
     if (i == mHighlightedSample)
       iPlotDrawHighlightedMark(canvas, theScreenX, theScreenY);
 
-    if (i > 0 && mSegment && mSegment->GetSampleBool(i))
+    if (k > 0 && mSegment && mSegment->GetSampleBool(i))
     {
       cdCanvasEnd(canvas);
       cdCanvasBegin(canvas, CD_OPEN_LINES);
@@ -1019,9 +2254,12 @@ void iupPlotDataSet::DrawDataLine(const iupPlotTrafo *inTrafoX, const iupPlotTra
   cdCanvasEnd(canvas);
 
   if (mHighlightedCurve)
-    iPlotDrawHighlightedCurve(canvas, theCount, mDataX, mDataY, mSegment, inTrafoX, inTrafoY, false);
+    iPlotDrawHighlightedCurve(canvas, theCount, theIndex, mDataX, mDataY, mSegment, inTrafoX, inTrafoY, false);
   else if (mSelectedCurve)
-    iPlotDrawHighlightedCurve(canvas, theCount, mDataX, mDataY, mSegment, inTrafoX, inTrafoY, false, true);
+    iPlotDrawHighlightedCurve(canvas, theCount, theIndex, mDataX, mDataY, mSegment, inTrafoX, inTrafoY, false, true);
+
+  if (theDecimated)
+    iupArrayDestroy(theDecimated);
 }
 
 void iupPlotDataSet::DrawErrorBar(const iupPlotTrafo *inTrafoY, cdCanvas* canvas, int index, double theY, double theScreenX) const
@@ -1103,7 +2341,9 @@ void iupPlotDataSet::DrawDataStem(const iupPlotTrafo *inTrafoX, const iupPlotTra
 
 void iupPlotDataSet::DrawDataArea(const iupPlotTrafo *inTrafoX, const iupPlotTrafo *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify) const
 {
-  int theCount = mDataX->GetCount();
+  Iarray* theDecimated = DecimateSamples(inTrafoX, canvas, inNotify);
+  const int* theIndex = theDecimated ? (const int*)iupArrayGetData(theDecimated) : NULL;
+  int theCount = theDecimated ? iupArrayCount(theDecimated) : mDataX->GetCount();
   cdCanvasBegin(canvas, CD_FILL);
 
   double theScreenY0 = inTrafoY->Transform(0);
@@ -1112,8 +2352,9 @@ void iupPlotDataSet::DrawDataArea(const iupPlotTrafo *inTrafoX, const iupPlotTra
   if (mAreaTransparency != 255)
     cdCanvasSetForeground(canvas, cdEncodeAlpha(mColor, mAreaTransparency));
 
-  for (int i = 0; i < theCount; i++)
+  for (int k = 0; k < theCount; k++)
   {
+    int i = theIndex ? theIndex[k] : k;
     double theX = mDataX->GetSample(i);
     double theY = mDataY->GetSample(i);
     double theScreenX = inTrafoX->Transform(theX);
@@ -1122,10 +2363,10 @@ void iupPlotDataSet::DrawDataArea(const iupPlotTrafo *inTrafoX, const iupPlotTra
     if (inNotify->cb)
       inNotify->cb(inNotify->ih, inNotify->ds, i, theX, theY, (int)mSelection->GetSampleBool(i));
 
-    if (i == 0)
+    if (k == 0)
       cdfCanvasVertex(canvas, theScreenX, theScreenY0);
 
-    if (i > 0 && mSegment && mSegment->GetSampleBool(i))
+    if (k > 0 && mSegment && mSegment->GetSampleBool(i))
     {
       cdfCanvasVertex(canvas, theLastScreenX, theScreenY0);
       cdfCanvasVertex(canvas, theScreenX, theScreenY0);
@@ -1136,7 +2377,7 @@ void iupPlotDataSet::DrawDataArea(const iupPlotTrafo *inTrafoX, const iupPlotTra
     if (i == mHighlightedSample)
       iPlotDrawHighlightedMark(canvas, theScreenX, theScreenY);
 
-    if (i == theCount - 1)
+    if (k == theCount - 1)
       cdfCanvasVertex(canvas, theScreenX, theScreenY0);
 
     theLastScreenX = theScreenX;
@@ -1150,14 +2391,15 @@ void iupPlotDataSet::DrawDataArea(const iupPlotTrafo *inTrafoX, const iupPlotTra
 
     cdCanvasBegin(canvas, CD_OPEN_LINES);
 
-    for (int i = 0; i < theCount; i++)
+    for (int k = 0; k < theCount; k++)
     {
+      int i = theIndex ? theIndex[k] : k;
       double theX = mDataX->GetSample(i);
       double theY = mDataY->GetSample(i);
       double theScreenX = inTrafoX->Transform(theX);
       double theScreenY = inTrafoY->Transform(theY);
 
-      if (i > 0 && mSegment && mSegment->GetSampleBool(i))
+      if (k > 0 && mSegment && mSegment->GetSampleBool(i))
       {
         cdCanvasEnd(canvas);
         cdCanvasBegin(canvas, CD_OPEN_LINES);
@@ -1170,9 +2412,12 @@ void iupPlotDataSet::DrawDataArea(const iupPlotTrafo *inTrafoX, const iupPlotTra
   }
 
   if (mHighlightedCurve)
-    iPlotDrawHighlightedCurve(canvas, theCount, mDataX, mDataY, mSegment, inTrafoX, inTrafoY, false);
+    iPlotDrawHighlightedCurve(canvas, theCount, theIndex, mDataX, mDataY, mSegment, inTrafoX, inTrafoY, false);
   else if (mSelectedCurve)
-    iPlotDrawHighlightedCurve(canvas, theCount, mDataX, mDataY, mSegment, inTrafoX, inTrafoY, false, true);
+    iPlotDrawHighlightedCurve(canvas, theCount, theIndex, mDataX, mDataY, mSegment, inTrafoX, inTrafoY, false, true);
+
+  if (theDecimated)
+    iupArrayDestroy(theDecimated);
 }
 
 void iupPlotDataSet::DrawDataBar(const iupPlotTrafo *inTrafoX, const iupPlotTrafo *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify) const
@@ -1320,12 +2565,15 @@ void iupPlotDataSet::DrawDataMultiBar(const iupPlotTrafo *inTrafoX, const iupPlo
 
 void iupPlotDataSet::DrawDataStep(const iupPlotTrafo *inTrafoX, const iupPlotTrafo *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify) const
 {
-  int theCount = mDataX->GetCount();
+  Iarray* theDecimated = DecimateSamples(inTrafoX, canvas, inNotify);
+  const int* theIndex = theDecimated ? (const int*)iupArrayGetData(theDecimated) : NULL;
+  int theCount = theDecimated ? iupArrayCount(theDecimated) : mDataX->GetCount();
   cdCanvasBegin(canvas, CD_OPEN_LINES);
   double theLastScreenX = 0.;
 
-  for (int i = 0; i < theCount; i++)
+  for (int k = 0; k < theCount; k++)
   {
+    int i = theIndex ? theIndex[k] : k;
     double theX = mDataX->GetSample(i);
     double theY = mDataY->GetSample(i);
     double theScreenX = inTrafoX->Transform(theX);
@@ -1334,13 +2582,13 @@ void iupPlotDataSet::DrawDataStep(const iupPlotTrafo *inTrafoX, const iupPlotTra
     if (inNotify->cb)
       inNotify->cb(inNotify->ih, inNotify->ds, i, theX, theY, (int)mSelection->GetSampleBool(i));
 
-    if (i > 0 && mSegment && mSegment->GetSampleBool(i))
+    if (k > 0 && mSegment && mSegment->GetSampleBool(i))
     {
       cdCanvasEnd(canvas);
       cdCanvasBegin(canvas, CD_OPEN_LINES);
     }
 
-    if (i > 0)
+    if (k > 0)
       cdfCanvasVertex(canvas, theLastScreenX, theScreenY);
 
     cdfCanvasVertex(canvas, theScreenX, theScreenY);
@@ -1355,9 +2603,12 @@ void iupPlotDataSet::DrawDataStep(const iupPlotTrafo *inTrafoX, const iupPlotTra
 
 
   if (mHighlightedCurve)
-    iPlotDrawHighlightedCurve(canvas, theCount, mDataX, mDataY, mSegment, inTrafoX, inTrafoY, true);
+    iPlotDrawHighlightedCurve(canvas, theCount, theIndex, mDataX, mDataY, mSegment, inTrafoX, inTrafoY, true);
   else if (mSelectedCurve)
-    iPlotDrawHighlightedCurve(canvas, theCount, mDataX, mDataY, mSegment, inTrafoX, inTrafoY, true, true);
+    iPlotDrawHighlightedCurve(canvas, theCount, theIndex, mDataX, mDataY, mSegment, inTrafoX, inTrafoY, true, true);
+
+  if (theDecimated)
+    iupArrayDestroy(theDecimated);
 }
 
 static int iPlotGetPieTextAligment(double bisectrix, double inPieSliceLabelPos)
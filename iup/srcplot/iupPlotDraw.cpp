@@ -88,23 +88,39 @@ bool iupPlotGrid::DrawY(iupPlotTickIter* inTickIter, iupPlotTrafo* inTrafo, cons
 /************************************************************************************************/
 
 
-void iupPlot::DrawCrossSamplesH(const iupPlotRect &inRect, const iupPlotData *inXData, const iupPlotData *inYData, cdCanvas* canvas) const
+void iupPlot::DrawCrossSamplesH(const iupPlotRect &inRect, const iupPlotDataSet *inDataSet, cdCanvas* canvas) const
 {
-  int theCount = inXData->GetCount();
+  const iupPlotData *theXData = inDataSet->GetDataX();
+  const iupPlotData *theYData = inDataSet->GetDataY();
+
+  int theCount = theXData->GetCount();
   if (theCount == 0)
     return;
 
   double theXTarget = mAxisX.mTrafo->TransformBack((double)mCrossHairX);
-  bool theFirstIsLess = inXData->GetSample(0) < theXTarget;
+
+  // when X values are ordered there is only one crossing
+  int theIndex = inDataSet->FindSampleX(theXTarget);
+  if (theIndex != -1)
+  {
+    if (theIndex > 0 && theIndex < theCount)
+    {
+      int theScreenY = iupPlotRound(mAxisY.mTrafo->Transform(theYData->GetSample(theIndex)));
+      cdfCanvasLine(canvas, inRect.mX, theScreenY, inRect.mX + inRect.mWidth - 1, theScreenY);
+    }
+    return;
+  }
+
+  bool theFirstIsLess = theXData->GetSample(0) < theXTarget;
 
   for (int i = 0; i < theCount; i++)
   {
-    double theX = inXData->GetSample(i);
+    double theX = theXData->GetSample(i);
     bool theCurrentIsLess = theX < theXTarget;
 
     if (theCurrentIsLess != theFirstIsLess)
     {
-      double theY = inYData->GetSample(i);
+      double theY = theYData->GetSample(i);
       int theScreenY = iupPlotRound(mAxisY.mTrafo->Transform(theY)); // transform to pixels
       // Draw a horizontal line at data Y coordinate
       cdfCanvasLine(canvas, inRect.mX, theScreenY, inRect.mX + inRect.mWidth - 1, theScreenY);
@@ -126,38 +142,35 @@ void iupPlot::DrawCrossHairH(const iupPlotRect &inRect, cdCanvas* canvas) const
   {
     iupPlotDataSet* dataset = mDataSetList[ds];
 
-    const iupPlotData *theXData = dataset->GetDataX();
-    const iupPlotData *theYData = dataset->GetDataY();
-
     cdCanvasSetForeground(canvas, dataset->mColor);
 
-    DrawCrossSamplesH(inRect, theXData, theYData, canvas);
+    DrawCrossSamplesH(inRect, dataset, canvas);
   }
 }
 
-void iupPlot::DrawCrossSamplesV(const iupPlotRect &inRect, const iupPlotData *inXData, const iupPlotData *inYData, cdCanvas* canvas) const
+void iupPlot::DrawCrossSamplesV(const iupPlotRect &inRect, const iupPlotDataSet *inDataSet, cdCanvas* canvas) const
 {
-  int theCount = inXData->GetCount();
+  const iupPlotData *theXData = inDataSet->GetDataX();
+  const iupPlotData *theYData = inDataSet->GetDataY();
+
+  int theCount = theXData->GetCount();
   if (theCount == 0)
     return;
 
   double theYTarget = mAxisY.mTrafo->TransformBack((double)mCrossHairY);
-  bool theFirstIsLess = inYData->GetSample(0) < theYTarget;
+  bool theCurrentIsLess = theYData->GetSample(0) < theYTarget;
 
-  for (int i = 0; i < theCount; i++)
+  // the dataset skips the samples that are all at the same side of the target
+  int i = inDataSet->FindCrossingY(1, theYTarget, theCurrentIsLess);
+  while (i != -1)
   {
-    double theY = inYData->GetSample(i);
-    bool theCurrentIsLess = theY < theYTarget;
+    double theX = theXData->GetSample(i);
+    int theScreenX = iupPlotRound(mAxisX.mTrafo->Transform(theX)); // transform to pixels
+    // Draw a vertical line at data X coordinate
+    cdfCanvasLine(canvas, theScreenX, inRect.mY, theScreenX, inRect.mY + inRect.mHeight - 1);
 
-    if (theCurrentIsLess != theFirstIsLess)
-    {
-      double theX = inXData->GetSample(i);
-      int theScreenX = iupPlotRound(mAxisX.mTrafo->Transform(theX)); // transform to pixels
-      // Draw a vertical line at data X coordinate
-      cdfCanvasLine(canvas, theScreenX, inRect.mY, theScreenX, inRect.mY + inRect.mHeight - 1);
-
-      theFirstIsLess = theCurrentIsLess;
-    }
+    theCurrentIsLess = !theCurrentIsLess;
+    i = inDataSet->FindCrossingY(i + 1, theYTarget, theCurrentIsLess);
   }
 }
 
@@ -173,12 +186,9 @@ void iupPlot::DrawCrossHairV(const iupPlotRect &inRect, cdCanvas* canvas) const
   {
     iupPlotDataSet* dataset = mDataSetList[ds];
 
-    const iupPlotData *theXData = dataset->GetDataX();
-    const iupPlotData *theYData = dataset->GetDataY();
-
     cdCanvasSetForeground(canvas, dataset->mColor);
 
-    DrawCrossSamplesV(inRect, theXData, theYData, canvas);
+    DrawCrossSamplesV(inRect, dataset, canvas);
   }
 }
 
@@ -2439,6 +2439,7 @@ void IupPlotAddSamples(Ihandle* ih, int inIndex, double *x, double *y, int count
     return;
 
   iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[inIndex];
+  theDataSet->ReserveSamples(count);
   for (int i = 0; i < count; i++)
     theDataSet->AddSample(x[i], y[i]);
 }
@@ -2457,10 +2458,83 @@ void IupPlotAddStrSamples(Ihandle* ih, int inIndex, const char** x, double* y, i
     return;
 
   iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[inIndex];
+  theDataSet->ReserveSamples(count);
   for (int i = 0; i < count; i++)
     theDataSet->AddSample(x[i], y[i]);
 }
 
+void IupPlotAppendRolling(Ihandle* ih, int inIndex, double *x, double *y, int count)
+{
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return;
+
+  if (ih->iclass->nativetype != IUP_TYPECANVAS ||
+      !IupClassMatch(ih, "plot"))
+      return;
+
+  if (inIndex < 0 || inIndex >= ih->data->current_plot->mDataSetListCount)
+    return;
+
+  iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[inIndex];
+  int theCapacity = theDataSet->GetCapacity();
+  if (theCapacity && count > theCapacity)
+  {
+    // only the last samples would remain
+    x += count - theCapacity;
+    y += count - theCapacity;
+    count = theCapacity;
+  }
+
+  theDataSet->ReserveSamples(count);
+  for (int i = 0; i < count; i++)
+    theDataSet->AddSample(x[i], y[i]);  // discards the oldest samples when full
+}
+
+static int iPlotCheckBufferType(int type)
+{
+  return type == IUP_PLOT_DOUBLE || type == IUP_PLOT_FLOAT || type == IUP_PLOT_SHORT;
+}
+
+void IupPlotAttachBuffers(Ihandle* ih, int inIndex, const void* x, int x_type, int x_stride, const void* y, int y_type, int y_stride, int count)
+{
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return;
+
+  if (ih->iclass->nativetype != IUP_TYPECANVAS ||
+      !IupClassMatch(ih, "plot"))
+      return;
+
+  if (inIndex < 0 || inIndex >= ih->data->current_plot->mDataSetListCount)
+    return;
+
+  if (!iPlotCheckBufferType(x_type) || !iPlotCheckBufferType(y_type) || count < 0)
+    return;
+
+  iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[inIndex];
+  if (theDataSet->AttachBuffers(x, (iupPlotBufferType)x_type, x_stride, y, (iupPlotBufferType)y_type, y_stride, count))
+    ih->data->current_plot->mRedraw = true;
+}
+
+void IupPlotBuffersChanged(Ihandle* ih, int inIndex, int start, int end)
+{
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return;
+
+  if (ih->iclass->nativetype != IUP_TYPECANVAS ||
+      !IupClassMatch(ih, "plot"))
+      return;
+
+  if (inIndex < 0 || inIndex >= ih->data->current_plot->mDataSetListCount)
+    return;
+
+  iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[inIndex];
+  theDataSet->BuffersChanged(start, end);
+  ih->data->current_plot->mRedraw = true;
+}
+
 void IupPlotInsertStrSamples(Ihandle* ih, int inIndex, int inSampleIndex, const char** inX, double* inY, int count)
 {
   iupASSERT(iupObjectCheck(ih));
@@ -2475,6 +2549,7 @@ void IupPlotInsertStrSamples(Ihandle* ih, int inIndex, int inSampleIndex, const
     return;
 
   iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[inIndex];
+  theDataSet->ReserveSamples(count);
 
   for (int i = 0; i < count; i++)
     theDataSet->InsertSample(inSampleIndex + i, inX[i], inY[i]);
@@ -2494,6 +2569,7 @@ void IupPlotInsertSamples(Ihandle* ih, int inIndex, int inSampleIndex, double *i
     return;
 
   iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[inIndex];
+  theDataSet->ReserveSamples(count);
 
   for (int i = 0; i < count; i++)
     theDataSet->InsertSample(inSampleIndex + i, inX[i], inY[i]);